@@ -45,6 +45,9 @@ enum
 };
 typedef NSUInteger CCControlEvent;
 
+/** Number of kinds of control state. */
+#define kControlStateTotalNumber 4
+
 /** The possible state for a control.  */
 enum 
 {
@@ -63,6 +66,41 @@ typedef NSUInteger CCControlState;
  */
 typedef void (^CCControlBlock) (id sender, CCControlEvent event);
 
+/**
+ * A target-action pair registered for a control event. The implementation of
+ * the action is resolved once when the pair is added so that sending an action
+ * message goes neither through NSInvocation nor through the method lookup.
+ */
+typedef struct
+{
+    __unsafe_unretained id target;
+    SEL                    action;
+    IMP                    implementation;
+    NSUInteger             numberOfArguments;
+} CCControlTargetAction;
+
+/** Growable list of the target-action pairs registered for a control event. */
+typedef struct
+{
+    CCControlTargetAction *pairs;
+    NSUInteger            count;
+    NSUInteger            capacity;
+} CCControlTargetActionList;
+
+@class CCControlSubscription;
+
+/**
+ * List of the block subscriptions registered for a control event. A cancelled
+ * subscription leaves a hole (nil) which is reclaimed lazily.
+ */
+typedef struct
+{
+    CCControlSubscription * __unsafe_unretained *subscriptions;
+    NSUInteger                                  count;
+    NSUInteger                                  capacity;
+    NSUInteger                                  holes;
+} CCControlSubscriptionList;
+
 /**
  * CCControl is inspired by the UIControl API class from the UIKit library of
  * CocoaTouch. It provides a base class for Cocos2D control such as CCControlButton 
@@ -94,9 +132,46 @@ typedef void (^CCControlBlock) (id sender, CCControlEvent event);
     BOOL           _selected;
     BOOL           _highlighted;
     
+    // Value changed coalescing
+    BOOL           _coalescesValueChangedEvents;
+    BOOL           _valueChangedPending;
+    NSUInteger     _coalescedValueChangedCount;
+    
 @private
-    NSMutableDictionary *_dispatchTable;
-    NSMutableDictionary *_dispatchBlockTable;
+    // Dispatch tables indexed by the bit position of the control events
+    CCControlTargetActionList _dispatchTable[kControlEventTotalNumber];
+    CCControlBlock            _dispatchBlockTable[kControlEventTotalNumber];
+    CCControlSubscriptionList _subscriptionTable[kControlEventTotalNumber];
+    NSUInteger                _dispatchDepth;
+    BOOL                      _dispatchNeedsCompaction;
+    
+    // Hit-test manager
+    BOOL                      _hitTestManaged;
+    
+    // Inverse transform and visibility of the parents, cached until a node of
+    // the scene graph moves, is hidden or is reparented
+    CGAffineTransform         _worldToParentTransform;
+    NSUInteger                _transformCacheGeneration;
+    NSUInteger                _visibilityCacheGeneration;
+    BOOL                      _cachedHasVisibleParents;
+    
+    // Deferred colour and opacity cascade
+    BOOL                      _defersCascade;
+    NSUInteger                _cascadeDirtyFlags;
+    NSUInteger                _cascadeSkippedFlags;
+    NSMutableArray            *_cascadeSkippedChildren;
+    
+    // Raster cache
+    BOOL                      _rasterizesWhenIdle;
+    BOOL                      _rasterValid;
+    CCRenderTexture           *_rasterTexture;
+    CCControlState            _rasterState;
+    ccColor3B                 _rasterColor;
+    GLubyte                   _rasterOpacity;
+    CGSize                    _rasterContentSize;
+    
+    // Reuse pool
+    NSString                  *_reuseIdentifier;
 }
 /** @name RGBA Protocol Properties */
 /** Conforms to CCRGBAProtocol protocol. */
@@ -126,9 +201,108 @@ typedef void (^CCControlBlock) (id sender, CCControlEvent event);
 @property(nonatomic, getter = isSelected) BOOL selected;
 /** A Boolean value that determines whether the control is highlighted. */
 @property(nonatomic, getter = isHighlighted) BOOL highlighted;
-/** True if all of the controls parents are visible */
+/**
+ * True if all of the controls parents are visible. It is computed with the
+ * transform of the parents in a single walk of the ancestors.
+ */
 @property(nonatomic,readonly) BOOL hasVisibleParents;
 
+/** @name Coalescing Value Changed Events */
+/**
+ * Tells whether the CCControlEventValueChanged events are coalesced. When
+ * enabled, the control sends at most one value changed event per scheduler
+ * tick, after all the input samples of the frame have been handled. The
+ * pending event is flushed immediately when the touch ends.
+ *
+ * The default value is NO.
+ */
+@property (nonatomic, assign) BOOL coalescesValueChangedEvents;
+/**
+ * The number of CCControlEventValueChanged events which have been merged into
+ * a later one since the coalescing has been enabled.
+ */
+@property (nonatomic, readonly) NSUInteger coalescedValueChangedCount;
+
+/** @name Deferring the Colour and Opacity Cascade */
+/**
+ * Tells whether the colour and the opacity are cascaded to the children when
+ * the control is visited rather than when they are set. When enabled, the
+ * changes made during a frame (by a CCFadeTo and a CCTintTo for example)
+ * are pushed once per frame, and only to the visible children: the hidden
+ * ones, such as the per-state nodes of a CCControlButton, are brought up to
+ * date when they are shown (see resolveCascadeForChild:).
+ *
+ * Turning it off brings every child up to date immediately.
+ *
+ * The default value is NO.
+ */
+@property (nonatomic, assign) BOOL defersCascade;
+
+/** @name Rasterizing Idle Controls */
+/**
+ * Tells whether the control is drawn from a rasterized image while it is
+ * idle. The control and its children are rendered once into a render
+ * texture taken from the CCControlRasterCache, which is then drawn as a
+ * single quad as long as the state, the colour, the opacity and the content
+ * size of the control do not change. The image is rendered again at the
+ * first frame following a change of the state or a layout pass.
+ *
+ * The control is visited normally while one of its children runs an
+ * action. The image covers the content size and the bounding boxes of the
+ * children, at the resolution of the node space of the control.
+ *
+ * It does not apply to the switches drawn by a CCControlSwitchBatchNode,
+ * and it must be left off for the controls which clip their children, such
+ * as the CCControlPicker.
+ *
+ * The default value is NO.
+ */
+@property (nonatomic, assign) BOOL rasterizesWhenIdle;
+
+/** @name Reusing Controls */
+/**
+ * The identifier of the queue of the CCControlPool the control returns to
+ * when it is removed from its parent, losing its targets and blocks (see
+ * prepareForEnqueue). Controls with the same identifier
+ * must be interchangeable once reset by prepareForReuse: same class and
+ * same backing nodes (skin, fonts, sprites).
+ *
+ * The default value is nil: the control is not pooled.
+ */
+@property (nonatomic, copy) NSString *reuseIdentifier;
+
+
+#pragma mark CCControl - Reusing Controls
+/** @name Reusing Controls */
+
+/**
+ * Returns a control of the receiver class taken from the shared
+ * CCControlPool, or nil if the pool has none for the given identifier.
+ *
+ * @param identifier A reuse identifier.
+ */
++ (id)dequeueReusableControlWithIdentifier:(NSString *)identifier;
+
+/**
+ * Detaches the control from everything it sends events to when it enters
+ * the CCControlPool: its targets, blocks and subscriptions are removed, its
+ * pending value changed event is forgotten and its actions and scheduled
+ * selectors are stopped. A pooled control so keeps no target alive and
+ * sends nothing.
+ *
+ * Subclasses must call super and stop their own timers and animations.
+ */
+- (void)prepareForEnqueue;
+
+/**
+ * Resets the look of the control before it is reused: its state and its
+ * colour are reset and its transform is set back to the identity. The nodes
+ * it is made of are kept.
+ *
+ * Subclasses must call super and reset their own attributes.
+ */
+- (void)prepareForReuse;
+
 
 #pragma mark CCControl - Preparing and Sending Action Messages
 /** @name Preparing and Sending Action Messages */
@@ -141,6 +315,15 @@ typedef void (^CCControlBlock) (id sender, CCControlEvent event);
  */
 - (void)sendActionsForControlEvents:(CCControlEvent)controlEvents;
 
+/**
+ * Sends the pending CCControlEventValueChanged event immediately if there is
+ * one. Does nothing if the value changed events are not coalesced.
+ *
+ * The controls call it when the touch ends so that the final value is not
+ * delayed until the next tick.
+ */
+- (void)flushValueChangedEvents;
+
 /**
  * Adds a target and action for a particular event (or events) to an internal
  * dispatch table.
@@ -185,6 +368,32 @@ typedef void (^CCControlBlock) (id sender, CCControlEvent event);
  */
 - (void)setBlock:(CCControlBlock)block forControlEvents:(CCControlEvent)controlEvents;
 
+/**
+ * Subscribes a block to a particular event (or events). Unlike
+ * setBlock:forControlEvents: several blocks can be subscribed to the same
+ * event, they are called in the order of their subscription.
+ *
+ * @param block The block to which the action message is sent. It cannot be
+ * nil. The block is copied.
+ * @param controlEvents A bitmask specifying the control events for which the
+ * action message is sent. See "CCControlEvent" for bitmask constants.
+ *
+ * @return a subscription token to pass to removeSubscription: (or to cancel)
+ * to remove the block in constant time. The control keeps the subscription
+ * alive until then, so the token can be ignored if the block never needs to be
+ * removed. Returns nil if controlEvents contains no control event.
+ */
+- (CCControlSubscription *)addBlock:(CCControlBlock)block forControlEvents:(CCControlEvent)controlEvents;
+
+/**
+ * Removes a block subscription from the control, for all its control events.
+ * Removing a subscription which has already been removed does nothing.
+ *
+ * @param subscription The subscription token returned by
+ * addBlock:forControlEvents:.
+ */
+- (void)removeSubscription:(CCControlSubscription *)subscription;
+
 
 #pragma mark - Tracking Touches and Redrawing Controls
 /** @name Tracking Touches and Redrawing Controls */
@@ -199,6 +408,48 @@ typedef void (^CCControlBlock) (id sender, CCControlEvent event);
  */
 - (BOOL)isPointInside:(CGPoint)location;
 
+/**
+ * Returns the rect, in the node space of the receiver, outside of which a
+ * touch is never inside the receiver. It is used by the hit-test manager to
+ * index the control.
+ *
+ * By default it returns the rect of the content size. Subclasses whose
+ * touchable area exceeds their content size must override it.
+ *
+ * @see CCControlHitTestManager
+ */
+- (CGRect)hitTestRect;
+
+/**
+ * Converts a location from the world space to the node space of the receiver.
+ *
+ * Unlike convertToNodeSpace: the transform of the parents is computed once per
+ * frame and then reused by all the conversions and hit tests of the frame.
+ *
+ * @param worldLocation A location in the world space.
+ */
+- (CGPoint)convertWorldLocationToNodeSpace:(CGPoint)worldLocation;
+
+/**
+ * Converts a location from the world space to the node space of the parent of
+ * the receiver, using the same cache as convertWorldLocationToNodeSpace:.
+ *
+ * @param worldLocation A location in the world space.
+ */
+- (CGPoint)convertWorldLocationToParentSpace:(CGPoint)worldLocation;
+
+/**
+ * Invalidates the cached inverse of the transform of the parents of the
+ * receiver, so that it is computed again on the next use.
+ *
+ * The cache is invalidated whenever a node changes its position, anchor
+ * point, content size, rotation, scale, skew, visibility or parent through
+ * the CCNode setters, so there is no need to call it when an ancestor moves
+ * that way. Call it after changing the transform of an ancestor by other
+ * means, e.g. a subclass of CCNode overriding nodeToParentTransform.
+ */
+- (void)setNeedsTransformUpdate;
+
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
 
 /**
@@ -250,4 +501,55 @@ typedef void (^CCControlBlock) (id sender, CCControlEvent event);
  */
 - (void)needsLayout;
 
+/**
+ * Pushes the colour and the opacity changed since the last frame to the
+ * visible children. Does nothing unless the cascade is deferred.
+ *
+ * It is called by visit, so only the nodes drawing controls without visiting
+ * them need to call it.
+ */
+- (void)resolveCascade;
+
+/**
+ * Pushes to the given child the colour and the opacity it has missed while
+ * it was hidden. Subclasses call it when they show a child again.
+ *
+ * @param child A child of the receiver.
+ */
+- (void)resolveCascadeForChild:(CCNode *)child;
+
+/**
+ * Invalidates the rasterized image of the receiver and of its rasterizing
+ * ancestors, see rasterizesWhenIdle. The state setters and the layout passes
+ * of the controls call it; call it when a child is changed from outside.
+ */
+- (void)setNeedsRasterize;
+
+@end
+
+#pragma mark - CCControlSubscription
+
+/**
+ * Token returned by the control when a block subscribes to some control
+ * events.
+ *
+ * The subscription does not retain its control: once the control is
+ * deallocated the subscription becomes inactive.
+ */
+@interface CCControlSubscription : NSObject
+
+/** @name Getting the Subscription Attributes */
+/** The control events the block is subscribed to. */
+@property (nonatomic, readonly) CCControlEvent controlEvents;
+/** Tells whether the block is still called by its control. */
+@property (nonatomic, readonly, getter = isActive) BOOL active;
+
+/** @name Cancelling the Subscription */
+
+/**
+ * Removes the subscription from its control. Does nothing if the subscription
+ * is no longer active.
+ */
+- (void)cancel;
+
 @end
@@ -25,20 +25,232 @@
  */
 
 #import "CCControl.h"
+#import "CCControlHitTestManager.h"
+#import "CCControlInstrumentation.h"
+#import "CCControlPool.h"
+#import "CCControlRasterCache.h"
 #import "ARCMacro.h"
 
-@interface CCControl ()
-/** 
- * Table of connection between the CCControlEvents and their associated
- * target-actions pairs. For each CCButtonEvents a list of NSInvocation
- * (which contains the target-action pair) is linked.
+#import <objc/runtime.h>
+
+/** Mask of all the control events a control can send. */
+#define kControlEventAllMask ((1 << kControlEventTotalNumber) - 1)
+
+/** The values waiting to be cascaded to the children. */
+enum
+{
+    kCCControlCascadeColor            = 1 << 0,
+    kCCControlCascadeOpacity          = 1 << 1,
+    kCCControlCascadeDisplayedColor   = 1 << 2,
+    kCCControlCascadeDisplayedOpacity = 1 << 3
+};
+
+/** Number of controls being rendered into their rasterized image. */
+static NSUInteger ccControlRasterizationDepth = 0;
+
+#pragma mark - Transform Generation
+
+/**
+ * Incremented each time a node of the scene graph changes its transform, its
+ * visibility or its parent. The controls compare it with the generation of
+ * their cached parent transform to skip the walk of their ancestors while
+ * nothing has changed. It starts at 1 so that 0 means "not cached".
+ */
+static NSUInteger ccControlTransformGeneration = 1;
+
+/** The CCNode setters changing the transform, the visibility or the parent. */
+static const char *ccControlTransformSetters[] =
+{
+    "setPosition:", "setAnchorPoint:", "setContentSize:", "setIgnoreAnchorPointForPosition:",
+    "setRotation:", "setRotationX:", "setRotationY:", "setScale:", "setScaleX:", "setScaleY:",
+    "setSkewX:", "setSkewY:", "setVisible:", "setParent:",
+};
+
+/**
+ * Wraps the CCNode setters which change the transform, the visibility or the
+ * parent of a node so that they increment ccControlTransformGeneration. The
+ * subclasses overriding them call super, so every node goes through them.
+ * The setters missing from the cocos2d version in use are skipped.
+ */
+static void ccControlInstallTransformHooks(void)
+{
+    Class nodeClass = [CCNode class];
+    
+    for (NSUInteger i = 0; i < sizeof(ccControlTransformSetters) / sizeof(ccControlTransformSetters[0]); i++) {
+        SEL selector  = sel_registerName(ccControlTransformSetters[i]);
+        Method method = class_getInstanceMethod(nodeClass, selector);
+        
+        if (!method) {
+            continue;
+        }
+        
+        // The hooks are typed after the argument of the setter
+        IMP original   = method_getImplementation(method);
+        char *argument = method_copyArgumentType(method, 2);
+        IMP hook       = NULL;
+        
+        switch (argument[0]) {
+            case 'f':
+                hook = imp_implementationWithBlock(^(id receiver, float value) {
+                    ccControlTransformGeneration++;
+                    ((void (*)(id, SEL, float))original)(receiver, selector, value);
+                });
+                break;
+            case 'd':
+                hook = imp_implementationWithBlock(^(id receiver, double value) {
+                    ccControlTransformGeneration++;
+                    ((void (*)(id, SEL, double))original)(receiver, selector, value);
+                });
+                break;
+            case 'c':
+            case 'B':
+                hook = imp_implementationWithBlock(^(id receiver, BOOL value) {
+                    ccControlTransformGeneration++;
+                    ((void (*)(id, SEL, BOOL))original)(receiver, selector, value);
+                });
+                break;
+            case '@':
+                hook = imp_implementationWithBlock(^(id receiver, id value) {
+                    ccControlTransformGeneration++;
+                    ((void (*)(id, SEL, id))original)(receiver, selector, value);
+                });
+                break;
+            case '{':
+                if (strncmp(argument, "{CGPoint", 8) == 0) {
+                    hook = imp_implementationWithBlock(^(id receiver, CGPoint value) {
+                        ccControlTransformGeneration++;
+                        ((void (*)(id, SEL, CGPoint))original)(receiver, selector, value);
+                    });
+                }
+                else if (strncmp(argument, "{CGSize", 7) == 0) {
+                    hook = imp_implementationWithBlock(^(id receiver, CGSize value) {
+                        ccControlTransformGeneration++;
+                        ((void (*)(id, SEL, CGSize))original)(receiver, selector, value);
+                    });
+                }
+                break;
+        }
+        
+        free(argument);
+        
+        NSCAssert(hook, @"CCControl. Unexpected argument type for -[CCNode %s]", ccControlTransformSetters[i]);
+        if (hook) {
+            method_setImplementation(method, hook);
+        }
+    }
+}
+
+#pragma mark - Dispatch Table
+
+/**
+ * Appends the given target-action pair at the end of the list, growing its
+ * storage geometrically.
+ */
+static inline void ccControlTargetActionListAppend(CCControlTargetActionList *list, CCControlTargetAction pair)
+{
+    if (list->count == list->capacity) {
+        list->capacity = MAX(4, list->capacity * 2);
+        list->pairs    = realloc(list->pairs, list->capacity * sizeof(CCControlTargetAction));
+    }
+    
+    list->pairs[list->count++] = pair;
+}
+
+/**
+ * Removes the pairs which have been marked as removed (their action is NULL)
+ * while keeping the registration order of the others.
+ */
+static inline void ccControlTargetActionListCompact(CCControlTargetActionList *list)
+{
+    NSUInteger count = 0;
+    
+    for (NSUInteger i = 0; i < list->count; i++) {
+        if (list->pairs[i].action != NULL) {
+            list->pairs[count++] = list->pairs[i];
+        }
+    }
+    
+    list->count = count;
+}
+
+/**
+ * Sends the action message of the given pair using its cached implementation.
+ * The message includes the sender and the event if the action accepts them.
+ */
+static inline void ccControlTargetActionInvoke(CCControlTargetAction pair, CCControl *sender, CCControlEvent controlEvent)
+{
+    switch (pair.numberOfArguments) {
+        case 2:
+            ((void (*)(id, SEL))pair.implementation)(pair.target, pair.action);
+            break;
+        case 3:
+            ((void (*)(id, SEL, id))pair.implementation)(pair.target, pair.action, sender);
+            break;
+        default:
+            ((void (*)(id, SEL, id, CCControlEvent))pair.implementation)(pair.target, pair.action, sender, controlEvent);
+            break;
+    }
+}
+
+@interface CCControlSubscription ()
+{
+@public
+    __unsafe_unretained CCControl *_control;
+    CCControlBlock                _block;
+    CCControlEvent                _controlEvents;
+    NSUInteger                    _slots[kControlEventTotalNumber];
+}
+
+/**
+ * Initializes a subscription of the given block to the given control events.
+ *
+ * @param control The control which sends the events. It is not retained.
+ * @param block The block to call. It is copied.
+ * @param controlEvents A bitmask specifying the control events the block is
+ * subscribed to.
+ */
+- (id)initWithControl:(CCControl *)control block:(CCControlBlock)block controlEvents:(CCControlEvent)controlEvents;
+
+@end
+
+/**
+ * Appends the given subscription at the end of the list and returns the slot
+ * it occupies.
  */
-@property (nonatomic, strong) NSMutableDictionary *dispatchTable;
-/** 
- * Table of connection between the CCControlEvents and their associated
- * blocks. For each CCButtonEvents a list of blocks is linked.
+static inline NSUInteger ccControlSubscriptionListAppend(CCControlSubscriptionList *list, CCControlSubscription *subscription)
+{
+    if (list->count == list->capacity) {
+        list->capacity      = MAX(4, list->capacity * 2);
+        list->subscriptions = (CCControlSubscription * __unsafe_unretained *)realloc(list->subscriptions, list->capacity * sizeof(CCControlSubscription *));
+    }
+    
+    list->subscriptions[list->count] = subscription;
+    
+    return list->count++;
+}
+
+/**
+ * Reclaims the holes left by the cancelled subscriptions while keeping the
+ * subscription order, and updates the slot of the moved subscriptions.
  */
-@property (nonatomic, strong) NSMutableDictionary *dispatchBlockTable;
+static inline void ccControlSubscriptionListCompact(CCControlSubscriptionList *list, NSUInteger index)
+{
+    NSUInteger count = 0;
+    
+    for (NSUInteger i = 0; i < list->count; i++) {
+        __unsafe_unretained CCControlSubscription *subscription = list->subscriptions[i];
+        
+        if (subscription) {
+            subscription->_slots[index]  = count;
+            list->subscriptions[count++] = subscription;
+        }
+    }
+    
+    list->count = count;
+    list->holes = 0;
+}
+
+@interface CCControl ()
 
 /**
  * Adds a target and action for a particular event to an internal dispatch 
@@ -70,30 +282,85 @@
 - (void)removeTarget:(id)target action:(SEL)action forControlEvent:(CCControlEvent)controlEvent;
 
 /**
- * Returns an NSInvocation object able to construct messages using a given 
- * target-action pair. The invocation may optionnaly include the sender and
- * the event as parameters, in that order.
+ * Returns a target-action pair whose implementation and number of arguments
+ * are resolved from the given target and action.
  *
  * @param target The target object.
  * @param action A selector identifying an action message.
- * @param controlEvent A control events for which the action message is sent.
- * See "CCControlEvent" for constants.
  *
- * @return an NSInvocation object able to construct messages using a given 
- * target-action pair.
+ * @return a target-action pair ready to be dispatched.
+ */
+- (CCControlTargetAction)targetActionWithTarget:(id)target action:(SEL)action;
+
+/**
+ * Removes the target-action pairs marked as removed while the actions were
+ * being sent.
+ */
+- (void)compactDispatchTable;
+
+/**
+ * Sends action messages for the given control events without coalescing them.
+ *
+ * @param controlEvents A bitmask whose set flags specify the control events for
+ * which action messages are sent.
+ */
+- (void)dispatchActionsForControlEvents:(CCControlEvent)controlEvents;
+
+/**
+ * Scheduled each tick while the value changed events are coalesced to send the
+ * pending one.
  */
-- (NSInvocation *)invocationWithTarget:(id)target action:(SEL)action forControlEvent:(CCControlEvent)controlEvent;
+- (void)sendCoalescedValueChangedEvent:(ccTime)delta;
+
+/** Invalidates the grid of the hit-test manager if the control is registered
+ to it. */
+- (void)setNeedsHitTestUpdate;
+
+/**
+ * Recomputes and inverts the transform of the parents if a node has changed
+ * its transform, its visibility or its parent since the last call.
+ */
+- (void)updateTransformCacheIfNeeded;
 
 /**
- * Returns the NSInvocation list for the given control event. If the list does
- * not exist, it'll create an empty array before returning it.
+ * Removes the given subscription from the dispatch lists of its events and
+ * releases it, without reclaiming the holes it leaves.
  *
- * @param controlEvent A control events for which the action message is sent.
- * See "CCControlEvent" for constants.
+ * @param subscription A subscription registered to the receiver.
+ */
+- (void)detachSubscription:(CCControlSubscription *)subscription;
+
+/**
+ * Pushes the given values of the receiver to a child.
  *
- * @return the NSInvocation list for the given control event.
+ * @param flags A bitmask of the values to push.
+ * @param child A child of the receiver.
+ */
+- (void)cascadeValues:(NSUInteger)flags toChild:(CCNode<CCRGBAProtocol> *)child;
+
+/**
+ * Returns YES if the control can be drawn from its rasterized image, that is
+ * none of its children runs an action and no grid is applied to it.
+ */
+- (BOOL)isIdle;
+
+/**
+ * Draws the rasterized image of the control, rendering it first if it is not
+ * up to date.
+ */
+- (void)visitRasterized;
+
+/** Renders the control and its children into its render texture. */
+- (void)rasterize;
+
+/**
+ * Draws the control and visits its children, in the order of visit but
+ * without the transform of the control.
  */
-- (NSMutableArray *)dispatchListforControlEvent:(CCControlEvent)controlEvent;
+- (void)drawWithChildren;
+
+/** Gives the render texture back to the raster cache. */
+- (void)releaseRasterTexture;
 
 #if NS_BLOCKS_AVAILABLE
 
@@ -111,13 +378,16 @@
 @end
 
 @implementation CCControl
-@synthesize dispatchTable        = _dispatchTable;
-@synthesize dispatchBlockTable   = _dispatchBlockTable;
 @synthesize defaultTouchPriority = _defaultTouchPriority;
 @synthesize state                = _state;
 @synthesize enabled              = _enabled;
 @synthesize selected             = _selected;
 @synthesize highlighted          = _highlighted;
+@synthesize coalescesValueChangedEvents = _coalescesValueChangedEvents;
+@synthesize coalescedValueChangedCount  = _coalescedValueChangedCount;
+@synthesize defersCascade               = _defersCascade;
+@synthesize rasterizesWhenIdle          = _rasterizesWhenIdle;
+@synthesize reuseIdentifier             = _reuseIdentifier;
 
 // CCRGBAProtocol (v2.1)
 @synthesize opacity               = _opacity;
@@ -128,10 +398,34 @@
 @synthesize cascadeColorEnabled   = _cascadeColorEnabled;
 @synthesize cascadeOpacityEnabled = _cascadeOpacityEnabled;
 
++ (void)initialize
+{
+    if (self == [CCControl class]) {
+        ccControlInstallTransformHooks();
+    }
+}
+
 - (void)dealloc
 {
-    SAFE_ARC_RELEASE(_dispatchBlockTable);
-    SAFE_ARC_RELEASE(_dispatchTable);
+    for (int i = 0; i < kControlEventTotalNumber; i++) {
+        CCControlSubscriptionList *list = &_subscriptionTable[i];
+        
+        for (NSUInteger j = 0; j < list->count; j++) {
+            if (list->subscriptions[j]) {
+                [self detachSubscription:list->subscriptions[j]];
+            }
+        }
+    }
+    
+    for (int i = 0; i < kControlEventTotalNumber; i++) {
+        free(_dispatchTable[i].pairs);
+        free(_subscriptionTable[i].subscriptions);
+        SAFE_ARC_BLOCK_RELEASE(_dispatchBlockTable[i]);
+    }
+    
+    SAFE_ARC_RELEASE(_cascadeSkippedChildren);
+    SAFE_ARC_RELEASE(_reuseIdentifier);
+    [self releaseRasterTexture];
     
     SAFE_ARC_SUPER_DEALLOC();
 }
@@ -167,29 +461,59 @@
         // Set the touch dispatcher priority by default to 1
         self.defaultTouchPriority = 1;
         
-        // Initialise the tables
-        _dispatchTable      = [[NSMutableDictionary alloc] initWithCapacity:1];
-        _dispatchBlockTable = [[NSMutableDictionary alloc] initWithCapacity:1];
+        // The dispatch tables are zero-filled by the allocation and grow on demand
     }
     return self;
 }
 
 - (void)onEnter
 {
+    // The control may have been moved to another parent
+    [self setNeedsTransformUpdate];
+    
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
-    CCTouchDispatcher *dispatcher = [CCDirector sharedDirector].touchDispatcher;
-	[dispatcher addTargetedDelegate:self priority:_defaultTouchPriority swallowsTouches:YES];
+    CCControlHitTestManager *hitTestManager = [CCControlHitTestManager sharedHitTestManager];
+    
+    if ([hitTestManager isEnabled]) {
+        // Let the manager route the touches to the control
+        [hitTestManager addControl:self];
+        _hitTestManaged = YES;
+    }
+    else {
+        CCTouchDispatcher *dispatcher = [CCDirector sharedDirector].touchDispatcher;
+        [dispatcher addTargetedDelegate:self priority:_defaultTouchPriority swallowsTouches:YES];
+    }
 #endif
 	[super onEnter];
+    
+    if (_coalescesValueChangedEvents) {
+        [self schedule:@selector(sendCoalescedValueChangedEvent:)];
+    }
 }
 
 - (void)onExit
 {
+    [self setNeedsTransformUpdate];
+    
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
-    CCTouchDispatcher *dispatcher = [CCDirector sharedDirector].touchDispatcher;
-	[dispatcher removeDelegate:self];
+    if (_hitTestManaged) {
+        [[CCControlHitTestManager sharedHitTestManager] removeControl:self];
+        _hitTestManaged = NO;
+    }
+    else {
+        CCTouchDispatcher *dispatcher = [CCDirector sharedDirector].touchDispatcher;
+        [dispatcher removeDelegate:self];
+    }
 #endif
     
+    if (_coalescesValueChangedEvents) {
+        [self unschedule:@selector(sendCoalescedValueChangedEvent:)];
+        [self flushValueChangedEvents];
+    }
+    
+    // Let the controls on stage use the render texture
+    [self releaseRasterTexture];
+    
 	[super onExit];
 }
 
@@ -202,12 +526,122 @@
 
 #endif
 
+#pragma mark CCNode Transform
+
+- (void)setPosition:(CGPoint)position
+{
+    [super setPosition:position];
+    
+    [self setNeedsHitTestUpdate];
+}
+
+- (void)setAnchorPoint:(CGPoint)anchorPoint
+{
+    [super setAnchorPoint:anchorPoint];
+    
+    [self setNeedsHitTestUpdate];
+}
+
+- (void)setContentSize:(CGSize)contentSize
+{
+    [super setContentSize:contentSize];
+    
+    [self setNeedsHitTestUpdate];
+}
+
+- (void)setRotation:(float)rotation
+{
+    [super setRotation:rotation];
+    
+    [self setNeedsHitTestUpdate];
+}
+
+- (void)setScale:(float)scale
+{
+    [super setScale:scale];
+    
+    [self setNeedsHitTestUpdate];
+}
+
+- (void)setScaleX:(float)scaleX
+{
+    [super setScaleX:scaleX];
+    
+    [self setNeedsHitTestUpdate];
+}
+
+- (void)setScaleY:(float)scaleY
+{
+    [super setScaleY:scaleY];
+    
+    [self setNeedsHitTestUpdate];
+}
+
+#pragma mark CCNode Hierarchy
+
+- (void)setParent:(CCNode *)parent
+{
+    CCNode *previousParent = [self parent];
+    
+    [super setParent:parent];
+    
+    if (_reuseIdentifier) {
+        if (parent) {
+            // The control is used again without going through the pool
+            [[CCControlPool sharedPool] removeControl:self];
+        }
+        else if (previousParent) {
+            [[CCControlPool sharedPool] enqueueControl:self];
+        }
+    }
+}
+
+- (void)visit
+{
+    // Resolve the deferred cascade once per frame, before drawing the children
+    if (_cascadeDirtyFlags && [self visible]) {
+        [self resolveCascade];
+    }
+    
+    // The images are not rendered within the image of an ancestor
+    if (_rasterizesWhenIdle && ccControlRasterizationDepth == 0 && [self visible] && [self isIdle]) {
+        [self visitRasterized];
+    }
+    else {
+        // The children may be animated, so the image will be rendered again
+        _rasterValid = NO;
+        
+        [super visit];
+    }
+}
+
+- (void)removeChild:(CCNode *)child cleanup:(BOOL)cleanup
+{
+    [_cascadeSkippedChildren removeObjectIdenticalTo:child];
+    
+    [super removeChild:child cleanup:cleanup];
+}
+
+- (void)removeAllChildrenWithCleanup:(BOOL)cleanup
+{
+    [_cascadeSkippedChildren removeAllObjects];
+    
+    [super removeAllChildrenWithCleanup:cleanup];
+}
+
 #pragma mark CCRGBAProtocol
 
 - (void)setColor:(ccColor3B)color
 {
     _color = color;
     
+    if (_defersCascade) {
+        _cascadeDirtyFlags |= kCCControlCascadeColor;
+        return;
+    }
+    
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterColorCascade);
+    
     for (CCNode<CCRGBAProtocol> *child in self.children) {
         [child setColor:color];
     }
@@ -217,6 +651,13 @@
 {
     _opacity = opacity;
     
+    if (_defersCascade) {
+        _cascadeDirtyFlags |= kCCControlCascadeOpacity;
+        return;
+    }
+    
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterOpacityCascade);
+    
     for (CCNode<CCRGBAProtocol> *child in self.children) {
         [child setOpacity:opacity];
     }
@@ -236,8 +677,15 @@
 - (void)updateDisplayedOpacity:(GLubyte)parentOpacity
 {
 	_displayedOpacity = _realOpacity * parentOpacity/255.0;
+    _rasterValid      = NO;
     
     if (_cascadeOpacityEnabled) {
+        if (_defersCascade) {
+            _cascadeDirtyFlags |= kCCControlCascadeDisplayedOpacity;
+            return;
+        }
+        
+        CC_CONTROL_INSTRUMENT(self, CCControlCounterOpacityCascade);
         id<CCRGBAProtocol> item;
         
         CCARRAY_FOREACH(self.children, item) {
@@ -253,8 +701,15 @@
 	_displayedColor.r = _realColor.r * parentColor.r/255.0;
 	_displayedColor.g = _realColor.g * parentColor.g/255.0;
 	_displayedColor.b = _realColor.b * parentColor.b/255.0;
+    _rasterValid      = NO;
     
     if (_cascadeColorEnabled) {
+        if (_defersCascade) {
+            _cascadeDirtyFlags |= kCCControlCascadeDisplayedColor;
+            return;
+        }
+        
+        CC_CONTROL_INSTRUMENT(self, CCControlCounterColorCascade);
         id<CCRGBAProtocol> item;
         
         CCARRAY_FOREACH(self.children, item) {
@@ -272,6 +727,7 @@
 - (void)setEnabled:(BOOL)enabled
 {
     _enabled = enabled;
+    [self setNeedsRasterize];
     
     if(_enabled) {
         _state = CCControlStateNormal;
@@ -286,6 +742,7 @@
 - (void)setSelected:(BOOL)selected
 {
     _selected = selected;
+    [self setNeedsRasterize];
     
     [self needsLayout];
 }
@@ -293,66 +750,202 @@
 - (void)setHighlighted:(BOOL)highlighted
 {
     _highlighted = highlighted;
+    [self setNeedsRasterize];
     
     [self needsLayout];
 }
 
-- (BOOL)hasVisibleParents
+- (void)setCoalescesValueChangedEvents:(BOOL)coalescesValueChangedEvents
 {
-    for( CCNode *c = self.parent; c != nil; c = c.parent) {
-		if (!c.visible) {
-            return NO;
+    if (_coalescesValueChangedEvents == coalescesValueChangedEvents) {
+        return;
+    }
+    
+    if (coalescesValueChangedEvents) {
+        _coalescesValueChangedEvents = YES;
+        _coalescedValueChangedCount  = 0;
+        
+        if ([self isRunning]) {
+            [self schedule:@selector(sendCoalescedValueChangedEvent:)];
+        }
+    }
+    else {
+        if ([self isRunning]) {
+            [self unschedule:@selector(sendCoalescedValueChangedEvent:)];
         }
+        
+        [self flushValueChangedEvents];
+        
+        _coalescesValueChangedEvents = NO;
     }
+}
 
-    return YES;
+- (void)setDefersCascade:(BOOL)defersCascade
+{
+    if (_defersCascade == defersCascade) {
+        return;
+    }
+    
+    _defersCascade = defersCascade;
+    
+    if (!defersCascade) {
+        // Bring every child up to date as if the values had been cascaded immediately
+        for (CCNode<CCRGBAProtocol> *child in self.children) {
+            NSUInteger flags = _cascadeDirtyFlags;
+            
+            if ([_cascadeSkippedChildren indexOfObjectIdenticalTo:child] != NSNotFound) {
+                flags |= _cascadeSkippedFlags;
+            }
+            
+            [self cascadeValues:flags toChild:child];
+        }
+        
+        _cascadeDirtyFlags   = 0;
+        _cascadeSkippedFlags = 0;
+        [_cascadeSkippedChildren removeAllObjects];
+    }
+}
+
+- (void)setRasterizesWhenIdle:(BOOL)rasterizesWhenIdle
+{
+    _rasterizesWhenIdle = rasterizesWhenIdle;
+    
+    if (!rasterizesWhenIdle) {
+        [self releaseRasterTexture];
+    }
+}
+
+- (BOOL)hasVisibleParents
+{
+    if (_visibilityCacheGeneration == ccControlTransformGeneration) {
+        return _cachedHasVisibleParents;
+    }
+    
+    // Stops at the first hidden ancestor, without computing the transform
+    _cachedHasVisibleParents = YES;
+    
+    for (CCNode *node = [self parent]; node != nil; node = [node parent]) {
+        if (![node visible]) {
+            _cachedHasVisibleParents = NO;
+            break;
+        }
+    }
+    
+    _visibilityCacheGeneration = ccControlTransformGeneration;
+    
+    return _cachedHasVisibleParents;
 }
 
 #pragma mark -
 #pragma mark CCControl Public Methods
 
-- (void)sendActionsForControlEvents:(CCControlEvent)controlEvents
++ (id)dequeueReusableControlWithIdentifier:(NSString *)identifier
+{
+    id control = [[CCControlPool sharedPool] dequeueControlWithReuseIdentifier:identifier];
+    
+    NSAssert(control == nil || [control isKindOfClass:self], @"The identifier is used by controls of another class.");
+    
+    return control;
+}
+
+- (void)prepareForEnqueue
 {
-    // For each control events
+    // Forget the pending event rather than sending it to the previous targets
+    _valueChangedPending             = NO;
+    self.coalescesValueChangedEvents = NO;
+    _coalescedValueChangedCount      = 0;
+    
     for (int i = 0; i < kControlEventTotalNumber; i++) {
-        // If the given controlEvents bitmask contains the curent event
-        if ((controlEvents & (1 << i))) {
-            // Call invocations
-            NSArray *invocationList = [self dispatchListforControlEvent:(1 << i)];
-            
-            for (NSInvocation *invocation in invocationList) {
-                [invocation invoke];
-            }
-            
-            // Call blocks
-            CCControlBlock block = [_dispatchBlockTable objectForKey:[NSNumber numberWithUnsignedInteger:(1 << i)]];
-            
-            if (block) {
-                block (self, (1 << i));
+        CCControlSubscriptionList *list = &_subscriptionTable[i];
+        
+        for (NSUInteger j = 0; j < list->count; j++) {
+            if (list->subscriptions[j]) {
+                [self detachSubscription:list->subscriptions[j]];
             }
         }
+        list->count = 0;
+        list->holes = 0;
+        
+        _dispatchTable[i].count = 0;
+        SAFE_ARC_BLOCK_RELEASE(_dispatchBlockTable[i]);
+        _dispatchBlockTable[i] = nil;
     }
+    
+    [self stopAllActions];
+    [self unscheduleAllSelectors];
 }
 
-- (void)addTarget:(id)target action:(SEL)action forControlEvents:(CCControlEvent)controlEvents
+- (void)prepareForReuse
 {
-    // For each control events
-    for (int i = 0; i < kControlEventTotalNumber; i++) {
-        // If the given controlEvents bitmask contains the curent event
-        if ((controlEvents & (1 << i))) {
-            [self addTarget:target action:action forControlEvent:(1 << i)];
+    self.defersCascade      = NO;
+    self.rasterizesWhenIdle = NO;
+    
+    self.enabled     = YES;
+    self.selected    = NO;
+    self.highlighted = NO;
+    
+    // Snap the animations started by the state setters
+    [self stopAllActions];
+    
+    self.color   = ccWHITE;
+    self.opacity = 255;
+    
+    self.defaultTouchPriority = 1;
+    self.position             = CGPointZero;
+    self.rotation             = 0;
+    self.scale                = 1;
+    self.visible              = YES;
+    self.tag                  = kCCNodeTagInvalid;
+    self.userObject           = nil;
+}
+
+- (void)sendActionsForControlEvents:(CCControlEvent)controlEvents
+{
+    // Keep only the latest value changed event until the next tick
+    if (_coalescesValueChangedEvents && (controlEvents & CCControlEventValueChanged)) {
+        controlEvents &= ~CCControlEventValueChanged;
+        
+        if (_valueChangedPending) {
+            _coalescedValueChangedCount++;
         }
+        _valueChangedPending = YES;
+    }
+    
+    if (controlEvents) {
+        [self dispatchActionsForControlEvents:controlEvents];
+    }
+}
+
+- (void)flushValueChangedEvents
+{
+    if (_valueChangedPending) {
+        _valueChangedPending = NO;
+        
+        [self dispatchActionsForControlEvents:CCControlEventValueChanged];
+    }
+}
+
+- (void)addTarget:(id)target action:(SEL)action forControlEvents:(CCControlEvent)controlEvents
+{
+    controlEvents &= kControlEventAllMask;
+    
+    // For each control events contained into the given bitmask
+    while (controlEvents) {
+        [self addTarget:target action:action forControlEvent:(1 << __builtin_ctzl(controlEvents))];
+        
+        controlEvents &= controlEvents - 1;
     }
 }
 
 - (void)removeTarget:(id)target action:(SEL)action forControlEvents:(CCControlEvent)controlEvents
 {
-    // For each control events
-    for (int i = 0; i < kControlEventTotalNumber; i++) {
-        // If the given controlEvents bitmask contains the curent event
-        if ((controlEvents & (1 << i))) {
-            [self removeTarget:target action:action forControlEvent:(1 << i)];
-        }
+    controlEvents &= kControlEventAllMask;
+    
+    // For each control events contained into the given bitmask
+    while (controlEvents) {
+        [self removeTarget:target action:action forControlEvent:(1 << __builtin_ctzl(controlEvents))];
+        
+        controlEvents &= controlEvents - 1;
     }
 }
 
@@ -361,22 +954,54 @@
     return CGRectContainsPoint([self boundingBox], location);
 }
 
+- (CGRect)hitTestRect
+{
+    CGSize size = [self contentSize];
+    
+    return CGRectMake(0, 0, size.width, size.height);
+}
+
+- (CGPoint)convertWorldLocationToNodeSpace:(CGPoint)worldLocation
+{
+    [self updateTransformCacheIfNeeded];
+    
+    // The transform of the control itself is already cached by CCNode
+    CGAffineTransform worldToNode = CGAffineTransformConcat(_worldToParentTransform, [self parentToNodeTransform]);
+    
+    return CGPointApplyAffineTransform(worldLocation, worldToNode);
+}
+
+- (CGPoint)convertWorldLocationToParentSpace:(CGPoint)worldLocation
+{
+    [self updateTransformCacheIfNeeded];
+    
+    return CGPointApplyAffineTransform(worldLocation, _worldToParentTransform);
+}
+
+- (void)setNeedsTransformUpdate
+{
+    _transformCacheGeneration  = 0;
+    _visibilityCacheGeneration = 0;
+}
+
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
 
 - (CGPoint)touchLocation:(UITouch *)touch
 {
     CGPoint touchLocation = [touch locationInView:[touch view]];                     // Get the touch position
     touchLocation         = [[CCDirector sharedDirector] convertToGL:touchLocation]; // Convert the position to GL space
-    touchLocation         = [self convertToNodeSpace:touchLocation];                 // Convert to the node space of this class
+    touchLocation         = [self convertWorldLocationToNodeSpace:touchLocation];    // Convert to the node space of this class
     
     return touchLocation;
 }
 
 - (BOOL)isTouchInside:(UITouch *)touch
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterHitTest);
+    
     CGPoint touchLocation = [touch locationInView:[touch view]];                     // Get the touch position
     touchLocation         = [[CCDirector sharedDirector] convertToGL:touchLocation]; // Convert the position to GL space
-    touchLocation         = [[self parent] convertToNodeSpace:touchLocation];        // Convert to the node space of this class
+    touchLocation         = [self convertWorldLocationToParentSpace:touchLocation];  // Convert to the node space of the parent
 
     return [self isPointInside:touchLocation];
 }
@@ -386,15 +1011,17 @@
 - (CGPoint)eventLocation:(NSEvent *)event
 {
     CGPoint eventLocation = [[CCDirector sharedDirector] convertEventToGL:event];
-    eventLocation         = [self convertToNodeSpace:eventLocation];
+    eventLocation         = [self convertWorldLocationToNodeSpace:eventLocation];
     
     return eventLocation;
 }
 
 - (BOOL)isMouseInside:(NSEvent *)event
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterHitTest);
+    
     CGPoint eventLocation = [[CCDirector sharedDirector] convertEventToGL:event];
-    eventLocation         = [[self parent] convertToNodeSpace:eventLocation];
+    eventLocation         = [self convertWorldLocationToParentSpace:eventLocation];
 
     return [self isPointInside:eventLocation];
 }
@@ -403,92 +1030,416 @@
 
 - (void)needsLayout
 {
-    // Do nothing by default
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterNeedsLayout);
+    
+    [self setNeedsRasterize];
 }
 
-#pragma mark CCControl Private Methods
+- (void)resolveCascade
+{
+    NSUInteger flags = _cascadeDirtyFlags;
+    
+    if (flags == 0) {
+        return;
+    }
+    _cascadeDirtyFlags = 0;
+    
+    CC_CONTROL_INSTRUMENT(self, (flags & (kCCControlCascadeColor | kCCControlCascadeDisplayedColor))
+                          ? CCControlCounterColorCascade : CCControlCounterOpacityCascade);
+    
+    BOOL skipped = NO;
+    
+    for (CCNode<CCRGBAProtocol> *child in self.children) {
+        NSUInteger index = [_cascadeSkippedChildren count] ? [_cascadeSkippedChildren indexOfObjectIdenticalTo:child] : NSNotFound;
+        
+        if ([child visible]) {
+            // A child shown again also receives the values it has missed
+            if (index != NSNotFound) {
+                [self cascadeValues:(flags | _cascadeSkippedFlags) toChild:child];
+                [_cascadeSkippedChildren removeObjectAtIndex:index];
+            }
+            else {
+                [self cascadeValues:flags toChild:child];
+            }
+        }
+        else {
+            if (index == NSNotFound) {
+                if (!_cascadeSkippedChildren) {
+                    _cascadeSkippedChildren = [[NSMutableArray alloc] init];
+                }
+                [_cascadeSkippedChildren addObject:child];
+            }
+            skipped = YES;
+        }
+    }
+    
+    if (skipped) {
+        _cascadeSkippedFlags |= flags;
+    }
+    else if ([_cascadeSkippedChildren count] == 0) {
+        _cascadeSkippedFlags = 0;
+    }
+}
 
-- (void)addTarget:(id)target action:(SEL)action forControlEvent:(CCControlEvent)controlEvent
+- (void)resolveCascadeForChild:(CCNode *)child
 {
-    // Create the invocation object
-    NSInvocation *invocation = [self invocationWithTarget:target action:action forControlEvent:controlEvent];
+    NSUInteger index = [_cascadeSkippedChildren indexOfObjectIdenticalTo:child];
     
-    // Add the invocation into the dispatch list for the given control event
-    NSMutableArray *eventInvocationList = [self dispatchListforControlEvent:controlEvent];
-    [eventInvocationList addObject:invocation];
+    if (index == NSNotFound) {
+        return;
+    }
+    
+    [self cascadeValues:_cascadeSkippedFlags toChild:(CCNode<CCRGBAProtocol> *)child];
+    [_cascadeSkippedChildren removeObjectAtIndex:index];
+    
+    if ([_cascadeSkippedChildren count] == 0) {
+        _cascadeSkippedFlags = 0;
+    }
 }
 
-- (void)removeTarget:(id)target action:(SEL)action forControlEvent:(CCControlEvent)controlEvent
+- (void)setNeedsRasterize
 {
-    // Retrieve all invocations for the given control event
-    NSMutableArray *eventInvocationList = [self dispatchListforControlEvent:controlEvent];
+    for (CCNode *node = self; node != nil; node = [node parent]) {
+        if ([node isKindOfClass:[CCControl class]]) {
+            ((CCControl *)node)->_rasterValid = NO;
+        }
+    }
+}
 
-    NSPredicate *predicate = 
-    [NSPredicate predicateWithBlock:^ BOOL (id object, NSDictionary *bindings) {
-         NSInvocation *evaluatedObject = object;
-         
-         if ((target == nil && action == NULL)
-             || (target == nil && [evaluatedObject selector] == action)
-             || (action == NULL && [evaluatedObject target] == target)
-             || ([evaluatedObject target] == target && [evaluatedObject selector] == action)) {
-             return YES;
-         } 
+#pragma mark CCControl Private Methods
+
+- (void)addTarget:(id)target action:(SEL)action forControlEvent:(CCControlEvent)controlEvent
+{
+    // Resolve the pair once and add it into the dispatch list for the given control event
+    ccControlTargetActionListAppend(&_dispatchTable[__builtin_ctzl(controlEvent)],
+                                    [self targetActionWithTarget:target action:action]);
+}
 
-         return NO;
-     }];
+- (void)removeTarget:(id)target action:(SEL)action forControlEvent:(CCControlEvent)controlEvent
+{
+    // Retrieve all pairs for the given control event
+    CCControlTargetActionList *list = &_dispatchTable[__builtin_ctzl(controlEvent)];
+    BOOL removed                    = NO;
     
-    // Define the invocation to remove for the given control event
-    NSArray *removeObjectList = [eventInvocationList filteredArrayUsingPredicate:predicate];
+    for (NSUInteger i = 0; i < list->count; i++) {
+        CCControlTargetAction *pair = &list->pairs[i];
+        
+        if (pair->action != NULL
+            && (target == nil || pair->target == target)
+            && (action == NULL || pair->action == action)) {
+            // Mark the pair as removed
+            pair->action = NULL;
+            pair->target = nil;
+            removed      = YES;
+        }
+    }
     
-    // Remove the corresponding invocation objects
-    [eventInvocationList removeObjectsInArray:removeObjectList];
+    if (removed) {
+        // The lists can not be shrunk while they are walked through
+        if (_dispatchDepth > 0) {
+            _dispatchNeedsCompaction = YES;
+        } else {
+            ccControlTargetActionListCompact(list);
+        }
+    }
 }
 
-- (NSInvocation *)invocationWithTarget:(id)target action:(SEL)action forControlEvent:(CCControlEvent)controlEvent
+- (CCControlTargetAction)targetActionWithTarget:(id)target action:(SEL)action
 {
     NSAssert(target, @"The target cannot be nil");
     NSAssert(action != NULL, @"The action cannot be NULL");
     
-    // Create the method signature for the invocation
+    // Retrieve the method signature to know how many arguments the action accepts
     NSMethodSignature *sig = [target methodSignatureForSelector:action];
     NSAssert(sig, @"The given target does not implement the given action");
     
-    // Create the invocation object
-    // First and second corresponds respectively to target and action
-    NSInvocation *invocation = [NSInvocation invocationWithMethodSignature:sig];
-    [invocation setTarget:target];
-    [invocation setSelector:action];
+    // First and second arguments corresponds respectively to target and action
+    // The third one is the sender and the fourth one the control event
+    CCControlTargetAction pair;
+    pair.target            = target;
+    pair.action            = action;
+    pair.implementation    = [target methodForSelector:action];
+    pair.numberOfArguments = [sig numberOfArguments];
+    
+    return pair;
+}
+
+- (void)dispatchActionsForControlEvents:(CCControlEvent)controlEvents
+{
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterSendActions);
+    
+    controlEvents &= kControlEventAllMask;
+    
+    _dispatchDepth++;
+    
+    // Walk only through the events whose bit is set
+    while (controlEvents) {
+        NSUInteger index            = __builtin_ctzl(controlEvents);
+        CCControlEvent controlEvent = (1 << index);
+        controlEvents              &= controlEvents - 1;
+        
+        // Call the target-action pairs (the list may grow while dispatching)
+        CCControlTargetActionList *list = &_dispatchTable[index];
+        
+        for (NSUInteger i = 0; i < list->count; i++) {
+            CCControlTargetAction pair = list->pairs[i];
+            
+            if (pair.action != NULL) {
+                CC_CONTROL_INSTRUMENT(self, CCControlCounterHandlers);
+                
+                ccControlTargetActionInvoke(pair, self, controlEvent);
+            }
+        }
+        
+        // Call blocks
+        CCControlBlock block = _dispatchBlockTable[index];
+        
+        if (block) {
+            CC_CONTROL_INSTRUMENT(self, CCControlCounterHandlers);
+            
+            block (self, controlEvent);
+        }
+        
+        // Call the subscribed blocks
+        CCControlSubscriptionList *subscriptions = &_subscriptionTable[index];
+        
+        for (NSUInteger i = 0; i < subscriptions->count; i++) {
+            CCControlSubscription *subscription = subscriptions->subscriptions[i];
+            
+            if (subscription) {
+                // Keep the block alive in case it cancels its own subscription
+                CC_CONTROL_INSTRUMENT(self, CCControlCounterHandlers);
+                
+                CCControlBlock subscriptionBlock = SAFE_ARC_RETAIN(subscription->_block);
+                subscriptionBlock (self, controlEvent);
+                SAFE_ARC_RELEASE(subscriptionBlock);
+            }
+        }
+    }
+    
+    _dispatchDepth--;
+    
+    if (_dispatchDepth == 0 && _dispatchNeedsCompaction) {
+        [self compactDispatchTable];
+    }
+}
+
+- (void)cascadeValues:(NSUInteger)flags toChild:(CCNode<CCRGBAProtocol> *)child
+{
+    if (flags & kCCControlCascadeColor) {
+        [child setColor:_color];
+    }
+    
+    if (flags & kCCControlCascadeOpacity) {
+        [child setOpacity:_opacity];
+    }
+    
+#if COCOS2D_VERSION >= 0x00020100
+    if ((flags & (kCCControlCascadeDisplayedColor | kCCControlCascadeDisplayedOpacity))
+        && [child conformsToProtocol:@protocol(CCRGBAProtocol)]) {
+        if (flags & kCCControlCascadeDisplayedColor) {
+            [child updateDisplayedColor:_displayedColor];
+        }
+        
+        if (flags & kCCControlCascadeDisplayedOpacity) {
+            [child updateDisplayedOpacity:_displayedOpacity];
+        }
+    }
+#endif
+}
+
+- (BOOL)isIdle
+{
+    // Accessors rather than ivars, which cocos2d v2.1 has renamed
+    CCGridBase *grid = [self grid];
+    
+    if (grid && grid.active) {
+        return NO;
+    }
+    
+    CCNode *child;
+    CCARRAY_FOREACH([self children], child) {
+        if ([child numberOfRunningActions] > 0) {
+            return NO;
+        }
+    }
+    
+    return YES;
+}
+
+- (void)visitRasterized
+{
+    CGSize contentSize = [self contentSize];
+    
+    if (_rasterValid
+        && _rasterState == _state
+        && _rasterColor.r == _color.r && _rasterColor.g == _color.g && _rasterColor.b == _color.b
+        && _rasterOpacity == _opacity
+        && CGSizeEqualToSize(_rasterContentSize, contentSize)) {
+        [[CCControlRasterCache sharedRasterCache] recordHit];
+    }
+    else {
+        [[CCControlRasterCache sharedRasterCache] recordMiss];
+        
+        [self rasterize];
+    }
+    
+    // Draw the image as a single quad in the node space of the control
+    kmGLPushMatrix();
+    
+    [self transform];
+    [_rasterTexture.sprite visit];
+    
+    self.orderOfArrival = 0;
     
-    // If the selector accept the sender as third argument
-    if ([sig numberOfArguments] >= 3) {
-        CCControl *me   = self;
-        [invocation setArgument:&me atIndex:2];
+    kmGLPopMatrix();
+}
+
+- (void)rasterize
+{
+    // The image covers the content and the visible children
+    CGSize contentSize = [self contentSize];
+    CGRect rect        = CGRectMake(0, 0, contentSize.width, contentSize.height);
+    
+    CCNode *child;
+    CCARRAY_FOREACH([self children], child) {
+        if ([child visible]) {
+            rect = CGRectUnion(rect, [child boundingBox]);
+        }
+    }
+    rect = CGRectIntegral(rect);
+    
+    CGSize textureSize = _rasterTexture.sprite.texture.contentSize;
+    
+    if (!_rasterTexture
+        || textureSize.width < rect.size.width
+        || textureSize.height < rect.size.height) {
+        [self releaseRasterTexture];
+        
+        _rasterTexture = SAFE_ARC_RETAIN([[CCControlRasterCache sharedRasterCache] renderTextureWithSize:rect.size]);
+    }
+    
+    // The render texture expects the matrix of the scene: undo the parents
+    kmGLPushMatrix();
+    
+    CCNode *parent = [self parent];
+    
+    if (parent) {
+        CGAffineTransform worldToParent = [parent worldToNodeTransform];
+        kmMat4 matrix;
+        CGAffineToGL(&worldToParent, matrix.mat);
+        kmGLMultMatrix(&matrix);
     }
     
-    // If the selector accept the CCControlEvent as fourth argument
-    if ([sig numberOfArguments] >= 4) {
-        [invocation setArgument:&controlEvent atIndex:3];
+    ccControlRasterizationDepth++;
+    
+    [_rasterTexture beginWithClear:0 g:0 b:0 a:0];
+    kmGLTranslatef(-rect.origin.x, -rect.origin.y, 0);
+    [self drawWithChildren];
+    [_rasterTexture end];
+    
+    ccControlRasterizationDepth--;
+    
+    kmGLPopMatrix();
+    
+    // The render texture is upside down, its sprite is flipped
+    CCSprite *sprite = _rasterTexture.sprite;
+    [sprite setTextureRect:CGRectMake(0, 0, rect.size.width, rect.size.height)];
+    sprite.position  = ccp(CGRectGetMidX(rect), CGRectGetMidY(rect));
+    
+    _rasterState       = _state;
+    _rasterColor       = _color;
+    _rasterOpacity     = _opacity;
+    _rasterContentSize = contentSize;
+    _rasterValid       = YES;
+}
+
+- (void)drawWithChildren
+{
+    CCArray *children = [self children];
+    
+    if (children) {
+        [self sortAllChildren];
+        
+        ccArray *arrayData = children->data;
+        NSUInteger i       = 0;
+        
+        // Draw the children with a negative z order first
+        for ( ; i < arrayData->num; i++) {
+            CCNode *child = arrayData->arr[i];
+            
+            if ([child zOrder] < 0) {
+                [child visit];
+            }
+            else {
+                break;
+            }
+        }
+        
+        [self draw];
+        
+        for ( ; i < arrayData->num; i++) {
+            [arrayData->arr[i] visit];
+        }
+    }
+    else {
+        [self draw];
+    }
+}
+
+- (void)releaseRasterTexture
+{
+    if (_rasterTexture) {
+        [[CCControlRasterCache sharedRasterCache] recycleRenderTexture:_rasterTexture];
+        
+        SAFE_ARC_RELEASE(_rasterTexture);
+        _rasterTexture = nil;
     }
     
-    return invocation;
+    _rasterValid = NO;
+}
+
+- (void)sendCoalescedValueChangedEvent:(ccTime)delta
+{
+    [self flushValueChangedEvents];
+}
+
+- (void)setNeedsHitTestUpdate
+{
+    if (_hitTestManaged) {
+        [[CCControlHitTestManager sharedHitTestManager] setNeedsUpdate];
+    }
 }
 
-- (NSMutableArray *)dispatchListforControlEvent:(CCControlEvent)controlEvent
+- (void)updateTransformCacheIfNeeded
 {
-    // Get the key for the given control event
-    NSNumber *controlEventKey = [NSNumber numberWithUnsignedInteger:controlEvent];
+    // No node has moved, been hidden or reparented since the last time
+    if (_transformCacheGeneration == ccControlTransformGeneration) {
+        return;
+    }
     
-    // Get the invocation list for the  dispatch table
-    NSMutableArray *invocationList = [_dispatchTable objectForKey:controlEventKey];
+    // The transforms of the nodes are already cached by CCNode until they change
+    CGAffineTransform parentToWorld = CGAffineTransformIdentity;
+    
+    for (CCNode *node = [self parent]; node != nil; node = [node parent]) {
+        parentToWorld = CGAffineTransformConcat(parentToWorld, [node nodeToParentTransform]);
+    }
     
-    // If the invocation list does not exist for the  dispatch table, we create it
-    if (invocationList == nil) {
-        invocationList = [NSMutableArray arrayWithCapacity:1];
+    _worldToParentTransform   = CGAffineTransformInvert(parentToWorld);
+    _transformCacheGeneration = ccControlTransformGeneration;
+}
+
+- (void)compactDispatchTable
+{
+    for (int i = 0; i < kControlEventTotalNumber; i++) {
+        ccControlTargetActionListCompact(&_dispatchTable[i]);
         
-        [_dispatchTable setObject:invocationList forKey:controlEventKey];
+        if (_subscriptionTable[i].holes > 0) {
+            ccControlSubscriptionListCompact(&_subscriptionTable[i], i);
+        }
     }
     
-    return invocationList;
+    _dispatchNeedsCompaction = NO;
 }
 
 
@@ -497,12 +1448,71 @@
 
 - (void)setBlock:(CCControlBlock)block forControlEvents:(CCControlEvent)controlEvents
 {
-    // For each control events
-    for (int i = 0; i < kControlEventTotalNumber; i++) {
-        // If the given controlEvents bitmask contains the curent event
-        if ((controlEvents & (1 << i))) {
-            [self setBlock:block forControlEvent:(1 << i)];
+    controlEvents &= kControlEventAllMask;
+    
+    // For each control events contained into the given bitmask
+    while (controlEvents) {
+        [self setBlock:block forControlEvent:(1 << __builtin_ctzl(controlEvents))];
+        
+        controlEvents &= controlEvents - 1;
+    }
+}
+
+- (CCControlSubscription *)addBlock:(CCControlBlock)block forControlEvents:(CCControlEvent)controlEvents
+{
+    NSAssert(block, @"The block cannot be nil");
+    
+    controlEvents &= kControlEventAllMask;
+    
+    NSAssert(controlEvents, @"The control events must contain at least one event");
+    
+    // No list would own the subscription, nor give its retain back
+    if (controlEvents == 0) {
+        return nil;
+    }
+    
+    CCControlSubscription *subscription = [[CCControlSubscription alloc] initWithControl:self block:block controlEvents:controlEvents];
+    
+    // For each control events contained into the given bitmask
+    while (controlEvents) {
+        NSUInteger index = __builtin_ctzl(controlEvents);
+        
+        subscription->_slots[index] = ccControlSubscriptionListAppend(&_subscriptionTable[index], subscription);
+        
+        controlEvents &= controlEvents - 1;
+    }
+    
+    // The control owns the subscription until it is removed
+    CFRetain((__bridge CFTypeRef)subscription);
+    
+    return SAFE_ARC_AUTORELEASE(subscription);
+}
+
+- (void)removeSubscription:(CCControlSubscription *)subscription
+{
+    if (subscription == nil || subscription->_control != self) {
+        return;
+    }
+    
+    CCControlEvent controlEvents = subscription->_controlEvents;
+    
+    [self detachSubscription:subscription];
+    
+    // Reclaim the holes once they represent half of a list
+    if (_dispatchDepth > 0) {
+        _dispatchNeedsCompaction = YES;
+        return;
+    }
+    
+    while (controlEvents) {
+        NSUInteger index                = __builtin_ctzl(controlEvents);
+        CCControlSubscriptionList *list = &_subscriptionTable[index];
+        
+        if (list->holes * 2 > list->count) {
+            ccControlSubscriptionListCompact(list, index);
         }
+        
+        controlEvents &= controlEvents - 1;
     }
 }
 
@@ -510,18 +1520,65 @@
 
 - (void)setBlock:(CCControlBlock)block forControlEvent:(CCControlEvent)controlEvent
 {    
-    // Get the key for the given control event
-    NSNumber *controlEventKey = [NSNumber numberWithUnsignedInteger:controlEvent];
+    NSUInteger index            = __builtin_ctzl(controlEvent);
+    CCControlBlock previousBlock = _dispatchBlockTable[index];
+    
+    // Think to copy and release the block
+    _dispatchBlockTable[index] = block ? SAFE_ARC_BLOCK_COPY(block) : nil;
+    SAFE_ARC_BLOCK_RELEASE(previousBlock);
+}
+
+- (void)detachSubscription:(CCControlSubscription *)subscription
+{
+    CCControlEvent controlEvents = subscription->_controlEvents;
     
-    if (block) {
-        // Think to copy and release the block
-        CCControlBlock currentBlock = SAFE_ARC_BLOCK_COPY(block);
-        [_dispatchBlockTable setObject:currentBlock forKey:controlEventKey];
-        SAFE_ARC_BLOCK_RELEASE(currentBlock);
+    while (controlEvents) {
+        NSUInteger index                = __builtin_ctzl(controlEvents);
+        CCControlSubscriptionList *list = &_subscriptionTable[index];
+        
+        list->subscriptions[subscription->_slots[index]] = nil;
+        list->holes++;
+        
+        controlEvents &= controlEvents - 1;
     }
-    else {
-        [_dispatchBlockTable removeObjectForKey:controlEventKey];
+    
+    subscription->_control = nil;
+    
+    CFRelease((__bridge CFTypeRef)subscription);
+}
+
+@end
+
+#pragma mark - CCControlSubscription
+
+@implementation CCControlSubscription
+@synthesize controlEvents = _controlEvents;
+
+- (void)dealloc
+{
+    SAFE_ARC_BLOCK_RELEASE(_block);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+- (id)initWithControl:(CCControl *)control block:(CCControlBlock)block controlEvents:(CCControlEvent)controlEvents
+{
+    if ((self = [super init])) {
+        _control       = control;
+        _block         = SAFE_ARC_BLOCK_COPY(block);
+        _controlEvents = controlEvents;
     }
+    return self;
+}
+
+- (BOOL)isActive
+{
+    return (_control != nil);
+}
+
+- (void)cancel
+{
+    [_control removeSubscription:self];
 }
 
 @end
@@ -57,11 +57,25 @@
     
 @protected
     BOOL _pushed;
+    BOOL _loadsStatesLazily;
+    BOOL _autorepeat;
+    
+    // State tables indexed by the bit position of the control states
+    NSString                                *_titles[kControlStateTotalNumber];
+    ccColor3B                               _titleColors[kControlStateTotalNumber];
+    NSUInteger                              _titleColorStates;
+    CCNode<CCLabelProtocol, CCRGBAProtocol> *_titleLabels[kControlStateTotalNumber];
+    CCScale9Sprite                          *_backgroundSprites[kControlStateTotalNumber];
+    
+    // Nodes waiting for their state to be displayed, in lazy mode
+    CCSpriteFrame                           *_pendingBackgroundSpriteFrames[kControlStateTotalNumber];
+    NSString                                *_pendingTitleFonts[kControlStateTotalNumber];
+    NSUInteger                              _pendingTitleBMFontStates;
+    
+    // Aspects of the layout to recompute and label size of the last layout
+    NSUInteger                              _layoutDirtyFlags;
+    CGSize                                  _layoutTitleLabelSize;
     
-    NSMutableDictionary *_titleDispatchTable;
-    NSMutableDictionary *_titleColorDispatchTable;
-    NSMutableDictionary *_titleLabelDispatchTable;
-    NSMutableDictionary *_backgroundSpriteDispatchTable;
     CGPoint            _labelAnchorPoint;
 }
 /** Adjust the background image. YES by default. If the property is set to NO, the 
@@ -84,6 +98,24 @@
 /** The margins. By default the values of marginLR and marginTB are,
  respectively, equals to CCControlButtonMarginLR and CCControlButtonMarginTB. */
 @property (nonatomic, assign) float marginLR, marginTB;
+/**
+ * Tells whether the per-state nodes are loaded lazily. NO by default.
+ *
+ * When enabled, the title labels and background sprites of the states other
+ * than the current one are not added to the button until the button enters
+ * their state for the first time. The nodes described by a sprite frame
+ * (setBackgroundSpriteFrame:forState:) or by a font (setTitleBMFont:forState:
+ * and setTitleTTF:forState:) are not even created until then.
+ */
+@property (nonatomic, getter = doesLoadStatesLazily) BOOL loadsStatesLazily;
+/**
+ * Tells whether the button repeats its CCControlEventTouchDown event while
+ * it is held down. NO by default.
+ *
+ * The repeats are driven by the shared CCControlAutorepeat service, with the
+ * same timing as the steppers.
+ */
+@property (nonatomic) BOOL autorepeat;
 
 #pragma mark Constructors - Initializers
 /** @name Creating Buttons */
@@ -27,6 +27,8 @@
 #import "CCControlButton.h"
 
 #import "CCScale9Sprite.h"
+#import "CCControlInstrumentation.h"
+#import "CCControlAutorepeat.h"
 #import "ARCMacro.h"
 
 enum
@@ -34,17 +36,73 @@ enum
 	kZoomActionTag = 0xCCCB0001,
 };
 
+/** Aspects of the layout which have to be recomputed by updateLayout. */
+enum
+{
+    kCCControlButtonLayoutTitle      = 1 << 0,
+    kCCControlButtonLayoutTitleColor = 1 << 1,
+    kCCControlButtonLayoutSize       = 1 << 2,
+    kCCControlButtonLayoutAll        = kCCControlButtonLayoutTitle
+                                     | kCCControlButtonLayoutTitleColor
+                                     | kCCControlButtonLayoutSize,
+};
+
+/** Index of the normal state into the state tables. */
+#define kControlStateNormalIndex 0
+
+/** Returns YES whether the given state is one of the CCControlState values. */
+static inline BOOL ccControlButtonIsValidState(NSInteger state)
+{
+    return state > 0 && (state & (state - 1)) == 0 && state < (1 << kControlStateTotalNumber);
+}
+
+/**
+ * Returns the index of the given state into the state tables. An invalid
+ * state falls back to the normal one so that it never reads out of the
+ * tables.
+ */
+static inline NSUInteger ccControlButtonStateIndex(CCControlState state)
+{
+    NSCAssert(ccControlButtonIsValidState(state), @"The state must be one of the CCControlState values.");
+    
+    if (!ccControlButtonIsValidState(state)) {
+        return kControlStateNormalIndex;
+    }
+    
+    return __builtin_ctzl(state);
+}
+
 @interface CCControlButton ()
 /** Flag to know if the button is currently pushed.  */
 @property (nonatomic, getter = isPushed) BOOL pushed;
-/** Table of correspondence between the state and its title. */
-@property (nonatomic, strong) NSMutableDictionary *titleDispatchTable;
-/** Table of correspondence between the state and its title color. */
-@property (nonatomic, strong) NSMutableDictionary *titleColorDispatchTable;
-/** Table of correspondence between the state and its title label. */
-@property (nonatomic, strong) NSMutableDictionary *titleLabelDispatchTable;
-/** Table of correspondence between the state and the background sprite. */
-@property (nonatomic, strong) NSMutableDictionary *backgroundSpriteDispatchTable;
+
+/**
+ * Replaces the title label of a state. The label is added to the button
+ * unless the states are loaded lazily and it is not the current state.
+ */
+- (void)storeTitleLabel:(CCNode<CCLabelProtocol,CCRGBAProtocol> *)label atIndex:(NSUInteger)index;
+
+/**
+ * Replaces the background sprite of a state. The sprite is added to the
+ * button unless the states are loaded lazily and it is not the current state.
+ */
+- (void)storeBackgroundSprite:(CCScale9Sprite *)sprite atIndex:(NSUInteger)index;
+
+/** Creates the pending nodes of the given state if any. */
+- (void)loadStateAtIndex:(NSUInteger)index;
+
+/** Adds the given node to the button if it is not already. */
+- (void)attachStateNode:(CCNode *)node z:(NSInteger)z;
+
+/**
+ * Updates the layout incrementally: the title, its color and the sizes
+ * are only recomputed when they differ from the displayed ones or when
+ * they have been flagged as dirty.
+ */
+- (void)updateLayout;
+
+/** Sends the touch down event again, called by the autorepeat. */
+- (void)repeatTouchDown;
 
 @end
 
@@ -52,10 +110,6 @@ enum
 @synthesize pushed                        = _pushed;
 @synthesize titleLabel                    = _titleLabel;
 @synthesize backgroundSprite              = _backgroundSprite;
-@synthesize titleDispatchTable            = _titleDispatchTable;
-@synthesize titleColorDispatchTable       = _titleColorDispatchTable;
-@synthesize titleLabelDispatchTable       = _titleLabelDispatchTable;
-@synthesize backgroundSpriteDispatchTable = _backgroundSpriteDispatchTable;
 @synthesize adjustBackgroundImage         = _adjustBackgroundImage;
 @synthesize currentTitle                  = _currentTitle;
 @synthesize currentTitleColor             = _currentTitleColor;
@@ -63,13 +117,20 @@ enum
 @synthesize preferredSize                 = _preferredSize;
 @synthesize marginLR                      = _marginLR;
 @synthesize marginTB                      = _marginTB;
+@synthesize loadsStatesLazily             = _loadsStatesLazily;
+@synthesize autorepeat                    = _autorepeat;
 
 - (void)dealloc
 {
-    SAFE_ARC_RELEASE(_backgroundSpriteDispatchTable);
-    SAFE_ARC_RELEASE(_titleLabelDispatchTable);
-    SAFE_ARC_RELEASE(_titleColorDispatchTable);
-    SAFE_ARC_RELEASE(_titleDispatchTable);
+    [[CCControlAutorepeat sharedAutorepeat] stopRepeatingTarget:self];
+    
+    for (int i = 0; i < kControlStateTotalNumber; i++) {
+        SAFE_ARC_RELEASE(_titles[i]);
+        SAFE_ARC_RELEASE(_titleLabels[i]);
+        SAFE_ARC_RELEASE(_backgroundSprites[i]);
+        SAFE_ARC_RELEASE(_pendingBackgroundSpriteFrames[i]);
+        SAFE_ARC_RELEASE(_pendingTitleFonts[i]);
+    }
     SAFE_ARC_RELEASE(_backgroundSprite);
     SAFE_ARC_RELEASE(_titleLabel);
     SAFE_ARC_RELEASE(_currentTitle);
@@ -108,12 +169,6 @@ enum
         self.titleLabel       = label;
         self.backgroundSprite = backgroundsprite;
         
-        // Initialize the button state tables
-        self.titleDispatchTable            = [NSMutableDictionary dictionary];
-        self.titleColorDispatchTable       = [NSMutableDictionary dictionary];
-        self.titleLabelDispatchTable       = [NSMutableDictionary dictionary];
-        self.backgroundSpriteDispatchTable = [NSMutableDictionary dictionary];
-        
         // Set the default color and opacity
         self.color            = ccc3(255.0f, 255.0f, 255.0f);
         self.opacity          = 255.0f;
@@ -178,7 +233,16 @@ enum
         [self stopAction:action];
     }
     
-    [self needsLayout];
+    [self updateLayout];
+    
+    if (_autorepeat && highlighted && _pushed) {
+        [[CCControlAutorepeat sharedAutorepeat] startRepeatingTarget:self
+                                                              action:@selector(repeatTouchDown)
+                                                              timing:kCCControlAutorepeatTimingDefault];
+    }
+    else {
+        [[CCControlAutorepeat sharedAutorepeat] stopRepeatingTarget:self];
+    }
     
     if (_zoomOnTouchDown) {
         float scaleValue     = (highlighted && [self isEnabled] && ![self isSelected]) ? 1.1f : 1.0f;
@@ -192,7 +256,8 @@ enum
 {
     _adjustBackgroundImage = adjustBackgroundImage;
     
-    [self needsLayout];
+    _layoutDirtyFlags |= kCCControlButtonLayoutSize;
+    [self updateLayout];
 }
 
 - (void)setPreferredSize:(CGSize)preferredSize
@@ -203,9 +268,8 @@ enum
     else {
         _adjustBackgroundImage = NO;
     
-        for (id key in _backgroundSpriteDispatchTable) {
-            CCScale9Sprite* sprite = [_backgroundSpriteDispatchTable objectForKey:key];
-            [sprite setPreferredSize:preferredSize];
+        for (int i = 0; i < kControlStateTotalNumber; i++) {
+            [_backgroundSprites[i] setPreferredSize:preferredSize];
         }
     }
     
@@ -219,6 +283,7 @@ enum
     _labelAnchorPoint = labelAnchorPoint;
     
     _titleLabel.anchorPoint = labelAnchorPoint;
+    _layoutDirtyFlags      |= kCCControlButtonLayoutSize;
 }
 
 - (CGPoint) labelAnchorPoint
@@ -231,103 +296,97 @@ enum
 
 - (NSString *)titleForState:(CCControlState)state
 {
-    NSNumber *stateNumber = [NSNumber numberWithLong:state];
-    
-    NSString *title = [_titleDispatchTable objectForKey:stateNumber];
+    NSString *title = _titles[ccControlButtonStateIndex(state)];
     
     if (title) {
         return title;
     }
     
-    return [_titleDispatchTable objectForKey:[NSNumber numberWithInt:CCControlStateNormal]];
+    return _titles[kControlStateNormalIndex];
 }
 
 - (void)setTitle:(NSString *)title forState:(CCControlState)state
 {
-    NSNumber *stateNumber = [NSNumber numberWithLong:state];
+    NSUInteger index = ccControlButtonStateIndex(state);
     
-    [_titleDispatchTable removeObjectForKey:stateNumber];
-    
-    if (title) {
-        [_titleDispatchTable setObject:title forKey:stateNumber];
+    if (_titles[index] != title) {
+        SAFE_ARC_RELEASE(_titles[index]);
+        _titles[index] = [title copy];
     }
     
     // If the current state if equal to the given state we update the layout
     if (_state == state) {
-        [self needsLayout];
+        [self updateLayout];
     }
 }
 
 - (ccColor3B)titleColorForState:(CCControlState)state
 {
-    NSNumber *stateNumber = [NSNumber numberWithLong:state];
+    NSUInteger index = ccControlButtonStateIndex(state);
     
-    ccColor3B returnColor;
-    NSValue *colorValue = [_titleColorDispatchTable objectForKey:stateNumber];
-    
-    if (colorValue) {
-        [colorValue getValue:&returnColor];
-        
-        return returnColor;
+    if (_titleColorStates & (1 << index)) {
+        return _titleColors[index];
     }
     
-    colorValue = [_titleColorDispatchTable objectForKey:[NSNumber numberWithInt:CCControlStateNormal]];
-    [colorValue getValue:&returnColor];
-    
-    return returnColor;
+    return _titleColors[kControlStateNormalIndex];
 }
 
 - (void)setTitleColor:(ccColor3B)color forState:(CCControlState)state
 {
-    NSNumber *stateNumber = [NSNumber numberWithLong:state];
+    NSUInteger index = ccControlButtonStateIndex(state);
     
-    NSValue *colorValue = [NSValue valueWithBytes:&color objCType:@encode(ccColor3B)];
-    
-    [_titleColorDispatchTable removeObjectForKey:stateNumber];
-    [_titleColorDispatchTable setObject:colorValue forKey:stateNumber];
+    _titleColors[index]  = color;
+    _titleColorStates   |= (1 << index);
     
     // If the current state if equal to the given state we update the layout
     if (_state == state) {
-        [self needsLayout];
+        [self updateLayout];
     }
 }
 
 - (CCNode<CCLabelProtocol,CCRGBAProtocol> *)titleLabelForState:(CCControlState)state
 {
-    NSNumber *stateNumber = [NSNumber numberWithLong:state];
+    NSUInteger index = ccControlButtonStateIndex(state);
     
-    CCNode<CCLabelProtocol,CCRGBAProtocol> *titleLabel = [_titleLabelDispatchTable objectForKey:stateNumber];
+    [self loadStateAtIndex:index];
     
-    if (titleLabel) {
-        return titleLabel;
+    if (_titleLabels[index]) {
+        return _titleLabels[index];
     }
     
-    return [_titleLabelDispatchTable objectForKey:[NSNumber numberWithInt:CCControlStateNormal]];
+    return _titleLabels[kControlStateNormalIndex];
 }
 
 - (void)setTitleLabel:(CCNode<CCLabelProtocol,CCRGBAProtocol> *)label forState:(CCControlState)state
 {
-    NSNumber *stateNumber = [NSNumber numberWithLong:state];
+    NSUInteger index = ccControlButtonStateIndex(state);
     
-    CCNode<CCLabelProtocol,CCRGBAProtocol> *previousLabel = [_titleLabelDispatchTable objectForKey:stateNumber];
-    if (previousLabel) {
-        [self removeChild:previousLabel cleanup:YES];
-        [_titleLabelDispatchTable removeObjectForKey:stateNumber];
-    }
+    // The given label replaces the pending font
+    SAFE_ARC_RELEASE(_pendingTitleFonts[index]);
+    _pendingTitleFonts[index] = nil;
     
-    [_titleLabelDispatchTable setObject:label forKey:stateNumber];
-    [label setVisible:NO];
-    [label setAnchorPoint:ccp (0.5f, 0.5f)];
-    [self addChild:label z:1];
+    [self storeTitleLabel:label atIndex:index];
     
     // If the current state if equal to the given state we update the layout
     if (_state == state) {
-        [self needsLayout];
+        [self updateLayout];
     }
 }
 
 - (void)setTitleBMFont:(NSString*)fntFile forState:(CCControlState)state
 {
+    if (_loadsStatesLazily && _state != state) {
+        NSUInteger index = ccControlButtonStateIndex(state);
+        
+        // Create the label the first time the state is displayed
+        [self storeTitleLabel:nil atIndex:index];
+        SAFE_ARC_RELEASE(_pendingTitleFonts[index]);
+        _pendingTitleFonts[index]  = [fntFile copy];
+        _pendingTitleBMFontStates |= (1 << index);
+        
+        return;
+    }
+    
     NSString *title = [self titleForState:state];
     
     if (!title) {
@@ -352,6 +411,18 @@ enum
 
 - (void)setTitleTTF:(NSString *)fontName forState:(CCControlState)state
 {
+    if (_loadsStatesLazily && _state != state) {
+        NSUInteger index = ccControlButtonStateIndex(state);
+        
+        // Create the label the first time the state is displayed
+        [self storeTitleLabel:nil atIndex:index];
+        SAFE_ARC_RELEASE(_pendingTitleFonts[index]);
+        _pendingTitleFonts[index]  = [fontName copy];
+        _pendingTitleBMFontStates &= ~(1 << index);
+        
+        return;
+    }
+    
     NSString* title = [self titleForState:state];
     
     if (!title) {
@@ -400,51 +471,46 @@ enum
 
 - (CCScale9Sprite *)backgroundSpriteForState:(CCControlState)state
 {
-    NSNumber *stateNumber = [NSNumber numberWithLong:state];
+    NSUInteger index = ccControlButtonStateIndex(state);
     
-    CCScale9Sprite *backgroundSprite = [_backgroundSpriteDispatchTable objectForKey:stateNumber];
+    [self loadStateAtIndex:index];
     
-    if (backgroundSprite) {
-        return backgroundSprite;
+    if (_backgroundSprites[index]) {
+        return _backgroundSprites[index];
     }
     
-    return [_backgroundSpriteDispatchTable objectForKey:[NSNumber numberWithInt:CCControlStateNormal]];
+    return _backgroundSprites[kControlStateNormalIndex];
 }
 
 - (void)setBackgroundSprite:(CCScale9Sprite *)sprite forState:(CCControlState)state
 {
-    CGSize oldPreferredSize = _preferredSize;
-    
-    NSNumber *stateNumber = [NSNumber numberWithLong:state];
-    
-    CCScale9Sprite *previousBackgroundSprite = [_backgroundSpriteDispatchTable objectForKey:stateNumber];
-    
-    if (previousBackgroundSprite) {
-        [self removeChild:previousBackgroundSprite cleanup:YES];
-        [_backgroundSpriteDispatchTable removeObjectForKey:stateNumber];
-    }
+    NSUInteger index = ccControlButtonStateIndex(state);
     
-    [_backgroundSpriteDispatchTable setObject:sprite forKey:stateNumber];
-    [sprite setVisible:NO];
-    [self addChild:sprite];
+    // The given sprite replaces the pending sprite frame
+    SAFE_ARC_RELEASE(_pendingBackgroundSpriteFrames[index]);
+    _pendingBackgroundSpriteFrames[index] = nil;
     
-    if (_preferredSize.width != 0 || _preferredSize.height != 0) {
-        if (CGSizeEqualToSize(oldPreferredSize, _preferredSize)) {
-            // Force update of preferred size
-            [sprite setPreferredSize:CGSizeMake(oldPreferredSize.width + 1, oldPreferredSize.height + 1)];
-        }
-        
-        [sprite setPreferredSize:_preferredSize];
-    }
+    [self storeBackgroundSprite:sprite atIndex:index];
     
     // If the current state if equal to the given state we update the layout
     if (_state == state) {
-        [self needsLayout];
+        [self updateLayout];
     }
 }
 
 - (void)setBackgroundSpriteFrame:(CCSpriteFrame *)spriteFrame forState:(CCControlState)state
 {
+    if (_loadsStatesLazily && _state != state) {
+        NSUInteger index = ccControlButtonStateIndex(state);
+        
+        // Create the sprite the first time the state is displayed
+        [self storeBackgroundSprite:nil atIndex:index];
+        SAFE_ARC_RELEASE(_pendingBackgroundSpriteFrames[index]);
+        _pendingBackgroundSpriteFrames[index] = SAFE_ARC_RETAIN(spriteFrame);
+        
+        return;
+    }
+    
     CCScale9Sprite *sprite = [CCScale9Sprite spriteWithSpriteFrame:spriteFrame];
     [self setBackgroundSprite:sprite forState:state];
 }
@@ -461,67 +527,278 @@ enum
     [self needsLayout];
 }
 
+- (void)onExit
+{
+    [[CCControlAutorepeat sharedAutorepeat] stopRepeatingTarget:self];
+    
+    [super onExit];
+}
+
+- (void)prepareForReuse
+{
+    [super prepareForReuse];
+    
+    // The label and the background of the normal state are kept as backing nodes
+    for (NSUInteger i = 0; i < kControlStateTotalNumber; i++) {
+        if (i != kControlStateNormalIndex) {
+            [self storeTitleLabel:nil atIndex:i];
+            [self storeBackgroundSprite:nil atIndex:i];
+        }
+        
+        SAFE_ARC_RELEASE(_titles[i]);
+        _titles[i] = nil;
+        
+        SAFE_ARC_RELEASE(_pendingBackgroundSpriteFrames[i]);
+        _pendingBackgroundSpriteFrames[i] = nil;
+        
+        SAFE_ARC_RELEASE(_pendingTitleFonts[i]);
+        _pendingTitleFonts[i] = nil;
+    }
+    _pendingTitleBMFontStates = 0;
+    
+    // The label keeps its text until a new title is set, so that it is rendered once
+    _titleColors[kControlStateNormalIndex] = ccWHITE;
+    _titleColorStates                      = (1 << kControlStateNormalIndex);
+    
+    _pushed               = NO;
+    _autorepeat           = NO;
+    _zoomOnTouchDown      = YES;
+    _marginLR             = CCControlButtonMarginLR;
+    _marginTB             = CCControlButtonMarginTB;
+    self.labelAnchorPoint = ccp (0.5f, 0.5f);
+    self.preferredSize    = CGSizeZero;
+}
+
 #pragma mark CCButton Private Methods
 
-- (void)needsLayout
+- (void)repeatTouchDown
 {
-    // Hide the background and the label
-    _titleLabel.visible       = NO;
-    _backgroundSprite.visible = NO;
+    [self sendActionsForControlEvents:CCControlEventTouchDown];
+}
+
+- (void)storeTitleLabel:(CCNode<CCLabelProtocol,CCRGBAProtocol> *)label atIndex:(NSUInteger)index
+{
+    CCNode<CCLabelProtocol,CCRGBAProtocol> *previousLabel = _titleLabels[index];
     
-    // Update anchor points of all labels
-    self.labelAnchorPoint = _labelAnchorPoint;
+    if (label && label == previousLabel) {
+        return;
+    }
     
-    // Update the label to match with the current state
-    if (_currentTitle) {
-        SAFE_ARC_RELEASE(_currentTitle);
+    if (previousLabel) {
+        if ([previousLabel parent] == self) {
+            [self removeChild:previousLabel cleanup:YES];
+        }
+        SAFE_ARC_RELEASE(_titleLabels[index]);
+        _titleLabels[index] = nil;
+    }
+    
+    if (label) {
+        _titleLabels[index] = SAFE_ARC_RETAIN(label);
+        [label setVisible:NO];
+        [label setAnchorPoint:ccp (0.5f, 0.5f)];
+        
+        if (!_loadsStatesLazily || _state == (1 << index)) {
+            [self addChild:label z:1];
+        }
     }
+}
+
+- (void)storeBackgroundSprite:(CCScale9Sprite *)sprite atIndex:(NSUInteger)index
+{
+    CGSize oldPreferredSize = _preferredSize;
     
-    _currentTitle      = SAFE_ARC_RETAIN([self titleForState:_state]);
-    _currentTitleColor = [self titleColorForState:_state];
+    CCScale9Sprite *previousBackgroundSprite = _backgroundSprites[index];
     
-    self.titleLabel = [self titleLabelForState:_state];
+    if (sprite && sprite == previousBackgroundSprite) {
+        return;
+    }
     
-    if (_currentTitle) {
-        _titleLabel.string = _currentTitle;
+    if (previousBackgroundSprite) {
+        if ([previousBackgroundSprite parent] == self) {
+            [self removeChild:previousBackgroundSprite cleanup:YES];
+        }
+        SAFE_ARC_RELEASE(_backgroundSprites[index]);
+        _backgroundSprites[index] = nil;
     }
     
-    _titleLabel.color    = _currentTitleColor;
-    _titleLabel.position = ccp (self.contentSize.width / 2, self.contentSize.height / 2);
+    if (sprite == nil) {
+        return;
+    }
     
-    // Update the background sprite
-    self.backgroundSprite      = [self backgroundSpriteForState:_state];
-    _backgroundSprite.position = ccp (self.contentSize.width / 2, self.contentSize.height / 2);
-
-    // Get the title label size
-    CGSize titleLabelSize = [_titleLabel boundingBox].size;
+    _backgroundSprites[index] = SAFE_ARC_RETAIN(sprite);
+    [sprite setVisible:NO];
     
-    // Adjust the background image if necessary
-    if ([self doesAdjustBackgroundImage]) {
-        // Add the margins
-        [_backgroundSprite setContentSize:
-         CGSizeMake(titleLabelSize.width + _marginLR * 2, titleLabelSize.height + _marginTB * 2)];
+    if (!_loadsStatesLazily || _state == (1 << index)) {
+        [self addChild:sprite];
     }
-    else {
-        CGSize preferredSize = [_backgroundSprite preferredSize];
+    
+    if (_preferredSize.width != 0 || _preferredSize.height != 0) {
+        if (CGSizeEqualToSize(oldPreferredSize, _preferredSize)) {
+            // Force update of preferred size
+            [sprite setPreferredSize:CGSizeMake(oldPreferredSize.width + 1, oldPreferredSize.height + 1)];
+        }
+        
+        [sprite setPreferredSize:_preferredSize];
+    }
+}
 
-        if (preferredSize.width <= 0) {
-            preferredSize.width = titleLabelSize.width;
+- (void)loadStateAtIndex:(NSUInteger)index
+{
+    if (_pendingBackgroundSpriteFrames[index]) {
+        CCSpriteFrame *spriteFrame            = _pendingBackgroundSpriteFrames[index];
+        _pendingBackgroundSpriteFrames[index] = nil;
+        
+        [self storeBackgroundSprite:[CCScale9Sprite spriteWithSpriteFrame:spriteFrame] atIndex:index];
+        SAFE_ARC_RELEASE(spriteFrame);
+    }
+    
+    if (_pendingTitleFonts[index]) {
+        NSString *font             = _pendingTitleFonts[index];
+        _pendingTitleFonts[index]  = nil;
+        
+        NSString *title = _titles[index] ? _titles[index] : _titles[kControlStateNormalIndex];
+        
+        if (!title) {
+            title = @"";
         }
         
-        if (preferredSize.height <= 0) {
-            preferredSize.height = titleLabelSize.height;
+        CCNode<CCLabelProtocol,CCRGBAProtocol> *label;
+        if (_pendingTitleBMFontStates & (1 << index)) {
+            label = [CCLabelBMFont labelWithString:title fntFile:font];
         }
+        else {
+            label = [CCLabelTTF labelWithString:title fontName:font fontSize:12];
+        }
+        _pendingTitleBMFontStates &= ~(1 << index);
         
-        [_backgroundSprite setContentSize:preferredSize];
+        [self storeTitleLabel:label atIndex:index];
+        SAFE_ARC_RELEASE(font);
+    }
+}
+
+- (void)attachStateNode:(CCNode *)node z:(NSInteger)z
+{
+    if (node && [node parent] == nil) {
+        [self addChild:node z:z];
+    }
+}
+
+- (void)needsLayout
+{
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterNeedsLayout);
+    
+    // Recompute everything, the caller may have modified the nodes directly
+    _layoutDirtyFlags = kCCControlButtonLayoutAll;
+    
+    [self updateLayout];
+}
+
+- (void)updateLayout
+{
+    [self setNeedsRasterize];
+    
+    NSString *title                               = [self titleForState:_state];
+    ccColor3B titleColor                          = [self titleColorForState:_state];
+    CCNode<CCLabelProtocol,CCRGBAProtocol> *label = [self titleLabelForState:_state];
+    CCScale9Sprite *backgroundSprite              = [self backgroundSpriteForState:_state];
+    
+    NSUInteger dirtyFlags = _layoutDirtyFlags;
+    _layoutDirtyFlags     = 0;
+    
+    // Swap the label and the background if the state uses other nodes
+    if (label != _titleLabel) {
+        _titleLabel.visible = NO;
+        self.titleLabel     = label;
+        [self resolveCascadeForChild:_titleLabel];
+        
+        dirtyFlags |= kCCControlButtonLayoutAll;
+    }
+    [self attachStateNode:_titleLabel z:1];
+    
+    if (backgroundSprite != _backgroundSprite) {
+        _backgroundSprite.visible = NO;
+        self.backgroundSprite     = backgroundSprite;
+        [self resolveCascadeForChild:_backgroundSprite];
+        
+        dirtyFlags |= kCCControlButtonLayoutSize;
+    }
+    [self attachStateNode:_backgroundSprite z:0];
+    
+    if (title != _currentTitle && ![title isEqualToString:_currentTitle]) {
+        dirtyFlags |= kCCControlButtonLayoutTitle;
+    }
+    
+    if (titleColor.r != _currentTitleColor.r
+        || titleColor.g != _currentTitleColor.g
+        || titleColor.b != _currentTitleColor.b) {
+        dirtyFlags |= kCCControlButtonLayoutTitleColor;
+    }
+    
+    // Update the label to match with the current state
+    if (dirtyFlags & kCCControlButtonLayoutTitle) {
+        // Update anchor points of all labels
+        _titleLabel.anchorPoint = _labelAnchorPoint;
+        
+        if (_currentTitle != title) {
+            SAFE_ARC_RELEASE(_currentTitle);
+            _currentTitle = SAFE_ARC_RETAIN(title);
+        }
+        
+        // Setting the string renders the text again so avoid it when possible
+        if (_currentTitle && ![[_titleLabel string] isEqualToString:_currentTitle]) {
+            _titleLabel.string = _currentTitle;
+        }
     }
     
-    // Set the content size
-    CGRect maxRect   = CGRectUnion([_titleLabel boundingBox], [_backgroundSprite boundingBox]);
-    self.contentSize = CGSizeMake(maxRect.size.width, maxRect.size.height);
+    if (dirtyFlags & kCCControlButtonLayoutTitleColor) {
+        _currentTitleColor = titleColor;
+        _titleLabel.color  = _currentTitleColor;
+    }
+    
+    // Get the title label size
+    CGSize titleLabelSize = [_titleLabel boundingBox].size;
     
-    _titleLabel.position       = ccp (self.contentSize.width / 2, self.contentSize.height / 2);
-    _backgroundSprite.position = ccp (self.contentSize.width / 2, self.contentSize.height / 2);
+    if (!CGSizeEqualToSize(titleLabelSize, _layoutTitleLabelSize)) {
+        dirtyFlags |= kCCControlButtonLayoutSize;
+    }
+    
+    if (dirtyFlags & kCCControlButtonLayoutSize) {
+        _layoutTitleLabelSize = titleLabelSize;
+        
+        _titleLabel.position       = ccp (self.contentSize.width / 2, self.contentSize.height / 2);
+        _backgroundSprite.position = ccp (self.contentSize.width / 2, self.contentSize.height / 2);
+        
+        // Adjust the background image if necessary
+        if ([self doesAdjustBackgroundImage]) {
+            // Add the margins
+            [_backgroundSprite setContentSize:
+             CGSizeMake(titleLabelSize.width + _marginLR * 2, titleLabelSize.height + _marginTB * 2)];
+        }
+        else {
+            CGSize preferredSize = [_backgroundSprite preferredSize];
+            
+            if (preferredSize.width <= 0) {
+                preferredSize.width = titleLabelSize.width;
+            }
+            
+            if (preferredSize.height <= 0) {
+                preferredSize.height = titleLabelSize.height;
+            }
+            
+            [_backgroundSprite setContentSize:preferredSize];
+        }
+        
+        // Set the content size
+        CGRect maxRect   = CGRectUnion([_titleLabel boundingBox], [_backgroundSprite boundingBox]);
+        CGSize maxSize   = CGSizeMake(maxRect.size.width, maxRect.size.height);
+        
+        if (!CGSizeEqualToSize(maxSize, self.contentSize)) {
+            self.contentSize = maxSize;
+        }
+        
+        _titleLabel.position       = ccp (self.contentSize.width / 2, self.contentSize.height / 2);
+        _backgroundSprite.position = ccp (self.contentSize.width / 2, self.contentSize.height / 2);
+    }
     
     // Make visible the background and the label
     _titleLabel.visible       = YES;
@@ -696,6 +973,11 @@ enum
         NSString *keyChunk = [chunks objectAtIndex:0];
         int state          = [[chunks objectAtIndex:1] intValue];
         
+        // The state comes from a file, ignore the ones which are not valid
+        if (!ccControlButtonIsValidState(state)) {
+            return;
+        }
+        
         if ([keyChunk isEqualToString:@"title"]) {
             [self setTitle:value forState:state];
         }
@@ -733,6 +1015,10 @@ enum
         NSString *keyChunk = [chunks objectAtIndex:0];
         int state          = [[chunks objectAtIndex:1] intValue];
         
+        if (!ccControlButtonIsValidState(state)) {
+            return nil;
+        }
+        
         if ([keyChunk isEqualToString:@"title"]) {
             return [self titleForState:state];
         }
@@ -98,6 +98,23 @@ typedef enum
  */
 + (id)colourPickerWithHueFile:(NSString *)hueBackgroundFile tintBackgroundFile:(NSString *)tintBackgroundFile tintOverlayFile:(NSString *)tintOverlayFile pickerFile:(NSString *)pickerFile arrowFile:(NSString *)arrowFile;
 
+/**
+ * Initializes a colour picker with textures generated at the resolution of
+ * the screen, so no image file is needed.
+ *
+ * The textures are cached and shared by the colour pickers of the same diameter.
+ * @param diameter the diameter of the hue wheel in points (the default images are 166 points wide).
+ * @param arrow YES to add the arrow which represents the attachement direction.
+ * @see CCColourPickerTextures
+ */
+- (id)initWithDiameter:(CGFloat)diameter arrow:(BOOL)arrow;
+
+/**
+ * Creates a colour picker with generated textures.
+ * @see initWithDiameter:arrow:
+ */
++ (id)colourPickerWithDiameter:(CGFloat)diameter arrow:(BOOL)arrow;
+
 #pragma mark - Properties
 
 #pragma mark Managing the Arrow of the Colour Picker
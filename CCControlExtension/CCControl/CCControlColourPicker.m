@@ -28,6 +28,8 @@
  */
 
 #import "CCControlColourPicker.h"
+#import "CCColourPickerTextures.h"
+#import "CCControlInstrumentation.h"
 
 #import "ARCMacro.h"
 
@@ -46,6 +48,7 @@
 #pragma mark Constuctors - Initializers
 
 - (id)initWithBackgroundFile:(NSString *)backgroundFile pickerFile:(NSString *)pickerFile disableZoneLength:(double)length;
+- (id)initWithBackgroundSprite:(CCSprite *)background pickerSprite:(CCSprite *)picker disableZoneLength:(double)length;
 
 #pragma mark Public Methods
 
@@ -64,10 +67,13 @@
 @property (nonatomic, assign) CGFloat   brightness;
 @property (nonatomic, assign) CCSprite  *background;
 @property (nonatomic, assign) CCSprite  *picker;
+/** The inset of the saturation/brightness box into the background. */
+@property (nonatomic, assign) CGFloat   boxInset;
 
 #pragma mark Constuctors - Initializers
 
 - (id)initWithBackgroundFile:(NSString *)backgroundFile overlayFile:(NSString *)overlayFile pickerFile:(NSString *)pickerFile;
+- (id)initWithBackgroundSprite:(CCSprite *)background overlaySprite:(CCSprite *)overlay pickerSprite:(CCSprite *)picker boxInset:(CGFloat)boxInset;
 
 #pragma mark Public Methods
 
@@ -86,6 +92,9 @@
 @property (nonatomic, strong) CCControlSaturationBrightnessPicker   *colourPicker;
 @property (nonatomic, strong) CCControlHuePicker                    *huePicker;
 
+/** Designated initializer: setups the colour picker with its components. */
+- (id)initWithColourPicker:(CCControlSaturationBrightnessPicker *)colourPicker huePicker:(CCControlHuePicker *)huePicker arrow:(CCSprite *)arrow;
+
 - (void)updateArrow;
 - (void)updateControlPicker;
 - (void)updateHueAndControlPicker;
@@ -123,48 +132,25 @@
 
 - (id)initWithHueFile:(NSString *)hueBackgroundFile tintBackgroundFile:(NSString *)tintBackgroundFile tintOverlayFile:(NSString *)tintOverlayFile pickerFile:(NSString *)pickerFile arrowFile:(NSString *)arrowFile
 {
-    if ((self = [super init])) {
-        NSAssert(hueBackgroundFile,  @"Hue background must be not nil");
-        NSAssert(tintBackgroundFile, @"Tint background sprite must be not nil");
-        NSAssert(tintOverlayFile,    @"Tint overlay must be not nil");
-        NSAssert(pickerFile,         @"Picker must be not nil");
-        
-        // Init the arrow direction
-        _arrowDirection = CCControlColourPickerArrowDirectionRight;
-        
-        // Init default color
-        _hsv.h = 0;
-        _hsv.s = 0;
-        _hsv.v = 0;
-        
-        // Setup panels
-        _colourPicker = [[CCControlSaturationBrightnessPicker alloc] initWithBackgroundFile:tintBackgroundFile
-                                                                                overlayFile:tintOverlayFile
-                                                                                 pickerFile:pickerFile];
-        _huePicker    = [[CCControlHuePicker alloc] initWithBackgroundFile:hueBackgroundFile
-                                                                pickerFile:pickerFile
-                                                         disableZoneLength:(_colourPicker.contentSize.width / 2)];
-        
-        // Setup events
-		[_huePicker addTarget:self action:@selector(huePickerValueChanged:) forControlEvents:CCControlEventValueChanged];
-		[_colourPicker addTarget:self action:@selector(colourPickerValueChanged:) forControlEvents:CCControlEventValueChanged];
-        
-        // Set defaults
-        [self updateHueAndControlPicker];
-        
-        [self addChild:_colourPicker z:2];
-        [self addChild:_huePicker z:1];
-        
-        // Set content size
-        [self setContentSize:[_huePicker contentSize]];
-        
-        // Add the arrow
-        if (arrowFile) {
-            self.arrow = [CCSprite spriteWithFile:arrowFile];
-            [self addChild:_arrow z:0];
-        }
-	}
-	return self;
+    NSAssert(hueBackgroundFile,  @"Hue background must be not nil");
+    NSAssert(tintBackgroundFile, @"Tint background sprite must be not nil");
+    NSAssert(tintOverlayFile,    @"Tint overlay must be not nil");
+    NSAssert(pickerFile,         @"Picker must be not nil");
+    
+    CCControlSaturationBrightnessPicker *colourPicker = [[CCControlSaturationBrightnessPicker alloc] initWithBackgroundFile:tintBackgroundFile
+                                                                                                                overlayFile:tintOverlayFile
+                                                                                                                 pickerFile:pickerFile];
+    CCControlHuePicker *huePicker                     = [[CCControlHuePicker alloc] initWithBackgroundFile:hueBackgroundFile
+                                                                                                pickerFile:pickerFile
+                                                                                         disableZoneLength:(colourPicker.contentSize.width / 2)];
+    CCSprite *arrow                                   = (arrowFile) ? [CCSprite spriteWithFile:arrowFile] : nil;
+    
+    self = [self initWithColourPicker:colourPicker huePicker:huePicker arrow:arrow];
+    
+    SAFE_ARC_RELEASE(colourPicker);
+    SAFE_ARC_RELEASE(huePicker);
+    
+    return self;
 }
 
 + (id)colourPickerWithHueFile:(NSString *)hueBackgroundFile tintBackgroundFile:(NSString *)tintBackgroundFile tintOverlayFile:(NSString *)tintOverlayFile pickerFile:(NSString *)pickerFile arrowFile:(NSString *)arrowFile
@@ -172,6 +158,52 @@
     return SAFE_ARC_AUTORELEASE([[self alloc] initWithHueFile:hueBackgroundFile tintBackgroundFile:tintBackgroundFile tintOverlayFile:tintOverlayFile pickerFile:pickerFile arrowFile:arrowFile]);
 }
 
+- (id)initWithDiameter:(CGFloat)diameter arrow:(BOOL)arrow
+{
+    NSAssert(diameter > 0, @"The diameter must be positive");
+    
+    // The textures are generated at the resolution of the screen and shared
+    CGFloat tintDiameter   = roundf(diameter * kCCColourPickerTintDiameterRatio);
+    CGFloat markerDiameter = MAX(roundf(diameter * kCCColourPickerMarkerDiameterRatio), 1);
+    CGFloat arrowWidth     = MAX(roundf(diameter * kCCColourPickerArrowWidthRatio), 1);
+    
+    CCTexture2D *hueTexture     = [CCColourPickerTextures textureWithType:CCColourPickerTextureHueWheel
+                                                                     size:CGSizeMake(diameter, diameter)];
+    CCTexture2D *tintTexture    = [CCColourPickerTextures textureWithType:CCColourPickerTextureTintBackground
+                                                                     size:CGSizeMake(tintDiameter, tintDiameter)];
+    CCTexture2D *overlayTexture = [CCColourPickerTextures textureWithType:CCColourPickerTextureTintOverlay
+                                                                     size:CGSizeMake(tintDiameter, tintDiameter)];
+    CCTexture2D *markerTexture  = [CCColourPickerTextures textureWithType:CCColourPickerTextureMarker
+                                                                     size:CGSizeMake(markerDiameter, markerDiameter)];
+    
+    CCControlSaturationBrightnessPicker *colourPicker = [[CCControlSaturationBrightnessPicker alloc] initWithBackgroundSprite:[CCSprite spriteWithTexture:tintTexture]
+                                                                                                                overlaySprite:[CCSprite spriteWithTexture:overlayTexture]
+                                                                                                                 pickerSprite:[CCSprite spriteWithTexture:markerTexture]
+                                                                                                                     boxInset:(tintDiameter * kCCColourPickerTintBoxInsetRatio)];
+    CCControlHuePicker *huePicker                     = [[CCControlHuePicker alloc] initWithBackgroundSprite:[CCSprite spriteWithTexture:hueTexture]
+                                                                                                pickerSprite:[CCSprite spriteWithTexture:markerTexture]
+                                                                                           disableZoneLength:(tintDiameter / 2)];
+    CCSprite *arrowSprite                             = nil;
+    
+    if (arrow) {
+        CCTexture2D *arrowTexture = [CCColourPickerTextures textureWithType:CCColourPickerTextureArrow
+                                                                       size:CGSizeMake(arrowWidth, arrowWidth * 2)];
+        arrowSprite               = [CCSprite spriteWithTexture:arrowTexture];
+    }
+    
+    self = [self initWithColourPicker:colourPicker huePicker:huePicker arrow:arrowSprite];
+    
+    SAFE_ARC_RELEASE(colourPicker);
+    SAFE_ARC_RELEASE(huePicker);
+    
+    return self;
+}
+
++ (id)colourPickerWithDiameter:(CGFloat)diameter arrow:(BOOL)arrow
+{
+    return SAFE_ARC_AUTORELEASE([[self alloc] initWithDiameter:diameter arrow:arrow]);
+}
+
 #pragma mark Properties
 
 - (void)setColor:(ccColor3B)color
@@ -218,6 +250,45 @@
 #pragma mark CCControlColourPicker Public Methods
 #pragma mark CCControlColourPicker Private Methods
 
+- (id)initWithColourPicker:(CCControlSaturationBrightnessPicker *)colourPicker huePicker:(CCControlHuePicker *)huePicker arrow:(CCSprite *)arrow
+{
+    if ((self = [super init])) {
+        // Init the arrow direction
+        _arrowDirection = CCControlColourPickerArrowDirectionRight;
+        
+        // Init default color
+        _hsv.h = 0;
+        _hsv.s = 0;
+        _hsv.v = 0;
+        
+        // Setup panels
+        _colourPicker = SAFE_ARC_RETAIN(colourPicker);
+        _huePicker    = SAFE_ARC_RETAIN(huePicker);
+        
+        // Setup events
+		[_huePicker addTarget:self action:@selector(huePickerValueChanged:) forControlEvents:CCControlEventValueChanged];
+		[_colourPicker addTarget:self action:@selector(colourPickerValueChanged:) forControlEvents:CCControlEventValueChanged];
+        [_huePicker addTarget:self action:@selector(pickerTouchEnded:) forControlEvents:CCControlEventTouchUpInside | CCControlEventTouchUpOutside];
+        [_colourPicker addTarget:self action:@selector(pickerTouchEnded:) forControlEvents:CCControlEventTouchUpInside | CCControlEventTouchUpOutside];
+        
+        // Set defaults
+        [self updateHueAndControlPicker];
+        
+        [self addChild:_colourPicker z:2];
+        [self addChild:_huePicker z:1];
+        
+        // Set content size
+        [self setContentSize:[_huePicker contentSize]];
+        
+        // Add the arrow
+        if (arrow) {
+            self.arrow = arrow;
+            [self addChild:_arrow z:0];
+        }
+	}
+	return self;
+}
+
 - (void)updateArrow
 {
     if (!_arrow) {
@@ -294,6 +365,12 @@
     [self sendActionsForControlEvents:CCControlEventValueChanged];
 }
 
+- (void)pickerTouchEnded:(CCControl *)sender
+{
+    // Deliver the final colour without waiting for the next tick
+    [self flushValueChangedEvents];
+}
+
 #pragma mark -
 #pragma mark CCTargetedTouch Delegate Methods
 
@@ -336,12 +413,19 @@
 }
 
 - (id)initWithBackgroundFile:(NSString *)backgroundFile pickerFile:(NSString *)pickerFile disableZoneLength:(double)length
+{
+    return [self initWithBackgroundSprite:[CCSprite spriteWithFile:backgroundFile]
+                             pickerSprite:[CCSprite spriteWithFile:pickerFile]
+                        disableZoneLength:length];
+}
+
+- (id)initWithBackgroundSprite:(CCSprite *)background pickerSprite:(CCSprite *)picker disableZoneLength:(double)length
 {
     if ((self = [super init])) {
-        self.background = [CCSprite spriteWithFile:backgroundFile];
+        self.background = background;
         [self addChild:_background];
         
-        self.picker = [CCSprite spriteWithFile:pickerFile];
+        self.picker = picker;
         [self addChild:_picker];
         
         _length = length;
@@ -397,6 +481,8 @@
 
 - (void)updatePickerPosition:(CGPoint)location
 {
+    [self setNeedsRasterize];
+    
     // Work out the distance difference between the location and center
     float dx = location.x;
     float dy = location.y;
@@ -414,6 +500,8 @@
 
 - (BOOL)checkPickerPosition:(CGPoint)location
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterHitTest);
+    
     // Compute the distance between the current location and the center
     double distance  = sqrt(pow(location.x, 2) + pow(location.y, 2));
     int max_distance = self.contentSize.width / 2;
@@ -429,6 +517,14 @@
     return NO;
 }
 
+- (CGRect)hitTestRect
+{
+    // The sprites are centered on the node origin
+    CGSize size = [self contentSize];
+    
+    return CGRectMake(-size.width / 2, -size.height / 2, size.width, size.height);
+}
+
 #pragma mark CCTargetedTouch Delegate Methods
 
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
@@ -455,6 +551,16 @@
 	[self updatePickerPosition:touchLocation];
 }
 
+- (void)ccTouchEnded:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    if ([self isTouchInside:touch]) {
+        [self sendActionsForControlEvents:CCControlEventTouchUpInside];
+    }
+    else {
+        [self sendActionsForControlEvents:CCControlEventTouchUpOutside];
+    }
+}
+
 #elif __MAC_OS_X_VERSION_MAX_ALLOWED
 
 - (BOOL)ccMouseDown:(NSEvent *)event
@@ -489,7 +595,16 @@
 
 - (BOOL)ccMouseUp:(NSEvent *)event
 {
-    self.selected = NO;
+    if ([self isSelected]) {
+        self.selected = NO;
+        
+        if ([self isMouseInside:event]) {
+            [self sendActionsForControlEvents:CCControlEventTouchUpInside];
+        }
+        else {
+            [self sendActionsForControlEvents:CCControlEventTouchUpOutside];
+        }
+    }
     return NO;
 }
 
@@ -505,6 +620,7 @@
 @synthesize picker     = _picker;
 @synthesize saturation = _saturation;
 @synthesize brightness = _brightness;
+@synthesize boxInset   = _boxInset;
 
 - (void)dealloc
 {
@@ -517,16 +633,26 @@
 }
 
 - (id)initWithBackgroundFile:(NSString *)backgroundFile overlayFile:(NSString *)overlayFile pickerFile:(NSString *)pickerFile
+{
+    return [self initWithBackgroundSprite:[CCSprite spriteWithFile:backgroundFile]
+                            overlaySprite:[CCSprite spriteWithFile:overlayFile]
+                             pickerSprite:[CCSprite spriteWithFile:pickerFile]
+                                 boxInset:kCCColourPickerTintBoxInset];
+}
+
+- (id)initWithBackgroundSprite:(CCSprite *)background overlaySprite:(CCSprite *)overlay pickerSprite:(CCSprite *)picker boxInset:(CGFloat)boxInset
 {
     if ((self = [super init])) {
-        self.background = [CCSprite spriteWithFile:backgroundFile];
+        self.background = background;
         [self addChild:_background];
         
-        [self addChild:[CCSprite spriteWithFile:overlayFile] z:1];
+        [self addChild:overlay z:1];
         
-        self.picker = [CCSprite spriteWithFile:pickerFile];
+        self.picker = picker;
         [self addChild:_picker z:2];
         
+        _boxInset = boxInset;
+        
         self.contentSize = [_background contentSize];
     }
     return self;
@@ -567,8 +693,10 @@
 
 - (void)updatePickerPosition:(CGPoint)pickerPosition
 {
+    [self setNeedsRasterize];
+    
     // Clamp the position of the icon within the circle
-    static const int boxPos = 20;
+    float boxPos = _boxInset;
     
     // Work out the distance difference between the location and center
     float dx   = pickerPosition.x;
@@ -615,6 +743,8 @@
 
 - (BOOL)checkPickerPosition:(CGPoint)location
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterHitTest);
+    
     // Clamp the position of the icon within the circle
     
     // Get the center point of the bkgd image
@@ -638,6 +768,14 @@
     return NO;
 }
 
+- (CGRect)hitTestRect
+{
+    // The sprites are centered on the node origin
+    CGSize size = [self contentSize];
+    
+    return CGRectMake(-size.width / 2, -size.height / 2, size.width, size.height);
+}
+
 #pragma mark CCTargetedTouch Delegate Methods
 
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
@@ -667,6 +805,16 @@
     [self sendActionsForControlEvents:CCControlEventValueChanged];
 }
 
+- (void)ccTouchEnded:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    if ([self isTouchInside:touch]) {
+        [self sendActionsForControlEvents:CCControlEventTouchUpInside];
+    }
+    else {
+        [self sendActionsForControlEvents:CCControlEventTouchUpOutside];
+    }
+}
+
 #elif __MAC_OS_X_VERSION_MAX_ALLOWED
 
 - (BOOL)ccMouseDown:(NSEvent *)event
@@ -704,7 +852,16 @@
 
 - (BOOL)ccMouseUp:(NSEvent *)event
 {
-    self.selected = NO;
+    if ([self isSelected]) {
+        self.selected = NO;
+        
+        if ([self isMouseInside:event]) {
+            [self sendActionsForControlEvents:CCControlEventTouchUpInside];
+        }
+        else {
+            [self sendActionsForControlEvents:CCControlEventTouchUpOutside];
+        }
+    }
     return NO;
 }
 
@@ -0,0 +1,117 @@
+/*
+ * CCControlLayout.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+#import "CCControlLayoutFormat.h"
+
+@class CCControl;
+
+/**
+ * CCControlLayout builds CCControl hierarchies from the binary layout files
+ * described by CCControlLayoutFormat.h.
+ *
+ * The layout files are produced from a text description by the
+ * cccontrollayout command-line converter. The file is mapped in memory and
+ * its records are read in place: the controls are built by assigning their
+ * state tables directly, without going through the KVC keys (title|1,
+ * titleColor|1...) nor parsing any string, and each control is laid out
+ * once.
+ *
+ * The strings of the layout are converted once and shared by all the
+ * controls built by the same layout.
+ */
+@interface CCControlLayout : NSObject
+{
+@protected
+    NSData                      *_data;
+    const ccControlLayoutHeader *_header;
+    const ccControlLayoutRecord *_records;
+    const char                  *_strings;
+    CFMutableDictionaryRef      _stringCache;
+}
+
+#pragma mark Contructors - Initializers
+/** @name Creating Layouts */
+
+/**
+ * Initializes a layout with the content of a layout file. The file is
+ * mapped in memory when possible.
+ *
+ * @param file The path of the file relative to the resources.
+ * @return nil if the file cannot be read or is not a valid layout.
+ */
+- (id)initWithFile:(NSString *)file;
+
+/**
+ * Creates a layout with the content of a layout file.
+ *
+ * @see initWithFile:
+ */
++ (id)layoutWithFile:(NSString *)file;
+
+/**
+ * Initializes a layout with the given data. The data is retained and read
+ * in place.
+ *
+ * @param data The content of a layout file.
+ * @return nil if the data is not a valid layout.
+ */
+- (id)initWithData:(NSData *)data;
+
+/**
+ * Creates a layout with the given data.
+ *
+ * @see initWithData:
+ */
++ (id)layoutWithData:(NSData *)data;
+
+#pragma mark - Properties
+/** @name Accessing the Controls */
+
+/** The number of controls described by the layout. */
+@property (nonatomic, readonly) NSUInteger numberOfControls;
+
+#pragma mark - Public Methods
+
+/**
+ * Builds the control described at the given index, without its children.
+ *
+ * @param index The index of the control into the layout.
+ * @return An autoreleased control.
+ */
+- (CCControl *)buildControlAtIndex:(NSUInteger)index;
+
+/**
+ * Builds all the controls of the layout and returns them in a new node.
+ * The controls without parent are added to the returned node, the others
+ * to their parent control.
+ *
+ * @return An autoreleased node containing the controls.
+ */
+- (CCNode *)buildNode;
+
+@end
@@ -0,0 +1,480 @@
+/*
+ * CCControlLayout.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlLayout.h"
+#import "CCControlButton.h"
+#import "CCControlPicker.h"
+#import "CCControlSlider.h"
+#import "CCControlStepper.h"
+#import "CCControlSwitch.h"
+#import "CCScale9Sprite.h"
+#import "ARCMacro.h"
+
+/** Default font of the button titles, as used by CCControlButton. */
+#define kCCControlLayoutButtonFontName      @"Helvetica"
+#define kCCControlLayoutButtonFontSize      12
+/** Default font of the switch titles, as used by CCControlSwitch. */
+#define kCCControlLayoutSwitchFontName      @"Arial-BoldMT"
+#define kCCControlLayoutSwitchFontSize      16
+
+/** Returns the cap insets of the given sprite reference. */
+static inline CGRect ccControlLayoutCapInsets(const ccControlLayoutSprite *sprite)
+{
+    return CGRectMake(sprite->capInsets[0], sprite->capInsets[1], sprite->capInsets[2], sprite->capInsets[3]);
+}
+
+/** Returns the colour stored in the given bytes. */
+static inline ccColor3B ccControlLayoutColor(const uint8_t *color)
+{
+    return ccc3(color[0], color[1], color[2]);
+}
+
+@interface CCControlLayout ()
+
+/** Returns the string at the given offset of the string table, or nil for 0. */
+- (NSString *)stringAtOffset:(uint32_t)offset;
+
+/** Returns a sprite for the given reference, or nil if it is empty. */
+- (CCSprite *)spriteWithReference:(const ccControlLayoutSprite *)reference;
+
+/** Returns a 9-slice sprite for the given reference, or nil if it is empty. */
+- (CCScale9Sprite *)scale9SpriteWithReference:(const ccControlLayoutSprite *)reference;
+
+/** Returns the sprite frame of the given reference, or nil if it is empty. */
+- (CCSpriteFrame *)spriteFrameWithReference:(const ccControlLayoutSprite *)reference;
+
+/**
+ * Returns a label displaying the given title with the font of the given
+ * state, or with the given default font if the state has none.
+ */
+- (CCNode<CCLabelProtocol, CCRGBAProtocol> *)labelWithState:(const ccControlLayoutState *)state
+                                                      title:(NSString *)title
+                                            defaultFontName:(NSString *)fontName
+                                            defaultFontSize:(float)fontSize;
+
+@end
+
+/** The state table helpers of CCControlButton used by the loader. */
+@interface CCControlButton (CCControlLayoutPrivate)
+
+- (void)storeTitleLabel:(CCNode<CCLabelProtocol,CCRGBAProtocol> *)label atIndex:(NSUInteger)index;
+- (void)storeBackgroundSprite:(CCScale9Sprite *)sprite atIndex:(NSUInteger)index;
+
+@end
+
+@interface CCControlButton (CCControlLayout)
+
+/**
+ * Initializes a button with a layout record. The state tables are filled
+ * directly and the button is laid out once.
+ */
+- (id)initWithLayoutRecord:(const ccControlLayoutRecord *)record layout:(CCControlLayout *)layout;
+
+@end
+
+@implementation CCControlButton (CCControlLayout)
+
+- (id)initWithLayoutRecord:(const ccControlLayoutRecord *)record layout:(CCControlLayout *)layout
+{
+    const ccControlLayoutState *normalState         = &record->states[0];
+    NSString *normalTitle                           = [layout stringAtOffset:normalState->title];
+    CCNode<CCLabelProtocol, CCRGBAProtocol> *label  = [layout labelWithState:normalState
+                                                                        title:(normalTitle ? normalTitle : @"")
+                                                              defaultFontName:kCCControlLayoutButtonFontName
+                                                              defaultFontSize:kCCControlLayoutButtonFontSize];
+    CCScale9Sprite *backgroundSprite                = [layout scale9SpriteWithReference:&normalState->background];
+    
+    if (!backgroundSprite) {
+        backgroundSprite = [CCScale9Sprite node];
+    }
+    
+    if ((self = [self initWithLabel:label backgroundSprite:backgroundSprite])) {
+        _loadsStatesLazily      = (record->flags & kCCControlLayoutFlagLoadsStatesLazily) != 0;
+        _zoomOnTouchDown        = (record->flags & kCCControlLayoutFlagZoomOnTouchDown) != 0;
+        _adjustBackgroundImage  = (record->flags & kCCControlLayoutFlagAdjustBackground) != 0;
+        _marginLR               = record->margins[0];
+        _marginTB               = record->margins[1];
+        _labelAnchorPoint       = ccp(record->labelAnchorPoint[0], record->labelAnchorPoint[1]);
+        _titleLabel.anchorPoint = _labelAnchorPoint;
+        
+        for (NSUInteger i = 0; i < kCCControlLayoutStates; i++) {
+            const ccControlLayoutState *state = &record->states[i];
+            
+            if (state->flags & kCCControlLayoutStateTitleColor) {
+                _titleColors[i]    = ccControlLayoutColor(state->titleColor);
+                _titleColorStates |= (1 << i);
+            }
+            
+            // The normal title and nodes are set by the initializer
+            if (i == 0) {
+                continue;
+            }
+            
+            NSString *title = [layout stringAtOffset:state->title];
+            
+            if (title) {
+                SAFE_ARC_RELEASE(_titles[i]);
+                _titles[i] = [title copy];
+            }
+            
+            if (state->font) {
+                BOOL isBMFont = (state->flags & kCCControlLayoutStateBMFont) != 0;
+                
+                // The pending TTF labels are created with the default size
+                if (_loadsStatesLazily && (isBMFont || state->fontSize <= 0)) {
+                    SAFE_ARC_RELEASE(_pendingTitleFonts[i]);
+                    _pendingTitleFonts[i]      = [[layout stringAtOffset:state->font] copy];
+                    
+                    if (isBMFont) {
+                        _pendingTitleBMFontStates |= (1 << i);
+                    }
+                }
+                else {
+                    [self storeTitleLabel:[layout labelWithState:state
+                                                           title:(_titles[i] ? _titles[i] : normalTitle)
+                                                 defaultFontName:kCCControlLayoutButtonFontName
+                                                 defaultFontSize:kCCControlLayoutButtonFontSize]
+                                  atIndex:i];
+                }
+            }
+            
+            if (state->background.name) {
+                // The pending sprite frames are displayed without cap insets
+                if (_loadsStatesLazily && CGRectEqualToRect(ccControlLayoutCapInsets(&state->background), CGRectZero)) {
+                    SAFE_ARC_RELEASE(_pendingBackgroundSpriteFrames[i]);
+                    _pendingBackgroundSpriteFrames[i] = SAFE_ARC_RETAIN([layout spriteFrameWithReference:&state->background]);
+                }
+                else {
+                    [self storeBackgroundSprite:[layout scale9SpriteWithReference:&state->background] atIndex:i];
+                }
+            }
+        }
+        
+        if (record->preferredSize[0] != 0 || record->preferredSize[1] != 0) {
+            // Resizes all the backgrounds and lays out the button
+            self.preferredSize = CGSizeMake(record->preferredSize[0], record->preferredSize[1]);
+        }
+        else {
+            [self needsLayout];
+        }
+    }
+    return self;
+}
+
+@end
+
+@implementation CCControlLayout
+
+- (void)dealloc
+{
+    if (_stringCache) {
+        CFRelease(_stringCache);
+    }
+    SAFE_ARC_RELEASE(_data);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+#pragma mark Contructors - Initializers
+
+- (id)initWithFile:(NSString *)file
+{
+    NSString *path = [[CCFileUtils sharedFileUtils] fullPathFromRelativePath:file];
+    NSData *data   = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:NULL];
+    
+    NSAssert1(data, @"CCControlLayout. Unable to read the file: %@", file);
+    
+    return [self initWithData:data];
+}
+
++ (id)layoutWithFile:(NSString *)file
+{
+    return SAFE_ARC_AUTORELEASE([[self alloc] initWithFile:file]);
+}
+
+- (id)initWithData:(NSData *)data
+{
+    if ((self = [super init])) {
+        const char *error = ccControlLayoutValidate([data bytes], [data length]);
+        
+        NSAssert1(error == NULL, @"CCControlLayout. Invalid layout: %s", error);
+        
+        if (error) {
+            SAFE_ARC_RELEASE(self);
+            return nil;
+        }
+        
+        _data        = SAFE_ARC_RETAIN(data);
+        _header      = (const ccControlLayoutHeader *)[_data bytes];
+        _records     = (const ccControlLayoutRecord *)((const char *)_header + _header->recordsOffset);
+        _strings     = (const char *)_header + _header->stringsOffset;
+        _stringCache = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+    }
+    return self;
+}
+
++ (id)layoutWithData:(NSData *)data
+{
+    return SAFE_ARC_AUTORELEASE([[self alloc] initWithData:data]);
+}
+
+#pragma mark - Properties
+
+- (NSUInteger)numberOfControls
+{
+    return _header->recordCount;
+}
+
+#pragma mark - CCControlLayout Public Methods
+
+- (CCControl *)buildControlAtIndex:(NSUInteger)index
+{
+    NSAssert(index < _header->recordCount, @"The index is out of the layout.");
+    
+    const ccControlLayoutRecord *record = &_records[index];
+    CCControl *control                  = nil;
+    
+    switch (record->type)
+    {
+        case kCCControlLayoutTypeButton:
+        {
+            control = [[CCControlButton alloc] initWithLayoutRecord:record layout:self];
+            break;
+        }
+        case kCCControlLayoutTypeSlider:
+        {
+            CCControlSlider *slider = [[CCControlSlider alloc] initWithBackgroundSprite:[self spriteWithReference:&record->sprites[0]]
+                                                                        progressSprite:[self spriteWithReference:&record->sprites[1]]
+                                                                           thumbSprite:[self spriteWithReference:&record->sprites[2]]];
+            slider.minimumValue     = record->minimumValue;
+            slider.maximumValue     = record->maximumValue;
+            slider.value            = record->value;
+            
+            control = slider;
+            break;
+        }
+        case kCCControlLayoutTypeSwitch:
+        {
+            NSString *onTitle   = [self stringAtOffset:record->states[0].title];
+            NSString *offTitle  = [self stringAtOffset:record->states[3].title];
+            
+            CCNode<CCLabelProtocol, CCRGBAProtocol> *onLabel    = nil;
+            CCNode<CCLabelProtocol, CCRGBAProtocol> *offLabel   = nil;
+            
+            if (onTitle) {
+                onLabel = [self labelWithState:&record->states[0]
+                                         title:onTitle
+                               defaultFontName:kCCControlLayoutSwitchFontName
+                               defaultFontSize:kCCControlLayoutSwitchFontSize];
+            }
+            if (offTitle) {
+                offLabel = [self labelWithState:&record->states[3]
+                                          title:offTitle
+                                defaultFontName:kCCControlLayoutSwitchFontName
+                                defaultFontSize:kCCControlLayoutSwitchFontSize];
+            }
+            
+            CCControlSwitch *switchControl = [[CCControlSwitch alloc] initWithMaskSprite:[self spriteWithReference:&record->sprites[0]]
+                                                                                onSprite:[self spriteWithReference:&record->sprites[1]]
+                                                                               offSprite:[self spriteWithReference:&record->sprites[2]]
+                                                                             thumbSprite:[self spriteWithReference:&record->sprites[3]]
+                                                                                 onLabel:onLabel
+                                                                                offLabel:offLabel];
+            [switchControl setOn:(record->flags & kCCControlLayoutFlagOn) != 0 animated:NO];
+            
+            control = switchControl;
+            break;
+        }
+        case kCCControlLayoutTypeStepper:
+        {
+            CCControlStepper *stepper = [[CCControlStepper alloc] initWithMinusSprite:[self spriteWithReference:&record->sprites[0]]
+                                                                           plusSprite:[self spriteWithReference:&record->sprites[1]]];
+            
+            // The bounds must stay ordered while they are set
+            if (record->minimumValue < stepper.maximumValue) {
+                stepper.minimumValue = record->minimumValue;
+                stepper.maximumValue = record->maximumValue;
+            }
+            else {
+                stepper.maximumValue = record->maximumValue;
+                stepper.minimumValue = record->minimumValue;
+            }
+            stepper.stepValue       = record->stepValue;
+            stepper.continuous      = (record->flags & kCCControlLayoutFlagContinuous) != 0;
+            stepper.autorepeat      = (record->flags & kCCControlLayoutFlagAutorepeat) != 0;
+            stepper.wraps           = (record->flags & kCCControlLayoutFlagWraps) != 0;
+            stepper.value           = record->value;
+            
+            control = stepper;
+            break;
+        }
+        case kCCControlLayoutTypePicker:
+        {
+            CCControlPicker *picker = [[CCControlPicker alloc] initWithForegroundSprite:[self spriteWithReference:&record->sprites[0]]
+                                                                        selectionSprite:[self spriteWithReference:&record->sprites[1]]];
+            picker.looping          = (record->flags & kCCControlLayoutFlagLooping) != 0;
+            picker.swipeOrientation = (record->flags & kCCControlLayoutFlagSwipeHorizontally)
+                                    ? CCControlPickerOrientationHorizontal : CCControlPickerOrientationVertical;
+            
+            control = picker;
+            break;
+        }
+        default:
+            NSAssert(NO, @"Unknown control type.");
+            return nil;
+    }
+    
+    control.position = ccp(record->position[0], record->position[1]);
+    control.tag      = record->tag;
+    control.color    = ccControlLayoutColor(record->color);
+    control.opacity  = record->opacity;
+    
+    if (record->flags & kCCControlLayoutFlagAnchorPoint) {
+        control.anchorPoint = ccp(record->anchorPoint[0], record->anchorPoint[1]);
+    }
+    if (record->flags & kCCControlLayoutFlagDisabled) {
+        control.enabled = NO;
+    }
+    if (record->flags & kCCControlLayoutFlagSelected) {
+        control.selected = YES;
+    }
+    
+    return SAFE_ARC_AUTORELEASE(control);
+}
+
+- (CCNode *)buildNode
+{
+    CCNode *node            = [CCNode node];
+    NSUInteger count        = _header->recordCount;
+    NSMutableArray *controls = [NSMutableArray arrayWithCapacity:count];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        const ccControlLayoutRecord *record = &_records[i];
+        CCControl *control                  = [self buildControlAtIndex:i];
+        
+        // The parents precede their children in the layout
+        CCNode *parent = (record->parent == kCCControlLayoutNoParent) ? node : [controls objectAtIndex:record->parent];
+        [parent addChild:control z:record->z];
+        
+        [controls addObject:control];
+    }
+    
+    return node;
+}
+
+#pragma mark - CCControlLayout Private Methods
+
+- (NSString *)stringAtOffset:(uint32_t)offset
+{
+    if (offset == 0) {
+        return nil;
+    }
+    
+    const void *key  = (const void *)(uintptr_t)offset;
+    NSString *string = (__bridge NSString *)CFDictionaryGetValue(_stringCache, key);
+    
+    if (!string) {
+        string = [[NSString alloc] initWithUTF8String:_strings + offset];
+        
+        if (string) {
+            CFDictionarySetValue(_stringCache, key, (__bridge const void *)string);
+        }
+        SAFE_ARC_RELEASE(string);
+    }
+    
+    return string;
+}
+
+- (CCSprite *)spriteWithReference:(const ccControlLayoutSprite *)reference
+{
+    NSString *name = [self stringAtOffset:reference->name];
+    
+    if (!name) {
+        return nil;
+    }
+    
+    if (reference->flags & kCCControlLayoutSpriteFrame) {
+        return [CCSprite spriteWithSpriteFrameName:name];
+    }
+    
+    return [CCSprite spriteWithFile:name];
+}
+
+- (CCScale9Sprite *)scale9SpriteWithReference:(const ccControlLayoutSprite *)reference
+{
+    NSString *name = [self stringAtOffset:reference->name];
+    
+    if (!name) {
+        return nil;
+    }
+    
+    CGRect capInsets = ccControlLayoutCapInsets(reference);
+    
+    if (reference->flags & kCCControlLayoutSpriteFrame) {
+        return [CCScale9Sprite spriteWithSpriteFrameName:name capInsets:capInsets];
+    }
+    
+    return [CCScale9Sprite spriteWithFile:name capInsets:capInsets];
+}
+
+- (CCSpriteFrame *)spriteFrameWithReference:(const ccControlLayoutSprite *)reference
+{
+    NSString *name = [self stringAtOffset:reference->name];
+    
+    if (!name) {
+        return nil;
+    }
+    
+    if (reference->flags & kCCControlLayoutSpriteFrame) {
+        return [[CCSpriteFrameCache sharedSpriteFrameCache] spriteFrameByName:name];
+    }
+    
+    CCTexture2D *texture = [[CCTextureCache sharedTextureCache] addImage:name];
+    
+    return [CCSpriteFrame frameWithTexture:texture rect:CGRectMake(0, 0, texture.contentSize.width, texture.contentSize.height)];
+}
+
+- (CCNode<CCLabelProtocol, CCRGBAProtocol> *)labelWithState:(const ccControlLayoutState *)state
+                                                      title:(NSString *)title
+                                            defaultFontName:(NSString *)fontName
+                                            defaultFontSize:(float)fontSize
+{
+    NSString *font = [self stringAtOffset:state->font];
+    
+    if (!title) {
+        title = @"";
+    }
+    
+    if (font && (state->flags & kCCControlLayoutStateBMFont)) {
+        return [CCLabelBMFont labelWithString:title fntFile:font];
+    }
+    
+    return [CCLabelTTF labelWithString:title
+                              fontName:(font ? font : fontName)
+                              fontSize:(state->fontSize > 0 ? state->fontSize : fontSize)];
+}
+
+@end
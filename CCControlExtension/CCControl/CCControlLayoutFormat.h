@@ -0,0 +1,258 @@
+/*
+ * CCControlLayoutFormat.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef CCControlLayoutFormat_h
+#define CCControlLayoutFormat_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Binary layout of CCControl hierarchies, as read by CCControlLayout and
+ * written by the cccontrollayout converter (tools/cccontrollayout).
+ *
+ * A layout file is made of a header, an array of fixed-size control
+ * records and a table of NUL-terminated UTF-8 strings. Every field is
+ * little-endian and 4-byte aligned, so the file can be mapped in memory and
+ * its records read in place.
+ *
+ * The strings are referenced by their byte offset into the string table.
+ * The table starts with an empty string, so the offset 0 means "none".
+ *
+ * This header is shared with the converter and must stay plain C.
+ */
+
+/** "CCLY" read as a little-endian 32-bit integer. */
+#define kCCControlLayoutMagic           0x594c4343
+/** Version of the format described by this header. */
+#define kCCControlLayoutVersion         1
+/** Number of control states described per control. */
+#define kCCControlLayoutStates          4
+/** Number of sprites described per control. */
+#define kCCControlLayoutSprites         4
+/** Parent index of the controls added to the root of the layout. */
+#define kCCControlLayoutNoParent        -1
+
+/** Types of the controls described by a layout. */
+enum
+{
+    kCCControlLayoutTypeButton          = 1,
+    kCCControlLayoutTypeSlider          = 2,
+    kCCControlLayoutTypeSwitch          = 3,
+    kCCControlLayoutTypeStepper         = 4,
+    kCCControlLayoutTypePicker          = 5,
+};
+
+/** Flags of a control record. */
+enum
+{
+    kCCControlLayoutFlagDisabled            = 1 << 0,
+    kCCControlLayoutFlagSelected            = 1 << 1,
+    kCCControlLayoutFlagAnchorPoint         = 1 << 2,
+    /** Buttons. */
+    kCCControlLayoutFlagZoomOnTouchDown     = 1 << 3,
+    kCCControlLayoutFlagAdjustBackground    = 1 << 4,
+    kCCControlLayoutFlagLoadsStatesLazily   = 1 << 5,
+    /** Switches. */
+    kCCControlLayoutFlagOn                  = 1 << 6,
+    /** Steppers. */
+    kCCControlLayoutFlagContinuous          = 1 << 7,
+    kCCControlLayoutFlagAutorepeat          = 1 << 8,
+    kCCControlLayoutFlagWraps               = 1 << 9,
+    /** Pickers. */
+    kCCControlLayoutFlagLooping             = 1 << 10,
+    kCCControlLayoutFlagSwipeHorizontally   = 1 << 11,
+};
+
+/** Flags of a sprite reference. */
+enum
+{
+    /** The name is a sprite frame name of the CCSpriteFrameCache, not a file. */
+    kCCControlLayoutSpriteFrame         = 1 << 0,
+};
+
+/** Flags of a state description. */
+enum
+{
+    kCCControlLayoutStateTitleColor     = 1 << 0,
+    /** The font is a BMFont file, not a TTF font name. */
+    kCCControlLayoutStateBMFont         = 1 << 1,
+};
+
+/** Header at the beginning of a layout file. */
+typedef struct _ccControlLayoutHeader
+{
+    uint32_t    magic;
+    uint16_t    version;
+    /** sizeof(ccControlLayoutRecord) of the writer. */
+    uint16_t    recordSize;
+    uint32_t    recordCount;
+    uint32_t    recordsOffset;
+    uint32_t    stringsOffset;
+    uint32_t    stringsSize;
+} ccControlLayoutHeader;
+
+/**
+ * Reference to a sprite. The cap insets, in points, are only used by the
+ * CCScale9Sprite of the buttons.
+ */
+typedef struct _ccControlLayoutSprite
+{
+    uint32_t    name;
+    uint32_t    flags;
+    float       capInsets[4];
+} ccControlLayoutSprite;
+
+/** Title and background of a button state. */
+typedef struct _ccControlLayoutState
+{
+    uint32_t                title;
+    uint32_t                font;
+    float                   fontSize;
+    uint8_t                 titleColor[3];
+    uint8_t                 flags;
+    ccControlLayoutSprite   background;
+} ccControlLayoutState;
+
+/**
+ * Description of a control.
+ *
+ * The sprites are, by type:
+ * - slider: background, progress, thumb
+ * - switch: mask, on, off, thumb; with the on and off titles as the
+ * titles of the normal and selected states
+ * - stepper: minus, plus
+ * - picker: foreground, selection
+ * The states are indexed by the bit position of the CCControlState values
+ * and only used by the buttons and the switches.
+ */
+typedef struct _ccControlLayoutRecord
+{
+    uint32_t                type;
+    uint32_t                flags;
+    /** Index of the parent record, or kCCControlLayoutNoParent. */
+    int32_t                 parent;
+    int32_t                 tag;
+    int32_t                 z;
+    float                   position[2];
+    float                   anchorPoint[2];
+    float                   preferredSize[2];
+    float                   margins[2];
+    float                   labelAnchorPoint[2];
+    float                   value;
+    float                   minimumValue;
+    float                   maximumValue;
+    float                   stepValue;
+    uint8_t                 color[3];
+    uint8_t                 opacity;
+    ccControlLayoutSprite   sprites[kCCControlLayoutSprites];
+    ccControlLayoutState    states[kCCControlLayoutStates];
+} ccControlLayoutRecord;
+
+/** The records are read in place, so their layout must not depend on the compiler. */
+typedef char ccControlLayoutHeaderSizeCheck[(sizeof(ccControlLayoutHeader) == 24) ? 1 : -1];
+typedef char ccControlLayoutRecordSizeCheck[(sizeof(ccControlLayoutRecord) == 336) ? 1 : -1];
+
+/** Returns 1 if the given string offset references the string table. */
+static inline int ccControlLayoutIsValidString(const ccControlLayoutHeader *header, uint32_t offset)
+{
+    return offset < header->stringsSize;
+}
+
+/**
+ * Checks the header, the records and the string references of a layout
+ * file. Returns NULL if the layout can be read in place, or a description
+ * of the first error otherwise.
+ */
+static inline const char *ccControlLayoutValidate(const void *bytes, size_t length)
+{
+    const ccControlLayoutHeader *header = (const ccControlLayoutHeader *)bytes;
+    const ccControlLayoutRecord *records;
+    const char *strings;
+    uint32_t i, j;
+    
+    if (bytes == NULL || length < sizeof(ccControlLayoutHeader)) {
+        return "truncated header";
+    }
+    if (header->magic != kCCControlLayoutMagic) {
+        return "not a layout file";
+    }
+    if (header->version != kCCControlLayoutVersion) {
+        return "unsupported version";
+    }
+    if (header->recordSize != sizeof(ccControlLayoutRecord)) {
+        return "unsupported record size";
+    }
+    if (header->recordsOffset % 4 != 0
+        || header->recordsOffset > length
+        || header->recordCount > (length - header->recordsOffset) / sizeof(ccControlLayoutRecord)) {
+        return "truncated records";
+    }
+    if (header->stringsSize == 0
+        || header->stringsOffset > length
+        || header->stringsSize > length - header->stringsOffset) {
+        return "truncated string table";
+    }
+    
+    strings = (const char *)bytes + header->stringsOffset;
+    
+    if (strings[0] != '\0' || strings[header->stringsSize - 1] != '\0') {
+        return "unterminated string table";
+    }
+    
+    records = (const ccControlLayoutRecord *)((const char *)bytes + header->recordsOffset);
+    
+    for (i = 0; i < header->recordCount; i++) {
+        const ccControlLayoutRecord *record = &records[i];
+        
+        if (record->type < kCCControlLayoutTypeButton || record->type > kCCControlLayoutTypePicker) {
+            return "unknown control type";
+        }
+        // The parents are built before their children
+        if (record->parent != kCCControlLayoutNoParent
+            && (record->parent < 0 || (uint32_t)record->parent >= i)) {
+            return "invalid parent index";
+        }
+        for (j = 0; j < kCCControlLayoutSprites; j++) {
+            if (!ccControlLayoutIsValidString(header, record->sprites[j].name)) {
+                return "invalid sprite name";
+            }
+        }
+        for (j = 0; j < kCCControlLayoutStates; j++) {
+            const ccControlLayoutState *state = &record->states[j];
+            
+            if (!ccControlLayoutIsValidString(header, state->title)
+                || !ccControlLayoutIsValidString(header, state->font)
+                || !ccControlLayoutIsValidString(header, state->background.name)) {
+                return "invalid state string";
+            }
+        }
+    }
+    
+    return NULL;
+}
+
+#endif /* CCControlLayoutFormat_h */
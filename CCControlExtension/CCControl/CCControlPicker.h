@@ -37,6 +37,7 @@ typedef enum
 
 @protocol CCControlPickerDataSource;
 @protocol CCControlPickerDelegate;
+@class CCControlPickerRow;
 
 /**
  * Picker control for Cocos2D.
@@ -149,6 +150,17 @@ typedef enum
  */
 @property (nonatomic, getter = isLooping) BOOL looping;
 
+/**
+ * @abstract The virtualized vs. non-virtualized state of the picker.
+ * @discussion If YES, the picker asks its data source only for the rows
+ * which are visible, plus a small margin, and recycles the rows which
+ * are scrolled out. The data source can reuse them by calling the
+ * dequeueReusableRow method. Use this mode with large data sources.
+ *
+ * The default value for this property is NO.
+ */
+@property (nonatomic, getter = isVirtualized) BOOL virtualized;
+
 #pragma mark Specifying the Delegate
 /** @name Specifying the Delegate */
 /**
@@ -178,6 +190,18 @@ typedef enum
  */
 - (void)reloadComponent;
 
+#pragma mark Reusing Rows
+/** @name Reusing Rows */
+
+/**
+ * @abstract Returns a row which has been scrolled out, or nil if there is none.
+ * @discussion Only virtualized pickers recycle their rows. Call this method
+ * from the controlPicker:nodeForRow: data source method before creating a
+ * new row.
+ * @see virtualized
+ */
+- (CCControlPickerRow *)dequeueReusableRow;
+
 #pragma mark Selecting Rows in the Control Picker
 /** @name Selecting Rows in the Control Picker */
 
@@ -291,6 +315,17 @@ typedef enum
  */
 - (void)fitRowInSize:(CGSize)size;
 
+#pragma mark Reusing Rows
+/** @name Reusing Rows */
+
+/**
+ * @abstract Called when the row is dequeued to be reused by the control picker.
+ * @discussion The default implementation restores the downplayed appearance.
+ * Override it to reset your row.<br />
+ * (*do not forget to call the super [super prepareForReuse])*
+ */
+- (void)prepareForReuse;
+
 @end
 
 #pragma mark - CCControlPickerDataSource
@@ -25,35 +25,87 @@
  */
 
 #import "CCControlPicker.h"
+#import "CCControlInstrumentation.h"
+#import "CCControlVelocityTracker.h"
 #import "ARCMacro.h"
 
-#define CCControlPickerFriction         0.70f   // Between 0 and 1
+#define CCControlPickerFriction         0.70f   // Between 0 and 1, velocity kept every 1/60 s
+#define CCControlPickerMinimumVelocity  30.0f   // pt/s, the scrolling stops below
 #define CCControlPickerDefaultRowWidth  35      // px
 #define CCControlPickerDefaultRowHeight 35      // px
+#define CCControlPickerVirtualRowMargin 2       // Rows loaded around the visible ones
+
+/** Decay rate of the velocity per second, v(t) = v0 * exp(-rate * t). */
+#define CCControlPickerDecelerationRate (-logf(CCControlPickerFriction) * 60.0f)
 
 @interface CCControlPicker ()
 // Scroll Animation
-@property (nonatomic, getter = isDecelerating) BOOL         decelerating;
 @property (nonatomic, assign) CGPoint                       previousLocation;
-@property (nonatomic, assign) CGPoint                       velocity;
+@property (nonatomic, strong) CCControlVelocityTracker      *velocityTracker;
 @property (nonatomic, assign) CGRect                        limitBounds;
-@property (nonatomic, strong) NSDate                        *previousDate;
 @property (nonatomic, assign) NSUInteger                    highlightRow;
 // Picker
 @property (nonatomic, strong) CCLayer                       *rowsLayer;
 @property (nonatomic, assign) NSUInteger                    cachedRowCount;
 @property (nonatomic, assign) NSInteger                     selectedRow;
 @property (nonatomic, assign) CGSize                        cacheRowSize;
+@property (nonatomic, strong) NSMutableArray                *rowNodes;
+// Virtualization
+@property (nonatomic, strong) NSMutableArray                *visibleRows;
+@property (nonatomic, assign) NSInteger                     firstVisibleIndex;
+@property (nonatomic, strong) NSMutableArray                *reusableRows;
 
 /** Layout the picker with the number given row count. */
 - (void)needsLayoutWithRowCount:(NSUInteger)rowCount;
 
+/** Removes all the rows from the picker and puts them in the reuse queue. */
+- (void)removeAllRows;
+
+/**
+ * Loads the rows of the visible window (plus a small margin) and recycles
+ * the others. Does nothing if the window has not changed.
+ */
+- (void)updateVisibleRows;
+
+/**
+ * Returns the position of the row at the given virtual index. Virtual
+ * indexes are out of the data source bounds for the looping copies.
+ */
+- (CGPoint)positionForRowAtVirtualIndex:(NSInteger)index;
+
+/** Returns the data source row displayed at the given virtual index. */
+- (NSUInteger)rowForVirtualIndex:(NSInteger)index;
+
+/** Returns the node of the given row, or nil if it is not loaded. */
+- (id<CCControlPickerRowDelegate>)rowNodeForRow:(NSInteger)row;
+
 /** Returns YES whether the given value is out of the given bounds. */
 - (BOOL)isValue:(double)value outOfMinBound:(double)min maxBound:(double)max;
 
 /** Returns the row number at the closest location. */
 - (NSUInteger)rowNumberAtLocation:(CGPoint)location;
 
+/** Returns the row the closest to the given location, across the wrap point
+ * when the picker is looping. */
+- (NSUInteger)closestRowAtLocation:(CGPoint)location;
+
+/**
+ * Returns the virtual index of the given row the closest to the given
+ * location, so that a looping picker does not spin back through the whole
+ * list to reach it.
+ */
+- (NSInteger)virtualIndexForRow:(NSUInteger)row closestToLocation:(CGPoint)location;
+
+/**
+ * Returns the distance the rows layer travels along the swipe axis while the
+ * given velocity decays down to the minimum velocity.
+ */
+- (double)decelerationDistanceWithVelocity:(CGPoint)velocity;
+
+/** Brings the rows layer back to the selected row in the bounds and calls the
+ * delegate once the selection move is done. */
+- (void)selectRowMoveDidFinish;
+
 /** Apply the given translation to the given position and return it. */
 - (CGPoint)positionWithTranslation:(CGPoint)translation forLayerPosition:(CGPoint)position;
 
@@ -67,24 +119,27 @@
 /** Send to the picker's rows the appropriate events. */
 - (void)sendPickerRowEventForPosition:(CGPoint)location;
 
-// Manage mouse/touch events
-- (void)initMoveWithActionLocation:(CGPoint)location;
-- (void)updateMoveWithActionLocation:(CGPoint)location;
-- (void)endMoveWithActionLocation:(CGPoint)location;
+// Manage mouse/touch events, the timestamps are the ones of the events
+- (void)initMoveWithActionLocation:(CGPoint)location timestamp:(NSTimeInterval)timestamp;
+- (void)updateMoveWithActionLocation:(CGPoint)location timestamp:(NSTimeInterval)timestamp;
+- (void)endMoveWithActionLocation:(CGPoint)location timestamp:(NSTimeInterval)timestamp;
 
 @end
 
 @implementation CCControlPicker
-@synthesize decelerating     = _decelerating;
 @synthesize previousLocation = _previousLocation;
-@synthesize velocity         = _velocity;
+@synthesize velocityTracker  = _velocityTracker;
 @synthesize limitBounds      = _limitBounds;
-@synthesize previousDate     = _previousDate;
 @synthesize highlightRow     = _highlightRow;
 @synthesize rowsLayer        = _rowsLayer;
 @synthesize cachedRowCount   = _cachedRowCount;
 @synthesize selectedRow      = _selectedRow;
 @synthesize cacheRowSize     = _cacheRowSize;
+@synthesize rowNodes         = _rowNodes;
+@synthesize visibleRows      = _visibleRows;
+@synthesize firstVisibleIndex = _firstVisibleIndex;
+@synthesize reusableRows     = _reusableRows;
+@synthesize virtualized      = _virtualized;
 @synthesize background       = _background;
 @synthesize swipeOrientation = _swipeOrientation;
 @synthesize looping          = _looping;
@@ -93,8 +148,11 @@
 
 - (void)dealloc
 {
-    SAFE_ARC_RELEASE(_previousDate);
+    SAFE_ARC_RELEASE(_velocityTracker);
     SAFE_ARC_RELEASE(_rowsLayer);
+    SAFE_ARC_RELEASE(_rowNodes);
+    SAFE_ARC_RELEASE(_visibleRows);
+    SAFE_ARC_RELEASE(_reusableRows);
     SAFE_ARC_AUTORELEASE(_background);
     
     SAFE_ARC_SUPER_DEALLOC();
@@ -123,7 +181,7 @@
     if ((self = [super init])) {
         NSAssert(foregroundSprite, @"Foreground sprite must be not nil");
         
-        self.decelerating                 = NO;
+        self.velocityTracker              = [CCControlVelocityTracker velocityTracker];
         self.ignoreAnchorPointForPosition = NO;
         self.contentSize                  = foregroundSprite.contentSize;
         
@@ -134,6 +192,11 @@
                                        CCControlPickerDefaultRowHeight);
         _swipeOrientation = CCControlPickerOrientationVertical;
         _looping          = NO;
+        _virtualized      = NO;
+        
+        self.rowNodes     = [NSMutableArray array];
+        self.visibleRows  = [NSMutableArray array];
+        self.reusableRows = [NSMutableArray array];
         
         CGPoint center            = ccp (self.contentSize.width / 2, self.contentSize.height /2);
         foregroundSprite.position = center;
@@ -170,23 +233,20 @@
 {
     [super onEnter];
     
-    [self scheduleUpdate];
-    
     [self reloadComponent];
 }
 
-- (void)onExit
-{
-    [self unscheduleUpdate];
-    
-    [super onExit];
-}
 
 - (void)visit
 {
 	if (!self.visible)
         return;
     
+    // The rows layer may have been moved by an action since the last frame
+    if (_virtualized) {
+        [self updateVisibleRows];
+    }
+    
     glEnable(GL_SCISSOR_TEST);
     
     CGPoint worldOrg = [self convertToWorldSpace:ccp(0, 0)];
@@ -204,30 +264,6 @@
 	glDisable(GL_SCISSOR_TEST);
 }
 
-- (void)update:(ccTime)delta
-{
-    if (![self isDecelerating]) {
-        return;
-    }
-    
-    if (_velocity.y <= 30.0f && _velocity.y >= -30.0f) {
-        _decelerating = NO;
-        
-        NSUInteger rowNumber = [self rowNumberAtLocation:_rowsLayer.position];
-        [self selectRow:rowNumber animated:YES];
-        return;
-    }
-    
-    CGPoint tranlation  = ccp (_velocity.x * delta, _velocity.y * delta);
-    _rowsLayer.position = [self positionWithTranslation:tranlation forLayerPosition:_rowsLayer.position];
-    
-    [self sendPickerRowEventForPosition:_rowsLayer.position];
-    
-    // Update the new velocity
-    _velocity = ccp(_velocity.x * CCControlPickerFriction,
-                                  _velocity.y * CCControlPickerFriction);
-}
-
 #pragma mark Properties
 
 - (void)setBackground:(CCNode *)background
@@ -244,6 +280,19 @@
     }
 }
 
+- (void)setVirtualized:(BOOL)virtualized
+{
+    if (_virtualized == virtualized) {
+        return;
+    }
+    
+    _virtualized = virtualized;
+    
+    if ([self isRunning]) {
+        [self reloadComponent];
+    }
+}
+
 #pragma mark - CCControlPicker Public Methods
 
 - (CGSize)rowSize
@@ -267,26 +316,51 @@
     [self needsLayoutWithRowCount:_cachedRowCount];
 }
 
+- (CCControlPickerRow *)dequeueReusableRow
+{
+    CCControlPickerRow *row = SAFE_ARC_RETAIN([_reusableRows lastObject]);
+    
+    if (row) {
+        [_reusableRows removeLastObject];
+        [row prepareForReuse];
+    }
+    
+    return SAFE_ARC_AUTORELEASE(row);
+}
+
 - (void)selectRow:(NSUInteger)row animated:(BOOL)animated
 {
     CGPoint dest = _rowsLayer.position;
     
+    // The animation goes to the closest copy of the row, the position is
+    // brought back in the bounds once it is done
+    NSInteger index = animated ? [self virtualIndexForRow:row closestToLocation:dest] : row;
+    
     if (_swipeOrientation == CCControlPickerOrientationVertical) {
-        dest.y = _cacheRowSize.height * row;
+        dest.y = _cacheRowSize.height * index;
     }
     else {
-        dest.x = -_cacheRowSize.width * row;
+        dest.x = -_cacheRowSize.width * index;
     }
     
     _selectedRow = row;
     
+    // Move the rows right away so that the selected row is loaded
+    if (!animated) {
+        _rowsLayer.position = dest;
+        
+        if (_virtualized) {
+            [self updateVisibleRows];
+        }
+    }
+    
     // Send events
     if (_highlightRow != _selectedRow && _highlightRow != -1) {
-        id<CCControlPickerRowDelegate> rowNode  = (id<CCControlPickerRowDelegate>)[_rowsLayer getChildByTag:_selectedRow];
+        id<CCControlPickerRowDelegate> rowNode  = [self rowNodeForRow:_highlightRow];
         [rowNode rowDidDownplayed];
     }
     
-    id<CCControlPickerRowDelegate> rowNode = (id<CCControlPickerRowDelegate>)[_rowsLayer getChildByTag:_selectedRow];
+    id<CCControlPickerRowDelegate> rowNode = [self rowNodeForRow:_selectedRow];
     [rowNode rowWillBeSelected];
     
     _highlightRow = -1;
@@ -296,7 +370,7 @@
                                [CCEaseInOut actionWithAction:
                                 [CCEaseElasticOut actionWithAction:
                                  [CCMoveTo actionWithDuration:0.4f position:dest] period:0.02f] rate:1.0f],
-                               [CCCallFunc actionWithTarget:self selector:@selector(sendSelectedRowCallback)],nil]];
+                               [CCCallFunc actionWithTarget:self selector:@selector(selectRowMoveDidFinish)],nil]];
     }
     else {
         [self sendSelectedRowCallback];
@@ -312,28 +386,38 @@
 
 - (void)needsLayoutWithRowCount:(NSUInteger)rowCount
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterNeedsLayout);
+    
+    [self setNeedsRasterize];
+    
     CGPoint center = ccp (self.contentSize.width / 2, self.contentSize.height /2);
     
     if (_delegate && [_delegate respondsToSelector:@selector(rowSizeForControlPicker:)]) {
         _cacheRowSize = [_delegate rowSizeForControlPicker:self];
     }
     
+    [self removeAllRows];
+    
+    // Defines the limit bounds for non-circular picker
+    _limitBounds = CGRectMake(-_cacheRowSize.width * (_cachedRowCount - 1),
+                                 0,
+                                 0,
+                                 _cacheRowSize.height * (_cachedRowCount - 1));
+    
+    if (_virtualized) {
+        // Only the rows around the visible area are loaded
+        [self updateVisibleRows];
+        [self selectRow:0 animated:NO];
+        return;
+    }
+    
     for (NSUInteger i = 0; i < rowCount; i++) {
         CCControlPickerRow *row = [_dataSource controlPicker:self nodeForRow:i];
         [row fitRowInSize:_cacheRowSize];
         row.anchorPoint = ccp(0.5f, 0.5f);
-        [_rowsLayer addChild:row z:1 tag:i];
-        
-        CGPoint position = center;
-        
-        if (_swipeOrientation == CCControlPickerOrientationVertical) {
-            position.y += -_cacheRowSize.height * i;
-        }
-        else {
-            position.x += _cacheRowSize.width * i;
-        }
-        
-        row.position = position;
+        row.position    = [self positionForRowAtVirtualIndex:i];
+        [_rowsLayer addChild:row z:1];
+        [_rowNodes addObject:row];
     }
     
     if ([self isLooping]) {
@@ -372,15 +456,143 @@
         }
     }
     
-    // Defines the limit bounds for non-circular picker
-    _limitBounds = CGRectMake(-_cacheRowSize.width * (_cachedRowCount - 1),
-                                 0,
-                                 0,
-                                 _cacheRowSize.height * (_cachedRowCount - 1));
-    
     [self selectRow:0 animated:NO];
 }
 
+- (void)removeAllRows
+{
+    for (CCControlPickerRow *row in _visibleRows) {
+        [_rowsLayer removeChild:row cleanup:YES];
+        [_reusableRows addObject:row];
+    }
+    [_visibleRows removeAllObjects];
+    
+    [_rowNodes removeAllObjects];
+    [_rowsLayer removeAllChildrenWithCleanup:YES];
+    
+    _firstVisibleIndex = 0;
+}
+
+- (void)updateVisibleRows
+{
+    if (_cachedRowCount == 0) {
+        return;
+    }
+    
+    // Compute the window of virtual indexes around the center of the picker
+    double center, rowLength, pickerLength;
+    
+    if (_swipeOrientation == CCControlPickerOrientationVertical) {
+        center       = _rowsLayer.position.y / _cacheRowSize.height;
+        rowLength    = _cacheRowSize.height;
+        pickerLength = self.contentSize.height;
+    }
+    else {
+        center       = -_rowsLayer.position.x / _cacheRowSize.width;
+        rowLength    = _cacheRowSize.width;
+        pickerLength = self.contentSize.width;
+    }
+    
+    NSInteger halfCount  = ceil(pickerLength / (2 * rowLength)) + CCControlPickerVirtualRowMargin;
+    NSInteger firstIndex = floor(center) - halfCount;
+    NSInteger lastIndex  = ceil(center) + halfCount;
+    
+    if (![self isLooping]) {
+        firstIndex = MAX(firstIndex, 0);
+        lastIndex  = MIN(lastIndex, (NSInteger)_cachedRowCount - 1);
+    }
+    
+    NSInteger previousFirstIndex = _firstVisibleIndex;
+    NSInteger previousLastIndex  = _firstVisibleIndex + (NSInteger)[_visibleRows count] - 1;
+    
+    if (firstIndex == previousFirstIndex && lastIndex == previousLastIndex) {
+        return;
+    }
+    
+    // Recycle the rows which leave the window
+    for (NSInteger index = previousFirstIndex; index <= previousLastIndex; index++) {
+        if (index < firstIndex || lastIndex < index) {
+            CCControlPickerRow *row = [_visibleRows objectAtIndex:(index - previousFirstIndex)];
+            [_rowsLayer removeChild:row cleanup:YES];
+            [_reusableRows addObject:row];
+        }
+    }
+    
+    // Keep the rows still in the window and ask the data source for the others
+    NSMutableArray *visibleRows = [NSMutableArray arrayWithCapacity:(lastIndex - firstIndex + 1)];
+    
+    for (NSInteger index = firstIndex; index <= lastIndex; index++) {
+        if (previousFirstIndex <= index && index <= previousLastIndex) {
+            [visibleRows addObject:[_visibleRows objectAtIndex:(index - previousFirstIndex)]];
+            continue;
+        }
+        
+        NSUInteger rowNumber    = [self rowForVirtualIndex:index];
+        CCControlPickerRow *row = [_dataSource controlPicker:self nodeForRow:rowNumber];
+        [row fitRowInSize:_cacheRowSize];
+        row.anchorPoint = ccp(0.5f, 0.5f);
+        row.position    = [self positionForRowAtVirtualIndex:index];
+        [_rowsLayer addChild:row z:1];
+        
+        // A row loaded under the selection has missed the highlight event
+        if (rowNumber == _highlightRow) {
+            [row rowDidHighlighted];
+        }
+        
+        [visibleRows addObject:row];
+    }
+    
+    self.visibleRows   = visibleRows;
+    _firstVisibleIndex = firstIndex;
+}
+
+- (CGPoint)positionForRowAtVirtualIndex:(NSInteger)index
+{
+    CGPoint position = ccp (self.contentSize.width / 2, self.contentSize.height /2);
+    
+    if (_swipeOrientation == CCControlPickerOrientationVertical) {
+        position.y += -_cacheRowSize.height * index;
+    }
+    else {
+        position.x += _cacheRowSize.width * index;
+    }
+    
+    return position;
+}
+
+- (NSUInteger)rowForVirtualIndex:(NSInteger)index
+{
+    NSInteger rowCount = (NSInteger)_cachedRowCount;
+    
+    return ((index % rowCount) + rowCount) % rowCount;
+}
+
+- (id<CCControlPickerRowDelegate>)rowNodeForRow:(NSInteger)row
+{
+    if (row < 0 || row >= (NSInteger)_cachedRowCount) {
+        return nil;
+    }
+    
+    if (!_virtualized) {
+        return [_rowNodes objectAtIndex:row];
+    }
+    
+    // With looping the row may be displayed by a copy before or after it
+    NSInteger visibleCount  = [_visibleRows count];
+    NSInteger rowCount      = (NSInteger)_cachedRowCount;
+    NSInteger candidates[3] = { row, row + rowCount, row - rowCount };
+    
+    for (int i = 0; i < 3; i++) {
+        NSInteger index = candidates[i] - _firstVisibleIndex;
+        
+        if (index >= 0 && index < visibleCount) {
+            return [_visibleRows objectAtIndex:index];
+        }
+    }
+    
+    return nil;
+}
+
 - (BOOL)isValue:(double)value outOfMinBound:(double)min maxBound:(double)max
 {
     return  (value <= min || max <= value);
@@ -424,6 +636,54 @@
     }
 }
 
+- (NSUInteger)closestRowAtLocation:(CGPoint)location
+{
+    if (![self isLooping] || _cachedRowCount == 0) {
+        return [self rowNumberAtLocation:location];
+    }
+    
+    // Past the last row comes the first one again
+    double index = (_swipeOrientation == CCControlPickerOrientationVertical)
+        ? location.y / _cacheRowSize.height : -location.x / _cacheRowSize.width;
+    
+    return [self rowForVirtualIndex:(NSInteger)round(index)];
+}
+
+- (NSInteger)virtualIndexForRow:(NSUInteger)row closestToLocation:(CGPoint)location
+{
+    if (![self isLooping] || _cachedRowCount == 0) {
+        return row;
+    }
+    
+    double current, rowLength, pickerLength;
+    
+    if (_swipeOrientation == CCControlPickerOrientationVertical) {
+        current      = location.y / _cacheRowSize.height;
+        rowLength    = _cacheRowSize.height;
+        pickerLength = self.contentSize.height;
+    }
+    else {
+        current      = -location.x / _cacheRowSize.width;
+        rowLength    = _cacheRowSize.width;
+        pickerLength = self.contentSize.width;
+    }
+    
+    NSInteger rowCount = (NSInteger)_cachedRowCount;
+    NSInteger index    = row + rowCount * (NSInteger)round((current - row) / rowCount);
+    
+    // Without virtualization only a window of copies is laid out around the
+    // bounds, a longer move stays inside them
+    if (!_virtualized) {
+        NSInteger loopCount = pickerLength / rowLength;
+        
+        if (index < -loopCount / 2 || rowCount + loopCount / 2 <= index) {
+            index = row;
+        }
+    }
+    
+    return index;
+}
+
 - (CGPoint)positionWithTranslation:(CGPoint)translation forLayerPosition:(CGPoint)position
 {
     if (_swipeOrientation == CCControlPickerOrientationVertical) {
@@ -480,6 +740,40 @@
     }
 }
 
+- (double)decelerationDistanceWithVelocity:(CGPoint)velocity
+{
+    double speed = (_swipeOrientation == CCControlPickerOrientationVertical) ? velocity.y : velocity.x;
+    
+    if (ABS(speed) <= CCControlPickerMinimumVelocity) {
+        return 0;
+    }
+    
+    // v(t) = v0 * exp(-rate * t) travels (v0 - v1) / rate until it decays to v1
+    double distance = (ABS(speed) - CCControlPickerMinimumVelocity) / CCControlPickerDecelerationRate;
+    
+    return (speed < 0) ? -distance : distance;
+}
+
+- (void)selectRowMoveDidFinish
+{
+    CGPoint position = _rowsLayer.position;
+    
+    if (_swipeOrientation == CCControlPickerOrientationVertical) {
+        position.y = _cacheRowSize.height * _selectedRow;
+    }
+    else {
+        position.x = -_cacheRowSize.width * _selectedRow;
+    }
+    
+    _rowsLayer.position = position;
+    
+    if (_virtualized) {
+        [self updateVisibleRows];
+    }
+    
+    [self sendSelectedRowCallback];
+}
+
 -(void)sendSelectedRowCallback
 {
     if (_delegate && [_delegate respondsToSelector:@selector(controlPicker:didSelectRow:)]) {
@@ -487,44 +781,45 @@
     }
     
     // Notifie the row
-    id<CCControlPickerRowDelegate> rowNode = (id<CCControlPickerRowDelegate>)[_rowsLayer getChildByTag:_selectedRow];
+    id<CCControlPickerRowDelegate> rowNode = [self rowNodeForRow:_selectedRow];
     [rowNode rowDidSelected];
 }
 
 - (void)sendPickerRowEventForPosition:(CGPoint)location
 {
-    NSUInteger highlightRow = [self rowNumberAtLocation:_rowsLayer.position];
+    NSUInteger highlightRow = [self closestRowAtLocation:_rowsLayer.position];
     
     if (_highlightRow != highlightRow) {
         id<CCControlPickerRowDelegate> rowNode;
         
         if (_highlightRow != -1) {
-            rowNode = (id<CCControlPickerRowDelegate>)[_rowsLayer getChildByTag:_highlightRow];
+            rowNode = [self rowNodeForRow:_highlightRow];
             [rowNode rowDidDownplayed];
         }
         
         self.highlightRow = highlightRow;
-        rowNode           = (id<CCControlPickerRowDelegate>)[_rowsLayer getChildByTag:_highlightRow];
+        rowNode           = [self rowNodeForRow:_highlightRow];
         [rowNode rowDidHighlighted];
     }
 }
 
-- (void)initMoveWithActionLocation:(CGPoint)location
+- (void)initMoveWithActionLocation:(CGPoint)location timestamp:(NSTimeInterval)timestamp
 {
     self.selected = YES;
     
     [_rowsLayer stopAllActions];
     
-    _decelerating     = NO;
     _previousLocation = location;
-    self.previousDate = [NSDate date];
+    
+    [_velocityTracker reset];
+    [_velocityTracker addLocation:location timestamp:timestamp];
     
     // Update the cell layer position
     CGPoint translation = ccpSub(_previousLocation, location);
     _rowsLayer.position = [self positionWithTranslation:translation forLayerPosition:_rowsLayer.position];
 }
 
-- (void)updateMoveWithActionLocation:(CGPoint)location
+- (void)updateMoveWithActionLocation:(CGPoint)location timestamp:(NSTimeInterval)timestamp
 {
     // Update the cell layer position
     CGPoint translation = ccpSub(_previousLocation, location);
@@ -533,20 +828,34 @@
     // Sends the picker's row event
     [self sendPickerRowEventForPosition:_rowsLayer.position];
     
-    // Compute the current velocity
-    double delta_time      = [[NSDate date] timeIntervalSinceDate:_previousDate];
-    CGPoint delta_position = ccpSub(_previousLocation, location);
-    _velocity              = ccp(delta_position.x / delta_time, delta_position.y / delta_time);
-    
-    // Update the previous location and date
+    // Track the velocity and update the previous location
+    [_velocityTracker addLocation:location timestamp:timestamp];
     _previousLocation = location;
-    self.previousDate = [NSDate date];
 }
 
-- (void)endMoveWithActionLocation:(CGPoint)location
+- (void)endMoveWithActionLocation:(CGPoint)location timestamp:(NSTimeInterval)timestamp
 {
     self.selected = NO;
-    _decelerating = YES;
+    
+    [_velocityTracker addLocation:location timestamp:timestamp];
+    
+    if (_cachedRowCount == 0) {
+        return;
+    }
+    
+    // Glide at once to the row the closest to where the deceleration from
+    // the release velocity would stop (the rows layer follows the velocity)
+    CGPoint landing = _rowsLayer.position;
+    double distance = [self decelerationDistanceWithVelocity:[_velocityTracker velocity]];
+    
+    if (_swipeOrientation == CCControlPickerOrientationVertical) {
+        landing.y += distance;
+    }
+    else {
+        landing.x += distance;
+    }
+    
+    [self selectRow:[self closestRowAtLocation:landing] animated:YES];
 }
 
 #pragma mark -
@@ -565,9 +874,9 @@
     
     CGPoint touchLocation = [touch locationInView:[touch view]];
     touchLocation         = [[CCDirector sharedDirector] convertToGL:touchLocation];
-    touchLocation         = [[self parent] convertToNodeSpace:touchLocation];
+    touchLocation         = [self convertWorldLocationToParentSpace:touchLocation];
     
-    [self initMoveWithActionLocation:touchLocation];
+    [self initMoveWithActionLocation:touchLocation timestamp:[touch timestamp]];
     
     return YES;
 }
@@ -576,18 +885,18 @@
 {
     CGPoint touchLocation = [touch locationInView:[touch view]];
     touchLocation         = [[CCDirector sharedDirector] convertToGL:touchLocation];
-    touchLocation         = [[self parent] convertToNodeSpace:touchLocation];
+    touchLocation         = [self convertWorldLocationToParentSpace:touchLocation];
     
-    [self updateMoveWithActionLocation:touchLocation];
+    [self updateMoveWithActionLocation:touchLocation timestamp:[touch timestamp]];
 }
 
 - (void)ccTouchEnded:(UITouch *)touch withEvent:(UIEvent *)event
 {
     CGPoint touchLocation = [touch locationInView:[touch view]];
     touchLocation         = [[CCDirector sharedDirector] convertToGL:touchLocation];
-    touchLocation         = [[self parent] convertToNodeSpace:touchLocation];
+    touchLocation         = [self convertWorldLocationToParentSpace:touchLocation];
     
-    [self endMoveWithActionLocation:touchLocation];
+    [self endMoveWithActionLocation:touchLocation timestamp:[touch timestamp]];
 }
 
 - (void)ccTouchCancelled:(UITouch *)touch withEvent:(UIEvent *)event
@@ -607,9 +916,9 @@
     }
     
     CGPoint eventLocation = [[CCDirector sharedDirector] convertEventToGL:event];
-    eventLocation         = [[self parent] convertToNodeSpace:eventLocation];
+    eventLocation         = [self convertWorldLocationToParentSpace:eventLocation];
     
-    [self initMoveWithActionLocation:eventLocation];
+    [self initMoveWithActionLocation:eventLocation timestamp:[event timestamp]];
     
     return YES;
 }
@@ -621,9 +930,9 @@
         return NO;
     
     CGPoint eventLocation = [[CCDirector sharedDirector] convertEventToGL:event];
-    eventLocation         = [[self parent] convertToNodeSpace:eventLocation];
+    eventLocation         = [self convertWorldLocationToParentSpace:eventLocation];
     
-    [self updateMoveWithActionLocation:eventLocation];
+    [self updateMoveWithActionLocation:eventLocation timestamp:[event timestamp]];
     
     return YES;
 }
@@ -636,9 +945,9 @@
     }
     
     CGPoint eventLocation = [[CCDirector sharedDirector] convertEventToGL:event];
-    eventLocation         = [[self parent] convertToNodeSpace:eventLocation];
+    eventLocation         = [self convertWorldLocationToParentSpace:eventLocation];
     
-    [self endMoveWithActionLocation:eventLocation];
+    [self endMoveWithActionLocation:eventLocation timestamp:[event timestamp]];
     
     return NO;
 }
@@ -720,6 +1029,11 @@
     _textLabel.position   = center;
 }
 
+- (void)prepareForReuse
+{
+    [self rowDidDownplayed];
+}
+
 #pragma mark - CCControlPickerRow Delegate Methods
 
 - (void)rowDidHighlighted
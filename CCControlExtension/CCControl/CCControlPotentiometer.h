@@ -62,6 +62,9 @@
 /**
  * Creates potentiometer with a track filename and a progress filename.
  *
+ * The progress is drawn by a CCControlProgressTimer, which only updates
+ * the sweeping vertex of its radial geometry when the value changes.
+ *
  * @see initWithTrackSprite:progressSprite:thumbSprite:
  */
 + (id)potentiometerWithTrackFile:(NSString *)backgroundFile progressFile:(NSString *)progressFile thumbFile:(NSString *)thumbFile;
@@ -25,6 +25,8 @@
  */
 
 #import "CCControlPotentiometer.h"
+#import "CCControlInstrumentation.h"
+#import "CCControlProgressTimer.h"
 #import "ARCMacro.h"
 
 @interface CCControlPotentiometer () 
@@ -78,7 +80,7 @@
 	CCSprite *thumbSprite = [CCSprite spriteWithFile:thumbFile];
     
     // Prepare progress for potentiometer
-    CCProgressTimer *progressTimer = [CCProgressTimer progressWithSprite:[CCSprite spriteWithFile:progressFile]];
+    CCProgressTimer *progressTimer = [CCControlProgressTimer progressWithSprite:[CCSprite spriteWithFile:progressFile]];
     //progressTimer.type           = kCCProgressTimerTypeRadialCW;
 
     return SAFE_ARC_AUTORELEASE([[self alloc] initWithTrackSprite:backgroundSprite progressSprite:progressTimer thumbSprite:thumbSprite]);
@@ -153,6 +155,8 @@
 
 - (BOOL)isTouchInside:(UITouch *)touch
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterHitTest);
+    
     CGPoint touchLocation = [self touchLocation:touch];
     
     float distance = [self distanceBetweenPoint:_progressTimer.position andPoint:touchLocation];
@@ -192,6 +196,8 @@
 
 - (BOOL)isMouseInside:(NSEvent *)event
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterHitTest);
+    
     CGPoint eventLocation = [self eventLocation:event];
     float distance        = [self distanceBetweenPoint:_progressTimer.position andPoint:eventLocation];
     
@@ -324,10 +330,15 @@
 {
     self.thumbSprite.color = ccWHITE;
     self.selected          = NO;
+    
+    // Deliver the final value without waiting for the next tick
+    [self flushValueChangedEvents];
 }
 
 - (void)layoutWithValue:(float)value
 {
+    [self setNeedsRasterize];
+    
     // Update thumb and progress position for new value
     float percent             = (value - _minimumValue) / (_maximumValue - _minimumValue);
     _progressTimer.percentage = percent * 100.0f;
@@ -25,6 +25,7 @@
  */
 
 #import "CCControlSlider.h"
+#import "CCControlInstrumentation.h"
 #import "ARCMacro.h"
 
 @interface CCControlSlider ()
@@ -170,13 +171,25 @@
     self.value = _minimumValue;
 }
 
+- (CGRect)hitTestRect
+{
+    // The thumb can be touched beyond the edges of the track
+    CGRect rect     = [super hitTestRect];
+    rect.size.width += _thumbSprite.contentSize.width;
+    rect.origin.x   -= _thumbSprite.contentSize.width / 2;
+    
+    return rect;
+}
+
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
 
 - (BOOL)isTouchInside:(UITouch *)touch
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterHitTest);
+    
     CGPoint touchLocation = [touch locationInView:[touch view]];
     touchLocation         = [[CCDirector sharedDirector] convertToGL:touchLocation];
-    touchLocation         = [[self parent] convertToNodeSpace:touchLocation];
+    touchLocation         = [self convertWorldLocationToParentSpace:touchLocation];
     
     CGRect rect     = [self boundingBox];
     rect.size.width += _thumbSprite.contentSize.width;
@@ -189,7 +202,7 @@
 {
     CGPoint touchLocation = [touch locationInView:[touch view]];                     // Get the touch position
     touchLocation         = [[CCDirector sharedDirector] convertToGL:touchLocation]; // Convert the position to GL space
-    touchLocation         = [self convertToNodeSpace:touchLocation];                 // Convert to the node space of this class
+    touchLocation         = [self convertWorldLocationToNodeSpace:touchLocation];    // Convert to the node space of this class
     
     if (touchLocation.x < 0) {
         touchLocation.x = 0;
@@ -235,8 +248,10 @@
 
 - (BOOL)isMouseInside:(NSEvent *)event
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterHitTest);
+    
     CGPoint eventLocation = [[CCDirector sharedDirector] convertEventToGL:event];
-    eventLocation         = [[self parent] convertToNodeSpace:eventLocation];
+    eventLocation         = [self convertWorldLocationToParentSpace:eventLocation];
     
     CGRect rect     = [self boundingBox];
     rect.size.width += _thumbSprite.contentSize.width;
@@ -248,7 +263,7 @@
 - (CGPoint)locationFromEvent:(NSEvent *)event
 {
     CGPoint eventLocation = [[CCDirector sharedDirector] convertEventToGL:event];
-    eventLocation         = [self convertToNodeSpace:eventLocation];
+    eventLocation         = [self convertWorldLocationToNodeSpace:eventLocation];
     
     if (eventLocation.x < 0) {
         eventLocation.x = 0;
@@ -305,6 +320,8 @@
 
 - (void)needsLayout
 {
+    CC_CONTROL_INSTRUMENT(self, CCControlCounterNeedsLayout);
+    
     [self layoutWithValue:_value];
 }
 
@@ -354,6 +371,9 @@
     
     self.thumbSprite.color = ccWHITE;
     self.selected          = NO;
+    
+    // Deliver the final value without waiting for the next tick
+    [self flushValueChangedEvents];
 }
 
 - (float)valueForLocation:(CGPoint)location
@@ -364,6 +384,8 @@
 
 - (void)layoutWithValue:(float)value
 {
+    [self setNeedsRasterize];
+    
     // Update thumb position for new value
     float percent = (value - _minimumValue) / (_maximumValue - _minimumValue);
     
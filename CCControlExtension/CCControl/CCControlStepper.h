@@ -68,7 +68,6 @@ typedef enum
     
     BOOL                 _touchInsideFlag;
     CCControlStepperPart _touchedPart;
-    NSInteger            _autorepeatCount;
 }
 
 #pragma mark Contructors - Initializers
@@ -25,6 +25,7 @@
  */
 
 #import "CCControlStepper.h"
+#import "CCControlAutorepeat.h"
 #import "ARCMacro.h"
 
 #define CCControlStepperLabelColorEnabled  ccc3(55, 55, 55)
@@ -36,9 +37,6 @@
 #define CCControlStepperLabelFont @"Courier New"
 #endif
 
-#define kAutorepeatDeltaTime             0.15f
-#define kAutorepeatIncreaseTimeIncrement 12
-
 @interface CCControlStepper ()
 @property (nonatomic, strong) CCSprite   *minusSprite;
 @property (nonatomic, strong) CCSprite   *plusSprite;
@@ -57,6 +55,9 @@
 /** Stop the autorepeat. */
 - (void)stopAutorepeat;
 
+/** Increments or decrements the value, called by the autorepeat. */
+- (void)repeatStep;
+
 @end
 
 @implementation CCControlStepper
@@ -76,7 +77,7 @@
 
 - (void)dealloc
 {
-    [self unscheduleAllSelectors];
+    [self stopAutorepeat];
     
     SAFE_ARC_RELEASE(_minusSprite);
     SAFE_ARC_RELEASE(_plusSprite);
@@ -210,6 +211,7 @@
     }
     
     _value = value;
+    [self setNeedsRasterize];
     
     if (!_wraps) {
         _minusLabel.color = (value == _minimumValue) ? CCControlStepperLabelColorDisabled : CCControlStepperLabelColorEnabled;
@@ -223,25 +225,20 @@
 
 - (void)startAutorepeat
 {
-    _autorepeatCount = -1;
-    
-    [self schedule:@selector(update:) interval:kAutorepeatDeltaTime repeat:kCCRepeatForever delay:kAutorepeatDeltaTime * 3];
+    // Slow repeats first, then fast ones once the part has been held for a while
+    [[CCControlAutorepeat sharedAutorepeat] startRepeatingTarget:self
+                                                          action:@selector(repeatStep)
+                                                          timing:kCCControlAutorepeatTimingDefault];
 }
 
 /** Stop the autorepeat. */
 - (void)stopAutorepeat
 {
-    [self unschedule:@selector(update:)];
+    [[CCControlAutorepeat sharedAutorepeat] stopRepeatingTarget:self];
 }
 
-- (void)update:(ccTime)dt
+- (void)repeatStep
 {
-    _autorepeatCount++;
-    
-    if ((_autorepeatCount < kAutorepeatIncreaseTimeIncrement) && (_autorepeatCount % 3) != 0) {
-        return;
-    }
-    
     if (_touchedPart == kCCControlStepperPartMinus) {
         [self setValue:(_value - _stepValue) sendingEvent:_continuous];
     }
@@ -250,10 +247,47 @@
     }
 }
 
+- (void)onExit
+{
+    [self stopAutorepeat];
+    
+    [super onExit];
+}
+
+- (void)prepareForEnqueue
+{
+    [super prepareForEnqueue];
+    
+    [self stopAutorepeat];
+}
+
+- (void)prepareForReuse
+{
+    [super prepareForReuse];
+    
+    // Restore the default values
+    _autorepeat      = YES;
+    _continuous      = YES;
+    _minimumValue    = 0;
+    _maximumValue    = 100;
+    _stepValue       = 1;
+    _wraps           = NO;
+    _pushedTintColor = ccGRAY;
+    _touchedPart     = kCCControlStepperPartNone;
+    _touchInsideFlag = NO;
+    
+    _minusSprite.color = ccWHITE;
+    _plusSprite.color  = ccWHITE;
+    
+    [self setValue:_minimumValue sendingEvent:NO];
+}
+
 #pragma mark CCControlStepper Private Methods
 
 - (void)updateLayoutUsingTouchLocation:(CGPoint)location
 {
+    [self setNeedsRasterize];
+    
     if (location.x < _minusSprite.contentSize.width
         && _value > _minimumValue) {
         _touchedPart = kCCControlStepperPartMinus;
@@ -320,6 +354,7 @@
         
         _minusSprite.color = ccWHITE;
         _plusSprite.color  = ccWHITE;
+        [self setNeedsRasterize];
         
         if (_autorepeat) {
             [self stopAutorepeat];
@@ -331,6 +366,7 @@
 {
     _minusSprite.color  = ccWHITE;
     _plusSprite.color   = ccWHITE;
+    [self setNeedsRasterize];
     
     if (_autorepeat) {
         [self stopAutorepeat];
@@ -392,6 +428,7 @@
         
         _minusSprite.color = ccWHITE;
         _plusSprite.color  = ccWHITE;
+        [self setNeedsRasterize];
         
         if (_autorepeat) {
             [self stopAutorepeat];
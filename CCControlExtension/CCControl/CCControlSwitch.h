@@ -26,6 +26,8 @@
 
 #import "CCControl.h"
 
+@class CCControlSwitchSkin;
+
 /**
  * CCControlSwitch is a switch control for Cocos2D.
  *
@@ -93,6 +95,21 @@
  */
 + (id)switchWithMaskFile:(NSString *)maskFile onFile:(NSString *)onFile offFile:(NSString *)offFile thumbFile:(NSString *)thumbFile onTitle:(NSString *)onTitle offTitle:(NSString *)offTitle;
 
+/**
+ * Initializes a switch with the sprites of a skin atlas. Such switches can be
+ * drawn together in one draw call by a CCControlSwitchBatchNode.
+ * @param skin The skin of the switch.
+ * @see CCControlSwitchBatchNode
+ */
+- (id)initWithSkin:(CCControlSwitchSkin *)skin;
+
+/**
+ * Creates a switch with the sprites of a skin atlas.
+ *
+ * @see initWithSkin:
+ */
++ (id)switchWithSkin:(CCControlSwitchSkin *)skin;
+
 #pragma mark - Properties
 #pragma mark Setting the Off/On State
 /** @name Setting the Off/On State */
@@ -127,6 +144,28 @@
  */
 @property(nonatomic, assign) ccColor3B onThumbTintColor;
 
+/**
+ * @abstract The skin of the switch.
+ * @discussion nil if the switch was not created with a skin.
+ */
+@property (nonatomic, strong, readonly) CCControlSwitchSkin *skin;
+
 #pragma mark - Public Methods
 
+/**
+ * Removes the masks shared by the switches with the same mask sprite.
+ *
+ * The switches keep their own mask alive, so it is safe to call it at any
+ * time, e.g. when receiving a memory warning.
+ */
++ (void)purgeMaskCache;
+
+/**
+ * Removes the shared masks which are no longer used by a switch, and those
+ * whose source texture has been removed from the CCTextureCache.
+ *
+ * It is called when the application receives a memory warning on iOS.
+ */
++ (void)removeUnusedMasks;
+
 @end
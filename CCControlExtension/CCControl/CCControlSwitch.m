@@ -25,9 +25,31 @@
  */
 
 #import "CCControlSwitch.h"
+#import "CCControlSwitchBatchNode.h"
 #import "ARCMacro.h"
 #import "ccControlShaders.h"
 
+/**
+ * Begins the rendering into the render texture upside down, so the texture is
+ * stored from the top row like the images loaded from files.
+ */
+static inline void ccControlSwitchBeginTopDownRendering(CCRenderTexture *renderTexture, CGFloat height)
+{
+    [renderTexture begin];
+    
+    kmGLPushMatrix();
+    kmGLTranslatef(0, height, 0);
+    kmGLScalef(1, -1, 1);
+}
+
+/** Ends the rendering started with ccControlSwitchBeginTopDownRendering. */
+static inline void ccControlSwitchEndTopDownRendering(CCRenderTexture *renderTexture)
+{
+    kmGLPopMatrix();
+    
+    [renderTexture end];
+}
+
 #pragma mark CCControlSwitchSprite - Interface
 
 @interface CCControlSwitchSprite : CCSprite
@@ -46,6 +68,8 @@
     CCSprite                                *_thumbSprite;
     CCNode<CCLabelProtocol, CCRGBAProtocol> *_onLabel;
     CCNode<CCLabelProtocol, CCRGBAProtocol> *_offLabel;
+    
+    BOOL                                    _contentDirty;
 }
 /** Contains the position (in x-axis) of the slider inside the receiver. */
 @property (nonatomic, assign) CGFloat sliderXPosition;
@@ -71,6 +95,9 @@
 /** Updates the layout using the current state value. */
 - (void)needsLayout;
 
+/** Returns YES if the switch is drawn by a CCControlSwitchBatchNode. */
+- (BOOL)isBatched;
+
 @end
 
 #pragma mark - CCControlSwitch Implementation
@@ -80,19 +107,115 @@
 @property (nonatomic, strong) CCControlSwitchSprite *switchSprite;
 @property (nonatomic, assign) CGFloat               initialTouchXPosition;
 @property (nonatomic, getter = hasMoved) BOOL       moved;
+@property (nonatomic, strong) CCControlSwitchSkin   *skin;
+
+/**
+ * Returns a sprite whose texture can be sampled as the mask of the switch
+ * sprite. The masks are baked once per source texture, rect, tint and
+ * scale, and the source sprite is used as is when it is already a suitable
+ * mask.
+ *
+ * A baked mask is counted as used until releaseMaskTexture: is called with
+ * its texture.
+ */
++ (CCSprite *)maskSpriteWithSprite:(CCSprite *)sprite;
+
+/**
+ * Gives back a use of the baked mask with the given texture. Does nothing
+ * if the texture is not a baked mask.
+ */
++ (void)releaseMaskTexture:(CCTexture2D *)maskTexture;
+
+/**
+ * Returns YES if the texture of the given sprite has an alpha channel and
+ * the same layout as the render texture of the switch sprite, and if the
+ * sprite is drawn untinted, opaque and unscaled.
+ */
++ (BOOL)isSuitableMaskSprite:(CCSprite *)sprite;
+
+@end
+
+/** Everything which changes the baked mask of a mask sprite. */
+typedef struct _ccControlSwitchMaskKey
+{
+    GLuint      textureName;
+    CGRect      rect;
+    BOOL        rotated;
+    BOOL        flipX;
+    BOOL        flipY;
+    ccColor3B   color;
+    GLubyte     opacity;
+    float       scaleX;
+    float       scaleY;
+} ccControlSwitchMaskKey;
+
+/** A baked mask and the number of switch sprites using it. */
+@interface CCControlSwitchMask : NSObject
+{
+@public
+    CCTexture2D *_sourceTexture;    // Retained so its name cannot be reused
+    NSString    *_sourceTextureKey; // nil if not loaded by the CCTextureCache
+    CCTexture2D *_maskTexture;
+    NSUInteger  _useCount;
+}
 
 @end
 
+@implementation CCControlSwitchMask
+
+- (void)dealloc
+{
+    SAFE_ARC_RELEASE(_sourceTexture);
+    SAFE_ARC_RELEASE(_sourceTextureKey);
+    SAFE_ARC_RELEASE(_maskTexture);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+@end
+
+/** The lookup of the mask source textures in the CCTextureCache. */
+@interface CCTextureCache (CCControlSwitch)
+
+/** Returns the key of the given texture, or nil if it is not cached. */
+- (NSString *)ccControlSwitchKeyForTexture:(CCTexture2D *)texture;
+
+@end
+
+@implementation CCTextureCache (CCControlSwitch)
+
+- (NSString *)ccControlSwitchKeyForTexture:(CCTexture2D *)texture
+{
+    __block NSString *key = nil;
+    
+    dispatch_sync(_dictQueue, ^{
+#if COCOS2D_VERSION >= 0x00020100
+        key = [[_textures allKeysForObject:texture] lastObject];
+#else
+        key = [[textures_ allKeysForObject:texture] lastObject];
+#endif
+    });
+    
+    return key;
+}
+
+@end
+
+/** The CCControlSwitchMask by ccControlSwitchMaskKey. */
+static NSMutableDictionary *maskCache = nil;
+
 @implementation CCControlSwitch
 @synthesize switchSprite          = _switchSprite;
 @synthesize initialTouchXPosition = _initialTouchXPosition;
 @synthesize moved                 = _moved;
 @synthesize on                    = _on;
 @synthesize onThumbTintColor      = _onThumbTintColor;
+@synthesize skin                  = _skin;
 
 - (void)dealloc
 {
     SAFE_ARC_RELEASE(_switchSprite);
+    SAFE_ARC_RELEASE(_skin);
     
     SAFE_ARC_SUPER_DEALLOC();
 }
@@ -136,12 +259,7 @@
         _onThumbTintColor = ccGRAY;
         _on               = YES;
         
-        CCRenderTexture *rt = [CCRenderTexture renderTextureWithWidth:maskSprite.contentSize.width height:maskSprite.contentSize.height];
-        [rt begin];
-        maskSprite.position = ccp(maskSprite.contentSize.width / 2, maskSprite.contentSize.height / 2);
-        [maskSprite visit];
-        [rt end];
-        maskSprite = [CCSprite spriteWithTexture:rt.sprite.texture rect:rt.sprite.textureRect];
+        maskSprite = [CCControlSwitch maskSpriteWithSprite:maskSprite];
         
         _switchSprite = [[CCControlSwitchSprite alloc] initWithMaskSprite:maskSprite
                                                                  onSprite:onSprite
@@ -187,6 +305,27 @@
     return [self switchWithMaskSprite:maskSprite onSprite:onSprite offSprite:offSprite thumbSprite:thumbSprite onLabel:onLabel offLabel:offLabel];
 }
 
+- (id)initWithSkin:(CCControlSwitchSkin *)skin
+{
+    NSAssert(skin, @"Skin must not be nil.");
+    
+    // The labels are part of the on/off sprites of the skin
+    if ((self = [self initWithMaskSprite:[skin maskSprite]
+                                onSprite:[skin onSprite]
+                               offSprite:[skin offSprite]
+                             thumbSprite:[skin thumbSprite]
+                                 onLabel:nil
+                                offLabel:nil])) {
+        self.skin = skin;
+    }
+    return self;
+}
+
++ (id)switchWithSkin:(CCControlSwitchSkin *)skin
+{
+    return SAFE_ARC_AUTORELEASE([[self alloc] initWithSkin:skin]);
+}
+
 #pragma mark Properties
 
 - (void)setOn:(BOOL)isOn
@@ -220,6 +359,185 @@
     _switchSprite.opacity = (enabled) ? 255.0f : 128.0f;
 }
 
+#pragma mark CCControlSwitch Public Methods
+
++ (void)purgeMaskCache
+{
+    [maskCache removeAllObjects];
+}
+
++ (void)removeUnusedMasks
+{
+    CCTextureCache *textureCache = [CCTextureCache sharedTextureCache];
+    
+    for (NSValue *key in [maskCache allKeys]) {
+        CCControlSwitchMask *mask = [maskCache objectForKey:key];
+        
+        // Removes the masks used by no switch, and those whose source texture
+        // has been removed from the texture cache
+        if (mask->_useCount == 0
+            || (mask->_sourceTextureKey
+                && [textureCache textureForKey:mask->_sourceTextureKey] != mask->_sourceTexture)) {
+            [maskCache removeObjectForKey:key];
+        }
+    }
+}
+
+- (NSUInteger)fillBatchQuads:(ccControlSwitchQuad *)quads
+{
+    NSAssert(_skin, @"Only the switches created with a skin can be batched.");
+    
+    ccControlSwitchSkinLayout layout = _skin.layout;
+    CCSprite *thumbSprite            = _switchSprite.thumbSprite;
+    ccColor3B color                  = _switchSprite.color;
+    GLubyte opacity                  = _switchSprite.opacity;
+    ccColor3B thumbColor             = thumbSprite.color;
+    GLubyte thumbOpacity             = thumbSprite.opacity;
+    
+    // The batch node blends premultiplied colours
+    return ccControlSwitchFillQuads(&layout,
+                                    _switchSprite.sliderXPosition,
+                                    (ccControlSwitchColor4B) { color.r * opacity / 255, color.g * opacity / 255, color.b * opacity / 255, opacity },
+                                    (ccControlSwitchColor4B) { thumbColor.r * thumbOpacity / 255, thumbColor.g * thumbOpacity / 255, thumbColor.b * thumbOpacity / 255, thumbOpacity },
+                                    quads);
+}
+
+- (void)prepareForEnqueue
+{
+    [super prepareForEnqueue];
+    
+    [_switchSprite stopAllActions];
+}
+
+- (void)prepareForReuse
+{
+    [super prepareForReuse];
+    
+    _moved                          = NO;
+    _onThumbTintColor               = ccGRAY;
+    _switchSprite.thumbSprite.color = ccWHITE;
+    
+    // No target is left to receive the value changed event
+    [self setOn:YES animated:NO];
+}
+
+#pragma mark CCControlSwitch Private Methods
+
++ (CCSprite *)maskSpriteWithSprite:(CCSprite *)sprite
+{
+    if ([self isSuitableMaskSprite:sprite]) {
+        return sprite;
+    }
+    
+    // Zeroed so that the padding bytes compare equal
+    ccControlSwitchMaskKey maskKey;
+    memset(&maskKey, 0, sizeof(maskKey));
+    maskKey.textureName = sprite.texture.name;
+    maskKey.rect        = CC_RECT_POINTS_TO_PIXELS(sprite.textureRect);
+    maskKey.rotated     = sprite.textureRectRotated;
+    maskKey.flipX       = sprite.flipX;
+    maskKey.flipY       = sprite.flipY;
+    maskKey.color       = sprite.color;
+    maskKey.opacity     = sprite.opacity;
+    maskKey.scaleX      = sprite.scaleX;
+    maskKey.scaleY      = sprite.scaleY;
+    
+    NSValue *key = [NSValue valueWithBytes:&maskKey objCType:@encode(ccControlSwitchMaskKey)];
+    
+    if (maskCache == nil) {
+        maskCache = [[NSMutableDictionary alloc] init];
+        
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+        [[NSNotificationCenter defaultCenter] addObserverForName:UIApplicationDidReceiveMemoryWarningNotification
+                                                          object:nil
+                                                           queue:nil
+                                                      usingBlock:^(NSNotification *notification) {
+                                                          [CCControlSwitch removeUnusedMasks];
+                                                      }];
+#endif
+    }
+    
+    CCControlSwitchMask *mask = [maskCache objectForKey:key];
+    CGSize size               = sprite.contentSize;
+    
+    if (mask == nil) {
+        // Bake the mask into a texture with the layout of the switch sprite
+        CCRenderTexture *rt = [CCRenderTexture renderTextureWithWidth:size.width height:size.height];
+        ccControlSwitchBeginTopDownRendering(rt, size.height);
+        sprite.position     = ccp(size.width / 2, size.height / 2);
+        [sprite visit];
+        ccControlSwitchEndTopDownRendering(rt);
+        
+        mask                    = [[CCControlSwitchMask alloc] init];
+        mask->_sourceTexture    = SAFE_ARC_RETAIN(sprite.texture);
+        mask->_sourceTextureKey = SAFE_ARC_RETAIN([[CCTextureCache sharedTextureCache] ccControlSwitchKeyForTexture:sprite.texture]);
+        mask->_maskTexture      = SAFE_ARC_RETAIN(rt.sprite.texture);
+        
+        [maskCache setObject:mask forKey:key];
+        SAFE_ARC_RELEASE(mask);
+    }
+    
+    mask->_useCount++;
+    
+    return [CCSprite spriteWithTexture:mask->_maskTexture rect:CGRectMake(0, 0, size.width, size.height)];
+}
+
++ (void)releaseMaskTexture:(CCTexture2D *)maskTexture
+{
+    for (CCControlSwitchMask *mask in [maskCache objectEnumerator]) {
+        if (mask->_maskTexture == maskTexture) {
+            NSAssert(mask->_useCount > 0, @"The mask is released more often than used.");
+            
+            mask->_useCount--;
+            return;
+        }
+    }
+}
+
++ (BOOL)isSuitableMaskSprite:(CCSprite *)sprite
+{
+    CCTexture2D *texture = sprite.texture;
+    
+    switch (texture.pixelFormat) {
+        case kCCTexture2DPixelFormat_RGBA8888:
+        case kCCTexture2DPixelFormat_RGBA4444:
+        case kCCTexture2DPixelFormat_RGB5A1:
+        case kCCTexture2DPixelFormat_A8:
+        case kCCTexture2DPixelFormat_AI88:
+            break;
+        default:
+            return NO;
+    }
+    
+    if (sprite.textureRectRotated || sprite.flipX || sprite.flipY) {
+        return NO;
+    }
+    
+    // The mask is not drawn, so nothing would apply the tint nor the scale
+    ccColor3B color = sprite.color;
+    if (color.r != 255 || color.g != 255 || color.b != 255 || sprite.opacity != 255
+        || sprite.scaleX != 1.0f || sprite.scaleY != 1.0f) {
+        return NO;
+    }
+    
+    // The mask is sampled with the texture coordinates of the switch sprite,
+    // so it must be the whole texture, sized like the render texture
+    CGRect rect       = CC_RECT_POINTS_TO_PIXELS(sprite.textureRect);
+    CGSize size       = sprite.contentSize;
+    NSUInteger width  = (NSUInteger)((int)size.width * CC_CONTENT_SCALE_FACTOR());
+    NSUInteger height = (NSUInteger)((int)size.height * CC_CONTENT_SCALE_FACTOR());
+    
+    if (![[CCConfiguration sharedConfiguration] supportsNPOT]) {
+        width  = ccNextPOT(width);
+        height = ccNextPOT(height);
+    }
+    
+    return CGPointEqualToPoint(rect.origin, CGPointZero)
+        && CGSizeEqualToSize(rect.size, texture.contentSizeInPixels)
+        && texture.pixelsWide == width
+        && texture.pixelsHigh == height;
+}
+
 #pragma mark CCTargetedTouch Delegate Methods
 
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
@@ -228,7 +546,7 @@
 {
     CGPoint touchLocation = [touch locationInView:[touch view]];                      // Get the touch position
     touchLocation         = [[CCDirector sharedDirector] convertToGL:touchLocation];  // Convert the position to GL space
-    touchLocation         = [self convertToNodeSpace:touchLocation];                  // Convert to the node space of this class
+    touchLocation         = [self convertWorldLocationToNodeSpace:touchLocation];     // Convert to the node space of this class
     
     return touchLocation;
 }
@@ -287,7 +605,7 @@
 - (CGPoint)locationFromEvent:(NSEvent *)event
 {
     CGPoint eventLocation = [[CCDirector sharedDirector] convertEventToGL:event];
-    eventLocation         = [self convertToNodeSpace:eventLocation];
+    eventLocation         = [self convertWorldLocationToNodeSpace:eventLocation];
     
     return eventLocation;
 }
@@ -378,6 +696,8 @@
     SAFE_ARC_RELEASE(_thumbSprite);
     SAFE_ARC_RELEASE(_onLabel);
     SAFE_ARC_RELEASE(_offLabel);
+    
+    [CCControlSwitch releaseMaskTexture:[_maskSprite texture]];
     SAFE_ARC_RELEASE(_maskSprite);
     
     SAFE_ARC_SUPER_DEALLOC();
@@ -442,6 +762,16 @@
     return self;
 }
 
+- (void)onEnter
+{
+    [super onEnter];
+    
+    // The content is not rendered while the switch is batched
+    if (_contentDirty && ![self isBatched]) {
+        [self needsLayout];
+    }
+}
+
 - (void)draw
 {
     CC_NODE_DRAW_SETUP();
@@ -480,10 +810,15 @@
     
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glActiveTexture(GL_TEXTURE0);
+    
+    CC_INCREMENT_GL_DRAWS(1);
 }
 
 - (void)needsLayout
 {
+    // The switch may be drawn from a rasterized image
+    [(CCControl *)self.parent setNeedsRasterize];
+    
     _onSprite.position    = ccp(_onSprite.contentSize.width / 2 + _sliderXPosition,
                                 _onSprite.contentSize.height / 2);
     _offSprite.position   = ccp(_onSprite.contentSize.width + _offSprite.contentSize.width / 2 + _sliderXPosition,
@@ -501,10 +836,16 @@
                                  _offSprite.contentSize.height / 2);
     }
     
+    if ([self isBatched]) {
+        _contentDirty = YES;
+        return;
+    }
+    
     CCRenderTexture *rt = [CCRenderTexture renderTextureWithWidth:_maskSprite.contentSize.width
                                                            height:_maskSprite.contentSize.height];
     
-    [rt             begin];
+    // Rendered top down to be sampled like the mask
+    ccControlSwitchBeginTopDownRendering(rt, _maskSprite.contentSize.height);
     [self.onSprite  visit];
     [self.offSprite visit];
     
@@ -516,10 +857,15 @@
         [_offLabel visit];
     }
     
-    [rt end];
+    ccControlSwitchEndTopDownRendering(rt);
     
-    self.texture = rt.sprite.texture;
-    self.flipY   = YES;
+    self.texture  = rt.sprite.texture;
+    _contentDirty = NO;
+}
+
+- (BOOL)isBatched
+{
+    return [self.parent.parent isKindOfClass:[CCControlSwitchBatchNode class]];
 }
 
 - (void)setSliderXPosition:(CGFloat)sliderXPosition
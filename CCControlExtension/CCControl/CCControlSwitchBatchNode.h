@@ -0,0 +1,151 @@
+/*
+ * CCControlSwitchBatchNode.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlSwitch.h"
+#import "CCControlSwitchQuads.h"
+
+/** Number of quads of a switch: the on side, the off side and the thumb. */
+#define kCCControlSwitchQuadsPerSwitch              3
+
+/** Index of the mask texture coordinates attribute of the batch shader. */
+#define kCCControlSwitchVertexAttrib_MaskCoords     kCCVertexAttrib_MAX
+
+/** Key of the batch shader in the CCShaderCache. */
+#define kCCControlSwitchBatchShaderKey              @"ccControlSwitchBatch"
+
+#pragma mark - CCControlSwitchSkin
+
+/**
+ * CCControlSwitchSkin packs the mask, the on/off sides and the thumb of a
+ * switch into one atlas texture, so the switches using it can be drawn by a
+ * CCControlSwitchBatchNode in one draw call.
+ *
+ * The labels are composited over their side when the atlas is built.
+ */
+@interface CCControlSwitchSkin : NSObject
+{
+@protected
+    CCTexture2D                 *_texture;
+    ccControlSwitchSkinLayout   _layout;
+    
+    CGRect                      _maskRect;
+    CGRect                      _onRect;
+    CGRect                      _offRect;
+    CGRect                      _thumbRect;
+}
+/** The atlas texture. */
+@property (nonatomic, readonly) CCTexture2D                 *texture;
+/** The layout of the parts of the switch in the atlas. */
+@property (nonatomic, readonly) ccControlSwitchSkinLayout   layout;
+
+#pragma mark Contructors - Initializers
+
+/**
+ * Initializes a skin by packing the given parts of a switch. The sprites and
+ * the labels are only used to build the atlas.
+ *
+ * @param maskSprite The sprite used as mask to hide on/off sprites.
+ * @param onSprite The sprite displayed when the switch is in the on position.
+ * @param offSprite The sprite displayed when the switch is in the off position.
+ * @param thumbSprite The sprite used for the thumb.
+ * @param onLabel The label displayed over the onSprite, or nil.
+ * @param offLabel The label displayed over the offSprite, or nil.
+ */
+- (id)initWithMaskSprite:(CCSprite *)maskSprite onSprite:(CCSprite *)onSprite offSprite:(CCSprite *)offSprite thumbSprite:(CCSprite *)thumbSprite onLabel:(CCNode *)onLabel offLabel:(CCNode *)offLabel;
+
+/**
+ * Creates a skin by packing the given parts of a switch.
+ *
+ * @see initWithMaskSprite:onSprite:offSprite:thumbSprite:onLabel:offLabel:
+ */
++ (id)skinWithMaskSprite:(CCSprite *)maskSprite onSprite:(CCSprite *)onSprite offSprite:(CCSprite *)offSprite thumbSprite:(CCSprite *)thumbSprite onLabel:(CCNode *)onLabel offLabel:(CCNode *)offLabel;
+
+#pragma mark Public Methods
+
+/** Returns a new sprite displaying the mask from the atlas. */
+- (CCSprite *)maskSprite;
+
+/** Returns a new sprite displaying the on side and its label from the atlas. */
+- (CCSprite *)onSprite;
+
+/** Returns a new sprite displaying the off side and its label from the atlas. */
+- (CCSprite *)offSprite;
+
+/** Returns a new sprite displaying the thumb from the atlas. */
+- (CCSprite *)thumbSprite;
+
+@end
+
+#pragma mark - CCControlSwitchBatchNode
+
+/**
+ * CCControlSwitchBatchNode draws all its switches in one draw call, or in
+ * one draw call per 16384 quads (5461 switches) as the quads are indexed
+ * with GLushort.
+ *
+ * Its children must be CCControlSwitch objects created with the skin of the
+ * batch node. They are drawn in the order of their z-order, and their own
+ * children are not drawn.
+ */
+@interface CCControlSwitchBatchNode : CCNode <CCBlendProtocol>
+{
+@protected
+    CCControlSwitchSkin *_skin;
+    ccBlendFunc         _blendFunc;
+    
+    ccControlSwitchQuad *_quads;
+    GLushort            *_indices;
+    NSUInteger          _capacity;
+}
+/** The skin of the switches. */
+@property (nonatomic, readonly) CCControlSwitchSkin *skin;
+/** The blend function, for premultiplied colours by default. */
+@property (nonatomic, assign) ccBlendFunc           blendFunc;
+
+#pragma mark Contructors - Initializers
+
+/** Initializes a batch node drawing the switches with the given skin. */
+- (id)initWithSkin:(CCControlSwitchSkin *)skin;
+
+/** Creates a batch node drawing the switches with the given skin. */
++ (id)batchNodeWithSkin:(CCControlSwitchSkin *)skin;
+
+@end
+
+#pragma mark - CCControlSwitch Batching
+
+@interface CCControlSwitch (CCControlSwitchBatchNode)
+
+/**
+ * Fills the quads of the switch in its own coordinates, using its current
+ * state.
+ *
+ * @return The number of filled quads.
+ * @see ccControlSwitchFillQuads
+ */
+- (NSUInteger)fillBatchQuads:(ccControlSwitchQuad *)quads;
+
+@end
@@ -0,0 +1,409 @@
+/*
+ * CCControlSwitchBatchNode.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlSwitchBatchNode.h"
+#import "ARCMacro.h"
+#import "ccControlShaders.h"
+
+/** Space between the regions of the skin atlas, in points. */
+#define kCCControlSwitchSkinPadding     2
+/** Size of the opaque region of the skin atlas, in points. */
+#define kCCControlSwitchSkinOpaqueSize  4
+
+/** Returns the size with the layout of the C quad functions. */
+static inline ccControlSwitchSize ccControlSwitchSizeFromCGSize(CGSize size)
+{
+    return (ccControlSwitchSize) { size.width, size.height };
+}
+
+/** Returns the region with the layout of the C quad functions. */
+static inline ccControlSwitchRegion ccControlSwitchRegionFromCGRect(CGRect rect)
+{
+    return (ccControlSwitchRegion) { rect.origin.x, rect.origin.y, rect.size.width, rect.size.height };
+}
+
+#pragma mark - CCControlSwitchSkin Implementation
+
+@interface CCControlSwitchSkin ()
+
+/**
+ * Draws the node over the given rect of the atlas being rendered, the rect
+ * origin being its top left corner. The drawing is clipped to the rect.
+ *
+ * @param node The node to draw, at the top left corner of the rect if it is
+ * not a label. Its anchor point, position and blend function are restored
+ * once drawn.
+ * @param rect The rect of the atlas, in points.
+ * @param atlasHeight The height of the atlas, in points.
+ */
+- (void)drawNode:(CCNode *)node inRect:(CGRect)rect atlasHeight:(CGFloat)atlasHeight;
+
+/** Returns the texture coordinates of a rect of the atlas given in points. */
+- (CGRect)regionWithRect:(CGRect)rect;
+
+@end
+
+@implementation CCControlSwitchSkin
+@synthesize texture = _texture;
+@synthesize layout  = _layout;
+
+- (void)dealloc
+{
+    SAFE_ARC_RELEASE(_texture);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+- (id)initWithMaskSprite:(CCSprite *)maskSprite onSprite:(CCSprite *)onSprite offSprite:(CCSprite *)offSprite thumbSprite:(CCSprite *)thumbSprite onLabel:(CCNode *)onLabel offLabel:(CCNode *)offLabel
+{
+    if ((self = [super init])) {
+        NSAssert(maskSprite,  @"Mask must not be nil.");
+        NSAssert(onSprite,    @"onSprite must not be nil.");
+        NSAssert(offSprite,   @"offSprite must not be nil.");
+        NSAssert(thumbSprite, @"thumbSprite must not be nil.");
+        
+        _layout.maskSize  = ccControlSwitchSizeFromCGSize(maskSprite.contentSize);
+        _layout.onSize    = ccControlSwitchSizeFromCGSize(onSprite.contentSize);
+        _layout.offSize   = ccControlSwitchSizeFromCGSize(offSprite.contentSize);
+        _layout.thumbSize = ccControlSwitchSizeFromCGSize(thumbSprite.contentSize);
+        
+        // Place the regions side by side
+        CGFloat padding   = kCCControlSwitchSkinPadding;
+        CGFloat x         = padding;
+        
+        _maskRect         = CGRectMake(x, padding, ceilf(_layout.maskSize.width), ceilf(_layout.maskSize.height));
+        x                 += _maskRect.size.width + padding;
+        _onRect           = CGRectMake(x, padding, ceilf(_layout.onSize.width), ceilf(_layout.onSize.height));
+        x                 += _onRect.size.width + padding;
+        _offRect          = CGRectMake(x, padding, ceilf(_layout.offSize.width), ceilf(_layout.offSize.height));
+        x                 += _offRect.size.width + padding;
+        _thumbRect        = CGRectMake(x, padding, ceilf(_layout.thumbSize.width), ceilf(_layout.thumbSize.height));
+        x                 += _thumbRect.size.width + padding;
+        CGRect opaqueRect = CGRectMake(x, padding, kCCControlSwitchSkinOpaqueSize, kCCControlSwitchSkinOpaqueSize);
+        x                 += opaqueRect.size.width + padding;
+        
+        CGFloat height    = MAX(MAX(_maskRect.size.height, _onRect.size.height), MAX(_offRect.size.height, _thumbRect.size.height));
+        height            = MAX(height, opaqueRect.size.height) + padding * 2;
+        
+        // Render the atlas top down to store it like the images
+        CCRenderTexture *rt = [CCRenderTexture renderTextureWithWidth:x height:height];
+        [rt begin];
+        kmGLPushMatrix();
+        kmGLTranslatef(0, height, 0);
+        kmGLScalef(1, -1, 1);
+        
+        [self drawNode:maskSprite inRect:_maskRect atlasHeight:height];
+        [self drawNode:onSprite inRect:_onRect atlasHeight:height];
+        [self drawNode:offSprite inRect:_offRect atlasHeight:height];
+        [self drawNode:thumbSprite inRect:_thumbRect atlasHeight:height];
+        
+        // Same label positions as CCControlSwitchSprite -needsLayout,
+        // and the labels are put back where the caller placed them
+        if (onLabel) {
+            CGPoint position  = onLabel.position;
+            onLabel.position  = ccp(_onRect.origin.x + _layout.onSize.width / 2 - _layout.thumbSize.width / 6,
+                                    height - _onRect.origin.y - _layout.onSize.height / 2);
+            [self drawNode:onLabel inRect:_onRect atlasHeight:height];
+            onLabel.position  = position;
+        }
+        
+        if (offLabel) {
+            CGPoint position  = offLabel.position;
+            offLabel.position = ccp(_offRect.origin.x + _layout.offSize.width / 2 + _layout.thumbSize.width / 6,
+                                    height - _offRect.origin.y - _layout.offSize.height / 2);
+            [self drawNode:offLabel inRect:_offRect atlasHeight:height];
+            offLabel.position = position;
+        }
+        
+        ccDrawSolidRect(ccp(opaqueRect.origin.x, height - CGRectGetMaxY(opaqueRect)),
+                        ccp(CGRectGetMaxX(opaqueRect), height - opaqueRect.origin.y),
+                        ccc4f(1, 1, 1, 1));
+        
+        kmGLPopMatrix();
+        [rt end];
+        
+        _texture = SAFE_ARC_RETAIN(rt.sprite.texture);
+        
+        _layout.maskRegion   = ccControlSwitchRegionFromCGRect([self regionWithRect:CGRectMake(_maskRect.origin.x, _maskRect.origin.y, _layout.maskSize.width, _layout.maskSize.height)]);
+        _layout.onRegion     = ccControlSwitchRegionFromCGRect([self regionWithRect:CGRectMake(_onRect.origin.x, _onRect.origin.y, _layout.onSize.width, _layout.onSize.height)]);
+        _layout.offRegion    = ccControlSwitchRegionFromCGRect([self regionWithRect:CGRectMake(_offRect.origin.x, _offRect.origin.y, _layout.offSize.width, _layout.offSize.height)]);
+        _layout.thumbRegion  = ccControlSwitchRegionFromCGRect([self regionWithRect:CGRectMake(_thumbRect.origin.x, _thumbRect.origin.y, _layout.thumbSize.width, _layout.thumbSize.height)]);
+        _layout.opaqueRegion = ccControlSwitchRegionFromCGRect([self regionWithRect:opaqueRect]);
+    }
+    return self;
+}
+
++ (id)skinWithMaskSprite:(CCSprite *)maskSprite onSprite:(CCSprite *)onSprite offSprite:(CCSprite *)offSprite thumbSprite:(CCSprite *)thumbSprite onLabel:(CCNode *)onLabel offLabel:(CCNode *)offLabel
+{
+    return SAFE_ARC_AUTORELEASE([[self alloc] initWithMaskSprite:maskSprite onSprite:onSprite offSprite:offSprite thumbSprite:thumbSprite onLabel:onLabel offLabel:offLabel]);
+}
+
+#pragma mark CCControlSwitchSkin Public Methods
+
+- (CCSprite *)maskSprite
+{
+    return [CCSprite spriteWithTexture:_texture rect:CGRectMake(_maskRect.origin.x, _maskRect.origin.y, _layout.maskSize.width, _layout.maskSize.height)];
+}
+
+- (CCSprite *)onSprite
+{
+    return [CCSprite spriteWithTexture:_texture rect:CGRectMake(_onRect.origin.x, _onRect.origin.y, _layout.onSize.width, _layout.onSize.height)];
+}
+
+- (CCSprite *)offSprite
+{
+    return [CCSprite spriteWithTexture:_texture rect:CGRectMake(_offRect.origin.x, _offRect.origin.y, _layout.offSize.width, _layout.offSize.height)];
+}
+
+- (CCSprite *)thumbSprite
+{
+    return [CCSprite spriteWithTexture:_texture rect:CGRectMake(_thumbRect.origin.x, _thumbRect.origin.y, _layout.thumbSize.width, _layout.thumbSize.height)];
+}
+
+#pragma mark CCControlSwitchSkin Private Methods
+
+- (void)drawNode:(CCNode *)node inRect:(CGRect)rect atlasHeight:(CGFloat)atlasHeight
+{
+    // The atlas is rendered top down, so the rows of the framebuffer go down
+    CGFloat scale = CC_CONTENT_SCALE_FACTOR();
+    
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(rect.origin.x * scale, rect.origin.y * scale, rect.size.width * scale, rect.size.height * scale);
+    
+    if ([node isKindOfClass:[CCSprite class]] && ![node conformsToProtocol:@protocol(CCLabelProtocol)]) {
+        // Copy the sprites, alpha included, instead of blending them
+        CCSprite *sprite        = (CCSprite *)node;
+        ccBlendFunc blendFunc   = sprite.blendFunc;
+        CGPoint anchorPoint     = sprite.anchorPoint;
+        CGPoint position        = sprite.position;
+        
+        sprite.anchorPoint      = ccp(0.5f, 0.5f);
+        sprite.position         = ccp(rect.origin.x + sprite.contentSize.width / 2,
+                                      atlasHeight - rect.origin.y - sprite.contentSize.height / 2);
+        sprite.blendFunc        = (ccBlendFunc) { GL_ONE, GL_ZERO };
+        [sprite visit];
+        sprite.blendFunc        = blendFunc;
+        sprite.anchorPoint      = anchorPoint;
+        sprite.position         = position;
+    }
+    else {
+        [node visit];
+    }
+    
+    glDisable(GL_SCISSOR_TEST);
+}
+
+- (CGRect)regionWithRect:(CGRect)rect
+{
+    CGRect pixels = CC_RECT_POINTS_TO_PIXELS(rect);
+    
+    return CGRectMake(pixels.origin.x / _texture.pixelsWide, pixels.origin.y / _texture.pixelsHigh,
+                      pixels.size.width / _texture.pixelsWide, pixels.size.height / _texture.pixelsHigh);
+}
+
+@end
+
+#pragma mark - CCControlSwitchBatchNode Implementation
+
+/** Number of quads which can be indexed with GLushort, drawn by each draw call. */
+#define kCCControlSwitchMaxQuadsPerDraw ((USHRT_MAX + 1) / 4)
+
+@interface CCControlSwitchBatchNode ()
+
+/** Grows the quads to hold the quads of the given number of switches, and
+ the indices to draw them, kCCControlSwitchMaxQuadsPerDraw at a time. */
+- (void)ensureCapacity:(NSUInteger)switchCount;
+
+@end
+
+@implementation CCControlSwitchBatchNode
+@synthesize skin      = _skin;
+@synthesize blendFunc = _blendFunc;
+
+- (void)dealloc
+{
+    free(_quads);
+    free(_indices);
+    
+    SAFE_ARC_RELEASE(_skin);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+- (id)initWithSkin:(CCControlSwitchSkin *)skin
+{
+    if ((self = [super init])) {
+        NSAssert(skin, @"Skin must not be nil.");
+        
+        _skin      = SAFE_ARC_RETAIN(skin);
+        _blendFunc = (ccBlendFunc) { GL_ONE, GL_ONE_MINUS_SRC_ALPHA };
+        
+        // The batch shader is shared by the batch nodes
+        CCGLProgram *program = [[CCShaderCache sharedShaderCache] programForKey:kCCControlSwitchBatchShaderKey];
+        
+        if (program == nil) {
+            program = [[CCGLProgram alloc] initWithVertexShaderByteArray:ccControlSwitchBatch_vert
+                                                 fragmentShaderByteArray:ccControlSwitchBatch_frag];
+            
+            [program addAttribute:kCCAttributeNamePosition index:kCCVertexAttrib_Position];
+            [program addAttribute:kCCAttributeNameColor    index:kCCVertexAttrib_Color];
+            [program addAttribute:kCCAttributeNameTexCoord index:kCCVertexAttrib_TexCoords];
+            [program addAttribute:@"a_maskCoord"           index:kCCControlSwitchVertexAttrib_MaskCoords];
+            CHECK_GL_ERROR_DEBUG();
+            
+            [program link];
+            [program updateUniforms];
+            CHECK_GL_ERROR_DEBUG();
+            
+            [[CCShaderCache sharedShaderCache] addProgram:program forKey:kCCControlSwitchBatchShaderKey];
+            SAFE_ARC_RELEASE(program);
+        }
+        
+        self.shaderProgram = program;
+    }
+    return self;
+}
+
++ (id)batchNodeWithSkin:(CCControlSwitchSkin *)skin
+{
+    return SAFE_ARC_AUTORELEASE([[self alloc] initWithSkin:skin]);
+}
+
+- (void)addChild:(CCNode *)child z:(NSInteger)z tag:(NSInteger)tag
+{
+    NSAssert([child isKindOfClass:[CCControlSwitch class]], @"CCControlSwitchBatchNode only supports CCControlSwitch children.");
+    NSAssert([(CCControlSwitch *)child skin] == _skin, @"The switch must use the skin of the batch node.");
+    
+    [super addChild:child z:z tag:tag];
+}
+
+- (void)visit
+{
+    if (![self visible]) {
+        return;
+    }
+    
+    kmGLPushMatrix();
+    
+    [self transform];
+    [self sortAllChildren];
+    [self draw];
+    
+    kmGLPopMatrix();
+    
+    self.orderOfArrival = 0;
+}
+
+- (void)draw
+{
+    // Accessors rather than ivars, which cocos2d v2.1 has renamed
+    CCArray *children = [self children];
+    
+    [self ensureCapacity:[children count]];
+    
+    NSUInteger count = 0;
+    
+    for (CCControlSwitch *switchControl in children) {
+        if (![switchControl visible]) {
+            continue;
+        }
+        
+        // The switches are not visited
+        [switchControl resolveCascade];
+        
+        NSUInteger quadCount = [switchControl fillBatchQuads:&_quads[count]];
+        CGAffineTransform t  = [switchControl nodeToParentTransform];
+        ccControlSwitchTransformQuads(&_quads[count], quadCount, (ccControlSwitchTransform) { t.a, t.b, t.c, t.d, t.tx, t.ty });
+        count += quadCount;
+    }
+    
+    if (count == 0) {
+        return;
+    }
+    
+    CC_NODE_DRAW_SETUP();
+    
+    ccGLBlendFunc(_blendFunc.src, _blendFunc.dst);
+    ccGLBindTexture2D([_skin.texture name]);
+    ccGLEnableVertexAttribs(kCCVertexAttribFlag_PosColorTex);
+    glEnableVertexAttribArray(kCCControlSwitchVertexAttrib_MaskCoords);
+    
+#define kVertexSize sizeof(ccControlSwitchVertex)
+    NSUInteger drawCount = 0;
+    
+    // The GLushort indices address kCCControlSwitchMaxQuadsPerDraw quads at most,
+    // so the larger batches are drawn in several calls
+    for (NSUInteger first = 0; first < count; first += kCCControlSwitchMaxQuadsPerDraw) {
+        NSUInteger quadCount = MIN(count - first, kCCControlSwitchMaxQuadsPerDraw);
+        long offset          = (long)&_quads[first];
+        
+        glVertexAttribPointer(kCCVertexAttrib_Position, 2, GL_FLOAT, GL_FALSE, kVertexSize, (void *)(offset + offsetof(ccControlSwitchVertex, vertices)));
+        glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, kVertexSize, (void *)(offset + offsetof(ccControlSwitchVertex, colors)));
+        glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, kVertexSize, (void *)(offset + offsetof(ccControlSwitchVertex, texCoords)));
+        glVertexAttribPointer(kCCControlSwitchVertexAttrib_MaskCoords, 2, GL_FLOAT, GL_FALSE, kVertexSize, (void *)(offset + offsetof(ccControlSwitchVertex, maskCoords)));
+        
+        glDrawElements(GL_TRIANGLES, (GLsizei)quadCount * 6, GL_UNSIGNED_SHORT, _indices);
+        drawCount++;
+    }
+    
+    // The state cache only tracks the attributes of cocos2d
+    glDisableVertexAttribArray(kCCControlSwitchVertexAttrib_MaskCoords);
+    
+    CC_INCREMENT_GL_DRAWS(drawCount);
+}
+
+#pragma mark CCControlSwitchBatchNode Private Methods
+
+- (void)ensureCapacity:(NSUInteger)switchCount
+{
+    NSUInteger capacity = switchCount * kCCControlSwitchQuadsPerSwitch;
+    
+    if (capacity <= _capacity) {
+        return;
+    }
+    
+    _quads = realloc(_quads, capacity * sizeof(ccControlSwitchQuad));
+    
+    // The indices are the same for every draw call
+    NSUInteger indexedQuads = MIN(capacity, kCCControlSwitchMaxQuadsPerDraw);
+    
+    if (indexedQuads > MIN(_capacity, kCCControlSwitchMaxQuadsPerDraw)) {
+        _indices = realloc(_indices, indexedQuads * 6 * sizeof(GLushort));
+    }
+    
+    for (NSUInteger i = MIN(_capacity, kCCControlSwitchMaxQuadsPerDraw); i < indexedQuads; i++) {
+        _indices[i * 6 + 0] = i * 4 + 0;
+        _indices[i * 6 + 1] = i * 4 + 1;
+        _indices[i * 6 + 2] = i * 4 + 2;
+        _indices[i * 6 + 3] = i * 4 + 3;
+        _indices[i * 6 + 4] = i * 4 + 2;
+        _indices[i * 6 + 5] = i * 4 + 1;
+    }
+    
+    _capacity = capacity;
+}
+
+@end
@@ -29,6 +29,8 @@ extern "C" {
 #endif // __cplusplus__
 
 extern const GLchar * ccControlSwitchMask_frag;
+extern const GLchar * ccControlSwitchBatch_vert;
+extern const GLchar * ccControlSwitchBatch_frag;
     
 #ifdef __cplusplus__
 }
@@ -27,4 +27,10 @@
 #import "ccControlShaders.h"
 
 const GLchar * ccControlSwitchMask_frag =
-#import "ccShader_ControlSwitchMask_frag.h"
\ No newline at end of file
+#import "ccShader_ControlSwitchMask_frag.h"
+
+const GLchar * ccControlSwitchBatch_vert =
+#import "ccShader_ControlSwitchBatch_vert.h"
+
+const GLchar * ccControlSwitchBatch_frag =
+#import "ccShader_ControlSwitchBatch_frag.h"
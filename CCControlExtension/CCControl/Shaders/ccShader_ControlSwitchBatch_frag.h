@@ -0,0 +1,43 @@
+/*
+ * ccShader_ControlSwitchBatch_frag.h
+ *
+ * Copyright 2013 Yannick Loriot.
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+"                                                                                       \n\
+#ifdef GL_ES                                                                            \n\
+precision lowp float;                                                                   \n\
+#endif                                                                                  \n\
+                                                                                        \n\
+varying vec4        v_fragmentColor;                                                    \n\
+varying vec2        v_texCoord;                                                         \n\
+varying vec2        v_maskCoord;                                                        \n\
+uniform sampler2D   u_texture;                                                          \n\
+                                                                                        \n\
+void main()                                                                             \n\
+{                                                                                       \n\
+vec4 texColor   = texture2D(u_texture, v_texCoord);                                     \n\
+vec4 maskColor  = texture2D(u_texture, v_maskCoord);                                    \n\
+gl_FragColor    = v_fragmentColor * texColor * maskColor.a;                             \n\
+}                                                                                       \n\
+";
@@ -0,0 +1,52 @@
+/*
+ * ccShader_ControlSwitchBatch_vert.h
+ *
+ * Copyright 2013 Yannick Loriot.
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+"                                                                                       \n\
+attribute vec4      a_position;                                                         \n\
+attribute vec2      a_texCoord;                                                         \n\
+attribute vec2      a_maskCoord;                                                        \n\
+attribute vec4      a_color;                                                            \n\
+                                                                                        \n\
+uniform mat4        u_MVPMatrix;                                                        \n\
+                                                                                        \n\
+#ifdef GL_ES                                                                            \n\
+varying lowp vec4   v_fragmentColor;                                                    \n\
+varying mediump vec2 v_texCoord;                                                        \n\
+varying mediump vec2 v_maskCoord;                                                       \n\
+#else                                                                                   \n\
+varying vec4        v_fragmentColor;                                                    \n\
+varying vec2        v_texCoord;                                                         \n\
+varying vec2        v_maskCoord;                                                        \n\
+#endif                                                                                  \n\
+                                                                                        \n\
+void main()                                                                             \n\
+{                                                                                       \n\
+gl_Position     = u_MVPMatrix * a_position;                                             \n\
+v_fragmentColor = a_color;                                                              \n\
+v_texCoord      = a_texCoord;                                                           \n\
+v_maskCoord     = a_maskCoord;                                                          \n\
+}                                                                                       \n\
+";
@@ -0,0 +1,217 @@
+/*
+ * CCColourPickerFill.c
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "CCColourPickerFill.h"
+
+#include <math.h>
+
+/** Radius of the white disc of the hue wheel, relative to its size. */
+#define kCCColourPickerHueDiscRatio         0.4855f
+/** Outer radius of the ring of hues, relative to the wheel size. */
+#define kCCColourPickerHueOuterRatio        0.4548f
+/** Inner radius of the ring of hues, relative to the wheel size. */
+#define kCCColourPickerHueInnerRatio        0.3645f
+/** Radius between the white and the black rings of the marker. */
+#define kCCColourPickerMarkerMiddleRatio    0.77f
+/** Radius of the hole of the marker. */
+#define kCCColourPickerMarkerInnerRatio     0.54f
+/** Opacity of the black ring of the marker. */
+#define kCCColourPickerMarkerShadowOpacity  0.3f
+/** Half base of the arrow, relative to its height. */
+#define kCCColourPickerArrowHalfBaseRatio   0.19f
+/** Degrees per radian, the factor of CC_RADIANS_TO_DEGREES. */
+#define kCCColourPickerDegreesPerRadian     57.29577951f
+
+/**
+ * Returns how much of the pixel at the given distance from a center is
+ * covered by a disc of the given radius.
+ */
+static inline float ccColourPickerCoverage(float distance, float radius)
+{
+    return fminf(fmaxf(radius - distance + 0.5f, 0.0f), 1.0f);
+}
+
+/** Converts a percent value to a byte, rounding to the nearest. */
+static inline uint8_t ccColourPickerByte(float value)
+{
+    return (uint8_t)(value * 255.0f + 0.5f);
+}
+
+/** Computes the vector from the center of a square buffer to the center of
+ the given pixel, with the y axis pointing up. */
+static inline void ccColourPickerPixelOffset(size_t x, size_t y, size_t size, float *dx, float *dy)
+{
+    float center = size / 2.0f;
+    
+    *dx = x + 0.5f - center;
+    *dy = center - (y + 0.5f);
+}
+
+/** Computes the fully saturated and bright colour of the given hue, as
+ CCColourUtils does. */
+static inline void ccColourPickerHueColour(float hue, float *r, float *g, float *b)
+{
+    // The hues just below 360 may round up to the sixth sector, which is the first one
+    float hh = hue / 60.0f;
+    hh       = (hh >= 6.0f) ? 0.0f : hh;
+    long  i  = (long)hh;
+    float t  = hh - i;
+    float q  = 1.0f - t;
+    
+    switch (i) {
+        case 0:  *r = 1; *g = t; *b = 0; break;
+        case 1:  *r = q; *g = 1; *b = 0; break;
+        case 2:  *r = 0; *g = 1; *b = t; break;
+        case 3:  *r = 0; *g = q; *b = 1; break;
+        case 4:  *r = t; *g = 0; *b = 1; break;
+        default: *r = 1; *g = 0; *b = q; break;
+    }
+}
+
+void ccColourPickerFillHueWheel(uint8_t *pixels, size_t size)
+{
+    float discRadius  = size * kCCColourPickerHueDiscRatio;
+    float outerRadius = size * kCCColourPickerHueOuterRatio;
+    float innerRadius = size * kCCColourPickerHueInnerRatio;
+    
+    for (size_t y = 0; y < size; y++) {
+        for (size_t x = 0; x < size; x++) {
+            float dx, dy, r, g, b;
+            ccColourPickerPixelOffset(x, y, size, &dx, &dy);
+            
+            // The hue goes from 0 on the left to 180 on the right through the bottom
+            ccColourPickerHueColour(atan2f(dy, dx) * kCCColourPickerDegreesPerRadian + 180.0f, &r, &g, &b);
+            
+            float distance   = sqrtf(dx * dx + dy * dy);
+            float ring       = ccColourPickerCoverage(distance, outerRadius) * (1.0f - ccColourPickerCoverage(distance, innerRadius));
+            uint8_t *pixel   = &pixels[(y * size + x) * 4];
+            
+            // The ring of hues lies on a white disc
+            pixel[0] = ccColourPickerByte(1.0f - ring + r * ring);
+            pixel[1] = ccColourPickerByte(1.0f - ring + g * ring);
+            pixel[2] = ccColourPickerByte(1.0f - ring + b * ring);
+            pixel[3] = ccColourPickerByte(ccColourPickerCoverage(distance, discRadius));
+        }
+    }
+}
+
+void ccColourPickerFillTintBackground(uint8_t *pixels, size_t size)
+{
+    float radius = size / 2.0f;
+    
+    for (size_t y = 0; y < size; y++) {
+        for (size_t x = 0; x < size; x++) {
+            float dx, dy;
+            ccColourPickerPixelOffset(x, y, size, &dx, &dy);
+            
+            uint8_t *pixel = &pixels[(y * size + x) * 4];
+            
+            pixel[0] = 255;
+            pixel[1] = 255;
+            pixel[2] = 255;
+            pixel[3] = ccColourPickerByte(ccColourPickerCoverage(sqrtf(dx * dx + dy * dy), radius));
+        }
+    }
+}
+
+void ccColourPickerFillTintOverlay(uint8_t *pixels, size_t size, float boxInset)
+{
+    float radius  = size / 2.0f;
+    float limit   = size / 2.0f;
+    float boxSize = size - boxInset * 2;
+    
+    for (size_t y = 0; y < size; y++) {
+        for (size_t x = 0; x < size; x++) {
+            float dx, dy;
+            ccColourPickerPixelOffset(x, y, size, &dx, &dy);
+            
+            uint8_t *pixel = &pixels[(y * size + x) * 4];
+            
+            // Same mapping as CCControlSaturationBrightnessPicker
+            float saturation = 1.0f - fminf(fmaxf((dx + limit - boxInset) / boxSize, 0.0f), 1.0f);
+            float brightness = fminf(fmaxf((dy + limit - boxInset) / boxSize, 0.0f), 1.0f);
+            
+            // Blended over the hue H, a grey G with the alpha A gives
+            // A * G + (1 - A) * H, which is v * (1 - s) + v * s * H
+            float alpha = 1.0f - brightness * saturation;
+            float grey  = (alpha > 0.0f) ? brightness * (1.0f - saturation) / alpha : 0.0f;
+            
+            pixel[0] = ccColourPickerByte(grey);
+            pixel[1] = pixel[0];
+            pixel[2] = pixel[0];
+            pixel[3] = ccColourPickerByte(alpha * ccColourPickerCoverage(sqrtf(dx * dx + dy * dy), radius));
+        }
+    }
+}
+
+void ccColourPickerFillMarker(uint8_t *pixels, size_t size)
+{
+    float outerRadius  = size / 2.0f;
+    float middleRadius = size / 2.0f * kCCColourPickerMarkerMiddleRatio;
+    float innerRadius  = size / 2.0f * kCCColourPickerMarkerInnerRatio;
+    
+    for (size_t y = 0; y < size; y++) {
+        for (size_t x = 0; x < size; x++) {
+            float dx, dy;
+            ccColourPickerPixelOffset(x, y, size, &dx, &dy);
+            
+            float distance = sqrtf(dx * dx + dy * dy);
+            uint8_t *pixel = &pixels[(y * size + x) * 4];
+            
+            float white    = 1.0f - ccColourPickerCoverage(distance, middleRadius);
+            float ring     = ccColourPickerCoverage(distance, outerRadius) * (1.0f - ccColourPickerCoverage(distance, innerRadius));
+            
+            // A white ring around a translucent black ring
+            pixel[0] = ccColourPickerByte(white);
+            pixel[1] = pixel[0];
+            pixel[2] = pixel[0];
+            pixel[3] = ccColourPickerByte(ring * (white + (1.0f - white) * kCCColourPickerMarkerShadowOpacity));
+        }
+    }
+}
+
+void ccColourPickerFillArrow(uint8_t *pixels, size_t width, size_t height)
+{
+    // A triangle with its base on the left edge and its tip in the middle
+    float tipX     = width / 2.0f;
+    float centerY  = height / 2.0f;
+    float halfBase = height * kCCColourPickerArrowHalfBaseRatio;
+    float cosine   = tipX / sqrtf(tipX * tipX + halfBase * halfBase);
+    
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            float px       = x + 0.5f;
+            float py       = y + 0.5f;
+            float distance = (halfBase * (1.0f - px / tipX) - fabsf(py - centerY)) * cosine;
+            uint8_t *pixel = &pixels[(y * width + x) * 4];
+            
+            pixel[0] = 255;
+            pixel[1] = 255;
+            pixel[2] = 255;
+            pixel[3] = ccColourPickerByte(fminf(fmaxf(distance + 0.5f, 0.0f), 1.0f));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * CCColourPickerFill.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef CCColourPickerFill_h
+#define CCColourPickerFill_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The fill functions draw the colour picker textures into RGBA8888 buffers
+ * with straight alpha, the first row being the top of the image.
+ *
+ * The tint overlay is drawn so that, blended over the tint background
+ * coloured with a hue, each pixel takes the colour of the hue with the
+ * saturation and the brightness read by the picker at this location.
+ *
+ * This header is shared with the cccolourpickercheck tool
+ * (tools/cccolourpickercheck) and must stay plain C.
+ */
+
+/** Fills a size x size buffer with the hue wheel. */
+void ccColourPickerFillHueWheel(uint8_t *pixels, size_t size);
+
+/** Fills a size x size buffer with the tint background. */
+void ccColourPickerFillTintBackground(uint8_t *pixels, size_t size);
+
+/**
+ * Fills a size x size buffer with the tint overlay.
+ *
+ * @param boxInset The inset of the saturation/brightness box, in pixels.
+ */
+void ccColourPickerFillTintOverlay(uint8_t *pixels, size_t size, float boxInset);
+
+/** Fills a size x size buffer with the marker. */
+void ccColourPickerFillMarker(uint8_t *pixels, size_t size);
+
+/** Fills a width x height buffer with the arrow. */
+void ccColourPickerFillArrow(uint8_t *pixels, size_t width, size_t height);
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * CCColourPickerTextures.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+#import "CCColourPickerFill.h"
+
+/** Inset of the saturation/brightness box into the default tint disc, in points. */
+#define kCCColourPickerTintBoxInset         20
+
+/** Size of the default colour picker, in points. */
+#define kCCColourPickerDefaultDiameter      166.0f
+/** Diameter of the tint disc relative to the hue wheel. */
+#define kCCColourPickerTintDiameterRatio    (110.0f / 166.0f)
+/** Diameter of the marker relative to the hue wheel. */
+#define kCCColourPickerMarkerDiameterRatio  (13.0f / 166.0f)
+/** Width of the arrow relative to the hue wheel, its height being twice as much. */
+#define kCCColourPickerArrowWidthRatio      (13.0f / 166.0f)
+/** Inset of the saturation/brightness box relative to the tint disc. */
+#define kCCColourPickerTintBoxInsetRatio    (kCCColourPickerTintBoxInset / 110.0f)
+
+/** The textures of the colour picker. */
+typedef enum
+{
+    CCColourPickerTextureHueWheel,          // The ring of hues around the tint disc
+    CCColourPickerTextureTintBackground,    // The white disc tinted with the hue
+    CCColourPickerTextureTintOverlay,       // The saturation/brightness gradient
+    CCColourPickerTextureMarker,            // The marker of the hue and the tint
+    CCColourPickerTextureArrow              // The arrow pointing to the right
+} CCColourPickerTextureType;
+
+/**
+ * The CCColourPickerTextures class generates the textures of the colour
+ * picker at the resolution of the screen, instead of loading images.
+ *
+ * The textures are cached by type and size, and shared by all the colour
+ * pickers until removeAllTextures is called.
+ */
+@interface CCColourPickerTextures : NSObject
+
+/**
+ * Returns the texture of the given type, generated the first time.
+ *
+ * @param type The type of the texture.
+ * @param size The size of the texture, in points.
+ */
++ (CCTexture2D *)textureWithType:(CCColourPickerTextureType)type size:(CGSize)size;
+
+/** Releases the cached textures. The textures in use are kept alive by their
+ sprites. */
++ (void)removeAllTextures;
+
+@end
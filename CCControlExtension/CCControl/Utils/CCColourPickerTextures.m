@@ -0,0 +1,95 @@
+/*
+ * CCColourPickerTextures.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCColourPickerTextures.h"
+#import "ARCMacro.h"
+
+@implementation CCColourPickerTextures
+
+/** The generated textures, by type and size in pixels. */
+static NSMutableDictionary *textures = nil;
+
+#pragma mark -
+#pragma mark CCColourPickerTextures Public Methods
+
++ (CCTexture2D *)textureWithType:(CCColourPickerTextureType)type size:(CGSize)size
+{
+    NSUInteger width  = MAX(1, (NSUInteger)roundf(size.width * CC_CONTENT_SCALE_FACTOR()));
+    NSUInteger height = MAX(1, (NSUInteger)roundf(size.height * CC_CONTENT_SCALE_FACTOR()));
+    
+    NSAssert(type == CCColourPickerTextureArrow || width == height, @"The colour picker textures must be square, except the arrow.");
+    
+    NSString *key = [NSString stringWithFormat:@"%d-%lux%lu", type, (unsigned long)width, (unsigned long)height];
+    
+    if (textures == nil) {
+        textures = [[NSMutableDictionary alloc] init];
+    }
+    
+    CCTexture2D *texture = [textures objectForKey:key];
+    
+    if (texture) {
+        return texture;
+    }
+    
+    GLubyte *pixels = calloc(width * height * 4, sizeof(GLubyte));
+    
+    switch (type) {
+        case CCColourPickerTextureHueWheel:
+            ccColourPickerFillHueWheel(pixels, width);
+            break;
+        case CCColourPickerTextureTintBackground:
+            ccColourPickerFillTintBackground(pixels, width);
+            break;
+        case CCColourPickerTextureTintOverlay:
+            ccColourPickerFillTintOverlay(pixels, width, width * kCCColourPickerTintBoxInsetRatio);
+            break;
+        case CCColourPickerTextureMarker:
+            ccColourPickerFillMarker(pixels, width);
+            break;
+        case CCColourPickerTextureArrow:
+            ccColourPickerFillArrow(pixels, width, height);
+            break;
+    }
+    
+    texture = [[CCTexture2D alloc] initWithData:pixels
+                                    pixelFormat:kCCTexture2DPixelFormat_RGBA8888
+                                     pixelsWide:width
+                                     pixelsHigh:height
+                                    contentSize:CGSizeMake(width, height)];
+    free(pixels);
+    
+    [textures setObject:texture forKey:key];
+    SAFE_ARC_RELEASE(texture);
+    
+    return texture;
+}
+
++ (void)removeAllTextures
+{
+    [textures removeAllObjects];
+}
+
+@end
@@ -28,6 +28,7 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "cocos2d.h"
 
 typedef struct
 {
@@ -44,6 +45,31 @@ typedef struct
     double v;       // percent
 } HSV;
 
+/** Single precision RGBA colour used by the batch conversions. */
+typedef struct
+{
+    float r;        // percent
+    float g;        // percent
+    float b;        // percent
+    float a;        // percent
+} RGBAf;
+
+/** Single precision HSV colour used by the batch conversions. */
+typedef struct
+{
+    float h;        // angle in degrees
+    float s;        // percent
+    float v;        // percent
+} HSVf;
+
+/**
+ * Maximum difference between the results of the batch conversions and the
+ * ones of HSVfromRGB: and RGBfromHSV:, for the percent components.
+ */
+#define kCCColourUtilsComponentTolerance    1e-5f
+/** Same as kCCColourUtilsComponentTolerance, for the hue in degrees. */
+#define kCCColourUtilsHueTolerance          1e-3f
+
 @interface CCColourUtils : NSObject
 
 #pragma mark - Constuctors - Initializers
@@ -53,4 +79,36 @@ typedef struct
 + (HSV)HSVfromRGB:(RGBA)value;
 + (RGBA)RGBfromHSV:(HSV)value;
 
+#pragma mark Batch Conversions
+
+/*
+ * The batch conversions use SSE2 or NEON when available, 4 colours at a time,
+ * and give the same results as the methods above within the tolerances
+ * defined by kCCColourUtilsComponentTolerance and kCCColourUtilsHueTolerance.
+ * As with HSVfromRGB:, the hue of the grey colours is NAN. The source and the
+ * destination arrays must not overlap.
+ * Define CC_COLOUR_UTILS_DISABLE_SIMD to always use the scalar code.
+ */
+
+/** Converts count RGB colours to HSV. */
++ (void)HSVfromRGBColours:(const RGBAf *)colours toHSVColours:(HSVf *)hsvColours count:(NSUInteger)count;
+
+/** Converts count HSV colours to RGB. The alpha of the RGB colours is set to 1. */
++ (void)RGBfromHSVColours:(const HSVf *)hsvColours toRGBColours:(RGBAf *)colours count:(NSUInteger)count;
+
+/** Converts count packed RGB colours to HSV. */
++ (void)HSVfromColor3B:(const ccColor3B *)colours toHSVColours:(HSVf *)hsvColours count:(NSUInteger)count;
+
+/** Converts count HSV colours to packed RGB colours. */
++ (void)color3BfromHSVColours:(const HSVf *)hsvColours toColor3B:(ccColor3B *)colours count:(NSUInteger)count;
+
+/** Converts count packed RGBA colours to HSV. The alpha is ignored. */
++ (void)HSVfromColor4B:(const ccColor4B *)colours toHSVColours:(HSVf *)hsvColours count:(NSUInteger)count;
+
+/**
+ * Converts count HSV colours to packed RGBA colours. The alpha of the packed
+ * colours is left untouched so that a palette can be graded in place.
+ */
++ (void)color4BfromHSVColours:(const HSVf *)hsvColours toColor4B:(ccColor4B *)colours count:(NSUInteger)count;
+
 @end
@@ -29,6 +29,353 @@
 
 #import "CCColourUtils.h"
 
+#ifndef CC_COLOUR_UTILS_DISABLE_SIMD
+#   if defined(__SSE2__)
+#       include <emmintrin.h>
+#       define CC_COLOUR_UTILS_SSE2 1
+#   elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#       include <arm_neon.h>
+#       define CC_COLOUR_UTILS_NEON 1
+#   endif
+#endif
+
+/** Number of packed colours converted at once through a float buffer. */
+#define kCCColourUtilsPackedChunk 64
+
+#pragma mark Scalar Conversions
+
+static inline HSVf ccColourHSVfromRGBf(RGBAf value)
+{
+    HSVf  out;
+    float min   = fminf(fminf(value.r, value.g), value.b);
+    float max   = fmaxf(fmaxf(value.r, value.g), value.b);
+    float delta = max - min;
+    
+    out.v = max;
+    
+    if (max <= 0.0f) {
+        out.s = 0.0f;
+        out.h = NAN;
+        return out;
+    }
+    
+    out.s = delta / max;
+    
+    if (value.r >= max) {
+        out.h = (value.g - value.b) / delta;
+    }
+    else if (value.g >= max) {
+        out.h = 2.0f + (value.b - value.r) / delta;
+    }
+    else {
+        out.h = 4.0f + (value.r - value.g) / delta;
+    }
+    
+    out.h *= 60.0f;
+    
+    if (out.h < 0.0f) {
+        out.h += 360.0f;
+    }
+    
+    return out;
+}
+
+static inline RGBAf ccColourRGBfromHSVf(HSVf value)
+{
+    RGBAf out;
+    out.a = 1.0f;
+    
+    if (value.s <= 0.0f) {
+        float grey = isnan(value.h) ? value.v : 0.0f;
+        
+        out.r = out.g = out.b = grey;
+        return out;
+    }
+    
+    // The hues just below 360 may round up to the sixth sector, which is the first one
+    float hh = value.h / 60.0f;
+    hh       = (hh >= 6.0f) ? 0.0f : hh;
+    long  i  = (long)hh;
+    float ff = hh - i;
+    float v  = value.v;
+    float p  = v * (1.0f - value.s);
+    float q  = v * (1.0f - (value.s * ff));
+    float t  = v * (1.0f - (value.s * (1.0f - ff)));
+    
+    switch (i) {
+        case 0:  out.r = v; out.g = t; out.b = p; break;
+        case 1:  out.r = q; out.g = v; out.b = p; break;
+        case 2:  out.r = p; out.g = v; out.b = t; break;
+        case 3:  out.r = p; out.g = q; out.b = v; break;
+        case 4:  out.r = t; out.g = p; out.b = v; break;
+        default: out.r = v; out.g = p; out.b = q; break;
+    }
+    
+    return out;
+}
+
+#pragma mark SIMD Conversions
+
+#if CC_COLOUR_UTILS_SSE2 || CC_COLOUR_UTILS_NEON
+
+#if CC_COLOUR_UTILS_SSE2
+
+typedef __m128 ccV4;
+typedef __m128 ccV4Mask;
+
+#define ccV4Splat(x)            _mm_set1_ps(x)
+#define ccV4Add(a, b)           _mm_add_ps(a, b)
+#define ccV4Sub(a, b)           _mm_sub_ps(a, b)
+#define ccV4Mul(a, b)           _mm_mul_ps(a, b)
+#define ccV4Div(a, b)           _mm_div_ps(a, b)
+#define ccV4Min(a, b)           _mm_min_ps(a, b)
+#define ccV4Max(a, b)           _mm_max_ps(a, b)
+#define ccV4GreaterEqual(a, b)  _mm_cmpge_ps(a, b)
+#define ccV4LessEqual(a, b)     _mm_cmple_ps(a, b)
+#define ccV4Less(a, b)          _mm_cmplt_ps(a, b)
+#define ccV4Equal(a, b)         _mm_cmpeq_ps(a, b)
+#define ccV4IsNaN(a)            _mm_cmpunord_ps(a, a)
+#define ccV4Or(a, b)            _mm_or_ps(a, b)
+#define ccV4Truncate(a)         _mm_cvtepi32_ps(_mm_cvttps_epi32(a))
+
+/** Returns a where the mask is set, b elsewhere. */
+static inline ccV4 ccV4Select(ccV4Mask mask, ccV4 a, ccV4 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline void ccV4LoadRGB(const RGBAf *colours, ccV4 *r, ccV4 *g, ccV4 *b)
+{
+    ccV4 c0 = _mm_loadu_ps(&colours[0].r);
+    ccV4 c1 = _mm_loadu_ps(&colours[1].r);
+    ccV4 c2 = _mm_loadu_ps(&colours[2].r);
+    ccV4 c3 = _mm_loadu_ps(&colours[3].r);
+    
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    
+    *r = c0;
+    *g = c1;
+    *b = c2;
+}
+
+static inline void ccV4StoreRGB(RGBAf *colours, ccV4 r, ccV4 g, ccV4 b)
+{
+    ccV4 a = _mm_set1_ps(1.0f);
+    
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+    
+    _mm_storeu_ps(&colours[0].r, r);
+    _mm_storeu_ps(&colours[1].r, g);
+    _mm_storeu_ps(&colours[2].r, b);
+    _mm_storeu_ps(&colours[3].r, a);
+}
+
+static inline void ccV4LoadHSV(const HSVf *colours, ccV4 *h, ccV4 *s, ccV4 *v)
+{
+    *h = _mm_setr_ps(colours[0].h, colours[1].h, colours[2].h, colours[3].h);
+    *s = _mm_setr_ps(colours[0].s, colours[1].s, colours[2].s, colours[3].s);
+    *v = _mm_setr_ps(colours[0].v, colours[1].v, colours[2].v, colours[3].v);
+}
+
+static inline void ccV4StoreHSV(HSVf *colours, ccV4 h, ccV4 s, ccV4 v)
+{
+    float hh[4], ss[4], vv[4];
+    
+    _mm_storeu_ps(hh, h);
+    _mm_storeu_ps(ss, s);
+    _mm_storeu_ps(vv, v);
+    
+    for (int i = 0; i < 4; i++) {
+        colours[i].h = hh[i];
+        colours[i].s = ss[i];
+        colours[i].v = vv[i];
+    }
+}
+
+#else
+
+typedef float32x4_t ccV4;
+typedef uint32x4_t  ccV4Mask;
+
+#define ccV4Splat(x)            vdupq_n_f32(x)
+#define ccV4Add(a, b)           vaddq_f32(a, b)
+#define ccV4Sub(a, b)           vsubq_f32(a, b)
+#define ccV4Mul(a, b)           vmulq_f32(a, b)
+#define ccV4Min(a, b)           vminq_f32(a, b)
+#define ccV4Max(a, b)           vmaxq_f32(a, b)
+#define ccV4GreaterEqual(a, b)  vcgeq_f32(a, b)
+#define ccV4LessEqual(a, b)     vcleq_f32(a, b)
+#define ccV4Less(a, b)          vcltq_f32(a, b)
+#define ccV4Equal(a, b)         vceqq_f32(a, b)
+#define ccV4IsNaN(a)            vmvnq_u32(vceqq_f32(a, a))
+#define ccV4Or(a, b)            vorrq_u32(a, b)
+#define ccV4Truncate(a)         vcvtq_f32_s32(vcvtq_s32_f32(a))
+#define ccV4Select(mask, a, b)  vbslq_f32(mask, a, b)
+
+static inline ccV4 ccV4Div(ccV4 a, ccV4 b)
+{
+#if defined(__aarch64__)
+    return vdivq_f32(a, b);
+#else
+    // ARMv7 has no division, refine the reciprocal estimate twice
+    ccV4 reciprocal = vrecpeq_f32(b);
+    reciprocal      = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    reciprocal      = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    
+    return vmulq_f32(a, reciprocal);
+#endif
+}
+
+static inline void ccV4LoadRGB(const RGBAf *colours, ccV4 *r, ccV4 *g, ccV4 *b)
+{
+    float32x4x4_t c = vld4q_f32(&colours[0].r);
+    
+    *r = c.val[0];
+    *g = c.val[1];
+    *b = c.val[2];
+}
+
+static inline void ccV4StoreRGB(RGBAf *colours, ccV4 r, ccV4 g, ccV4 b)
+{
+    float32x4x4_t c;
+    c.val[0] = r;
+    c.val[1] = g;
+    c.val[2] = b;
+    c.val[3] = vdupq_n_f32(1.0f);
+    
+    vst4q_f32(&colours[0].r, c);
+}
+
+static inline void ccV4LoadHSV(const HSVf *colours, ccV4 *h, ccV4 *s, ccV4 *v)
+{
+    float32x4x3_t c = vld3q_f32(&colours[0].h);
+    
+    *h = c.val[0];
+    *s = c.val[1];
+    *v = c.val[2];
+}
+
+static inline void ccV4StoreHSV(HSVf *colours, ccV4 h, ccV4 s, ccV4 v)
+{
+    float32x4x3_t c;
+    c.val[0] = h;
+    c.val[1] = s;
+    c.val[2] = v;
+    
+    vst3q_f32(&colours[0].h, c);
+}
+
+#endif
+
+/** Converts 4 RGB colours to HSV, see ccColourHSVfromRGBf. */
+static inline void ccV4HSVfromRGB(const RGBAf *colours, HSVf *hsvColours)
+{
+    ccV4 r, g, b;
+    ccV4LoadRGB(colours, &r, &g, &b);
+    
+    ccV4 zero  = ccV4Splat(0.0f);
+    ccV4 max   = ccV4Max(ccV4Max(r, g), b);
+    ccV4 min   = ccV4Min(ccV4Min(r, g), b);
+    ccV4 delta = ccV4Sub(max, min);
+    
+    // The black colours have a zero saturation and no hue
+    ccV4Mask black = ccV4LessEqual(max, zero);
+    ccV4 s         = ccV4Select(black, zero, ccV4Div(delta, max));
+    
+    // Compute the three sectors then keep the one of the max component
+    ccV4 hr = ccV4Div(ccV4Sub(g, b), delta);
+    ccV4 hg = ccV4Add(ccV4Splat(2.0f), ccV4Div(ccV4Sub(b, r), delta));
+    ccV4 hb = ccV4Add(ccV4Splat(4.0f), ccV4Div(ccV4Sub(r, g), delta));
+    
+    ccV4 h = ccV4Select(ccV4GreaterEqual(r, max), hr,
+                        ccV4Select(ccV4GreaterEqual(g, max), hg, hb));
+    h      = ccV4Mul(h, ccV4Splat(60.0f));
+    h      = ccV4Select(ccV4Less(h, zero), ccV4Add(h, ccV4Splat(360.0f)), h);
+    
+    // The division by a zero delta gives NAN for the grey colours already
+    h      = ccV4Select(black, ccV4Splat(NAN), h);
+    
+    ccV4StoreHSV(hsvColours, h, s, max);
+}
+
+/** Converts 4 HSV colours to RGB, see ccColourRGBfromHSVf. */
+static inline void ccV4RGBfromHSV(const HSVf *hsvColours, RGBAf *colours)
+{
+    ccV4 h, s, v;
+    ccV4LoadHSV(hsvColours, &h, &s, &v);
+    
+    ccV4 zero = ccV4Splat(0.0f);
+    ccV4 one  = ccV4Splat(1.0f);
+    
+    // The hues just below 360 may round up to the sixth sector, which is the first one
+    ccV4 hh = ccV4Mul(h, ccV4Splat(1.0f / 60.0f));
+    hh      = ccV4Select(ccV4GreaterEqual(hh, ccV4Splat(6.0f)), zero, hh);
+    ccV4 i  = ccV4Truncate(hh);
+    ccV4 ff = ccV4Sub(hh, i);
+    ccV4 p  = ccV4Mul(v, ccV4Sub(one, s));
+    ccV4 q  = ccV4Mul(v, ccV4Sub(one, ccV4Mul(s, ff)));
+    ccV4 t  = ccV4Mul(v, ccV4Sub(one, ccV4Mul(s, ccV4Sub(one, ff))));
+    
+    // Select the components of each sector, the last one by default
+    ccV4Mask i0 = ccV4Equal(i, zero);
+    ccV4Mask i1 = ccV4Equal(i, one);
+    ccV4Mask i2 = ccV4Equal(i, ccV4Splat(2.0f));
+    ccV4Mask i3 = ccV4Equal(i, ccV4Splat(3.0f));
+    ccV4Mask i4 = ccV4Equal(i, ccV4Splat(4.0f));
+    
+    ccV4 r = ccV4Select(i1, q, ccV4Select(ccV4Or(i2, i3), p, ccV4Select(i4, t, v)));
+    ccV4 g = ccV4Select(i0, t, ccV4Select(ccV4Or(i1, i2), v, ccV4Select(i3, q, p)));
+    ccV4 b = ccV4Select(ccV4Or(i0, i1), p, ccV4Select(i2, t, ccV4Select(ccV4Or(i3, i4), v, q)));
+    
+    // The unsaturated colours are grey without hue, black otherwise
+    ccV4Mask unsaturated = ccV4LessEqual(s, zero);
+    ccV4 grey            = ccV4Select(ccV4IsNaN(h), v, zero);
+    
+    r = ccV4Select(unsaturated, grey, r);
+    g = ccV4Select(unsaturated, grey, g);
+    b = ccV4Select(unsaturated, grey, b);
+    
+    ccV4StoreRGB(colours, r, g, b);
+}
+
+#endif
+
+static void ccColourHSVfromRGBArray(const RGBAf *colours, HSVf *hsvColours, NSUInteger count)
+{
+    NSUInteger i = 0;
+    
+#if CC_COLOUR_UTILS_SSE2 || CC_COLOUR_UTILS_NEON
+    for (; i + 4 <= count; i += 4) {
+        ccV4HSVfromRGB(&colours[i], &hsvColours[i]);
+    }
+#endif
+    
+    for (; i < count; i++) {
+        hsvColours[i] = ccColourHSVfromRGBf(colours[i]);
+    }
+}
+
+static void ccColourRGBfromHSVArray(const HSVf *hsvColours, RGBAf *colours, NSUInteger count)
+{
+    NSUInteger i = 0;
+    
+#if CC_COLOUR_UTILS_SSE2 || CC_COLOUR_UTILS_NEON
+    for (; i + 4 <= count; i += 4) {
+        ccV4RGBfromHSV(&hsvColours[i], &colours[i]);
+    }
+#endif
+    
+    for (; i < count; i++) {
+        colours[i] = ccColourRGBfromHSVf(hsvColours[i]);
+    }
+}
+
+/** Converts a percent component to a byte, rounding to the nearest. */
+static inline GLubyte ccColourByteFromPercent(float value)
+{
+    return (GLubyte)(fminf(fmaxf(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
 @implementation CCColourUtils
 
 #pragma mark - Initialization
@@ -153,4 +500,86 @@
     return out;     
 }
 
+#pragma mark Batch Conversions
+
++ (void)HSVfromRGBColours:(const RGBAf *)colours toHSVColours:(HSVf *)hsvColours count:(NSUInteger)count
+{
+    ccColourHSVfromRGBArray(colours, hsvColours, count);
+}
+
++ (void)RGBfromHSVColours:(const HSVf *)hsvColours toRGBColours:(RGBAf *)colours count:(NSUInteger)count
+{
+    ccColourRGBfromHSVArray(hsvColours, colours, count);
+}
+
++ (void)HSVfromColor3B:(const ccColor3B *)colours toHSVColours:(HSVf *)hsvColours count:(NSUInteger)count
+{
+    RGBAf buffer[kCCColourUtilsPackedChunk];
+    
+    for (NSUInteger start = 0; start < count; start += kCCColourUtilsPackedChunk) {
+        NSUInteger length = MIN(count - start, kCCColourUtilsPackedChunk);
+        
+        for (NSUInteger i = 0; i < length; i++) {
+            buffer[i].r = colours[start + i].r / 255.0f;
+            buffer[i].g = colours[start + i].g / 255.0f;
+            buffer[i].b = colours[start + i].b / 255.0f;
+            buffer[i].a = 1.0f;
+        }
+        
+        ccColourHSVfromRGBArray(buffer, &hsvColours[start], length);
+    }
+}
+
++ (void)color3BfromHSVColours:(const HSVf *)hsvColours toColor3B:(ccColor3B *)colours count:(NSUInteger)count
+{
+    RGBAf buffer[kCCColourUtilsPackedChunk];
+    
+    for (NSUInteger start = 0; start < count; start += kCCColourUtilsPackedChunk) {
+        NSUInteger length = MIN(count - start, kCCColourUtilsPackedChunk);
+        
+        ccColourRGBfromHSVArray(&hsvColours[start], buffer, length);
+        
+        for (NSUInteger i = 0; i < length; i++) {
+            colours[start + i].r = ccColourByteFromPercent(buffer[i].r);
+            colours[start + i].g = ccColourByteFromPercent(buffer[i].g);
+            colours[start + i].b = ccColourByteFromPercent(buffer[i].b);
+        }
+    }
+}
+
++ (void)HSVfromColor4B:(const ccColor4B *)colours toHSVColours:(HSVf *)hsvColours count:(NSUInteger)count
+{
+    RGBAf buffer[kCCColourUtilsPackedChunk];
+    
+    for (NSUInteger start = 0; start < count; start += kCCColourUtilsPackedChunk) {
+        NSUInteger length = MIN(count - start, kCCColourUtilsPackedChunk);
+        
+        for (NSUInteger i = 0; i < length; i++) {
+            buffer[i].r = colours[start + i].r / 255.0f;
+            buffer[i].g = colours[start + i].g / 255.0f;
+            buffer[i].b = colours[start + i].b / 255.0f;
+            buffer[i].a = 1.0f;
+        }
+        
+        ccColourHSVfromRGBArray(buffer, &hsvColours[start], length);
+    }
+}
+
++ (void)color4BfromHSVColours:(const HSVf *)hsvColours toColor4B:(ccColor4B *)colours count:(NSUInteger)count
+{
+    RGBAf buffer[kCCColourUtilsPackedChunk];
+    
+    for (NSUInteger start = 0; start < count; start += kCCColourUtilsPackedChunk) {
+        NSUInteger length = MIN(count - start, kCCColourUtilsPackedChunk);
+        
+        ccColourRGBfromHSVArray(&hsvColours[start], buffer, length);
+        
+        for (NSUInteger i = 0; i < length; i++) {
+            colours[start + i].r = ccColourByteFromPercent(buffer[i].r);
+            colours[start + i].g = ccColourByteFromPercent(buffer[i].g);
+            colours[start + i].b = ccColourByteFromPercent(buffer[i].b);
+        }
+    }
+}
+
 @end
@@ -0,0 +1,135 @@
+/*
+ * CCControlAutorepeat.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+
+/** The timing of a repeated action, in seconds of holding. */
+typedef struct
+{
+    ccTime delay;             // Delay between the press and the first repeat.
+    ccTime interval;          // Interval between the first repeats.
+    ccTime fastInterval;      // Interval once the action has been repeated for accelerationDelay.
+    ccTime accelerationDelay; // Time of repeating after which fastInterval is used.
+} CCControlAutorepeatTiming;
+
+/** Returns a timing made of the given values. */
+static inline CCControlAutorepeatTiming CCControlAutorepeatTimingMake(ccTime delay, ccTime interval, ccTime fastInterval, ccTime accelerationDelay)
+{
+    CCControlAutorepeatTiming timing;
+    timing.delay             = delay;
+    timing.interval          = interval;
+    timing.fastInterval      = fastInterval;
+    timing.accelerationDelay = accelerationDelay;
+    
+    return timing;
+}
+
+/**
+ * The default timing of the controls: a repeat every 0.45 second after a
+ * 0.45 second delay, then every 0.15 second after 1.8 second of repeating.
+ */
+#define kCCControlAutorepeatTimingDefault CCControlAutorepeatTimingMake(0.45f, 0.45f, 0.15f, 1.8f)
+
+/** An action repeated while a control is held. */
+typedef struct
+{
+    __unsafe_unretained id    target;
+    SEL                       action;
+    IMP                       implementation;
+    ccTime                    startTime;
+    ccTime                    fireTime;
+    CCControlAutorepeatTiming timing;
+} CCControlAutorepeater;
+
+/**
+ * The CCControlAutorepeat repeats the actions of the controls which are
+ * held, such as the steppers and the buttons with autorepeat enabled.
+ *
+ * All the repeaters share a single update of the scheduler: they are kept in
+ * a queue ordered by their next fire time, so that a frame only looks at the
+ * head of the queue, and the repeat rate depends on the time the control has
+ * been held rather than on a number of ticks. The scheduler entry is added
+ * the first time an action is repeated and kept afterwards.
+ *
+ * The targets are not retained: a target must stop repeating before it is
+ * deallocated (the controls do it in onExit).
+ */
+@interface CCControlAutorepeat : NSObject
+{
+@private
+    CCControlAutorepeater   *_repeaters;
+    NSUInteger              _count;
+    NSUInteger              _capacity;
+    ccTime                  _time;
+    BOOL                    _scheduled;
+    
+    // Repeater being fired, it may stop repeating from its own action
+    __unsafe_unretained id  _firingTarget;
+    BOOL                    _firingTargetRemoved;
+}
+/** @name Reading the Repeaters */
+/** The number of actions currently repeated. */
+@property (nonatomic, readonly) NSUInteger numberOfRepeaters;
+
+#pragma mark Constructors - Initializers
+/** @name Getting the Autorepeat */
+
+/** Returns the shared autorepeat. */
++ (CCControlAutorepeat *)sharedAutorepeat;
+
+#pragma mark Public Methods
+/** @name Repeating Actions */
+
+/**
+ * Starts repeating an action with the given timing. The action of a target
+ * which is already repeating is replaced and its timing starts again.
+ *
+ * @param target The target object. It is not retained.
+ * @param action A selector identifying a message without argument.
+ * @param timing The timing of the repeats.
+ */
+- (void)startRepeatingTarget:(id)target action:(SEL)action timing:(CCControlAutorepeatTiming)timing;
+
+/**
+ * Stops repeating the action of the given target. Does nothing if it is not
+ * repeating.
+ *
+ * @param target The target object.
+ */
+- (void)stopRepeatingTarget:(id)target;
+
+/** Returns YES if the given target is repeating an action. */
+- (BOOL)isRepeatingTarget:(id)target;
+
+/**
+ * Fires the due repeaters. Called by the scheduler.
+ *
+ * @param delta The time elapsed since the last update.
+ */
+- (void)update:(ccTime)delta;
+
+@end
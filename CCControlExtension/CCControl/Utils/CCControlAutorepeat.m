@@ -0,0 +1,188 @@
+/*
+ * CCControlAutorepeat.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlAutorepeat.h"
+#import "ARCMacro.h"
+
+static CCControlAutorepeat *sharedAutorepeat = nil;
+
+/** Returns the interval before the next repeat of the given repeater. */
+static inline ccTime ccControlAutorepeaterInterval(CCControlAutorepeater *repeater, ccTime time)
+{
+    ccTime repeatingTime = time - repeater->startTime - repeater->timing.delay;
+    
+    return (repeatingTime < repeater->timing.accelerationDelay) ? repeater->timing.interval : repeater->timing.fastInterval;
+}
+
+@interface CCControlAutorepeat ()
+
+/** Inserts a repeater in the queue, after the ones firing before or at the same time. */
+- (void)insertRepeater:(CCControlAutorepeater)repeater;
+
+/** Returns the index of the repeater of the given target, or NSNotFound. */
+- (NSUInteger)indexOfTarget:(id)target;
+
+@end
+
+@implementation CCControlAutorepeat
+
+- (void)dealloc
+{
+    if (_scheduled) {
+        [[[CCDirector sharedDirector] scheduler] unscheduleUpdateForTarget:self];
+    }
+    
+    free(_repeaters);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
++ (CCControlAutorepeat *)sharedAutorepeat
+{
+    if (!sharedAutorepeat) {
+        sharedAutorepeat = [[CCControlAutorepeat alloc] init];
+    }
+    
+    return sharedAutorepeat;
+}
+
+#pragma mark Properties
+
+- (NSUInteger)numberOfRepeaters
+{
+    return _count;
+}
+
+#pragma mark -
+#pragma mark CCControlAutorepeat Public Methods
+
+- (void)startRepeatingTarget:(id)target action:(SEL)action timing:(CCControlAutorepeatTiming)timing
+{
+    NSAssert(target, @"The target cannot be nil");
+    NSAssert(action != NULL, @"The action cannot be NULL");
+    
+    [self stopRepeatingTarget:target];
+    
+    if (!_scheduled) {
+        [[[CCDirector sharedDirector] scheduler] scheduleUpdateForTarget:self priority:0 paused:NO];
+        _scheduled = YES;
+    }
+    
+    CCControlAutorepeater repeater;
+    repeater.target         = target;
+    repeater.action         = action;
+    repeater.implementation = [target methodForSelector:action];
+    repeater.startTime      = _time;
+    repeater.fireTime       = _time + timing.delay;
+    repeater.timing         = timing;
+    
+    [self insertRepeater:repeater];
+}
+
+- (void)stopRepeatingTarget:(id)target
+{
+    if (target == _firingTarget) {
+        _firingTargetRemoved = YES;
+    }
+    
+    NSUInteger index = [self indexOfTarget:target];
+    
+    if (index != NSNotFound) {
+        memmove(&_repeaters[index], &_repeaters[index + 1], (_count - index - 1) * sizeof(CCControlAutorepeater));
+        _count--;
+    }
+}
+
+- (BOOL)isRepeatingTarget:(id)target
+{
+    return [self indexOfTarget:target] != NSNotFound;
+}
+
+- (void)update:(ccTime)delta
+{
+    _time += delta;
+    
+    // The queue is ordered, only the due repeaters at its head are looked at
+    while (_count > 0 && _repeaters[0].fireTime <= _time) {
+        CCControlAutorepeater repeater = _repeaters[0];
+        
+        memmove(&_repeaters[0], &_repeaters[1], (_count - 1) * sizeof(CCControlAutorepeater));
+        _count--;
+        
+        _firingTarget        = repeater.target;
+        _firingTargetRemoved = NO;
+        
+        ((void (*)(id, SEL))repeater.implementation)(repeater.target, repeater.action);
+        
+        _firingTarget = nil;
+        
+        if (_firingTargetRemoved) {
+            continue;
+        }
+        
+        // Skip the repeats missed by a long frame rather than firing them in a burst
+        repeater.fireTime += ccControlAutorepeaterInterval(&repeater, repeater.fireTime);
+        
+        if (repeater.fireTime <= _time) {
+            repeater.fireTime = _time + ccControlAutorepeaterInterval(&repeater, _time);
+        }
+        
+        [self insertRepeater:repeater];
+    }
+}
+
+#pragma mark CCControlAutorepeat Private Methods
+
+- (void)insertRepeater:(CCControlAutorepeater)repeater
+{
+    if (_count == _capacity) {
+        _capacity  = MAX(4, _capacity * 2);
+        _repeaters = realloc(_repeaters, _capacity * sizeof(CCControlAutorepeater));
+    }
+    
+    NSUInteger index = _count;
+    
+    while (index > 0 && _repeaters[index - 1].fireTime > repeater.fireTime) {
+        index--;
+    }
+    
+    memmove(&_repeaters[index + 1], &_repeaters[index], (_count - index) * sizeof(CCControlAutorepeater));
+    _repeaters[index] = repeater;
+    _count++;
+}
+
+- (NSUInteger)indexOfTarget:(id)target
+{
+    for (NSUInteger i = 0; i < _count; i++) {
+        if (_repeaters[i].target == target) {
+            return i;
+        }
+    }
+    
+    return NSNotFound;
+}
+
+@end
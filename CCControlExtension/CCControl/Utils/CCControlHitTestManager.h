@@ -0,0 +1,176 @@
+/*
+ * CCControlHitTestManager.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+
+@class CCControl;
+
+/** Default size of the grid cells, in points. */
+#define kCCControlHitTestDefaultCellSize 64.0f
+/** Maximum number of cells along each axis of the grid. */
+#define kCCControlHitTestMaxCellsPerAxis 64
+/** Maximum number of touches tracked at the same time. */
+#define kCCControlHitTestMaxTrackedTouches 16
+
+/**
+ * Pairs a touch with the control which has claimed it.
+ */
+typedef struct
+{
+    __unsafe_unretained id        touch;
+    __unsafe_unretained CCControl *control;
+} CCControlTrackedTouch;
+
+/**
+ * A parent of registered controls with its world transform when the grid was
+ * built.
+ */
+typedef struct
+{
+    __unsafe_unretained CCNode *node;
+    CGAffineTransform          nodeToWorld;
+} CCControlHitTestParent;
+
+/**
+ * The CCControlHitTestManager routes the touches to the controls using a
+ * uniform grid of their world bounding boxes.
+ *
+ * By default each control registers itself as a targeted delegate of the
+ * touch dispatcher, so every touch-began asks all the controls of the scene
+ * whether they are touched. Once the manager is enabled, the controls entering
+ * the stage register to the manager instead. The manager registers once to
+ * the touch dispatcher for each distinct touch priority of its controls, so
+ * the other delegates of the dispatcher keep their order relative to the
+ * controls. On touch-began it only asks the few controls of the priority
+ * whose bounding box overlaps the grid cell of the touch, in registration
+ * order.
+ *
+ * The grid is rebuilt lazily on the next touch when a registered control
+ * moves, is resized, scaled or rotated. The manager also keeps the world
+ * transform of the parents of the controls, there are usually only a few of
+ * them, and rebuilds the grid when one of their ancestors has moved, scaled
+ * or scrolled since.
+ *
+ * On Mac the controls keep using the event dispatcher.
+ */
+@interface CCControlHitTestManager : NSObject
+{
+@private
+    NSMutableArray        *_controls;
+    NSInteger             *_controlPriorities;
+    NSUInteger            _controlPrioritiesCapacity;
+    NSMutableArray        *_priorityHandlers;
+    NSUInteger            _mutations;
+    BOOL                  _dirty;
+    
+    // Grid
+    CGRect                *_worldRects;
+    NSUInteger            _worldRectsCapacity;
+    CGRect                _gridBounds;
+    CGSize                _gridCellSize;
+    NSUInteger            _columns, _rows;
+    NSUInteger            *_cellStarts;
+    NSUInteger            _cellStartsCapacity;
+    NSUInteger            *_cellEntries;
+    NSUInteger            _cellEntriesCapacity;
+    NSUInteger            *_candidates;
+    NSUInteger            _candidatesCapacity;
+    CCControlHitTestParent *_parents;
+    NSUInteger            _parentsCount;
+    NSUInteger            _parentsCapacity;
+    
+    // Touch tracking
+    CCControlTrackedTouch _trackedTouches[kCCControlHitTestMaxTrackedTouches];
+    NSUInteger            _trackedTouchesCount;
+}
+/** @name Configuring the Manager */
+/**
+ * Tells whether the controls entering the stage register to the manager
+ * instead of the touch dispatcher. The controls already on stage are not
+ * affected. The default value is NO.
+ */
+@property (nonatomic, getter = isEnabled) BOOL enabled;
+/** The size of the grid cells, in points. The default value is
+ kCCControlHitTestDefaultCellSize. */
+@property (nonatomic, assign) CGFloat cellSize;
+/** The controls registered to the manager, in registration order. */
+@property (nonatomic, readonly) NSArray *controls;
+
+#pragma mark Constructors - Initializers
+/** @name Accessing the Shared Manager */
+
+/** Returns the shared hit-test manager. */
++ (CCControlHitTestManager *)sharedHitTestManager;
+
+#pragma mark Public Methods
+/** @name Managing the Controls */
+
+/**
+ * Registers a control to the manager. The controls call it themselves in
+ * onEnter when the manager is enabled. The control is dispatched at its
+ * defaultTouchPriority of the time of the registration, as when it
+ * registers to the touch dispatcher.
+ *
+ * @param control The control to register. It is retained until removed.
+ */
+- (void)addControl:(CCControl *)control;
+
+/**
+ * Unregisters a control from the manager. Does nothing if the control is not
+ * registered. The touches tracked by the control are dropped.
+ *
+ * @param control The control to unregister.
+ */
+- (void)removeControl:(CCControl *)control;
+
+/**
+ * Tells whether the given control is registered to the manager.
+ *
+ * @param control A control.
+ */
+- (BOOL)containsControl:(CCControl *)control;
+
+/**
+ * Invalidates the grid so that it is rebuilt on the next hit-test. The
+ * changes of the controls and of their ancestors are detected, call it when
+ * the hit-test rect of a control has changed otherwise.
+ */
+- (void)setNeedsUpdate;
+
+/** @name Hit-Testing */
+
+/**
+ * Returns the first control, in the touch dispatcher order, which is enabled,
+ * visible and whose hit-test rect contains the given location.
+ *
+ * @param location A location in world coordinates (GL space).
+ *
+ * @return the first control containing the given location, or nil.
+ */
+- (CCControl *)controlAtLocation:(CGPoint)location;
+
+@end
@@ -0,0 +1,563 @@
+/*
+ * CCControlHitTestManager.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlHitTestManager.h"
+#import "CCControl.h"
+#import "CCControlInstrumentation.h"
+#import "ARCMacro.h"
+
+@interface CCControlHitTestManager ()
+
+/** Computes the world rect of every control and rebuilds the grid. */
+- (void)rebuildGrid;
+
+/** Returns YES whether a parent of the controls has moved in the world since
+ the grid was built. */
+- (BOOL)hasParentMoved;
+
+/**
+ * Fills the candidates buffer with the indexes of the controls whose world
+ * rect contains the given location, sorted in the touch dispatcher order.
+ *
+ * @param location A location in world coordinates.
+ *
+ * @return the number of candidates.
+ */
+- (NSUInteger)candidatesAtLocation:(CGPoint)location;
+
+/** Counts a control of the given priority, and registers the manager to the
+ touch dispatcher at this priority for the first one. */
+- (void)registerPriority:(NSInteger)priority;
+
+/** Uncounts a control of the given priority, and unregisters the manager
+ from the touch dispatcher at this priority for the last one. */
+- (void)unregisterPriority:(NSInteger)priority;
+
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+/** Gives the touch to the first candidate of the given priority which claims
+ it. */
+- (BOOL)touchBegan:(UITouch *)touch withEvent:(UIEvent *)event priority:(NSInteger)priority;
+/** Forward the touch to the control which has claimed it. */
+- (void)touchMoved:(UITouch *)touch withEvent:(UIEvent *)event;
+- (void)touchEnded:(UITouch *)touch withEvent:(UIEvent *)event;
+- (void)touchCancelled:(UITouch *)touch withEvent:(UIEvent *)event;
+#endif
+
+@end
+
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+
+/**
+ * The delegate of the touch dispatcher for the controls of a given priority.
+ * It forwards the touches to the manager.
+ */
+@interface CCControlHitTestPriorityHandler : NSObject <CCTargetedTouchDelegate>
+/** The manager, not retained. It is set to nil when the handler is removed. */
+@property (nonatomic, assign) CCControlHitTestManager *manager;
+/** The touch priority of the handler. */
+@property (nonatomic, assign) NSInteger priority;
+/** The number of registered controls with this priority. */
+@property (nonatomic, assign) NSUInteger controlCount;
+
+@end
+
+@implementation CCControlHitTestPriorityHandler
+@synthesize manager      = _manager;
+@synthesize priority     = _priority;
+@synthesize controlCount = _controlCount;
+
+- (BOOL)ccTouchBegan:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    return [_manager touchBegan:touch withEvent:event priority:_priority];
+}
+
+- (void)ccTouchMoved:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    [_manager touchMoved:touch withEvent:event];
+}
+
+- (void)ccTouchEnded:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    [_manager touchEnded:touch withEvent:event];
+}
+
+- (void)ccTouchCancelled:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    [_manager touchCancelled:touch withEvent:event];
+}
+
+@end
+
+#endif
+
+/** Grows the given buffer so that it can hold at least count elements. */
+static inline void *ccControlHitTestGrowBuffer(void *buffer, NSUInteger *capacity, NSUInteger count, size_t size)
+{
+    if (count > *capacity) {
+        *capacity = MAX(count, *capacity * 2);
+        buffer    = realloc(buffer, *capacity * size);
+    }
+    
+    return buffer;
+}
+
+@implementation CCControlHitTestManager
+@synthesize enabled       = _enabled;
+@synthesize cellSize      = _cellSize;
+@synthesize controls      = _controls;
+
+static CCControlHitTestManager *sharedHitTestManager = nil;
+
+- (void)dealloc
+{
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+    for (CCControlHitTestPriorityHandler *handler in _priorityHandlers) {
+        handler.manager = nil;
+        [[CCDirector sharedDirector].touchDispatcher removeDelegate:handler];
+    }
+#endif
+    
+    free(_controlPriorities);
+    free(_worldRects);
+    free(_cellStarts);
+    free(_cellEntries);
+    free(_candidates);
+    free(_parents);
+    
+    SAFE_ARC_RELEASE(_controls);
+    SAFE_ARC_RELEASE(_priorityHandlers);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+- (id)init
+{
+    if ((self = [super init])) {
+        _controls         = [[NSMutableArray alloc] init];
+        _priorityHandlers = [[NSMutableArray alloc] init];
+        _cellSize         = kCCControlHitTestDefaultCellSize;
+        _dirty            = YES;
+    }
+    return self;
+}
+
++ (CCControlHitTestManager *)sharedHitTestManager
+{
+    if (sharedHitTestManager == nil) {
+        sharedHitTestManager = [[self alloc] init];
+    }
+    return sharedHitTestManager;
+}
+
+#pragma mark Properties
+
+- (void)setCellSize:(CGFloat)cellSize
+{
+    NSAssert(cellSize > 0, @"The cell size must be greater than 0");
+    
+    _cellSize = cellSize;
+    _dirty    = YES;
+}
+
+#pragma mark -
+#pragma mark CCControlHitTestManager Public Methods
+
+- (void)addControl:(CCControl *)control
+{
+    NSAssert(control, @"The control cannot be nil");
+    
+    if ([self containsControl:control]) {
+        return;
+    }
+    
+    NSUInteger count   = [_controls count] + 1;
+    _controlPriorities = ccControlHitTestGrowBuffer(_controlPriorities, &_controlPrioritiesCapacity, count, sizeof(NSInteger));
+    _controlPriorities[count - 1] = [control defaultTouchPriority];
+    
+    [_controls addObject:control];
+    _mutations++;
+    _dirty = YES;
+    
+    [self registerPriority:_controlPriorities[count - 1]];
+}
+
+- (void)removeControl:(CCControl *)control
+{
+    NSUInteger index = [_controls indexOfObjectIdenticalTo:control];
+    
+    if (index == NSNotFound) {
+        return;
+    }
+    
+    // Drop the touches tracked by the control
+    NSUInteger count = 0;
+    
+    for (NSUInteger i = 0; i < _trackedTouchesCount; i++) {
+        if (_trackedTouches[i].control != control) {
+            _trackedTouches[count++] = _trackedTouches[i];
+        }
+    }
+    _trackedTouchesCount = count;
+    
+    NSInteger priority = _controlPriorities[index];
+    memmove(&_controlPriorities[index], &_controlPriorities[index + 1], ([_controls count] - index - 1) * sizeof(NSInteger));
+    
+    [_controls removeObjectAtIndex:index];
+    _mutations++;
+    _dirty = YES;
+    
+    [self unregisterPriority:priority];
+}
+
+- (BOOL)containsControl:(CCControl *)control
+{
+    return ([_controls indexOfObjectIdenticalTo:control] != NSNotFound);
+}
+
+- (void)setNeedsUpdate
+{
+    _dirty = YES;
+}
+
+- (CCControl *)controlAtLocation:(CGPoint)location
+{
+    NSUInteger count = [self candidatesAtLocation:location];
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        CCControl *control = [_controls objectAtIndex:_candidates[i]];
+        CC_CONTROL_INSTRUMENT(control, CCControlCounterHitTest);
+        
+        if ([control isEnabled]
+            && [control visible]
+            && [control hasVisibleParents]
+            && CGRectContainsPoint([control hitTestRect], [control convertWorldLocationToNodeSpace:location])) {
+            return control;
+        }
+    }
+    
+    return nil;
+}
+
+#pragma mark CCControlHitTestManager Private Methods
+
+- (void)rebuildGrid
+{
+    NSUInteger count = [_controls count];
+    
+    _dirty        = NO;
+    _columns      = 0;
+    _rows         = 0;
+    _parentsCount = 0;
+    
+    if (count == 0) {
+        return;
+    }
+    
+    // Compute the world rects and their bounds, and remember the world
+    // transform of the distinct parents (the controls of a same parent are
+    // usually added in a row)
+    _worldRects = ccControlHitTestGrowBuffer(_worldRects, &_worldRectsCapacity, count, sizeof(CGRect));
+    _gridBounds = CGRectNull;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        CCControl *control = [_controls objectAtIndex:i];
+        CCNode *parent     = [control parent];
+        NSUInteger p       = _parentsCount;
+        
+        while (p > 0 && _parents[p - 1].node != parent) {
+            p--;
+        }
+        
+        if (p == 0 && parent) {
+            _parents = ccControlHitTestGrowBuffer(_parents, &_parentsCapacity, _parentsCount + 1, sizeof(CCControlHitTestParent));
+            _parents[_parentsCount].node        = parent;
+            _parents[_parentsCount].nodeToWorld = [parent nodeToWorldTransform];
+            _parentsCount++;
+        }
+        
+        _worldRects[i] = CGRectApplyAffineTransform([control hitTestRect], [control nodeToWorldTransform]);
+        _gridBounds    = CGRectUnion(_gridBounds, _worldRects[i]);
+    }
+    
+    if (CGRectIsEmpty(_gridBounds)) {
+        return;
+    }
+    
+    // Enlarge the cells if the grid would be too big
+    _gridCellSize = CGSizeMake(MAX(_cellSize, _gridBounds.size.width / kCCControlHitTestMaxCellsPerAxis),
+                               MAX(_cellSize, _gridBounds.size.height / kCCControlHitTestMaxCellsPerAxis));
+    _columns      = MAX(1, (NSUInteger)ceilf(_gridBounds.size.width / _gridCellSize.width));
+    _rows         = MAX(1, (NSUInteger)ceilf(_gridBounds.size.height / _gridCellSize.height));
+    
+    NSUInteger cellCount = _columns * _rows;
+    _cellStarts          = ccControlHitTestGrowBuffer(_cellStarts, &_cellStartsCapacity, cellCount + 1, sizeof(NSUInteger));
+    memset(_cellStarts, 0, (cellCount + 1) * sizeof(NSUInteger));
+    
+    // Count the entries of each cell
+    NSUInteger total = 0;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        CGRect rect = _worldRects[i];
+        
+        if (CGRectIsEmpty(rect)) {
+            continue;
+        }
+        
+        NSUInteger c0 = MIN(_columns - 1, (NSUInteger)((CGRectGetMinX(rect) - _gridBounds.origin.x) / _gridCellSize.width));
+        NSUInteger c1 = MIN(_columns - 1, (NSUInteger)((CGRectGetMaxX(rect) - _gridBounds.origin.x) / _gridCellSize.width));
+        NSUInteger r0 = MIN(_rows - 1, (NSUInteger)((CGRectGetMinY(rect) - _gridBounds.origin.y) / _gridCellSize.height));
+        NSUInteger r1 = MIN(_rows - 1, (NSUInteger)((CGRectGetMaxY(rect) - _gridBounds.origin.y) / _gridCellSize.height));
+        
+        for (NSUInteger r = r0; r <= r1; r++) {
+            for (NSUInteger c = c0; c <= c1; c++) {
+                _cellStarts[r * _columns + c]++;
+            }
+        }
+        
+        total += (c1 - c0 + 1) * (r1 - r0 + 1);
+    }
+    
+    // Turn the counts into end offsets
+    for (NSUInteger cell = 1; cell <= cellCount; cell++) {
+        _cellStarts[cell] += _cellStarts[cell - 1];
+    }
+    
+    // Fill the cells backwards so that each cell lists its controls in
+    // registration order, and that its offset ends up on its first entry
+    _cellEntries = ccControlHitTestGrowBuffer(_cellEntries, &_cellEntriesCapacity, MAX(1, total), sizeof(NSUInteger));
+    
+    for (NSUInteger i = count; i-- > 0;) {
+        CGRect rect = _worldRects[i];
+        
+        if (CGRectIsEmpty(rect)) {
+            continue;
+        }
+        
+        NSUInteger c0 = MIN(_columns - 1, (NSUInteger)((CGRectGetMinX(rect) - _gridBounds.origin.x) / _gridCellSize.width));
+        NSUInteger c1 = MIN(_columns - 1, (NSUInteger)((CGRectGetMaxX(rect) - _gridBounds.origin.x) / _gridCellSize.width));
+        NSUInteger r0 = MIN(_rows - 1, (NSUInteger)((CGRectGetMinY(rect) - _gridBounds.origin.y) / _gridCellSize.height));
+        NSUInteger r1 = MIN(_rows - 1, (NSUInteger)((CGRectGetMaxY(rect) - _gridBounds.origin.y) / _gridCellSize.height));
+        
+        for (NSUInteger r = r0; r <= r1; r++) {
+            for (NSUInteger c = c0; c <= c1; c++) {
+                _cellEntries[--_cellStarts[r * _columns + c]] = i;
+            }
+        }
+    }
+}
+
+- (BOOL)hasParentMoved
+{
+    for (NSUInteger i = 0; i < _parentsCount; i++) {
+        CGAffineTransform nodeToWorld = [_parents[i].node nodeToWorldTransform];
+        
+        if (!CGAffineTransformEqualToTransform(nodeToWorld, _parents[i].nodeToWorld)) {
+            return YES;
+        }
+    }
+    
+    return NO;
+}
+
+- (NSUInteger)candidatesAtLocation:(CGPoint)location
+{
+    if (_dirty || [self hasParentMoved]) {
+        [self rebuildGrid];
+    }
+    
+    if (_columns == 0 || !CGRectContainsPoint(_gridBounds, location)) {
+        return 0;
+    }
+    
+    NSUInteger column = MIN(_columns - 1, (NSUInteger)((location.x - _gridBounds.origin.x) / _gridCellSize.width));
+    NSUInteger row    = MIN(_rows - 1, (NSUInteger)((location.y - _gridBounds.origin.y) / _gridCellSize.height));
+    NSUInteger cell   = row * _columns + column;
+    NSUInteger start  = _cellStarts[cell];
+    NSUInteger end    = _cellStarts[cell + 1];
+    
+    _candidates = ccControlHitTestGrowBuffer(_candidates, &_candidatesCapacity, MAX(1, end - start), sizeof(NSUInteger));
+    
+    // Keep the controls whose rect contains the location, sorted by priority
+    // (insertion sort is stable so the registration order is kept)
+    NSUInteger count = 0;
+    
+    for (NSUInteger i = start; i < end; i++) {
+        NSUInteger index = _cellEntries[i];
+        
+        if (!CGRectContainsPoint(_worldRects[index], location)) {
+            continue;
+        }
+        
+        NSInteger priority = _controlPriorities[index];
+        NSUInteger j       = count++;
+        
+        while (j > 0 && _controlPriorities[_candidates[j - 1]] > priority) {
+            _candidates[j] = _candidates[j - 1];
+            j--;
+        }
+        
+        _candidates[j] = index;
+    }
+    
+    return count;
+}
+
+- (void)registerPriority:(NSInteger)priority
+{
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+    for (CCControlHitTestPriorityHandler *handler in _priorityHandlers) {
+        if (handler.priority == priority) {
+            handler.controlCount++;
+            return;
+        }
+    }
+    
+    CCControlHitTestPriorityHandler *handler = SAFE_ARC_AUTORELEASE([[CCControlHitTestPriorityHandler alloc] init]);
+    handler.manager                          = self;
+    handler.priority                         = priority;
+    handler.controlCount                     = 1;
+    [_priorityHandlers addObject:handler];
+    
+    [[CCDirector sharedDirector].touchDispatcher addTargetedDelegate:handler priority:priority swallowsTouches:YES];
+#endif
+}
+
+- (void)unregisterPriority:(NSInteger)priority
+{
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+    for (NSUInteger i = 0; i < [_priorityHandlers count]; i++) {
+        CCControlHitTestPriorityHandler *handler = [_priorityHandlers objectAtIndex:i];
+        
+        if (handler.priority != priority) {
+            continue;
+        }
+        
+        if (--handler.controlCount == 0) {
+            // The dispatcher may still deliver the current touch to the handler
+            handler.manager = nil;
+            [[CCDirector sharedDirector].touchDispatcher removeDelegate:handler];
+            [_priorityHandlers removeObjectAtIndex:i];
+        }
+        return;
+    }
+#endif
+}
+
+#pragma mark -
+#pragma mark CCControlHitTestManager Touch Methods
+
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+
+- (BOOL)touchBegan:(UITouch *)touch withEvent:(UIEvent *)event priority:(NSInteger)priority
+{
+    if (_trackedTouchesCount == kCCControlHitTestMaxTrackedTouches) {
+        return NO;
+    }
+    
+    CGPoint location     = [[CCDirector sharedDirector] convertToGL:[touch locationInView:[touch view]]];
+    NSUInteger count     = [self candidatesAtLocation:location];
+    NSUInteger mutations = _mutations;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        // The other priorities have their own handler in the dispatcher
+        if (_controlPriorities[_candidates[i]] != priority) {
+            continue;
+        }
+        
+        CCControl *control = [_controls objectAtIndex:_candidates[i]];
+        
+        if ([control ccTouchBegan:touch withEvent:event]) {
+            _trackedTouches[_trackedTouchesCount].touch   = touch;
+            _trackedTouches[_trackedTouchesCount].control = control;
+            _trackedTouchesCount++;
+            
+            return YES;
+        }
+        
+        // The candidates are no longer valid if the controls have changed
+        if (mutations != _mutations) {
+            break;
+        }
+    }
+    
+    return NO;
+}
+
+- (void)touchMoved:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    for (NSUInteger i = 0; i < _trackedTouchesCount; i++) {
+        if (_trackedTouches[i].touch == touch) {
+            CCControl *control = _trackedTouches[i].control;
+            
+            if ([control respondsToSelector:@selector(ccTouchMoved:withEvent:)]) {
+                [control ccTouchMoved:touch withEvent:event];
+            }
+            return;
+        }
+    }
+}
+
+- (void)touchEnded:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    for (NSUInteger i = 0; i < _trackedTouchesCount; i++) {
+        if (_trackedTouches[i].touch == touch) {
+            CCControl *control = SAFE_ARC_RETAIN(_trackedTouches[i].control);
+            
+            // Stop tracking the touch before notifying the control
+            _trackedTouches[i] = _trackedTouches[--_trackedTouchesCount];
+            
+            if ([control respondsToSelector:@selector(ccTouchEnded:withEvent:)]) {
+                [control ccTouchEnded:touch withEvent:event];
+            }
+            
+            SAFE_ARC_RELEASE(control);
+            return;
+        }
+    }
+}
+
+- (void)touchCancelled:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    for (NSUInteger i = 0; i < _trackedTouchesCount; i++) {
+        if (_trackedTouches[i].touch == touch) {
+            CCControl *control = SAFE_ARC_RETAIN(_trackedTouches[i].control);
+            
+            // Stop tracking the touch before notifying the control
+            _trackedTouches[i] = _trackedTouches[--_trackedTouchesCount];
+            
+            if ([control respondsToSelector:@selector(ccTouchCancelled:withEvent:)]) {
+                [control ccTouchCancelled:touch withEvent:event];
+            }
+            
+            SAFE_ARC_RELEASE(control);
+            return;
+        }
+    }
+}
+
+#endif
+
+@end
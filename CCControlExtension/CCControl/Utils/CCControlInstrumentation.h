@@ -0,0 +1,172 @@
+/*
+ * CCControlInstrumentation.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+
+#include <mach/mach_time.h>
+
+/**
+ * Set CC_CONTROL_INSTRUMENTATION to 1 in the preprocessor macros of the
+ * target to compile the instrumentation of the controls in. When it is 0
+ * the instrumentation points expand to nothing and cost nothing.
+ */
+#ifndef CC_CONTROL_INSTRUMENTATION
+#define CC_CONTROL_INSTRUMENTATION 0
+#endif
+
+/** Number of kinds of instrumentation counter. */
+#define kCCControlCounterTotalNumber 6
+
+/** The measured paths of the controls. */
+typedef enum
+{
+    CCControlCounterSendActions    = 0, // Dispatch of the control events, handlers included.
+    CCControlCounterHandlers       = 1, // Target-actions and blocks called by the dispatch.
+    CCControlCounterNeedsLayout    = 2, // Layout passes requested by needsLayout.
+    CCControlCounterHitTest        = 3, // Tests of a touch (or of a mouse event) against the control.
+    CCControlCounterColorCascade   = 4, // Cascades of the colour to the children.
+    CCControlCounterOpacityCascade = 5  // Cascades of the opacity to the children.
+} CCControlCounter;
+
+/** The number of calls and the time spent in a measured path. */
+typedef struct
+{
+    NSUInteger  numberOfCalls;
+    double      totalTime;  // In milliseconds
+    double      minTime;    // In milliseconds
+    double      maxTime;    // In milliseconds
+} CCControlCounterValue;
+
+/**
+ * Turns the recording on or off at run time when the instrumentation is
+ * compiled in. YES by default.
+ */
+extern BOOL ccControlInstrumentationEnabled;
+
+/**
+ * Adds a call to a measured path of the controls of the given class and
+ * tag.
+ *
+ * @param controlClass The class of the control.
+ * @param tag The tag of the control.
+ * @param counter The measured path.
+ * @param ticks The duration of the call in mach_absolute_time units.
+ */
+extern void ccControlInstrumentationRecord(Class controlClass, NSInteger tag, CCControlCounter counter, uint64_t ticks);
+
+/** A measured call, recorded when it goes out of scope. */
+typedef struct
+{
+    __unsafe_unretained Class controlClass;
+    NSInteger                 tag;
+    CCControlCounter          counter;
+    uint64_t                  start;
+} CCControlInstrumentationScope;
+
+static inline CCControlInstrumentationScope ccControlInstrumentationScopeBegin(CCNode *control, CCControlCounter counter)
+{
+    CCControlInstrumentationScope scope;
+    scope.controlClass = ccControlInstrumentationEnabled ? [control class] : Nil;
+    scope.tag          = [control tag];
+    scope.counter      = counter;
+    scope.start        = mach_absolute_time();
+    
+    return scope;
+}
+
+static inline void ccControlInstrumentationScopeEnd(CCControlInstrumentationScope *scope)
+{
+    if (scope->controlClass) {
+        ccControlInstrumentationRecord(scope->controlClass, scope->tag, scope->counter, mach_absolute_time() - scope->start);
+    }
+}
+
+/**
+ * Measures the rest of the enclosing block as a call to the given path of
+ * the given control. Only one measure can be taken per block.
+ */
+#if CC_CONTROL_INSTRUMENTATION
+#define CC_CONTROL_INSTRUMENT(__control__, __counter__)                                     \
+    CCControlInstrumentationScope __ccControlInstrumentationScope                           \
+        __attribute__((cleanup(ccControlInstrumentationScopeEnd), unused))                  \
+        = ccControlInstrumentationScopeBegin(__control__, __counter__)
+#else
+#define CC_CONTROL_INSTRUMENT(__control__, __counter__) do {} while (0)
+#endif
+
+/**
+ * The CCControlInstrumentation aggregates the counters of the controls per
+ * class and per tag. The classes are not merged with their superclasses:
+ * a CCControlButton subclass has its own counters.
+ *
+ * The counters are published to the CCProfiler as CCProfilingTimer named
+ * "<class> - <counter>" and "CCControl tag <tag> - <counter>", so they are
+ * listed by [[CCProfiler sharedProfiler] displayTimers] along with the
+ * cocos2d timers.
+ *
+ * The measures of the nested paths overlap: the handlers are measured
+ * within the dispatch of the events, and a cascade reaching a child
+ * control is measured within the cascade of its parent.
+ */
+@interface CCControlInstrumentation : NSObject
+{
+@private
+    CFMutableDictionaryRef  _classCounters;
+    CFMutableDictionaryRef  _tagCounters;
+}
+
+#pragma mark Constructors - Initializers
+/** @name Getting the Instrumentation */
+
+/** Returns the shared instrumentation. */
++ (CCControlInstrumentation *)sharedInstrumentation;
+
+#pragma mark Public Methods
+/** @name Reading the Counters */
+
+/** Returns the counter of the controls of the given class. */
+- (CCControlCounterValue)counter:(CCControlCounter)counter forClass:(Class)controlClass;
+
+/** Returns the counter of the controls of the given tag. */
+- (CCControlCounterValue)counter:(CCControlCounter)counter forTag:(NSInteger)tag;
+
+/** Returns a table of all the non-zero counters, one line per class or tag. */
+- (NSString *)dump;
+
+/**
+ * Creates or updates a CCProfilingTimer in the shared CCProfiler for each
+ * non-zero counter.
+ */
+- (void)publishToProfiler;
+
+/** Clears all the counters. The published timers are left as they are. */
+- (void)reset;
+
+/** Returns the name of the given counter. */
++ (NSString *)nameOfCounter:(CCControlCounter)counter;
+
+@end
@@ -0,0 +1,277 @@
+/*
+ * CCControlInstrumentation.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlInstrumentation.h"
+#import "ARCMacro.h"
+
+/** All the counters of a class or of a tag. */
+typedef struct
+{
+    CCControlCounterValue counters[kCCControlCounterTotalNumber];
+} CCControlCounterSet;
+
+BOOL ccControlInstrumentationEnabled = YES;
+
+static CCControlInstrumentation *sharedInstrumentation = nil;
+
+/** Returns the duration of a mach_absolute_time unit in milliseconds. */
+static double ccControlMillisecondsPerTick(void)
+{
+    static double millisecondsPerTick = 0;
+    
+    if (millisecondsPerTick == 0) {
+        mach_timebase_info_data_t timebase;
+        mach_timebase_info(&timebase);
+        
+        millisecondsPerTick = 1e-6 * timebase.numer / timebase.denom;
+    }
+    
+    return millisecondsPerTick;
+}
+
+/** Returns the counters of the given key, created on demand. */
+static CCControlCounterSet *ccControlCounterSetForKey(CFMutableDictionaryRef dictionary, const void *key)
+{
+    CCControlCounterSet *set = (CCControlCounterSet *)CFDictionaryGetValue(dictionary, key);
+    
+    if (!set) {
+        set = calloc(1, sizeof(CCControlCounterSet));
+        CFDictionarySetValue(dictionary, key, set);
+    }
+    
+    return set;
+}
+
+/** Adds a call of the given duration to a counter. */
+static void ccControlCounterValueAdd(CCControlCounterValue *value, double time)
+{
+    value->minTime       = (value->numberOfCalls == 0) ? time : MIN(value->minTime, time);
+    value->maxTime       = MAX(value->maxTime, time);
+    value->totalTime    += time;
+    value->numberOfCalls++;
+}
+
+/** Frees the counters stored in a dictionary. */
+static void ccControlCounterSetFree(const void *key, const void *value, void *context)
+{
+    free((void *)value);
+}
+
+@interface CCControlInstrumentation ()
+
+/** Appends a line per non-zero counter set of the dictionary to the string. */
+- (void)appendCounters:(CFDictionaryRef)dictionary byClass:(BOOL)byClass toString:(NSMutableString *)string;
+
+/** Publishes the non-zero counters of the dictionary to the profiler. */
+- (void)publishCounters:(CFDictionaryRef)dictionary byClass:(BOOL)byClass;
+
+/** Returns the name of the counters of the given key in the dump and the profiler. */
+- (NSString *)nameOfKey:(const void *)key byClass:(BOOL)byClass;
+
+@end
+
+@implementation CCControlInstrumentation
+
+- (void)dealloc
+{
+    CFDictionaryApplyFunction(_classCounters, ccControlCounterSetFree, NULL);
+    CFDictionaryApplyFunction(_tagCounters, ccControlCounterSetFree, NULL);
+    CFRelease(_classCounters);
+    CFRelease(_tagCounters);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+- (id)init
+{
+    if ((self = [super init])) {
+        // The classes and the tags are used as is, without being retained
+        _classCounters = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+        _tagCounters   = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+    }
+    return self;
+}
+
++ (CCControlInstrumentation *)sharedInstrumentation
+{
+    if (!sharedInstrumentation) {
+        sharedInstrumentation = [[CCControlInstrumentation alloc] init];
+    }
+    
+    return sharedInstrumentation;
+}
+
+#pragma mark -
+#pragma mark CCControlInstrumentation Public Methods
+
+- (CCControlCounterValue)counter:(CCControlCounter)counter forClass:(Class)controlClass
+{
+    CCControlCounterSet *set = (CCControlCounterSet *)CFDictionaryGetValue(_classCounters, (__bridge const void *)controlClass);
+    
+    if (set) {
+        return set->counters[counter];
+    }
+    
+    CCControlCounterValue value = { 0, 0, 0, 0 };
+    return value;
+}
+
+- (CCControlCounterValue)counter:(CCControlCounter)counter forTag:(NSInteger)tag
+{
+    CCControlCounterSet *set = (CCControlCounterSet *)CFDictionaryGetValue(_tagCounters, (const void *)tag);
+    
+    if (set) {
+        return set->counters[counter];
+    }
+    
+    CCControlCounterValue value = { 0, 0, 0, 0 };
+    return value;
+}
+
+- (NSString *)dump
+{
+    NSMutableString *string = [NSMutableString string];
+    
+    [string appendString:@"name"];
+    for (int i = 0; i < kCCControlCounterTotalNumber; i++) {
+        [string appendFormat:@"\t%@ (calls / ms)", [CCControlInstrumentation nameOfCounter:i]];
+    }
+    [string appendString:@"\n"];
+    
+    [self appendCounters:_classCounters byClass:YES toString:string];
+    [self appendCounters:_tagCounters byClass:NO toString:string];
+    
+    return string;
+}
+
+- (void)publishToProfiler
+{
+    [self publishCounters:_classCounters byClass:YES];
+    [self publishCounters:_tagCounters byClass:NO];
+}
+
+- (void)reset
+{
+    CFDictionaryApplyFunction(_classCounters, ccControlCounterSetFree, NULL);
+    CFDictionaryApplyFunction(_tagCounters, ccControlCounterSetFree, NULL);
+    CFDictionaryRemoveAllValues(_classCounters);
+    CFDictionaryRemoveAllValues(_tagCounters);
+}
+
++ (NSString *)nameOfCounter:(CCControlCounter)counter
+{
+    static NSString *names[kCCControlCounterTotalNumber] = {
+        @"sendActions", @"handlers", @"needsLayout", @"hitTest", @"colorCascade", @"opacityCascade"
+    };
+    
+    return names[counter];
+}
+
+#pragma mark CCControlInstrumentation Private Methods
+
+- (void)appendCounters:(CFDictionaryRef)dictionary byClass:(BOOL)byClass toString:(NSMutableString *)string
+{
+    CFIndex count       = CFDictionaryGetCount(dictionary);
+    const void **keys   = malloc(count * sizeof(void *));
+    const void **values = malloc(count * sizeof(void *));
+    CFDictionaryGetKeysAndValues(dictionary, keys, values);
+    
+    for (CFIndex i = 0; i < count; i++) {
+        const CCControlCounterSet *set = values[i];
+        
+        [string appendString:[self nameOfKey:keys[i] byClass:byClass]];
+        for (int j = 0; j < kCCControlCounterTotalNumber; j++) {
+            [string appendFormat:@"\t%lu / %.3f", (unsigned long)set->counters[j].numberOfCalls, set->counters[j].totalTime];
+        }
+        [string appendString:@"\n"];
+    }
+    
+    free(keys);
+    free(values);
+}
+
+- (void)publishCounters:(CFDictionaryRef)dictionary byClass:(BOOL)byClass
+{
+    CCProfiler *profiler = [CCProfiler sharedProfiler];
+    CFIndex count        = CFDictionaryGetCount(dictionary);
+    const void **keys    = malloc(count * sizeof(void *));
+    const void **values  = malloc(count * sizeof(void *));
+    CFDictionaryGetKeysAndValues(dictionary, keys, values);
+    
+    for (CFIndex i = 0; i < count; i++) {
+        const CCControlCounterSet *set = values[i];
+        NSString *keyName              = [self nameOfKey:keys[i] byClass:byClass];
+        
+        for (int j = 0; j < kCCControlCounterTotalNumber; j++) {
+            const CCControlCounterValue *value = &set->counters[j];
+            
+            if (value->numberOfCalls == 0) {
+                continue;
+            }
+            
+            NSString *timerName     = [NSString stringWithFormat:@"%@ - %@", keyName, [CCControlInstrumentation nameOfCounter:j]];
+            CCProfilingTimer *timer = [profiler->activeTimers objectForKey:timerName];
+            
+            if (!timer) {
+                timer = [profiler createAndAddTimerWithName:timerName];
+            }
+            
+            timer->numberOfCalls    = value->numberOfCalls;
+            timer->totalTime        = value->totalTime;
+            timer->averageTime      = value->totalTime / value->numberOfCalls;
+            timer->minTime          = value->minTime;
+            timer->maxTime          = value->maxTime;
+        }
+    }
+    
+    free(keys);
+    free(values);
+}
+
+- (NSString *)nameOfKey:(const void *)key byClass:(BOOL)byClass
+{
+    if (byClass) {
+        return NSStringFromClass((__bridge Class)key);
+    }
+    
+    return [NSString stringWithFormat:@"CCControl tag %ld", (long)(NSInteger)key];
+}
+
+#pragma mark - Recording
+
+void ccControlInstrumentationRecord(Class controlClass, NSInteger tag, CCControlCounter counter, uint64_t ticks)
+{
+    CCControlInstrumentation *instrumentation = [CCControlInstrumentation sharedInstrumentation];
+    double time                               = ticks * ccControlMillisecondsPerTick();
+    
+    ccControlCounterValueAdd(&ccControlCounterSetForKey(instrumentation->_classCounters, (__bridge const void *)controlClass)->counters[counter], time);
+    
+    if (tag != kCCNodeTagInvalid) {
+        ccControlCounterValueAdd(&ccControlCounterSetForKey(instrumentation->_tagCounters, (const void *)tag)->counters[counter], time);
+    }
+}
+
+@end
@@ -0,0 +1,131 @@
+/*
+ * CCControlPool.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+
+@class CCControl;
+
+/**
+ * The CCControlPool keeps the controls which have left the node tree so that
+ * the screens built over and over (lists, dialogs) reuse them instead of
+ * allocating their labels, sprites and tables again.
+ *
+ * Only the controls having a reuse identifier are pooled: a control returns
+ * to the queue of its identifier when it is removed from its parent, either
+ * explicitly or because the parent is deallocated (at the end of a scene
+ * transition for example). A pooled control added to a parent again is
+ * withdrawn from the pool.
+ *
+ * A control entering the pool is detached with prepareForEnqueue: its
+ * targets, blocks and subscriptions are removed and its actions stopped. A
+ * control taken from the pool is reset with prepareForReuse: its state,
+ * titles and transform are cleared while its backing nodes are kept.
+ *
+ * @see CCControl reuseIdentifier
+ */
+@interface CCControlPool : NSObject
+{
+@private
+    NSMutableDictionary *_queues;
+    CFMutableSetRef     _pooledControls;
+    NSUInteger          _maximumNumberOfControlsPerIdentifier;
+    
+    NSUInteger          _numberOfHits;
+    NSUInteger          _numberOfMisses;
+    NSUInteger          _numberOfReturnedControls;
+    NSUInteger          _numberOfDiscardedControls;
+}
+/** @name Configuring the Pool */
+/**
+ * The number of controls kept per reuse identifier. The controls returned
+ * beyond it are deallocated as usual.
+ *
+ * The default value is 64.
+ */
+@property (nonatomic, assign) NSUInteger maximumNumberOfControlsPerIdentifier;
+
+/** @name Reading the Statistics */
+/** The number of controls currently in the pool. */
+@property (nonatomic, readonly) NSUInteger numberOfPooledControls;
+/** The number of controls taken from the pool. */
+@property (nonatomic, readonly) NSUInteger numberOfHits;
+/** The number of requests for which the pool had no control. */
+@property (nonatomic, readonly) NSUInteger numberOfMisses;
+/** The number of controls returned to the pool. */
+@property (nonatomic, readonly) NSUInteger numberOfReturnedControls;
+/** The number of controls deallocated because their queue was full. */
+@property (nonatomic, readonly) NSUInteger numberOfDiscardedControls;
+
+#pragma mark Constructors - Initializers
+/** @name Getting the Pool */
+
+/** Returns the shared pool. */
++ (CCControlPool *)sharedPool;
+
+#pragma mark Public Methods
+/** @name Reusing the Controls */
+
+/**
+ * Returns a control of the given reuse identifier, reset with
+ * prepareForReuse, or nil if the pool has none.
+ *
+ * @param identifier A reuse identifier.
+ */
+- (id)dequeueControlWithReuseIdentifier:(NSString *)identifier;
+
+/**
+ * Returns a control to the queue of its reuse identifier and detaches it
+ * with prepareForEnqueue. The controls call it when they are removed from
+ * their parent.
+ *
+ * @param control A control having a reuse identifier and no parent.
+ */
+- (void)enqueueControl:(CCControl *)control;
+
+/**
+ * Withdraws a control from the pool. Does nothing if the control is not
+ * pooled.
+ *
+ * @param control A control.
+ */
+- (void)removeControl:(CCControl *)control;
+
+/** Returns the number of controls pooled with the given reuse identifier. */
+- (NSUInteger)numberOfPooledControlsWithReuseIdentifier:(NSString *)identifier;
+
+/** Releases all the pooled controls. */
+- (void)purge;
+
+/** @name Reading the Statistics */
+
+/** Returns a table of the statistics and of the pooled controls per identifier. */
+- (NSString *)dump;
+
+/** Clears the counters. */
+- (void)resetCounters;
+
+@end
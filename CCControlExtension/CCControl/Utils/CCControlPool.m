@@ -0,0 +1,177 @@
+/*
+ * CCControlPool.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlPool.h"
+#import "CCControl.h"
+#import "ARCMacro.h"
+
+static CCControlPool *sharedPool = nil;
+
+@implementation CCControlPool
+@synthesize maximumNumberOfControlsPerIdentifier = _maximumNumberOfControlsPerIdentifier;
+@synthesize numberOfHits                         = _numberOfHits;
+@synthesize numberOfMisses                       = _numberOfMisses;
+@synthesize numberOfReturnedControls             = _numberOfReturnedControls;
+@synthesize numberOfDiscardedControls            = _numberOfDiscardedControls;
+
+- (void)dealloc
+{
+    SAFE_ARC_RELEASE(_queues);
+    CFRelease(_pooledControls);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+- (id)init
+{
+    if ((self = [super init])) {
+        _queues                               = [[NSMutableDictionary alloc] init];
+        _maximumNumberOfControlsPerIdentifier = 64;
+        
+        // The controls are retained by their queue
+        _pooledControls = CFSetCreateMutable(kCFAllocatorDefault, 0, NULL);
+    }
+    return self;
+}
+
++ (CCControlPool *)sharedPool
+{
+    if (!sharedPool) {
+        sharedPool = [[CCControlPool alloc] init];
+    }
+    
+    return sharedPool;
+}
+
+#pragma mark Properties
+
+- (NSUInteger)numberOfPooledControls
+{
+    return CFSetGetCount(_pooledControls);
+}
+
+#pragma mark -
+#pragma mark CCControlPool Public Methods
+
+- (id)dequeueControlWithReuseIdentifier:(NSString *)identifier
+{
+    NSMutableArray *queue = [_queues objectForKey:identifier];
+    
+    if ([queue count] == 0) {
+        _numberOfMisses++;
+        
+        return nil;
+    }
+    
+    // Take the most recently returned control, its textures are likely still in use
+    CCControl *control = SAFE_ARC_RETAIN([queue lastObject]);
+    [queue removeLastObject];
+    CFSetRemoveValue(_pooledControls, (__bridge const void *)control);
+    
+    _numberOfHits++;
+    
+    [control prepareForReuse];
+    
+    return SAFE_ARC_AUTORELEASE(control);
+}
+
+- (void)enqueueControl:(CCControl *)control
+{
+    NSString *identifier = [control reuseIdentifier];
+    
+    NSAssert(identifier, @"The control must have a reuse identifier.");
+    NSAssert([control parent] == nil, @"The control must not have a parent.");
+    
+    if (CFSetContainsValue(_pooledControls, (__bridge const void *)control)) {
+        return;
+    }
+    
+    NSMutableArray *queue = [_queues objectForKey:identifier];
+    
+    if (!queue) {
+        queue = [NSMutableArray array];
+        [_queues setObject:queue forKey:identifier];
+    }
+    
+    if ([queue count] >= _maximumNumberOfControlsPerIdentifier) {
+        _numberOfDiscardedControls++;
+        return;
+    }
+    
+    [queue addObject:control];
+    CFSetAddValue(_pooledControls, (__bridge const void *)control);
+    
+    // Release the targets now rather than when the control is reused
+    [control prepareForEnqueue];
+    
+    _numberOfReturnedControls++;
+}
+
+- (void)removeControl:(CCControl *)control
+{
+    if (!CFSetContainsValue(_pooledControls, (__bridge const void *)control)) {
+        return;
+    }
+    
+    CFSetRemoveValue(_pooledControls, (__bridge const void *)control);
+    [[_queues objectForKey:[control reuseIdentifier]] removeObjectIdenticalTo:control];
+}
+
+- (NSUInteger)numberOfPooledControlsWithReuseIdentifier:(NSString *)identifier
+{
+    return [[_queues objectForKey:identifier] count];
+}
+
+- (void)purge
+{
+    CFSetRemoveAllValues(_pooledControls);
+    [_queues removeAllObjects];
+}
+
+- (NSString *)dump
+{
+    NSMutableString *string = [NSMutableString string];
+    
+    [string appendFormat:@"%lu pooled, %lu hits, %lu misses, %lu returned, %lu discarded\n",
+     (unsigned long)[self numberOfPooledControls], (unsigned long)_numberOfHits, (unsigned long)_numberOfMisses,
+     (unsigned long)_numberOfReturnedControls, (unsigned long)_numberOfDiscardedControls];
+    
+    for (NSString *identifier in [[_queues allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        [string appendFormat:@"%@: %lu\n", identifier, (unsigned long)[[_queues objectForKey:identifier] count]];
+    }
+    
+    return string;
+}
+
+- (void)resetCounters
+{
+    _numberOfHits              = 0;
+    _numberOfMisses            = 0;
+    _numberOfReturnedControls  = 0;
+    _numberOfDiscardedControls = 0;
+}
+
+@end
@@ -0,0 +1,71 @@
+/*
+ * CCControlProgressTimer.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+
+/** Number of corners of the sprite rect swept by the radial progress. */
+#define kCCControlProgressTimerCorners      4
+/** Maximum number of vertices of the radial progress: the midpoint, the
+ 12 o'clock point, the corners and the sweeping point. */
+#define kCCControlProgressTimerMaxVertices  (kCCControlProgressTimerCorners + 3)
+
+/**
+ * CCControlProgressTimer is a CCProgressTimer with an incremental radial
+ * mode, for the controls updating their progress on every touch sample.
+ *
+ * The corners of the sprite rect, the percentages at which the sweep crosses
+ * them and their vertices are computed once per sprite rect, midpoint and
+ * direction. A change of percentage then only intersects the sweeping ray
+ * with the edge of its segment, and only updates the sweeping vertex while
+ * it stays inside the same segment. The vertex data is allocated once at
+ * its maximum size.
+ *
+ * The bar type is drawn by CCProgressTimer.
+ */
+@interface CCControlProgressTimer : CCProgressTimer
+{
+@protected
+    BOOL                _incremental;
+    
+    BOOL                _radialTableValid;
+    ccV3F_C4B_T2F_Quad  _radialQuad;
+    CGPoint             _radialMidpoint;
+    BOOL                _radialReverse;
+    CGPoint             _radialCorners[kCCControlProgressTimerCorners];
+    float               _radialCornerPercents[kCCControlProgressTimerCorners];
+    ccV2F_C4B_T2F       _radialVertices[kCCControlProgressTimerMaxVertices];
+    ccV2F_C4B_T2F       *_radialVertexData;
+    NSInteger           _radialIndex;
+}
+/**
+ * @abstract Uses the incremental radial mode.
+ * @discussion By default it is YES. When NO the geometry is rebuilt by
+ * CCProgressTimer on every change of percentage.
+ */
+@property (nonatomic, assign, getter = isIncremental) BOOL incremental;
+
+@end
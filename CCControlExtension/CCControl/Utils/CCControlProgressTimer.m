@@ -0,0 +1,255 @@
+/*
+ * CCControlProgressTimer.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlProgressTimer.h"
+
+// The vertex data of CCProgressTimer has no setter, and cocos2d 2.1 prefixes
+// its ivars with an underscore
+#if COCOS2D_VERSION >= 0x00020100
+#define CCControlProgressTimerVertexData        _vertexData
+#define CCControlProgressTimerVertexDataCount   _vertexDataCount
+#else
+#define CCControlProgressTimerVertexData        vertexData_
+#define CCControlProgressTimerVertexDataCount   vertexDataCount_
+#endif
+
+/** The geometry helpers of CCProgressTimer used by the incremental mode. */
+@interface CCProgressTimer (CCControlProgressTimer)
+
+- (void)updateProgress;
+- (void)updateRadial;
+- (void)updateColor;
+- (CGPoint)boundaryTexCoord:(char)index;
+- (ccTex2F)textureCoordFromAlphaPoint:(CGPoint)alpha;
+- (ccVertex2F)vertexFromAlphaPoint:(CGPoint)alpha;
+
+@end
+
+/**
+ * Returns the fraction of the turn, between 0 and 1, swept from the 12 o'clock
+ * direction to the given direction, clockwise or counterclockwise if reverse.
+ */
+static inline float ccControlProgressTimerPercentOfDirection(CGPoint direction, BOOL reverse)
+{
+    float angle = atan2f(reverse ? -direction.x : direction.x, direction.y);
+    
+    if (angle < 0) {
+        angle += 2.0f * (float)M_PI;
+    }
+    
+    return angle / (2.0f * (float)M_PI);
+}
+
+@interface CCControlProgressTimer ()
+
+/** Returns YES if the table of the radial geometry matches the sprite. */
+- (BOOL)isRadialTableValid;
+
+/** Computes the corners, their percentages and their vertices. */
+- (void)updateRadialTable;
+
+/** Sets the vertex data to the given point of the sprite. */
+- (void)setVertex:(NSInteger)index withAlphaPoint:(CGPoint)alphaPoint;
+
+@end
+
+@implementation CCControlProgressTimer
+@synthesize incremental = _incremental;
+
+- (id)initWithSprite:(CCSprite *)sprite
+{
+    if ((self = [super initWithSprite:sprite])) {
+        _incremental = YES;
+    }
+    return self;
+}
+
+- (void)setIncremental:(BOOL)incremental
+{
+    _incremental      = incremental;
+    _radialTableValid = NO;
+    
+    // Let the mode owning the vertex data rebuild it
+    if (CCControlProgressTimerVertexData) {
+        free(CCControlProgressTimerVertexData);
+        CCControlProgressTimerVertexData      = NULL;
+        CCControlProgressTimerVertexDataCount = 0;
+    }
+    _radialVertexData = NULL;
+    
+    [self updateProgress];
+}
+
+#pragma mark CCControlProgressTimer Private Methods
+
+- (void)updateRadial
+{
+    CGPoint midpoint = [self midpoint];
+    
+    // The sweep cannot be split by segments around a midpoint on the boundary
+    if (!_incremental
+        || ![self sprite]
+        || midpoint.x <= 0 || midpoint.x >= 1
+        || midpoint.y <= 0 || midpoint.y >= 1) {
+        [super updateRadial];
+        
+        // CCProgressTimer may have allocated a smaller buffer, possibly at
+        // the address of the one freed before
+        _radialVertexData = NULL;
+        _radialIndex      = -1;
+        return;
+    }
+    
+    // CCProgressTimer frees or reallocates the vertex data when the sprite,
+    // the type or the direction changes
+    if (CCControlProgressTimerVertexData == NULL || CCControlProgressTimerVertexData != _radialVertexData) {
+        if (CCControlProgressTimerVertexData) {
+            free(CCControlProgressTimerVertexData);
+        }
+        CCControlProgressTimerVertexData      = malloc(kCCControlProgressTimerMaxVertices * sizeof(ccV2F_C4B_T2F));
+        NSAssert(CCControlProgressTimerVertexData, @"CCControlProgressTimer. Not enough memory");
+        CCControlProgressTimerVertexDataCount = 0;
+        _radialVertexData                     = CCControlProgressTimerVertexData;
+        _radialIndex                          = -1;
+    }
+    
+    if (![self isRadialTableValid]) {
+        [self updateRadialTable];
+    }
+    
+    float alpha       = [self percentage] / 100.f;
+    CGPoint topMid    = ccp(midpoint.x, 1.f);
+    NSInteger index   = 0;
+    
+    // Same segment as the closest intersection of CCProgressTimer: the
+    // corners strictly before the percentage are swept
+    if (alpha >= 1.f) {
+        index = kCCControlProgressTimerCorners;
+    }
+    else if (alpha > 0.f) {
+        while (index < kCCControlProgressTimerCorners && _radialCornerPercents[index] < alpha) {
+            index++;
+        }
+    }
+    
+    // Restore the corners hidden by the previous sweeping vertex
+    if (index != _radialIndex || CCControlProgressTimerVertexDataCount != index + 3) {
+        memcpy(CCControlProgressTimerVertexData, _radialVertices, (index + 2) * sizeof(ccV2F_C4B_T2F));
+        
+        CCControlProgressTimerVertexDataCount = (int)index + 3;
+        _radialIndex                          = index;
+    }
+    
+    CGPoint hit = topMid;
+    
+    if (alpha > 0.f && alpha < 1.f) {
+        float angle          = 2.f * (float)M_PI * ([self reverseDirection] ? alpha : 1.f - alpha);
+        CGPoint percentagePt = ccpRotateByAngle(topMid, midpoint, angle);
+        CGPoint edgePtA      = (index == 0) ? topMid : _radialCorners[index - 1];
+        CGPoint edgePtB      = (index == kCCControlProgressTimerCorners) ? topMid : _radialCorners[index];
+        float s              = 0;
+        float t              = 0;
+        
+        if (ccpLineIntersect(edgePtA, edgePtB, midpoint, percentagePt, &s, &t)) {
+            hit = ccpAdd(midpoint, ccpMult(ccpSub(percentagePt, midpoint), t));
+        }
+        else {
+            hit = edgePtA;
+        }
+    }
+    
+    [self setVertex:CCControlProgressTimerVertexDataCount - 1 withAlphaPoint:hit];
+}
+
+- (BOOL)isRadialTableValid
+{
+    if (!_radialTableValid
+        || _radialReverse != [self reverseDirection]
+        || !CGPointEqualToPoint(_radialMidpoint, [self midpoint])) {
+        return NO;
+    }
+    
+    // The sprite rect, its texture coordinates or its flip may have changed
+    ccV3F_C4B_T2F_Quad quad = [self sprite].quad;
+    
+    return memcmp(&quad.bl.vertices, &_radialQuad.bl.vertices, sizeof(ccVertex3F)) == 0
+        && memcmp(&quad.tr.vertices, &_radialQuad.tr.vertices, sizeof(ccVertex3F)) == 0
+        && memcmp(&quad.bl.texCoords, &_radialQuad.bl.texCoords, sizeof(ccTex2F)) == 0
+        && memcmp(&quad.tr.texCoords, &_radialQuad.tr.texCoords, sizeof(ccTex2F)) == 0;
+}
+
+- (void)updateRadialTable
+{
+    _radialQuad      = [self sprite].quad;
+    _radialMidpoint  = [self midpoint];
+    _radialReverse   = [self reverseDirection];
+    
+    CGPoint topMid   = ccp(_radialMidpoint.x, 1.f);
+    ccColor4B color  = _radialQuad.tl.colors;
+    
+    _radialVertices[0].texCoords = [self textureCoordFromAlphaPoint:_radialMidpoint];
+    _radialVertices[0].vertices  = [self vertexFromAlphaPoint:_radialMidpoint];
+    _radialVertices[1].texCoords = [self textureCoordFromAlphaPoint:topMid];
+    _radialVertices[1].vertices  = [self vertexFromAlphaPoint:topMid];
+    
+    for (NSInteger i = 0; i < kCCControlProgressTimerCorners; i++) {
+        _radialCorners[i]                = [self boundaryTexCoord:i];
+        _radialCornerPercents[i]         = ccControlProgressTimerPercentOfDirection(ccpSub(_radialCorners[i], _radialMidpoint), _radialReverse);
+        _radialVertices[i + 2].texCoords = [self textureCoordFromAlphaPoint:_radialCorners[i]];
+        _radialVertices[i + 2].vertices  = [self vertexFromAlphaPoint:_radialCorners[i]];
+    }
+    
+    for (NSInteger i = 0; i < kCCControlProgressTimerMaxVertices; i++) {
+        _radialVertices[i].colors = color;
+    }
+    
+    // Forces the corners to be copied
+    _radialIndex      = -1;
+    _radialTableValid = YES;
+}
+
+- (void)setVertex:(NSInteger)index withAlphaPoint:(CGPoint)alphaPoint
+{
+    CCControlProgressTimerVertexData[index].texCoords = [self textureCoordFromAlphaPoint:alphaPoint];
+    CCControlProgressTimerVertexData[index].vertices  = [self vertexFromAlphaPoint:alphaPoint];
+    CCControlProgressTimerVertexData[index].colors    = _radialVertices[0].colors;
+}
+
+- (void)updateColor
+{
+    [super updateColor];
+    
+    // Keep the colour of the corners restored from the table
+    if (_radialTableValid) {
+        ccColor4B color = [self sprite].quad.tl.colors;
+        
+        for (NSInteger i = 0; i < kCCControlProgressTimerMaxVertices; i++) {
+            _radialVertices[i].colors = color;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,113 @@
+/*
+ * CCControlRasterCache.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+
+/**
+ * The sizes of the pooled render textures are rounded up to a multiple of
+ * this value (in points), so that controls of close sizes share them.
+ */
+#define kCCControlRasterCacheGranularity 16
+
+/**
+ * The CCControlRasterCache pools the render textures used by the controls
+ * which rasterize themselves when they are idle (see the rasterizesWhenIdle
+ * property of CCControl), and counts how often the rasterized images are
+ * reused.
+ *
+ * A control gives its render texture back when it stops rasterizing or
+ * leaves the stage, so that the next one can render into it instead of
+ * allocating a new framebuffer.
+ */
+@interface CCControlRasterCache : NSObject
+{
+@private
+    NSMutableArray  *_freeRenderTextures;
+    NSUInteger      _maximumNumberOfFreeRenderTextures;
+    
+    NSUInteger      _numberOfHits;
+    NSUInteger      _numberOfMisses;
+    NSUInteger      _numberOfRenderTexturesCreated;
+}
+/** @name Configuring the Pool */
+/**
+ * The number of unused render textures kept in the pool. The render
+ * textures given back beyond it are released.
+ *
+ * The default value is 8.
+ */
+@property (nonatomic, assign) NSUInteger maximumNumberOfFreeRenderTextures;
+/** The number of unused render textures currently in the pool. */
+@property (nonatomic, readonly) NSUInteger numberOfFreeRenderTextures;
+
+/** @name Reading the Counters */
+/** The number of frames a control has been drawn from its rasterized image. */
+@property (nonatomic, readonly) NSUInteger numberOfHits;
+/** The number of times a control has been rendered into its image. */
+@property (nonatomic, readonly) NSUInteger numberOfMisses;
+/** The number of render textures allocated by the pool. */
+@property (nonatomic, readonly) NSUInteger numberOfRenderTexturesCreated;
+
+#pragma mark Constructors - Initializers
+/** @name Getting the Raster Cache */
+
+/** Returns the shared raster cache. */
++ (CCControlRasterCache *)sharedRasterCache;
+
+#pragma mark Public Methods
+/** @name Managing the Render Textures */
+
+/**
+ * Returns a render texture at least as large as the given size, taken from
+ * the pool when one fits, created otherwise.
+ *
+ * @param size The size in points of the image to render.
+ */
+- (CCRenderTexture *)renderTextureWithSize:(CGSize)size;
+
+/**
+ * Gives a render texture back to the pool.
+ *
+ * @param renderTexture A render texture returned by renderTextureWithSize:.
+ */
+- (void)recycleRenderTexture:(CCRenderTexture *)renderTexture;
+
+/** Releases all the unused render textures. */
+- (void)purge;
+
+/** @name Counting the Hits and the Misses */
+
+/** Counts a frame drawn from a rasterized image. */
+- (void)recordHit;
+
+/** Counts a rendering of a control into its image. */
+- (void)recordMiss;
+
+/** Clears the counters. */
+- (void)resetCounters;
+
+@end
@@ -0,0 +1,159 @@
+/*
+ * CCControlRasterCache.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlRasterCache.h"
+#import "ARCMacro.h"
+
+static CCControlRasterCache *sharedRasterCache = nil;
+
+/** Rounds up the given length to the granularity of the pool. */
+static inline CGFloat ccControlRasterCacheRoundUp(CGFloat length)
+{
+    return ceilf(MAX(length, 1) / kCCControlRasterCacheGranularity) * kCCControlRasterCacheGranularity;
+}
+
+@implementation CCControlRasterCache
+@synthesize maximumNumberOfFreeRenderTextures = _maximumNumberOfFreeRenderTextures;
+@synthesize numberOfHits                      = _numberOfHits;
+@synthesize numberOfMisses                    = _numberOfMisses;
+@synthesize numberOfRenderTexturesCreated     = _numberOfRenderTexturesCreated;
+
+- (void)dealloc
+{
+    SAFE_ARC_RELEASE(_freeRenderTextures);
+    
+    SAFE_ARC_SUPER_DEALLOC();
+}
+
+- (id)init
+{
+    if ((self = [super init])) {
+        _freeRenderTextures                = [[NSMutableArray alloc] init];
+        _maximumNumberOfFreeRenderTextures = 8;
+    }
+    return self;
+}
+
++ (CCControlRasterCache *)sharedRasterCache
+{
+    if (!sharedRasterCache) {
+        sharedRasterCache = [[CCControlRasterCache alloc] init];
+    }
+    
+    return sharedRasterCache;
+}
+
+#pragma mark Properties
+
+- (void)setMaximumNumberOfFreeRenderTextures:(NSUInteger)maximumNumberOfFreeRenderTextures
+{
+    _maximumNumberOfFreeRenderTextures = maximumNumberOfFreeRenderTextures;
+    
+    while ([_freeRenderTextures count] > _maximumNumberOfFreeRenderTextures) {
+        [_freeRenderTextures removeObjectAtIndex:0];
+    }
+}
+
+- (NSUInteger)numberOfFreeRenderTextures
+{
+    return [_freeRenderTextures count];
+}
+
+#pragma mark -
+#pragma mark CCControlRasterCache Public Methods
+
+- (CCRenderTexture *)renderTextureWithSize:(CGSize)size
+{
+    CGFloat width  = ccControlRasterCacheRoundUp(size.width);
+    CGFloat height = ccControlRasterCacheRoundUp(size.height);
+    
+    // Take the smallest free texture which fits without wasting more than its half
+    NSUInteger bestIndex = NSNotFound;
+    CGFloat bestArea     = 2 * width * height;
+    NSUInteger index     = 0;
+    
+    for (CCRenderTexture *renderTexture in _freeRenderTextures) {
+        CGSize textureSize = renderTexture.sprite.texture.contentSize;
+        CGFloat area       = textureSize.width * textureSize.height;
+        
+        if (textureSize.width >= width && textureSize.height >= height && area <= bestArea) {
+            bestIndex = index;
+            bestArea  = area;
+        }
+        index++;
+    }
+    
+    if (bestIndex != NSNotFound) {
+        CCRenderTexture *renderTexture = SAFE_ARC_RETAIN([_freeRenderTextures objectAtIndex:bestIndex]);
+        [_freeRenderTextures removeObjectAtIndex:bestIndex];
+        
+        return SAFE_ARC_AUTORELEASE(renderTexture);
+    }
+    
+    _numberOfRenderTexturesCreated++;
+    
+    return [CCRenderTexture renderTextureWithWidth:width height:height];
+}
+
+- (void)recycleRenderTexture:(CCRenderTexture *)renderTexture
+{
+    if (renderTexture == nil) {
+        return;
+    }
+    
+    // Forget the oldest texture first
+    if ([_freeRenderTextures count] >= _maximumNumberOfFreeRenderTextures && [_freeRenderTextures count] > 0) {
+        [_freeRenderTextures removeObjectAtIndex:0];
+    }
+    
+    if (_maximumNumberOfFreeRenderTextures > 0) {
+        [_freeRenderTextures addObject:renderTexture];
+    }
+}
+
+- (void)purge
+{
+    [_freeRenderTextures removeAllObjects];
+}
+
+- (void)recordHit
+{
+    _numberOfHits++;
+}
+
+- (void)recordMiss
+{
+    _numberOfMisses++;
+}
+
+- (void)resetCounters
+{
+    _numberOfHits                  = 0;
+    _numberOfMisses                = 0;
+    _numberOfRenderTexturesCreated = 0;
+}
+
+@end
@@ -0,0 +1,125 @@
+/*
+ * CCControlSwitchQuads.c
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "CCControlSwitchQuads.h"
+
+/** Sets the members of a vertex. */
+static void ccControlSwitchSetVertex(ccControlSwitchVertex *vertex, float x, float y, float u, float v, float maskU, float maskV, ccControlSwitchColor4B color)
+{
+    vertex->vertices.x   = x;
+    vertex->vertices.y   = y;
+    vertex->colors       = color;
+    vertex->texCoords.u  = u;
+    vertex->texCoords.v  = v;
+    vertex->maskCoords.u = maskU;
+    vertex->maskCoords.v = maskV;
+}
+
+/**
+ * Fills the quad of a side of the switch, clipped to the mask.
+ *
+ * @param x The left of the side in the switch, its bottom being 0.
+ * @param size The size of the side.
+ * @param region The region of the side in the atlas.
+ * @return 0 if the side is hidden by the mask.
+ */
+static int ccControlSwitchFillSideQuad(ccControlSwitchQuad *quad, const ccControlSwitchSkinLayout *layout, float x, ccControlSwitchSize size, ccControlSwitchRegion region, ccControlSwitchColor4B color)
+{
+    ccControlSwitchSize maskSize = layout->maskSize;
+    ccControlSwitchRegion mask   = layout->maskRegion;
+    
+    float x0 = (x > 0) ? x : 0;
+    float x1 = (x + size.width < maskSize.width) ? x + size.width : maskSize.width;
+    float y0 = 0;
+    float y1 = (size.height < maskSize.height) ? size.height : maskSize.height;
+    
+    if (x0 >= x1 || y0 >= y1) {
+        return 0;
+    }
+    
+    // The texture coordinates grow downward
+    float u0     = region.x + (x0 - x) / size.width * region.width;
+    float u1     = region.x + (x1 - x) / size.width * region.width;
+    float v0     = region.y + (size.height - y0) / size.height * region.height;
+    float v1     = region.y + (size.height - y1) / size.height * region.height;
+    
+    float maskU0 = mask.x + x0 / maskSize.width * mask.width;
+    float maskU1 = mask.x + x1 / maskSize.width * mask.width;
+    float maskV0 = mask.y + (maskSize.height - y0) / maskSize.height * mask.height;
+    float maskV1 = mask.y + (maskSize.height - y1) / maskSize.height * mask.height;
+    
+    ccControlSwitchSetVertex(&quad->bl, x0, y0, u0, v0, maskU0, maskV0, color);
+    ccControlSwitchSetVertex(&quad->br, x1, y0, u1, v0, maskU1, maskV0, color);
+    ccControlSwitchSetVertex(&quad->tl, x0, y1, u0, v1, maskU0, maskV1, color);
+    ccControlSwitchSetVertex(&quad->tr, x1, y1, u1, v1, maskU1, maskV1, color);
+    
+    return 1;
+}
+
+size_t ccControlSwitchFillQuads(const ccControlSwitchSkinLayout *layout, float sliderXPosition, ccControlSwitchColor4B color, ccControlSwitchColor4B thumbColor, ccControlSwitchQuad *quads)
+{
+    size_t count                  = 0;
+    ccControlSwitchSize onSize    = layout->onSize;
+    ccControlSwitchSize thumbSize = layout->thumbSize;
+    
+    // Same positions as CCControlSwitchSprite -needsLayout
+    if (ccControlSwitchFillSideQuad(&quads[count], layout, sliderXPosition, onSize, layout->onRegion, color)) {
+        count++;
+    }
+    
+    if (ccControlSwitchFillSideQuad(&quads[count], layout, onSize.width + sliderXPosition, layout->offSize, layout->offRegion, color)) {
+        count++;
+    }
+    
+    // The thumb is not masked so it samples the opaque region as mask
+    ccControlSwitchRegion thumb  = layout->thumbRegion;
+    ccControlSwitchRegion opaque = layout->opaqueRegion;
+    float x0                     = onSize.width + sliderXPosition - thumbSize.width / 2;
+    float x1                     = x0 + thumbSize.width;
+    float y0                     = layout->maskSize.height / 2 - thumbSize.height / 2;
+    float y1                     = y0 + thumbSize.height;
+    float maskU                  = opaque.x + opaque.width / 2;
+    float maskV                  = opaque.y + opaque.height / 2;
+    
+    ccControlSwitchSetVertex(&quads[count].bl, x0, y0, thumb.x, thumb.y + thumb.height, maskU, maskV, thumbColor);
+    ccControlSwitchSetVertex(&quads[count].br, x1, y0, thumb.x + thumb.width, thumb.y + thumb.height, maskU, maskV, thumbColor);
+    ccControlSwitchSetVertex(&quads[count].tl, x0, y1, thumb.x, thumb.y, maskU, maskV, thumbColor);
+    ccControlSwitchSetVertex(&quads[count].tr, x1, y1, thumb.x + thumb.width, thumb.y, maskU, maskV, thumbColor);
+    count++;
+    
+    return count;
+}
+
+void ccControlSwitchTransformQuads(ccControlSwitchQuad *quads, size_t count, ccControlSwitchTransform transform)
+{
+    ccControlSwitchVertex *vertices = (ccControlSwitchVertex *)quads;
+    
+    for (size_t i = 0; i < count * 4; i++) {
+        ccControlSwitchVertex2F vertex = vertices[i].vertices;
+        vertices[i].vertices.x         = transform.a * vertex.x + transform.c * vertex.y + transform.tx;
+        vertices[i].vertices.y         = transform.b * vertex.x + transform.d * vertex.y + transform.ty;
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * CCControlSwitchQuads.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef CCControlSwitchQuads_h
+#define CCControlSwitchQuads_h
+
+#include <stddef.h>
+
+/**
+ * The quads of the switches drawn by a CCControlSwitchBatchNode.
+ *
+ * This header is shared with the cccontrolswitchcheck tool
+ * (tools/cccontrolswitchcheck) and must stay plain C. Its types have the
+ * memory layout of their cocos2d counterparts (ccVertex2F, ccColor4B,
+ * ccTex2F) so that the quads can be fed to OpenGL as is.
+ */
+
+/** A position, like ccVertex2F. */
+typedef struct _ccControlSwitchVertex2F
+{
+    float   x;
+    float   y;
+} ccControlSwitchVertex2F;
+
+/** A colour with premultiplied alpha, like ccColor4B. */
+typedef struct _ccControlSwitchColor4B
+{
+    unsigned char   r;
+    unsigned char   g;
+    unsigned char   b;
+    unsigned char   a;
+} ccControlSwitchColor4B;
+
+/** Texture coordinates, like ccTex2F. */
+typedef struct _ccControlSwitchTex2F
+{
+    float   u;
+    float   v;
+} ccControlSwitchTex2F;
+
+/** A size, in points. */
+typedef struct _ccControlSwitchSize
+{
+    float   width;
+    float   height;
+} ccControlSwitchSize;
+
+/** A region of the atlas, in texture coordinates. */
+typedef struct _ccControlSwitchRegion
+{
+    float   x;
+    float   y;
+    float   width;
+    float   height;
+} ccControlSwitchRegion;
+
+/** An affine transform, like CGAffineTransform. */
+typedef struct _ccControlSwitchTransform
+{
+    float   a, b, c, d;
+    float   tx, ty;
+} ccControlSwitchTransform;
+
+/** A vertex of a batched switch, with the texture coordinates of its mask. */
+typedef struct _ccControlSwitchVertex
+{
+    ccControlSwitchVertex2F vertices;
+    ccControlSwitchColor4B  colors;
+    ccControlSwitchTex2F    texCoords;
+    ccControlSwitchTex2F    maskCoords;
+} ccControlSwitchVertex;
+
+/** A quad of a batched switch. */
+typedef struct _ccControlSwitchQuad
+{
+    ccControlSwitchVertex   bl;
+    ccControlSwitchVertex   br;
+    ccControlSwitchVertex   tl;
+    ccControlSwitchVertex   tr;
+} ccControlSwitchQuad;
+
+/**
+ * Layout of a switch skin: the sizes of its parts in points and their
+ * regions in the atlas in texture coordinates, the origin being the top left
+ * corner of the region like for the images.
+ */
+typedef struct _ccControlSwitchSkinLayout
+{
+    ccControlSwitchSize     maskSize;
+    ccControlSwitchSize     onSize;
+    ccControlSwitchSize     offSize;
+    ccControlSwitchSize     thumbSize;
+    
+    ccControlSwitchRegion   maskRegion;
+    ccControlSwitchRegion   onRegion;
+    ccControlSwitchRegion   offRegion;
+    ccControlSwitchRegion   thumbRegion;
+    ccControlSwitchRegion   opaqueRegion;   // Region sampled as mask by the unmasked thumb
+} ccControlSwitchSkinLayout;
+
+/**
+ * Fills the quads of a switch in the coordinates of the switch, with the same
+ * layout as a non batched switch: the on and off sides are clipped to the
+ * mask and the thumb is drawn over them.
+ *
+ * @param layout The layout of the skin.
+ * @param sliderXPosition The position of the slider, between
+ * thumbSize.width / 2 - onSize.width (off) and 0 (on).
+ * @param color The premultiplied colour of the sides.
+ * @param thumbColor The premultiplied colour of the thumb.
+ * @param quads The quads to fill, kCCControlSwitchQuadsPerSwitch at most.
+ * @return The number of filled quads.
+ */
+size_t ccControlSwitchFillQuads(const ccControlSwitchSkinLayout *layout, float sliderXPosition, ccControlSwitchColor4B color, ccControlSwitchColor4B thumbColor, ccControlSwitchQuad *quads);
+
+/** Applies the affine transform to the vertices of the quads. */
+void ccControlSwitchTransformQuads(ccControlSwitchQuad *quads, size_t count, ccControlSwitchTransform transform);
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * CCControlVelocityTracker.h
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "cocos2d.h"
+
+/** Number of samples kept by the velocity tracker. */
+#define kCCControlVelocityTrackerCapacity   16
+/** Age limit of the samples used to estimate the velocity, in seconds. */
+#define kCCControlVelocityTrackerHorizon    0.1
+
+/**
+ * A location sampled at a given time.
+ */
+typedef struct
+{
+    CGPoint location;
+    double  timestamp;
+} CCControlVelocitySample;
+
+/**
+ * The CCControlVelocityTracker estimates the velocity of a touch or of a
+ * mouse drag.
+ *
+ * The samples are stored in a fixed ring buffer so that adding one does not
+ * allocate. The velocity is the slope of the least-squares line fitted to the
+ * samples of the last kCCControlVelocityTrackerHorizon seconds, which smooths
+ * the noise of the event locations.
+ */
+@interface CCControlVelocityTracker : NSObject
+{
+@private
+    CCControlVelocitySample _samples[kCCControlVelocityTrackerCapacity];
+    NSUInteger              _head;
+    NSUInteger              _count;
+}
+
+#pragma mark Constructors - Initializers
+/** @name Create Velocity Trackers */
+
+/** Creates an empty velocity tracker. */
++ (id)velocityTracker;
+
+#pragma mark Public Methods
+/** @name Tracking the Velocity */
+
+/**
+ * Returns the current time of a monotonic clock, in seconds. Unlike NSDate
+ * it does not allocate and is not affected by the changes of the system time.
+ */
++ (double)currentTimestamp;
+
+/** Removes all the samples. */
+- (void)reset;
+
+/** Adds a location sampled now. */
+- (void)addLocation:(CGPoint)location;
+
+/**
+ * Adds a location sampled at the given time. The timestamps must be given in
+ * increasing order. Use the timestamps of the touches or of the events when
+ * they are available: they are not delayed by the event delivery.
+ *
+ * @param location The location to add.
+ * @param timestamp The time of the sample, in seconds.
+ */
+- (void)addLocation:(CGPoint)location timestamp:(double)timestamp;
+
+/**
+ * Returns the estimated velocity in points per second, or CGPointZero if
+ * there are not enough recent samples.
+ */
+- (CGPoint)velocity;
+
+@end
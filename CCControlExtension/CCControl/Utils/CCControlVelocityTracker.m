@@ -0,0 +1,123 @@
+/*
+ * CCControlVelocityTracker.m
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlVelocityTracker.h"
+#import "ARCMacro.h"
+
+#include <mach/mach_time.h>
+
+@implementation CCControlVelocityTracker
+
+- (id)init
+{
+    if ((self = [super init])) {
+        [self reset];
+    }
+    return self;
+}
+
++ (id)velocityTracker
+{
+    return SAFE_ARC_AUTORELEASE([[self alloc] init]);
+}
+
+#pragma mark -
+#pragma mark CCControlVelocityTracker Public Methods
+
++ (double)currentTimestamp
+{
+    static double secondsPerTick = 0;
+    
+    if (secondsPerTick == 0) {
+        mach_timebase_info_data_t timebase;
+        mach_timebase_info(&timebase);
+        
+        secondsPerTick = 1e-9 * timebase.numer / timebase.denom;
+    }
+    
+    return mach_absolute_time() * secondsPerTick;
+}
+
+- (void)reset
+{
+    _head  = 0;
+    _count = 0;
+}
+
+- (void)addLocation:(CGPoint)location
+{
+    [self addLocation:location timestamp:[CCControlVelocityTracker currentTimestamp]];
+}
+
+- (void)addLocation:(CGPoint)location timestamp:(double)timestamp
+{
+    _samples[_head].location  = location;
+    _samples[_head].timestamp = timestamp;
+    
+    _head  = (_head + 1) % kCCControlVelocityTrackerCapacity;
+    _count = MIN(_count + 1, kCCControlVelocityTrackerCapacity);
+}
+
+- (CGPoint)velocity
+{
+    if (_count < 2) {
+        return CGPointZero;
+    }
+    
+    NSUInteger newest = (_head + kCCControlVelocityTrackerCapacity - 1) % kCCControlVelocityTrackerCapacity;
+    double origin     = _samples[newest].timestamp;
+    
+    // Accumulate the sums of the least-squares fit, relative to the newest
+    // sample to keep the precision
+    double n = 0, st = 0, stt = 0, sx = 0, sy = 0, stx = 0, sty = 0;
+    
+    for (NSUInteger i = 0; i < _count; i++) {
+        CCControlVelocitySample *sample = &_samples[(newest + kCCControlVelocityTrackerCapacity - i) % kCCControlVelocityTrackerCapacity];
+        double t                        = sample->timestamp - origin;
+        
+        if (t < -kCCControlVelocityTrackerHorizon) {
+            break;
+        }
+        
+        n   += 1;
+        st  += t;
+        stt += t * t;
+        sx  += sample->location.x;
+        sy  += sample->location.y;
+        stx += t * sample->location.x;
+        sty += t * sample->location.y;
+    }
+    
+    double denominator = n * stt - st * st;
+    
+    if (n < 2 || denominator <= DBL_EPSILON) {
+        return CGPointZero;
+    }
+    
+    return ccp ((n * stx - st * sx) / denominator, (n * sty - st * sy) / denominator);
+}
+
+@end
@@ -10,6 +10,14 @@
 
 #import "cocos2d.h"
 
+/** The ways a 9-slice sprite can render its slices. */
+enum
+{
+    CCScale9SpriteRenderModeSprites = 0, // Each slice is a CCSprite child of a CCSpriteBatchNode.
+    CCScale9SpriteRenderModeQuads   = 1  // The nine slices are quads of a texture atlas drawn by the sprite itself, without child nodes.
+};
+typedef NSUInteger CCScale9SpriteRenderMode;
+
 /**
  * A 9-slice sprite for cocos2d.
  *
@@ -54,6 +62,11 @@
     CCSprite            *_bottom;
     CCSprite            *_bottomRight;
     BOOL                _spritesGenerated;
+    
+    // Quads render mode
+    CCScale9SpriteRenderMode _renderMode;
+    CCTextureAtlas      *_textureAtlas;
+    CGRect              _sliceRects[9];
 }
 /** @name Setting the Default Sizes */
 /** Original sprite's size. */
@@ -77,6 +90,19 @@
 /** Sets the bottom side inset */
 @property(nonatomic, assign) float insetBottom;
 
+/** @name Rendering */
+/**
+ * The way the slices are rendered.
+ *
+ * With CCScale9SpriteRenderModeQuads the sprite writes its nine quads
+ * directly into its own texture atlas and draws them in a single call. It
+ * creates no child node and resizing it only recomputes the vertices, which
+ * makes it cheaper to create and to animate.
+ *
+ * The default value is the one returned by defaultRenderMode.
+ */
+@property (nonatomic, assign) CCScale9SpriteRenderMode renderMode;
+
 /** @name RGBA Protocol Properties */
 /** Conforms to CCRGBAProtocol protocol. */
 @property (nonatomic, readwrite) GLubyte opacity;
@@ -94,6 +120,22 @@
 @property (nonatomic, getter = isCascadeOpacityEnabled) BOOL cascadeOpacityEnabled;
 
 #pragma mark Constructor - Initializers
+/** @name Setting the Default Render Mode */
+
+/**
+ * Returns the render mode given to the 9-slice sprites when they are
+ * initialized. By default it is CCScale9SpriteRenderModeSprites.
+ */
++ (CCScale9SpriteRenderMode)defaultRenderMode;
+
+/**
+ * Sets the render mode given to the 9-slice sprites when they are
+ * initialized. It does not change the existing sprites.
+ *
+ * @param renderMode The new default render mode.
+ */
++ (void)setDefaultRenderMode:(CCScale9SpriteRenderMode)renderMode;
+
 /** @name Create 9-Scale Sprites */
 
 /**
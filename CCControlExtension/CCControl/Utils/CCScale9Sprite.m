@@ -20,12 +20,318 @@ enum positions
     pBottomLeft
 };
 
+/** Column (left, centre, right) and row (bottom, middle, top) of each position. */
+static const int ccScale9SliceColumns[9] = { 1, 1, 0, 2, 1, 2, 0, 2, 0 };
+static const int ccScale9SliceRows[9]    = { 1, 2, 1, 1, 0, 2, 2, 0, 0 };
+
+/** The render mode given to the new sprites. */
+static CCScale9SpriteRenderMode ccScale9DefaultRenderMode = CCScale9SpriteRenderModeSprites;
+
+/**
+ * Scales and offsets of the columns and of the rows of the grid for a given
+ * content size.
+ */
+typedef struct
+{
+    float scaleX[3];
+    float scaleY[3];
+    float x[3];
+    float y[3];
+} ccScale9Layout;
+
+/**
+ * Computes the texture rects of the nine slices of a sprite rect, indexed by
+ * their position.
+ *
+ * @param rect The rect of the whole image into the texture.
+ * @param c The rect of the centre slice into the texture.
+ * @param rotated Tells whether the image is rotated into the texture.
+ * @param slices The array filled with the rects.
+ */
+static void ccScale9SliceRects(CGRect rect, CGRect c, BOOL rotated, CGRect slices[9])
+{
+    float l = rect.origin.x;
+    float t = rect.origin.y;
+    float h = rect.size.height;
+    float w = rect.size.width;
+    
+    slices[pCentre] = c;
+    
+    if (rotated) {
+        slices[pBottom]      = CGRectMake(l, c.origin.y, c.size.width, c.origin.x - l);
+        slices[pTop]         = CGRectMake(c.origin.x + c.size.height, c.origin.y, c.size.width, h - c.size.height - (c.origin.x - l));
+        slices[pRight]       = CGRectMake(c.origin.x, c.origin.y + c.size.width, w - (c.origin.y - t) - c.size.width, c.size.height);
+        slices[pLeft]        = CGRectMake(c.origin.x, t, c.origin.y - t, c.size.height);
+        slices[pTopRight]    = CGRectMake(c.origin.x + c.size.height, c.origin.y + c.size.width, w - (c.origin.y - t) - c.size.width, h - c.size.height - (c.origin.x - l));
+        slices[pTopLeft]     = CGRectMake(c.origin.x + c.size.height, t, c.origin.y - t, h - c.size.height - (c.origin.x - l));
+        slices[pBottomRight] = CGRectMake(l, c.origin.y + c.size.width, w - (c.origin.y - t) - c.size.width, c.origin.x - l);
+        slices[pBottomLeft]  = CGRectMake(l, t, c.origin.y - t, c.origin.x - l);
+    }
+    else {
+        slices[pTop]         = CGRectMake(c.origin.x, t, c.size.width, c.origin.y - t);
+        slices[pBottom]      = CGRectMake(c.origin.x, c.origin.y + c.size.height, c.size.width, h - (c.origin.y - t + c.size.height));
+        slices[pLeft]        = CGRectMake(l, c.origin.y, c.origin.x - l, c.size.height);
+        slices[pRight]       = CGRectMake(c.origin.x + c.size.width, c.origin.y, w - (c.origin.x - l + c.size.width), c.size.height);
+        slices[pTopLeft]     = CGRectMake(l, t, c.origin.x - l, c.origin.y - t);
+        slices[pTopRight]    = CGRectMake(c.origin.x + c.size.width, t, w - (c.origin.x - l + c.size.width), c.origin.y - t);
+        slices[pBottomLeft]  = CGRectMake(l, c.origin.y + c.size.height, c.origin.x - l, h - (c.origin.y - t + c.size.height));
+        slices[pBottomRight] = CGRectMake(c.origin.x + c.size.width, c.origin.y + c.size.height, w - (c.origin.x - l + c.size.width), h - (c.origin.y - t + c.size.height));
+    }
+}
+
+/**
+ * Computes the layout of the grid for the given content size. The corners keep
+ * their size while the centre stretches, unless the content size is smaller
+ * than the corners in which case the slices shrink proportionally.
+ */
+static ccScale9Layout ccScale9LayoutMake(CGSize size, CGSize originalSize, CGRect capInsets, const CGRect slices[9])
+{
+    CGSize centre = slices[pCentre].size;
+    
+    float sizableWidth  = size.width - slices[pTopLeft].size.width - slices[pTopRight].size.width;
+    float sizableHeight = size.height - slices[pTopLeft].size.height - slices[pBottomRight].size.height;
+    
+    ccScale9Layout layout = {
+        { 1, sizableWidth / centre.width, 1 },
+        { 1, sizableHeight / centre.height, 1 },
+        { 0, 0, 0 },
+        { 0, 0, 0 }
+    };
+    
+    if (sizableWidth < 0 || sizableHeight < 0) {
+        float topProportion    = (originalSize.height - capInsets.origin.y - capInsets.size.height) / originalSize.height;
+        float bottomProportion = capInsets.origin.y / originalSize.height;
+        float leftProportion   = capInsets.origin.x / originalSize.width;
+        float rightProportion  = (originalSize.width - capInsets.origin.x - capInsets.size.width) / originalSize.width;
+        
+        if (sizableWidth < 0) {
+            layout.scaleX[0] = (size.width * leftProportion) / slices[pLeft].size.width;
+            layout.scaleX[1] = (size.width * (1.0f - leftProportion - rightProportion)) / centre.width;
+            layout.scaleX[2] = (size.width * rightProportion) / slices[pRight].size.width;
+        }
+        
+        if (sizableHeight < 0) {
+            layout.scaleY[2] = (size.height * topProportion) / slices[pTop].size.height;
+            layout.scaleY[1] = (size.height * (1.0f - topProportion - bottomProportion)) / centre.height;
+            layout.scaleY[0] = (size.height * bottomProportion) / slices[pBottom].size.height;
+        }
+    }
+    
+    // Computes the offsets of the columns and of the rows
+    layout.x[1] = slices[pLeft].size.width * layout.scaleX[0];
+    layout.x[2] = layout.x[1] + centre.width * layout.scaleX[1];
+    layout.y[1] = slices[pBottom].size.height * layout.scaleY[0];
+    layout.y[2] = layout.y[1] + centre.height * layout.scaleY[1];
+    
+    return layout;
+}
+
+/** The precomputed slices of an image, shared by all the sprites using it. */
+typedef struct
+{
+    CGRect  capInsets;          // The rect of the centre slice into the texture
+    CGRect  rects[9];           // The texture rects of the slices
+    ccTex2F texCoords[9][4];    // The texture coordinates of the slices (bl, br, tl, tr)
+} ccScale9SliceTable;
+
+/**
+ * Key of the slice table cache. The slices only depend on the pixel size of
+ * the texture, which is part of the key, so a texture name reused by a new
+ * texture of another size cannot hit a stale entry.
+ */
+typedef struct
+{
+    GLuint     textureName;
+    CGRect     rect;
+    CGRect     capInsets;
+    NSUInteger pixelsWide;
+    NSUInteger pixelsHigh;
+    float      contentScaleFactor;
+    BOOL       rotated;
+} ccScale9SliceKey;
+
+/** An entry of the slice table cache, holding its own key. */
+typedef struct
+{
+    ccScale9SliceKey   key;
+    ccScale9SliceTable table;
+} ccScale9SliceEntry;
+
+/** Maximum number of slice tables in the cache before it is emptied. */
+#define kCCScale9SliceTableCacheLimit 256
+
+static Boolean ccScale9SliceKeyEqual(const void *a, const void *b)
+{
+    return memcmp(a, b, sizeof(ccScale9SliceKey)) == 0;
+}
+
+/** FNV-1a hash of the bytes of the key. */
+static CFHashCode ccScale9SliceKeyHash(const void *key)
+{
+    const unsigned char *bytes = key;
+    uint32_t hash              = 2166136261u;
+    
+    for (size_t i = 0; i < sizeof(ccScale9SliceKey); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    
+    return hash;
+}
+
+static void ccScale9SliceEntryRelease(CFAllocatorRef allocator, const void *entry)
+{
+    free((void *)entry);
+}
+
+/**
+ * Computes the texture coordinates of a slice the same way as CCSprite does.
+ */
+static void ccScale9SliceTexCoords(ccTex2F texCoords[4], CGRect rect, BOOL rotated, CCTexture2D *texture)
+{
+    rect = CC_RECT_POINTS_TO_PIXELS(rect);
+    
+    float atlasWidth  = (float)texture.pixelsWide;
+    float atlasHeight = (float)texture.pixelsHigh;
+    
+    float left, right, top, bottom;
+    
+    if (rotated) {
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+        left   = (2 * rect.origin.x + 1) / (2 * atlasWidth);
+        right  = left + (rect.size.height * 2 - 2) / (2 * atlasWidth);
+        top    = (2 * rect.origin.y + 1) / (2 * atlasHeight);
+        bottom = top + (rect.size.width * 2 - 2) / (2 * atlasHeight);
+#else
+        left   = rect.origin.x / atlasWidth;
+        right  = (rect.origin.x + rect.size.height) / atlasWidth;
+        top    = rect.origin.y / atlasHeight;
+        bottom = (rect.origin.y + rect.size.width) / atlasHeight;
+#endif
+        
+        texCoords[0] = (ccTex2F){ left, top };
+        texCoords[1] = (ccTex2F){ left, bottom };
+        texCoords[2] = (ccTex2F){ right, top };
+        texCoords[3] = (ccTex2F){ right, bottom };
+    }
+    else {
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+        left   = (2 * rect.origin.x + 1) / (2 * atlasWidth);
+        right  = left + (rect.size.width * 2 - 2) / (2 * atlasWidth);
+        top    = (2 * rect.origin.y + 1) / (2 * atlasHeight);
+        bottom = top + (rect.size.height * 2 - 2) / (2 * atlasHeight);
+#else
+        left   = rect.origin.x / atlasWidth;
+        right  = (rect.origin.x + rect.size.width) / atlasWidth;
+        top    = rect.origin.y / atlasHeight;
+        bottom = (rect.origin.y + rect.size.height) / atlasHeight;
+#endif
+        
+        texCoords[0] = (ccTex2F){ left, bottom };
+        texCoords[1] = (ccTex2F){ right, bottom };
+        texCoords[2] = (ccTex2F){ left, top };
+        texCoords[3] = (ccTex2F){ right, top };
+    }
+}
+
+/**
+ * Returns the slice table of the given image, computing it only the first
+ * time the image is sliced with these cap insets. The lookup does not
+ * allocate. The table stays valid until the next call, which may empty the
+ * cache when it is full. Must be called from the cocos2d thread.
+ *
+ * @param texture The texture of the image.
+ * @param rect The rect of the whole image into the texture.
+ * @param rotated Tells whether the image is rotated into the texture.
+ * @param capInsets The rect of the centre slice, or CGRectZero for a 3x3 grid
+ * of equal blocks.
+ */
+static const ccScale9SliceTable *ccScale9SliceTableForImage(CCTexture2D *texture, CGRect rect, BOOL rotated, CGRect capInsets)
+{
+    // The entries hold their key, so only the values are released
+    static CFMutableDictionaryRef sliceTables = NULL;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        CFDictionaryKeyCallBacks keyCallBacks     = { 0, NULL, NULL, NULL, ccScale9SliceKeyEqual, ccScale9SliceKeyHash };
+        CFDictionaryValueCallBacks valueCallBacks = { 0, NULL, ccScale9SliceEntryRelease, NULL, NULL };
+        sliceTables = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &keyCallBacks, &valueCallBacks);
+    });
+    
+    ccScale9SliceKey key;
+    memset(&key, 0, sizeof(key)); // The padding is part of the key
+    key.textureName        = texture.name;
+    key.rect               = rect;
+    key.capInsets          = capInsets;
+    key.pixelsWide         = texture.pixelsWide;
+    key.pixelsHigh         = texture.pixelsHigh;
+    key.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    key.rotated            = rotated;
+    
+    ccScale9SliceEntry *entry = (ccScale9SliceEntry *)CFDictionaryGetValue(sliceTables, &key);
+    
+    if (entry == NULL) {
+        ccScale9SliceTable slices;
+        
+        // If there is no specified center region
+        if (CGRectEqualToRect(capInsets, CGRectZero)) {
+            // Get the image edges
+            float l = rect.origin.x;
+            float t = rect.origin.y;
+            float h = rect.size.height;
+            float w = rect.size.width;
+            
+            // Apply the 3x3 grid format
+            if (rotated) {
+                capInsets = CGRectMake(l+h/3, t+w/3, w/3, h/3);
+            }
+            else {
+                capInsets = CGRectMake(l+w/3, t+h/3, w/3, h/3);
+            }
+        }
+        
+        slices.capInsets = capInsets;
+        ccScale9SliceRects(rect, capInsets, rotated, slices.rects);
+        
+        for (int i = 0; i < 9; i++) {
+            ccScale9SliceTexCoords(slices.texCoords[i], slices.rects[i], rotated, texture);
+        }
+        
+        if (CFDictionaryGetCount(sliceTables) >= kCCScale9SliceTableCacheLimit) {
+            CFDictionaryRemoveAllValues(sliceTables);
+        }
+        
+        entry        = malloc(sizeof(ccScale9SliceEntry));
+        entry->key   = key;
+        entry->table = slices;
+        CFDictionarySetValue(sliceTables, &entry->key, entry);
+    }
+    
+    return &entry->table;
+}
+
 @interface CCScale9Sprite ()
 
+- (id)initWithBatchNode:(CCSpriteBatchNode *)batchnode rect:(CGRect)rect rotated:(BOOL)rotated capInsets:(CGRect)capInsets;
 - (id)initWithBatchNode:(CCSpriteBatchNode *)batchnode rect:(CGRect)rect capInsets:(CGRect)capInsets;
 - (void)updateWithBatchNode:(CCSpriteBatchNode*)batchnode rect:(CGRect)rect rotated:(BOOL)rotated capInsets:(CGRect)capInsets;
 - (void)updatePosition;
 
+/** Creates the nine child sprites from the slice rects. */
+- (void)generateSprites;
+
+/** Updates the texture rects of the existing child sprites from the slice
+ rects. */
+- (void)updateSprites;
+
+/**
+ * Fills the texture atlas with the nine quads.
+ *
+ * @param sliceTable The slice table of the image.
+ */
+- (void)generateQuadsWithSliceTable:(const ccScale9SliceTable *)sliceTable;
+
+/** Applies the current color and opacity to the quads. */
+- (void)updateQuadColors;
+
 @end
 
 @implementation CCScale9Sprite
@@ -58,6 +364,7 @@ enum positions
     SAFE_ARC_RELEASE(_bottom);
     SAFE_ARC_RELEASE(_bottomRight);
     SAFE_ARC_RELEASE(_scale9Image);
+    SAFE_ARC_RELEASE(_textureAtlas);
     
     SAFE_ARC_SUPER_DEALLOC();
 }
@@ -67,6 +374,10 @@ enum positions
 - (id)initWithBatchNode:(CCSpriteBatchNode *)batchnode rect:(CGRect)rect rotated:(BOOL)rotated capInsets:(CGRect)capInsets
 {
     if ((self = [super init])) {
+        _renderMode = ccScale9DefaultRenderMode;
+        _opacity    = 255;
+        _color      = ccWHITE;
+        
         if (batchnode) {
             [self updateWithBatchNode:batchnode rect:rect rotated:rotated capInsets:capInsets];
             self.anchorPoint = ccp(0.5f, 0.5f);
@@ -90,6 +401,16 @@ enum positions
     return [self initWithBatchNode:batchnode rect:rect capInsets:capInsets];
 }
 
++ (CCScale9SpriteRenderMode)defaultRenderMode
+{
+    return ccScale9DefaultRenderMode;
+}
+
++ (void)setDefaultRenderMode:(CCScale9SpriteRenderMode)renderMode
+{
+    ccScale9DefaultRenderMode = renderMode;
+}
+
 + (id)spriteWithFile:(NSString *)file rect:(CGRect)rect capInsets:(CGRect)capInsets
 {
     return SAFE_ARC_AUTORELEASE([[self alloc] initWithFile:file rect:rect capInsets:capInsets]);
@@ -190,29 +511,38 @@ enum positions
 
 - (void) updateWithBatchNode:(CCSpriteBatchNode *)batchnode rect:(CGRect)rect rotated:(BOOL)rotated capInsets:(CGRect)capInsets
 {
-    GLubyte opacity = opacity;
+    GLubyte opacity = _opacity;
     ccColor3B color = _color;
     
-    // Release old sprites
-    [self removeAllChildrenWithCleanup:YES];
-    
-    SAFE_ARC_RELEASE(_centre);
-    SAFE_ARC_RELEASE(_top);
-    SAFE_ARC_RELEASE(_topLeft);
-    SAFE_ARC_RELEASE(_topRight);
-    SAFE_ARC_RELEASE(_left);
-    SAFE_ARC_RELEASE(_right);
-    SAFE_ARC_RELEASE(_bottomLeft);
-    SAFE_ARC_RELEASE(_bottom);
-    SAFE_ARC_RELEASE(_bottomRight);
+    // The child sprites are kept when only the slices change
+    BOOL reuseSprites = (batchnode == _scale9Image
+                         && _centre != nil
+                         && _renderMode == CCScale9SpriteRenderModeSprites);
     
-    if (_scale9Image != batchnode) {
-        SAFE_ARC_RELEASE(_scale9Image);
-        _scale9Image = SAFE_ARC_RETAIN(batchnode);
+    if (!reuseSprites) {
+        // Release old sprites
+        [self removeAllChildrenWithCleanup:YES];
+        
+        SAFE_ARC_RELEASE(_centre);
+        SAFE_ARC_RELEASE(_top);
+        SAFE_ARC_RELEASE(_topLeft);
+        SAFE_ARC_RELEASE(_topRight);
+        SAFE_ARC_RELEASE(_left);
+        SAFE_ARC_RELEASE(_right);
+        SAFE_ARC_RELEASE(_bottomLeft);
+        SAFE_ARC_RELEASE(_bottom);
+        SAFE_ARC_RELEASE(_bottomRight);
+        
+        _centre = _top = _topLeft = _topRight = _left = _right = _bottomLeft = _bottom = _bottomRight = nil;
+        
+        if (_scale9Image != batchnode) {
+            SAFE_ARC_RELEASE(_scale9Image);
+            _scale9Image = SAFE_ARC_RETAIN(batchnode);
+        }
+        
+        [_scale9Image removeAllChildrenWithCleanup:YES];
     }
     
-    [_scale9Image removeAllChildrenWithCleanup:YES];
-    
     _capInsets          = capInsets;
     _spriteFrameRotated = rotated;
     
@@ -227,147 +557,34 @@ enum positions
     _spriteRect        = rect;
     _originalSize      = rect.size;
     _preferredSize     = _originalSize;
-    _capInsetsInternal = capInsets;
     
-    // Get the image edges
-    float l = rect.origin.x;
-    float t = rect.origin.y;
-    float h = rect.size.height;
-    float w = rect.size.width;
+    // Get the slices shared by the sprites using the same image and insets
+    const ccScale9SliceTable *sliceTable = ccScale9SliceTableForImage(_scale9Image.texture, rect, rotated, capInsets);
     
-    // If there is no specified center region
-    if (CGRectEqualToRect(_capInsetsInternal, CGRectZero)) {
-        // Apply the 3x3 grid format
-        if (rotated) {
-            _capInsetsInternal = CGRectMake(l+h/3, t+w/3, w/3, h/3);
-        }
-        else {
-            _capInsetsInternal  = CGRectMake(l+w/3, t+h/3, w/3, h/3);
-        }
-    }
+    _capInsetsInternal = sliceTable->capInsets;
+    memcpy(_sliceRects, sliceTable->rects, sizeof(_sliceRects));
     
     // Set up the images
-    if (rotated) {
-        // Sprite is rotated
-        _centre      = [[CCSprite alloc] initWithTexture:_scale9Image.texture rect:_capInsetsInternal rotated:YES];
-        _bottom      = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(l,
-                                                                    _capInsetsInternal.origin.y,
-                                                                    _capInsetsInternal.size.width,
-                                                                    _capInsetsInternal.origin.x - l)
-                                                 rotated:rotated];
-        _top         = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x + _capInsetsInternal.size.height,
-                                                                    _capInsetsInternal.origin.y,
-                                                                    _capInsetsInternal.size.width,
-                                                                    h - _capInsetsInternal.size.height - (_capInsetsInternal.origin.x - l))
-                                                 rotated:rotated];
-        _right       = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x,
-                                                                    _capInsetsInternal.origin.y+_capInsetsInternal.size.width,
-                                                                    w - (_capInsetsInternal.origin.y-t)-_capInsetsInternal.size.width,
-                                                                    _capInsetsInternal.size.height)
-                                                 rotated:rotated];
-        _left        = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x,
-                                                                    t,
-                                                                    _capInsetsInternal.origin.y - t,
-                                                                    _capInsetsInternal.size.height)
-                                                 rotated:rotated];
-        _topRight    = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x + _capInsetsInternal.size.height,
-                                                                    _capInsetsInternal.origin.y + _capInsetsInternal.size.width,
-                                                                    w - (_capInsetsInternal.origin.y-t)-_capInsetsInternal.size.width,
-                                                                    h - _capInsetsInternal.size.height - (_capInsetsInternal.origin.x - l))
-                                                 rotated:rotated];
-        _topLeft     = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x + _capInsetsInternal.size.height,
-                                                                    t,
-                                                                    _capInsetsInternal.origin.y - t,
-                                                                    h - _capInsetsInternal.size.height - (_capInsetsInternal.origin.x - l))
-                                                 rotated:rotated];
-        _bottomRight = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(l,
-                                                                    _capInsetsInternal.origin.y + _capInsetsInternal.size.width,
-                                                                    w - (_capInsetsInternal.origin.y-t)-_capInsetsInternal.size.width,
-                                                                    _capInsetsInternal.origin.x - l)
-                                                 rotated:rotated];
-        _bottomLeft  = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(l,
-                                                                    t,
-                                                                    _capInsetsInternal.origin.y - t,
-                                                                    _capInsetsInternal.origin.x - l)
-                                                 rotated:rotated];
+    if (_renderMode == CCScale9SpriteRenderModeQuads) {
+        [self generateQuadsWithSliceTable:sliceTable];
     }
     else {
-        // Sprite is not rotated
-        _centre      = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:_capInsetsInternal
-                                                 rotated:rotated];
-        _top         = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x,
-                                                                    t,
-                                                                    _capInsetsInternal.size.width,
-                                                                    _capInsetsInternal.origin.y - t)
-                                                 rotated:rotated];
-        _bottom      = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x,
-                                                                    _capInsetsInternal.origin.y + _capInsetsInternal.size.height,
-                                                                    _capInsetsInternal.size.width,
-                                                                    h - (_capInsetsInternal.origin.y - t + _capInsetsInternal.size.height))
-                                                 rotated:rotated];
-        _left        = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(l,
-                                                                    _capInsetsInternal.origin.y,
-                                                                    _capInsetsInternal.origin.x - l,
-                                                                    _capInsetsInternal.size.height)
-                                                 rotated:rotated
-                        ];
-        _right       = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x + _capInsetsInternal.size.width,
-                                                                    _capInsetsInternal.origin.y,
-                                                                    w - (_capInsetsInternal.origin.x - l + _capInsetsInternal.size.width),
-                                                                    _capInsetsInternal.size.height)
-                                                 rotated:rotated];
-        _topLeft     = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(l,
-                                                                    t,
-                                                                    _capInsetsInternal.origin.x - l,
-                                                                    _capInsetsInternal.origin.y - t)
-                                                 rotated:rotated];
-        _topRight    = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x + _capInsetsInternal.size.width,
-                                                                    t,
-                                                                    w - (_capInsetsInternal.origin.x - l + _capInsetsInternal.size.width),
-                                                                    _capInsetsInternal.origin.y - t)
-                                                 rotated:rotated];
-        _bottomLeft  = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(l,
-                                                                    _capInsetsInternal.origin.y + _capInsetsInternal.size.height,
-                                                                    _capInsetsInternal.origin.x - l,
-                                                                    h - (_capInsetsInternal.origin.y - t + _capInsetsInternal.size.height))
-                                                 rotated:rotated];
-        _bottomRight = [[CCSprite alloc] initWithTexture:_scale9Image.texture
-                                                    rect:CGRectMake(_capInsetsInternal.origin.x + _capInsetsInternal.size.width,
-                                                                    _capInsetsInternal.origin.y + _capInsetsInternal.size.height,
-                                                                    w - (_capInsetsInternal.origin.x - l + _capInsetsInternal.size.width),
-                                                                    h - (_capInsetsInternal.origin.y - t + _capInsetsInternal.size.height))
-                                                 rotated:rotated];
-    }
-    
-    // Add images as children of scale9Image
-    [_scale9Image addChild:_centre z:0 tag:pCentre];
-    [_scale9Image addChild:_top z:1 tag:pTop];
-    [_scale9Image addChild:_bottom z:1 tag:pBottom];
-    [_scale9Image addChild:_left z:1 tag:pLeft];
-    [_scale9Image addChild:_right z:1 tag:pRight];
-    [_scale9Image addChild:_topLeft z:2 tag:pTopLeft];
-    [_scale9Image addChild:_topRight z:2 tag:pTopRight];
-    [_scale9Image addChild:_bottomLeft z:2 tag:pBottomLeft];
-    [_scale9Image addChild:_bottomRight z:2 tag:pBottomRight];
+        SAFE_ARC_RELEASE(_textureAtlas);
+        _textureAtlas = nil;
+        
+        if (reuseSprites) {
+            [self updateSprites];
+        }
+        else {
+            [self generateSprites];
+        }
+    }
     
     [self setContentSize:rect.size];
-    [self addChild:_scale9Image];
+    
+    if (_renderMode == CCScale9SpriteRenderModeSprites && !reuseSprites) {
+        [self addChild:_scale9Image];
+    }
     
     if (_spritesGenerated) {
         // Restore color and opacity
@@ -389,84 +606,135 @@ enum positions
 
 - (void)updatePosition
 {
-    CGSize size = self.contentSize;
-    
-    float sizableWidth  = size.width - _topLeft.contentSize.width - _topRight.contentSize.width;
-    float sizableHeight = size.height - _topLeft.contentSize.height - _bottomRight.contentSize.height;
+    ccScale9Layout layout = ccScale9LayoutMake(self.contentSize, _originalSize, _capInsetsInternal, _sliceRects);
     
-    float scaleLeftFactor   = 1;
-    float scaleCenterFactor = (sizableWidth / _centre.contentSize.width);
-    float scaleRightFactor  = 1;
-    float scaleTopFactor    = 1;
-    float scaleMiddleFactor = (sizableHeight / _centre.contentSize.height);
-    float scaleBottomFactor = 1;
-
-    if (sizableWidth < 0 || sizableHeight < 0) {
-        float topProportion    =  (_originalSize.height - _capInsetsInternal.origin.y - _capInsetsInternal.size.height) / _originalSize.height;
-        float bottomProportion = _capInsetsInternal.origin.y / _originalSize.height;
-        float leftProportion   = _capInsetsInternal.origin.x / _originalSize.width;
-        float rightProportion  = (_originalSize.width - _capInsetsInternal.origin.x - _capInsetsInternal.size.width) / _originalSize.width;
+    if (_renderMode == CCScale9SpriteRenderModeQuads) {
+        if (_textureAtlas == nil) {
+            return;
+        }
         
-        if (sizableWidth < 0) {
-            scaleLeftFactor   = (size.width * topProportion) / _left.contentSize.width;
-            scaleCenterFactor = (size.width * (1.0f - leftProportion - rightProportion)) / _centre.contentSize.width;
-            scaleRightFactor  = (size.width * rightProportion) / _right.contentSize.width;
+        // Write the vertices of the nine quads in a single pass
+        ccV3F_C4B_T2F_Quad *quads = [_textureAtlas quads];
+        
+        for (int i = 0; i < 9; i++) {
+            int column = ccScale9SliceColumns[i];
+            int row    = ccScale9SliceRows[i];
+            
+            float x0 = layout.x[column];
+            float y0 = layout.y[row];
+            float x1 = x0 + _sliceRects[i].size.width * layout.scaleX[column];
+            float y1 = y0 + _sliceRects[i].size.height * layout.scaleY[row];
+            
+            quads[i].bl.vertices = (ccVertex3F){ x0, y0, 0 };
+            quads[i].br.vertices = (ccVertex3F){ x1, y0, 0 };
+            quads[i].tl.vertices = (ccVertex3F){ x0, y1, 0 };
+            quads[i].tr.vertices = (ccVertex3F){ x1, y1, 0 };
+            
+            [_textureAtlas updateQuad:&quads[i] atIndex:i];
         }
+    }
+    else {
+        CCSprite *sprites[9] = { _centre, _top, _left, _right, _bottom, _topRight, _topLeft, _bottomRight, _bottomLeft };
         
-        if (sizableHeight < 0) {
-            scaleTopFactor    = (size.height * topProportion) / _top.contentSize.height;
-            scaleMiddleFactor = (size.height * (1.0f - topProportion - bottomProportion)) / _centre.contentSize.height;
-            scaleBottomFactor = (size.height * bottomProportion) / _bottom.contentSize.height;
+        for (int i = 0; i < 9; i++) {
+            int column = ccScale9SliceColumns[i];
+            int row    = ccScale9SliceRows[i];
+            
+            sprites[i].scaleX   = layout.scaleX[column];
+            sprites[i].scaleY   = layout.scaleY[row];
+            sprites[i].position = ccp(layout.x[column], layout.y[row]);
         }
     }
+}
+
+- (void)generateSprites
+{
+    CCTexture2D *texture = _scale9Image.texture;
+    
+    _centre      = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pCentre] rotated:_spriteFrameRotated];
+    _top         = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pTop] rotated:_spriteFrameRotated];
+    _left        = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pLeft] rotated:_spriteFrameRotated];
+    _right       = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pRight] rotated:_spriteFrameRotated];
+    _bottom      = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pBottom] rotated:_spriteFrameRotated];
+    _topRight    = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pTopRight] rotated:_spriteFrameRotated];
+    _topLeft     = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pTopLeft] rotated:_spriteFrameRotated];
+    _bottomRight = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pBottomRight] rotated:_spriteFrameRotated];
+    _bottomLeft  = [[CCSprite alloc] initWithTexture:texture rect:_sliceRects[pBottomLeft] rotated:_spriteFrameRotated];
+    
+    CCSprite *sprites[9] = { _centre, _top, _left, _right, _bottom, _topRight, _topLeft, _bottomRight, _bottomLeft };
+    
+    // Add images as children of scale9Image, the corners above the edges above the centre
+    for (int i = 0; i < 9; i++) {
+        int z = (i == pCentre) ? 0 : ((i < pTopRight) ? 1 : 2);
+        
+        sprites[i].anchorPoint = ccp(0,0);
+        [_scale9Image addChild:sprites[i] z:z tag:i];
+    }
+}
+
+- (void)updateSprites
+{
+    CCSprite *sprites[9] = { _centre, _top, _left, _right, _bottom, _topRight, _topLeft, _bottomRight, _bottomLeft };
+    
+    for (int i = 0; i < 9; i++) {
+        [sprites[i] setTextureRect:_sliceRects[i] rotated:_spriteFrameRotated untrimmedSize:_sliceRects[i].size];
+    }
+}
 
-    // Computes the sizes
-    float centerWidth  = _centre.contentSize.width * scaleCenterFactor;
-    float leftWidth    = _left.contentSize.width * scaleLeftFactor;
-    float middleHeight = _centre.contentSize.height * scaleMiddleFactor;
-    float bottomHeight = _bottom.contentSize.height * scaleBottomFactor;
-
-    // Apply the scales
-    _topLeft.scaleX     = scaleLeftFactor;
-    _topLeft.scaleY     = scaleTopFactor;
-    _top.scaleX         = scaleCenterFactor;
-    _top.scaleY         = scaleTopFactor;
-    _topRight.scaleX    = scaleRightFactor;
-    _topRight.scaleY    = scaleTopFactor;
-    _left.scaleX        = scaleLeftFactor;
-    _left.scaleY        = scaleMiddleFactor;
-    _centre.scaleX      = scaleCenterFactor;
-    _centre.scaleY      = scaleMiddleFactor;
-    _right.scaleX       = scaleRightFactor;
-    _right.scaleY       = scaleMiddleFactor;
-    _bottomLeft.scaleX  = scaleLeftFactor;
-    _bottomLeft.scaleY  = scaleBottomFactor;
-    _bottom.scaleX      = scaleCenterFactor;
-    _bottom.scaleY      = scaleBottomFactor;
-    _bottomRight.scaleX = scaleRightFactor;
-    _bottomRight.scaleY = scaleBottomFactor;
-    
-    // Set anchor points
-    _bottomLeft.anchorPoint  = ccp(0,0);
-    _bottomRight.anchorPoint = ccp(0,0);
-    _topLeft.anchorPoint     = ccp(0,0);
-    _topRight.anchorPoint    = ccp(0,0);
-    _left.anchorPoint        = ccp(0,0);
-    _right.anchorPoint       = ccp(0,0);
-    _top.anchorPoint         = ccp(0,0);
-    _bottom.anchorPoint      = ccp(0,0);
-    _centre.anchorPoint      = ccp(0,0);
-    
-    // Set positions
-    _bottomLeft.position  = ccp(0,0);
-    _bottomRight.position = ccp(leftWidth + centerWidth, 0);
-    _topLeft.position     = ccp(0, bottomHeight + middleHeight);
-    _topRight.position    = ccp(leftWidth + centerWidth, bottomHeight + middleHeight);
-    _left.position        = ccp(0, bottomHeight);
-    _right.position       = ccp(leftWidth + centerWidth, bottomHeight);
-    _bottom.position      = ccp(leftWidth, 0);
-    _top.position         = ccp(leftWidth, bottomHeight + middleHeight);
-    _centre.position      = ccp(leftWidth, bottomHeight);
+- (void)generateQuadsWithSliceTable:(const ccScale9SliceTable *)sliceTable
+{
+    CCTexture2D *texture = _scale9Image.texture;
+    
+    if (_textureAtlas == nil) {
+        _textureAtlas = [[CCTextureAtlas alloc] initWithTexture:texture capacity:9];
+        
+        self.shaderProgram = [[CCShaderCache sharedShaderCache] programForKey:kCCShader_PositionTextureColor];
+    }
+    else {
+        [_textureAtlas setTexture:texture];
+    }
+    
+    // Premultiply the colors as the sprites do with such textures
+    _opacityModifyRGB = [texture hasPremultipliedAlpha];
+    
+    ccV3F_C4B_T2F_Quad quad;
+    memset(&quad, 0, sizeof(quad));
+    
+    for (int i = 0; i < 9; i++) {
+        quad.bl.texCoords = sliceTable->texCoords[i][0];
+        quad.br.texCoords = sliceTable->texCoords[i][1];
+        quad.tl.texCoords = sliceTable->texCoords[i][2];
+        quad.tr.texCoords = sliceTable->texCoords[i][3];
+        
+        [_textureAtlas updateQuad:&quad atIndex:i];
+    }
+    
+    [self updateQuadColors];
+    
+    _positionsAreDirty = YES;
+}
+
+- (void)updateQuadColors
+{
+    if (_renderMode != CCScale9SpriteRenderModeQuads || _textureAtlas == nil) {
+        return;
+    }
+    
+    ccColor4B color4 = { _color.r, _color.g, _color.b, _opacity };
+    
+    if (_opacityModifyRGB) {
+        color4.r = color4.r * _opacity / 255;
+        color4.g = color4.g * _opacity / 255;
+        color4.b = color4.b * _opacity / 255;
+    }
+    
+    ccV3F_C4B_T2F_Quad *quads = [_textureAtlas quads];
+    
+    for (int i = 0; i < 9; i++) {
+        quads[i].bl.colors = quads[i].br.colors = quads[i].tl.colors = quads[i].tr.colors = color4;
+        
+        [_textureAtlas updateQuad:&quads[i] atIndex:i];
+    }
 }
 
 - (void)setPreferredSize:(CGSize)preferredSize
@@ -484,6 +752,8 @@ enum positions
     for (CCNode<CCRGBAProtocol> *child in _scale9Image.children) {
         [child setColor:color];
     }
+    
+    [self updateQuadColors];
 }
 
 - (void)setOpacity:(GLubyte)opacity
@@ -493,6 +763,8 @@ enum positions
     for (CCNode<CCRGBAProtocol> *child in _scale9Image.children) {
         [child setOpacity:opacity];
     }
+    
+    [self updateQuadColors];
 }
 
 - (void)setOpacityModifyRGB:(BOOL)boolean
@@ -502,6 +774,8 @@ enum positions
     for (CCNode<CCRGBAProtocol> *child in _scale9Image.children) {
         [child setOpacityModifyRGB:boolean];
     }
+    
+    [self updateQuadColors];
 }
 
 #if COCOS2D_VERSION >= 0x00020100
@@ -554,6 +828,21 @@ enum positions
     _insetBottom = 0;
 }
 
+- (void)setRenderMode:(CCScale9SpriteRenderMode)renderMode
+{
+    if (_renderMode == renderMode) {
+        return;
+    }
+    
+    _renderMode = renderMode;
+    
+    if (_scale9Image) {
+        CGSize contentSize = self.contentSize;
+        [self updateWithBatchNode:_scale9Image rect:_spriteRect rotated:_spriteFrameRotated capInsets:_capInsets];
+        [self setContentSize:contentSize];
+    }
+}
+
 - (void)setCapInsets:(CGRect)capInsets
 {
     CGSize contentSize = self.contentSize;
@@ -614,7 +903,10 @@ enum positions
 
 - (CCScale9Sprite *)resizableSpriteWithCapInsets:(CGRect)capInsets
 {
-    return SAFE_ARC_AUTORELEASE([[CCScale9Sprite alloc] initWithBatchNode:_scale9Image rect:_spriteRect capInsets:capInsets]);
+    // The batch node is already the child of the receiver in the sprites mode
+    CCSpriteBatchNode *batchnode = [CCSpriteBatchNode batchNodeWithTexture:_scale9Image.texture capacity:9];
+    
+    return SAFE_ARC_AUTORELEASE([[CCScale9Sprite alloc] initWithBatchNode:batchnode rect:_spriteRect rotated:_spriteFrameRotated capInsets:capInsets]);
 }
 
 #pragma mark -
@@ -631,4 +923,18 @@ enum positions
     [super visit];
 }
 
+- (void)draw
+{
+    if (_renderMode != CCScale9SpriteRenderModeQuads || [_textureAtlas totalQuads] == 0) {
+        return;
+    }
+    
+    CC_NODE_DRAW_SETUP();
+    
+    ccBlendFunc blendFunc = [_scale9Image blendFunc];
+    ccGLBlendFunc(blendFunc.src, blendFunc.dst);
+    
+    [_textureAtlas drawQuads];
+}
+
 @end
@@ -30,6 +30,14 @@
 #import "CCScale9Sprite.h"
 
 #import "CCControl.h"
+#import "CCControlHitTestManager.h"
+#import "CCControlVelocityTracker.h"
+#import "CCControlInstrumentation.h"
+#import "CCControlRasterCache.h"
+#import "CCControlPool.h"
+#import "CCControlAutorepeat.h"
+#import "CCColourPickerTextures.h"
+#import "CCControlProgressTimer.h"
 #import "CCControlButton.h"
 #import "CCControlColourPicker.h"
 #import "CCControlPicker.h"
@@ -37,5 +45,7 @@
 #import "CCControlSlider.h"
 #import "CCControlStepper.h"
 #import "CCControlSwitch.h"
+#import "CCControlSwitchBatchNode.h"
+#import "CCControlLayout.h"
 
 #endif
@@ -28,10 +28,24 @@
 
 #import "CCControlExtension.h"
 
+/**
+ * When set to 1 the scenes record the touches (or the mouse events) they
+ * receive and save them in the documents directory when they exit, to be
+ * replayed by the CCControlTouchReplayBenchmark.
+ */
+#define kCCControlSceneRecordsTouchTraces 0
+
+@class CCControlTouchRecorder;
+
 @interface CCControlScene : CCLayer
 {
 @public
     CCLabelTTF *sceneTitleLabel;
+    
+#if kCCControlSceneRecordsTouchTraces
+@protected
+    CCControlTouchRecorder *touchRecorder;
+#endif
 }
 /** Title label of the scene. */
 @property (nonatomic, retain) CCLabelTTF *sceneTitleLabel;
@@ -47,4 +61,17 @@
 
 #pragma mark Public Methods
 
+/**
+ * Returns the image files loaded by the scene, which are preloaded by the
+ * CCControlSceneManager before the scene is built. Subclasses add their own
+ * files to the ones of their super class.
+ */
++ (NSArray *)assetFiles;
+
+/**
+ * Returns the path of the file in which the touch trace of the scene is
+ * saved: <documents>/<class name>.cctrace.
+ */
++ (NSString *)touchTracePath;
+
 @end
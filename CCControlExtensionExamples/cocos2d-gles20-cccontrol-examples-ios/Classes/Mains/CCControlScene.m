@@ -26,6 +26,7 @@
 #import "CCControlScene.h"
 
 #import "CCControlSceneManager.h"
+#import "CCControlTouchTrace.h"
 
 @interface CCControlScene ()
 
@@ -42,6 +43,9 @@
 - (void) dealloc
 {
     [sceneTitleLabel release], sceneTitleLabel = nil;
+#if kCCControlSceneRecordsTouchTraces
+    [touchRecorder release], touchRecorder = nil;
+#endif
     
 	[super dealloc];
 }
@@ -106,24 +110,78 @@
 	return scene;
 }
 
+- (void)onEnterTransitionDidFinish
+{
+    [super onEnterTransitionDidFinish];
+    
+    // The scene is idle, so load the files of the scenes which may come next
+    [[CCControlSceneManager sharedControlSceneManager] preloadAdjacentControlScenes];
+}
+
+#if kCCControlSceneRecordsTouchTraces
+
+- (void)onEnter
+{
+    [super onEnter];
+    
+    touchRecorder = [[CCControlTouchRecorder alloc] init];
+    [touchRecorder startRecording];
+}
+
+- (void)onExit
+{
+    [touchRecorder stopRecording];
+    
+    if (touchRecorder.trace.numberOfSamples > 0)
+    {
+        [touchRecorder.trace writeToFile:[[self class] touchTracePath]];
+    }
+    [touchRecorder release], touchRecorder = nil;
+    
+    [super onExit];
+}
+
+#endif
+
 #pragma mark -
 #pragma mark CCControlScene Public Methods
 
++ (NSArray *)assetFiles
+{
+    return [NSArray arrayWithObjects:@"background.png", @"ribbon.png", @"b1.png", @"b2.png", @"r1.png", @"r2.png", @"f1.png", @"f2.png", nil];
+}
+
++ (NSString *)touchTracePath
+{
+    NSString *documents = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+    
+    return [documents stringByAppendingPathComponent:[NSStringFromClass(self) stringByAppendingPathExtension:@"cctrace"]];
+}
+
 #pragma mark CCControlScene Private Methods
 
 - (void)previousCallback:(id)sender
 {
-    [[CCDirector sharedDirector] replaceScene:[[CCControlSceneManager sharedControlSceneManager] previousControlScene]];
+    [[CCControlSceneManager sharedControlSceneManager] previousControlSceneWithBlock:^(CCScene *scene)
+     {
+         [[CCDirector sharedDirector] replaceScene:scene];
+     }];
 }
 
 - (void)restartCallback:(id)sender
 {
-	[[CCDirector sharedDirector] replaceScene:[[CCControlSceneManager sharedControlSceneManager] currentControlScene]];
+    [[CCControlSceneManager sharedControlSceneManager] currentControlSceneWithBlock:^(CCScene *scene)
+     {
+         [[CCDirector sharedDirector] replaceScene:scene];
+     }];
 }
 
 - (void)nextCallback:(id)sender
 {
-    [[CCDirector sharedDirector] replaceScene:[[CCControlSceneManager sharedControlSceneManager] nextControlScene]];
+    [[CCControlSceneManager sharedControlSceneManager] nextControlSceneWithBlock:^(CCScene *scene)
+     {
+         [[CCDirector sharedDirector] replaceScene:scene];
+     }];
 }
 
 @end
@@ -25,12 +25,37 @@
 
 #import "cocos2d.h"
 
+/**
+ * The CCControlSceneManager builds the example scenes in turn.
+ *
+ * The image files of a scene (CCControlScene assetFiles) are loaded in the
+ * background with the addImageAsync: method of the CCTextureCache: the files
+ * of the scenes adjacent to the current one are loaded while it is idle, and
+ * a requested scene is only built once its files are resident, so that the
+ * transitions do not load the images on the main thread. A scene whose files
+ * are still loading after a few seconds is built anyway, and loads them on
+ * the main thread.
+ */
 @interface CCControlSceneManager : NSObject
 {
 @private
     NSInteger currentControlSceneId;
     NSArray *controlScenes;
+    
+    BOOL preloadsControlScenes;
+    double lastTransitionLatency;
+    NSUInteger transitionRequestId;
+    
+    // Files being loaded and preloads waiting for them
+    NSMutableSet *loadingFiles;
+    NSMutableArray *pendingPreloads;
 }
+/** Tells whether the files of the scenes are preloaded. YES by default. When
+ NO, the scenes are built as soon as they are requested. */
+@property (nonatomic, assign) BOOL preloadsControlScenes;
+/** Time in milliseconds between the request of the last scene and the end of
+ its building, including the wait for its files. */
+@property (nonatomic, readonly) double lastTransitionLatency;
 
 #pragma mark Constructors - Initializers
 
@@ -48,4 +73,36 @@
 /** Returns the current control scene. */
 - (CCScene *)currentControlScene;
 
+/**
+ * Moves to the next control scene and calls the block with it once its files
+ * are resident. The block is not called if another scene is requested in the
+ * meantime.
+ */
+- (void)nextControlSceneWithBlock:(void (^)(CCScene *scene))block;
+
+/**
+ * Moves to the previous control scene and calls the block with it once its
+ * files are resident. The block is not called if another scene is requested
+ * in the meantime.
+ */
+- (void)previousControlSceneWithBlock:(void (^)(CCScene *scene))block;
+
+/**
+ * Calls the block with a new current control scene once its files are
+ * resident. The block is not called if another scene is requested in the
+ * meantime.
+ */
+- (void)currentControlSceneWithBlock:(void (^)(CCScene *scene))block;
+
+/** Starts loading the files of the scenes before and after the current one. */
+- (void)preloadAdjacentControlScenes;
+
+/**
+ * Starts loading the files of the given scene which are not resident yet.
+ *
+ * @param name The class name of the scene.
+ * @param block The block called once the files are loaded, may be nil.
+ */
+- (void)preloadControlSceneNamed:(NSString *)name withBlock:(void (^)(void))block;
+
 @end
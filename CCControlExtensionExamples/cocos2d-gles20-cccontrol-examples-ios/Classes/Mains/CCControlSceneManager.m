@@ -25,24 +25,48 @@
 
 #import "CCControlSceneManager.h"
 
+#import <QuartzCore/QuartzCore.h>
 #import "CCControlScene.h"
 
+/**
+ * Time in seconds after which a requested scene stops waiting for its files.
+ * The texture cache never calls back when its loading thread cannot share
+ * the GL context, so the remaining files are then loaded synchronously by
+ * the scene itself.
+ */
+#define kCCControlSceneManagerPreloadTimeout    3.0
+
 @interface CCControlSceneManager ()
 /** Control scene id. */
 @property (nonatomic, assign) NSInteger currentControlSceneId;
 /** List of control scene's names. */
 @property (nonatomic, retain) NSArray *controlScenes;
 
+/** Called when a file has been loaded by the texture cache. */
+- (void)fileDidLoad:(NSString *)file;
+
+/** Calls the blocks of the preloads whose files are all loaded. */
+- (void)firePendingPreloads;
+
+/**
+ * Stops waiting for the files of the given preload, if it is still pending,
+ * and calls its block.
+ */
+- (void)preloadDidTimeOut:(NSArray *)preload;
+
 @end
 
 @implementation CCControlSceneManager
 @synthesize currentControlSceneId, controlScenes;
+@synthesize preloadsControlScenes, lastTransitionLatency;
 
 static CCControlSceneManager *sharedInstance = nil;
 
 - (void)dealloc
 {
     [controlScenes release], controlScenes = nil;
+    [loadingFiles release], loadingFiles = nil;
+    [pendingPreloads release], pendingPreloads = nil;
     
     if (sharedInstance)
     {
@@ -59,6 +83,9 @@ static CCControlSceneManager *sharedInstance = nil;
     if ((self = [super init]))
     {
         currentControlSceneId = 0;
+        preloadsControlScenes = YES;
+        loadingFiles          = [[NSMutableSet alloc] init];
+        pendingPreloads       = [[NSMutableArray alloc] init];
         
         controlScenes = [[NSArray alloc] initWithObjects:
                          @"CCControlSliderTest",
@@ -70,6 +97,24 @@ static CCControlSceneManager *sharedInstance = nil;
                          @"CCControlButtonTest_Styling",
                          @"CCControlPotentiometerTest",
                          @"CCControlPickerTest",
+                         @"CCControlHitTestBenchmark",
+                         @"CCControlTransformCacheBenchmark",
+                         @"CCScale9SpriteBenchmark",
+                         @"CCControlButtonHighlightBenchmark",
+                         @"CCControlPickerBenchmark",
+                         @"CCColourUtilsBenchmark",
+                         @"CCColourPickerTexturesBenchmark",
+                         @"CCControlSwitchMaskBenchmark",
+                         @"CCControlSwitchBatchBenchmark",
+                         @"CCControlPotentiometerBenchmark",
+                         @"CCControlLayoutBenchmark",
+                         @"CCControlTouchReplayBenchmark",
+                         @"CCControlCascadeBenchmark",
+                         @"CCControlRasterBenchmark",
+                         @"CCControlPoolBenchmark",
+                         @"CCControlAutorepeatBenchmark",
+                         @"CCControlSceneTransitionBenchmark",
+                         @"CCControlStressBenchmark",
                          nil];
     }
     return self;
@@ -116,6 +161,169 @@ static CCControlSceneManager *sharedInstance = nil;
 	return [nextControlScene sceneWithTitle:controlSceneName];
 }
 
+- (void)nextControlSceneWithBlock:(void (^)(CCScene *scene))block
+{
+    currentControlSceneId = (currentControlSceneId + 1) % [controlScenes count];
+    
+    [self currentControlSceneWithBlock:block];
+}
+
+- (void)previousControlSceneWithBlock:(void (^)(CCScene *scene))block
+{
+    currentControlSceneId = currentControlSceneId - 1;
+    if (currentControlSceneId < 0)
+    {
+        currentControlSceneId = [controlScenes count] - 1;
+    }
+    
+    [self currentControlSceneWithBlock:block];
+}
+
+- (void)currentControlSceneWithBlock:(void (^)(CCScene *scene))block
+{
+    NSString *controlSceneName  = [controlScenes objectAtIndex:currentControlSceneId];
+    NSUInteger requestId        = ++transitionRequestId;
+    CFTimeInterval requestTime  = CACurrentMediaTime();
+    
+    void (^buildBlock)(void)    = ^
+    {
+        // A newer request replaces this one
+        if (requestId != transitionRequestId)
+        {
+            return;
+        }
+        
+        CCScene *scene          = [self currentControlScene];
+        lastTransitionLatency   = (CACurrentMediaTime() - requestTime) * 1000.0;
+        
+        CCLOG(@"%@ built in %.1f ms", controlSceneName, lastTransitionLatency);
+        
+        block(scene);
+    };
+    
+    if (preloadsControlScenes)
+    {
+        [self preloadControlSceneNamed:controlSceneName withBlock:buildBlock];
+    }
+    else
+    {
+        buildBlock();
+    }
+}
+
+- (void)preloadAdjacentControlScenes
+{
+    if (!preloadsControlScenes)
+    {
+        return;
+    }
+    
+    NSUInteger count        = [controlScenes count];
+    NSUInteger nextId       = (currentControlSceneId + 1) % count;
+    NSUInteger previousId   = (currentControlSceneId + count - 1) % count;
+    
+    [self preloadControlSceneNamed:[controlScenes objectAtIndex:nextId] withBlock:nil];
+    [self preloadControlSceneNamed:[controlScenes objectAtIndex:previousId] withBlock:nil];
+}
+
+- (void)preloadControlSceneNamed:(NSString *)name withBlock:(void (^)(void))block
+{
+    NSArray *files          = [NSClassFromString(name) assetFiles];
+    CCTextureCache *cache   = [CCTextureCache sharedTextureCache];
+    
+    for (NSString *file in files)
+    {
+        if ([loadingFiles containsObject:file] || [cache textureForKey:file])
+        {
+            continue;
+        }
+        
+        [loadingFiles addObject:file];
+        
+        // The texture is decoded on the loading thread of the cache
+        [cache addImageAsync:file withBlock:^(CCTexture2D *texture)
+         {
+             [self fileDidLoad:file];
+         }];
+    }
+    
+    if (block)
+    {
+        NSArray *preload = [NSArray arrayWithObjects:files, [[block copy] autorelease], nil];
+        [pendingPreloads addObject:preload];
+        
+        [self firePendingPreloads];
+        
+        if ([pendingPreloads indexOfObjectIdenticalTo:preload] != NSNotFound)
+        {
+            [self performSelector:@selector(preloadDidTimeOut:) withObject:preload afterDelay:kCCControlSceneManagerPreloadTimeout];
+        }
+    }
+}
+
 #pragma mark CCControlSceneManager Private Methods
 
+- (void)fileDidLoad:(NSString *)file
+{
+    // The cache calls back even if the file could not be loaded, so that a
+    // missing file does not block the scenes using it
+    [loadingFiles removeObject:file];
+    
+    [self firePendingPreloads];
+}
+
+- (void)firePendingPreloads
+{
+    NSMutableIndexSet *loadedIndexes    = [NSMutableIndexSet indexSet];
+    
+    [pendingPreloads enumerateObjectsUsingBlock:^(NSArray *preload, NSUInteger index, BOOL *stop)
+     {
+         for (NSString *file in [preload objectAtIndex:0])
+         {
+             if ([loadingFiles containsObject:file])
+             {
+                 return;
+             }
+         }
+         
+         [loadedIndexes addIndex:index];
+     }];
+    
+    // The blocks may start new preloads, so they are removed first
+    NSArray *loadedPreloads             = [pendingPreloads objectsAtIndexes:loadedIndexes];
+    [pendingPreloads removeObjectsAtIndexes:loadedIndexes];
+    
+    for (NSArray *preload in loadedPreloads)
+    {
+        [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(preloadDidTimeOut:) object:preload];
+        
+        void (^block)(void)             = [preload objectAtIndex:1];
+        block();
+    }
+}
+
+- (void)preloadDidTimeOut:(NSArray *)preload
+{
+    NSUInteger index = [pendingPreloads indexOfObjectIdenticalTo:preload];
+    
+    if (index == NSNotFound)
+    {
+        return;
+    }
+    
+    // The files still loading will be loaded on the main thread when the
+    // scene is built, and no longer hold the other preloads
+    for (NSString *file in [preload objectAtIndex:0])
+    {
+        if ([loadingFiles containsObject:file])
+        {
+            CCLOG(@"%@ is still loading after %.1f s, it is loaded synchronously", file, kCCControlSceneManagerPreloadTimeout);
+            
+            [loadingFiles removeObject:file];
+        }
+    }
+    
+    [self firePendingPreloads];
+}
+
 @end
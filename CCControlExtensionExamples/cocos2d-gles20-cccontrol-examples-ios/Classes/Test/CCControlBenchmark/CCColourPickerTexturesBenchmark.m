@@ -0,0 +1,100 @@
+/*
+ * CCColourPickerTexturesBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCColourPickerTexturesBenchmark.h"
+#import "CCColourPickerTextures.h"
+
+/** Number of colour pickers created with empty caches. */
+#define kColourPickerTexturesBenchmarkColdPickers   10
+/** Number of colour pickers created with warm caches. */
+#define kColourPickerTexturesBenchmarkWarmPickers   100
+
+@interface CCColourPickerTexturesBenchmark ()
+
+/** Creates and releases a colour picker using the images. */
+- (void)createFilePicker;
+
+/** Creates and releases a colour picker using the generated textures. */
+- (void)createGeneratedPicker;
+
+@end
+
+@implementation CCColourPickerTexturesBenchmark
+
+#pragma mark -
+#pragma mark CCColourPickerTexturesBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    // Startup: every picker finds empty caches
+    double fileColdTime = [self millisecondsForIterations:kColourPickerTexturesBenchmarkColdPickers block:^(NSUInteger i) {
+        [[CCTextureCache sharedTextureCache] removeUnusedTextures];
+        [self createFilePicker];
+    }];
+    
+    double generatedColdTime = [self millisecondsForIterations:kColourPickerTexturesBenchmarkColdPickers block:^(NSUInteger i) {
+        [CCColourPickerTextures removeAllTextures];
+        [self createGeneratedPicker];
+    }];
+    
+    // Then the textures are shared
+    [self createFilePicker];
+    double fileWarmTime = [self millisecondsForIterations:kColourPickerTexturesBenchmarkWarmPickers block:^(NSUInteger i) {
+        [self createFilePicker];
+    }];
+    
+    [self createGeneratedPicker];
+    double generatedWarmTime = [self millisecondsForIterations:kColourPickerTexturesBenchmarkWarmPickers block:^(NSUInteger i) {
+        [self createGeneratedPicker];
+    }];
+    
+    [self logResult:@"Startup, per picker"];
+    [self logResult:@"Images: %.2f ms", fileColdTime / kColourPickerTexturesBenchmarkColdPickers];
+    [self logResult:@"Generated: %.2f ms", generatedColdTime / kColourPickerTexturesBenchmarkColdPickers];
+    [self logResult:@"Warm caches, per picker"];
+    [self logResult:@"Images: %.3f ms", fileWarmTime / kColourPickerTexturesBenchmarkWarmPickers];
+    [self logResult:@"Generated: %.3f ms", generatedWarmTime / kColourPickerTexturesBenchmarkWarmPickers];
+}
+
+#pragma mark CCColourPickerTexturesBenchmark Private Methods
+
+- (void)createFilePicker
+{
+    CCControlColourPicker *colourPicker = [[CCControlColourPicker alloc] initWithHueFile:@"hueBackground.png"
+                                                                      tintBackgroundFile:@"tintBackground.png"
+                                                                         tintOverlayFile:@"tintOverlay.png"
+                                                                              pickerFile:@"picker.png"
+                                                                               arrowFile:@"arrow.png"];
+    [colourPicker release];
+}
+
+- (void)createGeneratedPicker
+{
+    CCControlColourPicker *colourPicker = [[CCControlColourPicker alloc] initWithDiameter:kCCColourPickerDefaultDiameter arrow:YES];
+    [colourPicker release];
+}
+
+@end
@@ -0,0 +1,111 @@
+/*
+ * CCColourUtilsBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCColourUtilsBenchmark.h"
+#import "CCColourUtils.h"
+
+/** Number of converted colours. */
+#define kColourUtilsBenchmarkColours    1000000
+
+/**
+ * Colours whose conversion went wrong once, checked first. The first one has
+ * a hue just below 360 degrees which rounded up to a sixth sector.
+ */
+static const RGBAf kColourUtilsBenchmarkRegressions[] =
+{
+    { 0.557f, 0.00315f, 0.00315014087f, 1.0f },
+    { 1.0f, 0.0f, 0.0000001f, 1.0f },
+    { 0.9f, 0.1f, 0.10001f, 1.0f },
+    { 0.5f, 0.2f, 0.3f, 1.0f },
+};
+
+@implementation CCColourUtilsBenchmark
+
+#pragma mark -
+#pragma mark CCColourUtilsBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    NSUInteger count            = kColourUtilsBenchmarkColours;
+    RGBAf *colours              = malloc(count * sizeof(RGBAf));
+    RGBAf *results              = malloc(count * sizeof(RGBAf));
+    HSVf *hsvColours            = malloc(count * sizeof(HSVf));
+    ccColor4B *packedColours    = malloc(count * sizeof(ccColor4B));
+    
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        packedColours[i]        = ccc4(arc4random() % 256, arc4random() % 256, arc4random() % 256, 255);
+        colours[i].r            = packedColours[i].r / 255.0f;
+        colours[i].g            = packedColours[i].g / 255.0f;
+        colours[i].b            = packedColours[i].b / 255.0f;
+        colours[i].a            = 1.0f;
+    }
+    
+    // The regressions fill the first SIMD batch
+    memcpy(colours, kColourUtilsBenchmarkRegressions, sizeof(kColourUtilsBenchmarkRegressions));
+    
+    [self logResult:@"%d colours", kColourUtilsBenchmarkColours];
+    
+    // One colour at a time, in double precision
+    double scalarTime = [self millisecondsForIterations:count block:^(NSUInteger i) {
+        RGBA rgba               = { colours[i].r, colours[i].g, colours[i].b, 1.0 };
+        HSV hsv                 = [CCColourUtils HSVfromRGB:rgba];
+        rgba                    = [CCColourUtils RGBfromHSV:hsv];
+        results[i].r            = rgba.r;
+    }];
+    
+    double batchTime = [self millisecondsForIterations:1 block:^(NSUInteger i) {
+        [CCColourUtils HSVfromRGBColours:colours toHSVColours:hsvColours count:count];
+        [CCColourUtils RGBfromHSVColours:hsvColours toRGBColours:results count:count];
+    }];
+    
+    double packedTime = [self millisecondsForIterations:1 block:^(NSUInteger i) {
+        [CCColourUtils HSVfromColor4B:packedColours toHSVColours:hsvColours count:count];
+        [CCColourUtils color4BfromHSVColours:hsvColours toColor4B:packedColours count:count];
+    }];
+    
+    // Compare the round trip of the batch conversions with the sources
+    float maxError              = 0;
+    
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        maxError                = MAX(maxError, fabsf(results[i].r - colours[i].r));
+        maxError                = MAX(maxError, fabsf(results[i].g - colours[i].g));
+        maxError                = MAX(maxError, fabsf(results[i].b - colours[i].b));
+    }
+    
+    [self logResult:@"One at a time: %.2f ms (RGB > HSV > RGB)", scalarTime];
+    [self logResult:@"Batch: %.2f ms, max round trip error %g (%@)", batchTime, maxError,
+     (maxError <= kCCColourUtilsComponentTolerance) ? @"passed" : @"FAILED"];
+    [self logResult:@"Batch ccColor4B: %.2f ms", packedTime];
+    
+    free(colours);
+    free(results);
+    free(hsvColours);
+    free(packedColours);
+}
+
+@end
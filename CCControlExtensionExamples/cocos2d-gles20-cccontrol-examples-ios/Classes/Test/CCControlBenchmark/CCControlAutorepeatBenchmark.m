@@ -0,0 +1,147 @@
+/*
+ * CCControlAutorepeatBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlAutorepeatBenchmark.h"
+
+/** Number of controls held at the same time. */
+#define kAutorepeatBenchmarkTargets 500
+/** Number of frames, ten seconds at 60 fps. */
+#define kAutorepeatBenchmarkFrames  600
+/** Duration of a frame. */
+#define kAutorepeatBenchmarkDelta   (1.0f / 60.0f)
+
+/** Stands for a held control, counts the steps it receives. */
+@interface CCAutorepeatBenchmarkTarget : CCNode
+{
+@public
+    NSUInteger _steps;
+    NSInteger  _ticks;
+}
+
+/** Called by the shared autorepeat. */
+- (void)step;
+
+/** Called by the scheduler, as the steppers did with their own selector. */
+- (void)tick:(ccTime)dt;
+
+@end
+
+@implementation CCAutorepeatBenchmarkTarget
+
+- (void)step
+{
+    _steps++;
+}
+
+- (void)tick:(ccTime)dt
+{
+    _ticks++;
+    
+    // Every third tick until the twelfth one, then every tick
+    if ((_ticks < 12) && (_ticks % 3) != 0)
+    {
+        return;
+    }
+    
+    _steps++;
+}
+
+@end
+
+@interface CCControlAutorepeatBenchmark ()
+
+/**
+ * Holds the targets during the frames, using the shared autorepeat when
+ * shared is YES, and returns the time spent in milliseconds.
+ *
+ * @param steps On output, the number of steps received by the targets.
+ */
+- (double)holdTargetsUsingSharedAutorepeat:(BOOL)shared steps:(NSUInteger *)steps;
+
+@end
+
+@implementation CCControlAutorepeatBenchmark
+
+#pragma mark -
+#pragma mark CCControlAutorepeatBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    NSUInteger scheduledSteps, sharedSteps;
+    
+    [self logResult:@"%d held controls, %d frames", kAutorepeatBenchmarkTargets, kAutorepeatBenchmarkFrames];
+    
+    double scheduledTime    = [self holdTargetsUsingSharedAutorepeat:NO steps:&scheduledSteps];
+    double sharedTime       = [self holdTargetsUsingSharedAutorepeat:YES steps:&sharedSteps];
+    
+    [self logResult:@"Scheduled selectors: %.3f ms/frame, %lu steps", scheduledTime / kAutorepeatBenchmarkFrames, (unsigned long)scheduledSteps];
+    [self logResult:@"Shared autorepeat: %.3f ms/frame, %lu steps", sharedTime / kAutorepeatBenchmarkFrames, (unsigned long)sharedSteps];
+}
+
+#pragma mark CCControlAutorepeatBenchmark Private Methods
+
+- (double)holdTargetsUsingSharedAutorepeat:(BOOL)shared steps:(NSUInteger *)steps
+{
+    CCScheduler *scheduler          = [CCDirector sharedDirector].scheduler;
+    CCControlAutorepeat *autorepeat = [CCControlAutorepeat sharedAutorepeat];
+    NSMutableArray *targets         = [NSMutableArray arrayWithCapacity:kAutorepeatBenchmarkTargets];
+    
+    for (NSUInteger i = 0; i < kAutorepeatBenchmarkTargets; i++)
+    {
+        CCAutorepeatBenchmarkTarget *target = [CCAutorepeatBenchmarkTarget node];
+        [self addChild:target];
+        [targets addObject:target];
+        
+        if (shared)
+        {
+            [autorepeat startRepeatingTarget:target action:@selector(step) timing:kCCControlAutorepeatTimingDefault];
+        }
+        else
+        {
+            target->_ticks = -1;
+            [target schedule:@selector(tick:) interval:0.15f repeat:kCCRepeatForever delay:0.45f];
+        }
+    }
+    
+    // The frames are driven by hand so that only the scheduler is measured
+    double time = [self millisecondsForIterations:kAutorepeatBenchmarkFrames block:^(NSUInteger frame) {
+        [scheduler update:kAutorepeatBenchmarkDelta];
+    }];
+    
+    *steps = 0;
+    
+    for (CCAutorepeatBenchmarkTarget *target in targets)
+    {
+        *steps += target->_steps;
+        
+        [autorepeat stopRepeatingTarget:target];
+        [self removeChild:target cleanup:YES];
+    }
+    
+    return time;
+}
+
+@end
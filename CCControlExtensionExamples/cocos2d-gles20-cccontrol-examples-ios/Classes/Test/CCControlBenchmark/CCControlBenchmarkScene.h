@@ -0,0 +1,56 @@
+/*
+ * CCControlBenchmarkScene.h
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlScene.h"
+
+/**
+ * Base class of the benchmark scenes. The benchmark runs once the scene is
+ * displayed and its results are printed on screen and in the console.
+ */
+@interface CCControlBenchmarkScene : CCControlScene
+{
+@protected
+    CCLabelTTF      *resultLabel;
+    NSMutableArray  *resultLines;
+}
+/** The label displaying the results. */
+@property (nonatomic, retain) CCLabelTTF *resultLabel;
+
+#pragma mark Public Methods
+
+/** Runs the benchmark. Subclasses must override it. */
+- (void)runBenchmark;
+
+/**
+ * Returns the time spent, in milliseconds, to call the given block the given
+ * number of times.
+ */
+- (double)millisecondsForIterations:(NSUInteger)iterations block:(void (^)(NSUInteger iteration))block;
+
+/** Appends a line to the results and logs it in the console. */
+- (void)logResult:(NSString *)format, ... NS_FORMAT_FUNCTION(1,2);
+
+@end
@@ -0,0 +1,119 @@
+/*
+ * CCControlBenchmarkScene.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlBenchmarkScene.h"
+
+#import <QuartzCore/QuartzCore.h>
+
+@interface CCControlBenchmarkScene ()
+
+/** Scheduled callback which starts the benchmark. */
+- (void)startBenchmark:(ccTime)delta;
+
+@end
+
+@implementation CCControlBenchmarkScene
+@synthesize resultLabel;
+
+- (void)dealloc
+{
+    [resultLabel    release];
+    [resultLines    release];
+    
+    [super          dealloc];
+}
+
+- (id)init
+{
+	if ((self = [super init]))
+    {
+        CGSize screenSize           = [[CCDirector sharedDirector] winSize];
+        
+        resultLines                 = [[NSMutableArray alloc] init];
+        
+        self.resultLabel            = [CCLabelTTF labelWithString:@"Running..."
+                                                       dimensions:CGSizeMake(screenSize.width - 20, screenSize.height - 140)
+                                                       hAlignment:kCCTextAlignmentLeft
+                                                         fontName:@"Arial"
+                                                         fontSize:12];
+        resultLabel.anchorPoint     = ccp(0.5f, 1.0f);
+        resultLabel.position        = ccp(screenSize.width / 2, screenSize.height - 70);
+        [self addChild:resultLabel z:2];
+    }
+    return self;
+}
+
+- (void)onEnterTransitionDidFinish
+{
+    [super onEnterTransitionDidFinish];
+    
+    // Let a frame be drawn before blocking the main thread
+    [self scheduleOnce:@selector(startBenchmark:) delay:0.1f];
+}
+
+#pragma mark -
+#pragma mark CCControlBenchmarkScene Public Methods
+
+- (void)runBenchmark
+{
+    [self logResult:@"Nothing to run"];
+}
+
+- (double)millisecondsForIterations:(NSUInteger)iterations block:(void (^)(NSUInteger iteration))block
+{
+    CFTimeInterval start = CACurrentMediaTime();
+    
+    for (NSUInteger i = 0; i < iterations; i++)
+    {
+        block(i);
+    }
+    
+    return (CACurrentMediaTime() - start) * 1000.0;
+}
+
+- (void)logResult:(NSString *)format, ...
+{
+    va_list args;
+    va_start(args, format);
+    NSString *line = [[NSString alloc] initWithFormat:format arguments:args];
+    va_end(args);
+    
+    NSLog(@"%@: %@", sceneTitleLabel.string, line);
+    
+    [resultLines addObject:line];
+    [line release];
+    
+    resultLabel.string = [resultLines componentsJoinedByString:@"\n"];
+}
+
+#pragma mark CCControlBenchmarkScene Private Methods
+
+- (void)startBenchmark:(ccTime)delta
+{
+    [self runBenchmark];
+}
+
+@end
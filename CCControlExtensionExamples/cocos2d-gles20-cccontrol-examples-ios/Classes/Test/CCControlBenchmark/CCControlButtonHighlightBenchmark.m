@@ -0,0 +1,154 @@
+/*
+ * CCControlButtonHighlightBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlButtonHighlightBenchmark.h"
+
+/** Number of buttons, as a long menu. */
+#define kButtonHighlightBenchmarkButtons    500
+/** Number of frames, each one toggles the highlighted state of every button. */
+#define kButtonHighlightBenchmarkFrames     60
+
+/** Renders the text of the label, as setting its string did. */
+@interface CCLabelTTF (HighlightBenchmark)
+
+- (void)updateTexture;
+
+@end
+
+/** Changes the state the way the touch handlers do. */
+@interface CCControlButton (HighlightBenchmark)
+
+/** Updates the state then performs the incremental layout. */
+- (void)benchmarkSetHighlighted:(BOOL)highlighted;
+
+/**
+ * Updates the state then performs a full layout, as before the dirty flags:
+ * every aspect is recomputed and the text of the label is rendered again.
+ */
+- (void)benchmarkSetHighlightedWithFullLayout:(BOOL)highlighted;
+
+@end
+
+@implementation CCControlButton (HighlightBenchmark)
+
+- (void)benchmarkSetHighlighted:(BOOL)highlighted
+{
+    _state              = highlighted ? CCControlStateHighlighted : CCControlStateNormal;
+    self.highlighted    = highlighted;
+}
+
+- (void)benchmarkSetHighlightedWithFullLayout:(BOOL)highlighted
+{
+    _state              = highlighted ? CCControlStateHighlighted : CCControlStateNormal;
+    _highlighted        = highlighted;
+    
+    // The string comparisons of the layout would skip the rendering
+    [self needsLayout];
+    [(CCLabelTTF *)_titleLabel updateTexture];
+}
+
+@end
+
+@interface CCControlButtonHighlightBenchmark ()
+
+/** Returns a list of buttons with a highlighted background and title color. */
+- (CCNode *)buttonList;
+
+/**
+ * Returns the time spent to toggle the highlighted state of the buttons of
+ * the list, to draw it and to wait for the GPU, in milliseconds per frame.
+ */
+- (double)millisecondsPerFrameToToggleList:(CCNode *)list fullLayout:(BOOL)fullLayout;
+
+@end
+
+@implementation CCControlButtonHighlightBenchmark
+
+#pragma mark -
+#pragma mark CCControlButtonHighlightBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    [self logResult:@"%d buttons, %d frames", kButtonHighlightBenchmarkButtons, kButtonHighlightBenchmarkFrames];
+    
+    CCNode *list            = [self buttonList];
+    
+    double fullTime         = [self millisecondsPerFrameToToggleList:list fullLayout:YES];
+    double incrementalTime  = [self millisecondsPerFrameToToggleList:list fullLayout:NO];
+    
+    [self logResult:@"Full layout: %.3f ms/frame", fullTime];
+    [self logResult:@"Incremental layout: %.3f ms/frame", incrementalTime];
+}
+
+#pragma mark CCControlButtonHighlightBenchmark Private Methods
+
+- (CCNode *)buttonList
+{
+    CCNode *list                        = [CCNode node];
+    
+    for (NSUInteger i = 0; i < kButtonHighlightBenchmarkButtons; i++)
+    {
+        CCScale9Sprite *background      = [CCScale9Sprite spriteWithFile:@"button.png"];
+        CCScale9Sprite *highlighted     = [CCScale9Sprite spriteWithFile:@"buttonHighlighted.png"];
+        CCLabelTTF *label               = [CCLabelTTF labelWithString:[NSString stringWithFormat:@"Button %lu", (unsigned long)i]
+                                                             fontName:@"HelveticaNeue-Bold"
+                                                             fontSize:30];
+        [label setColor:ccc3(159, 168, 176)];
+        
+        CCControlButton *button         = [CCControlButton buttonWithLabel:label backgroundSprite:background];
+        button.zoomOnTouchDown          = NO;
+        button.position                 = ccp(0, i * 40);
+        [button setBackgroundSprite:highlighted forState:CCControlStateHighlighted];
+        [button setTitleColor:ccWHITE forState:CCControlStateHighlighted];
+        [list addChild:button];
+    }
+    
+    return list;
+}
+
+- (double)millisecondsPerFrameToToggleList:(CCNode *)list fullLayout:(BOOL)fullLayout
+{
+    double time = [self millisecondsForIterations:kButtonHighlightBenchmarkFrames block:^(NSUInteger frame) {
+        for (CCControlButton *button in [list children])
+        {
+            if (fullLayout)
+            {
+                [button benchmarkSetHighlightedWithFullLayout:(frame % 2 == 0)];
+            }
+            else
+            {
+                [button benchmarkSetHighlighted:(frame % 2 == 0)];
+            }
+        }
+        
+        [list visit];
+        glFinish();
+    }];
+    
+    return time / kButtonHighlightBenchmarkFrames;
+}
+
+@end
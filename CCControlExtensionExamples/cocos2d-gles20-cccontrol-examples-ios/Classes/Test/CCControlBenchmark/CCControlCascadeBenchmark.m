@@ -0,0 +1,137 @@
+/*
+ * CCControlCascadeBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlCascadeBenchmark.h"
+
+/** Number of buttons of the panel. */
+#define kCascadeBenchmarkButtons    50
+/** Number of frames of the fade, one second at 60 fps. */
+#define kCascadeBenchmarkFrames     60
+/** Number of fades. */
+#define kCascadeBenchmarkRuns       10
+
+@interface CCControlCascadeBenchmark ()
+
+/**
+ * Returns a panel of buttons having a label and a background for each state.
+ *
+ * @param defersCascade Tells whether the buttons defer the cascade.
+ */
+- (CCNode *)panelDeferringCascade:(BOOL)defersCascade;
+
+/**
+ * Fades and tints the panel as a CCFadeTo and a CCTintTo running on each
+ * button would do, and returns the time spent in milliseconds.
+ */
+- (double)fadePanel:(CCNode *)panel;
+
+@end
+
+@implementation CCControlCascadeBenchmark
+
+#pragma mark -
+#pragma mark CCControlCascadeBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    [self logResult:@"%d buttons with 4 states, %d frames, %d runs", kCascadeBenchmarkButtons, kCascadeBenchmarkFrames, kCascadeBenchmarkRuns];
+    
+    double immediateTime    = [self fadePanel:[self panelDeferringCascade:NO]];
+    double deferredTime     = [self fadePanel:[self panelDeferringCascade:YES]];
+    
+    [self logResult:@"Immediate cascade: %.3f ms/frame", immediateTime / (kCascadeBenchmarkFrames * kCascadeBenchmarkRuns)];
+    [self logResult:@"Deferred cascade: %.3f ms/frame", deferredTime / (kCascadeBenchmarkFrames * kCascadeBenchmarkRuns)];
+}
+
+#pragma mark CCControlCascadeBenchmark Private Methods
+
+- (CCNode *)panelDeferringCascade:(BOOL)defersCascade
+{
+    static const CCControlState states[] = { CCControlStateNormal, CCControlStateHighlighted, CCControlStateDisabled, CCControlStateSelected };
+    
+    CCNode *panel                       = [CCNode node];
+    
+    for (NSUInteger i = 0; i < kCascadeBenchmarkButtons; i++)
+    {
+        CCLabelTTF *label               = [CCLabelTTF labelWithString:[NSString stringWithFormat:@"Button %lu", (unsigned long)i]
+                                                             fontName:@"HelveticaNeue-Bold"
+                                                             fontSize:30];
+        CCControlButton *button         = [CCControlButton buttonWithLabel:label backgroundSprite:[CCScale9Sprite spriteWithFile:@"button.png"]];
+        button.defersCascade            = defersCascade;
+        button.position                 = ccp((i % 5) * 100, (i / 5) * 40);
+        
+        for (NSUInteger j = 1; j < 4; j++)
+        {
+            CCLabelTTF *stateLabel      = [CCLabelTTF labelWithString:label.string fontName:@"HelveticaNeue-Bold" fontSize:30];
+            NSString *file              = (states[j] == CCControlStateHighlighted) ? @"buttonHighlighted.png" : @"button.png";
+            
+            [button setTitleLabel:stateLabel forState:states[j]];
+            [button setBackgroundSprite:[CCScale9Sprite spriteWithFile:file] forState:states[j]];
+        }
+        
+        [panel addChild:button];
+    }
+    
+    return panel;
+}
+
+- (double)fadePanel:(CCNode *)panel
+{
+    NSMutableArray *actions = [NSMutableArray array];
+    
+    return [self millisecondsForIterations:kCascadeBenchmarkRuns block:^(NSUInteger run) {
+        [actions removeAllObjects];
+        
+        for (CCControlButton *button in [panel children])
+        {
+            button.opacity              = 255;
+            button.color                = ccWHITE;
+            
+            CCFiniteTimeAction *fade    = [CCFadeTo actionWithDuration:1.0f opacity:0];
+            CCFiniteTimeAction *tint    = [CCTintTo actionWithDuration:1.0f red:255 green:0 blue:0];
+            [fade startWithTarget:button];
+            [tint startWithTarget:button];
+            [actions addObject:fade];
+            [actions addObject:tint];
+        }
+        
+        for (NSUInteger frame = 0; frame < kCascadeBenchmarkFrames; frame++)
+        {
+            for (CCFiniteTimeAction *action in actions)
+            {
+                [action step:1.0f / kCascadeBenchmarkFrames];
+            }
+            
+            // Do what the visit of the buttons does before drawing
+            for (CCControlButton *button in [panel children])
+            {
+                [button resolveCascade];
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,152 @@
+/*
+ * CCControlHitTestBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlHitTestBenchmark.h"
+
+#import "CCControlHitTestManager.h"
+
+/** Number of control columns and rows in the panel. */
+#define kHitTestBenchmarkColumns    20
+#define kHitTestBenchmarkRows       12
+/** Number of simulated touches. */
+#define kHitTestBenchmarkTouches    10000
+
+@interface CCControlHitTestBenchmark ()
+
+/** Returns the first control hit at the given location, asking every control
+ in turn as the touch dispatcher does. */
+- (CCControl *)linearControlAtLocation:(CGPoint)location inControls:(NSArray *)controls;
+
+@end
+
+@implementation CCControlHitTestBenchmark
+
+#pragma mark -
+#pragma mark CCControlHitTestBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    // Build an inventory-like panel with one nested layer per row
+    CCNode *panel                   = [CCNode node];
+    panel.position                  = ccp(10, 60);
+    NSMutableArray *controls        = [NSMutableArray array];
+    
+    for (NSUInteger row = 0; row < kHitTestBenchmarkRows; row++)
+    {
+        CCNode *rowLayer            = [CCNode node];
+        rowLayer.position           = ccp(0, row * 22);
+        [panel addChild:rowLayer];
+        
+        for (NSUInteger column = 0; column < kHitTestBenchmarkColumns; column++)
+        {
+            CCControl *control      = [CCControl node];
+            control.contentSize     = CGSizeMake(20, 20);
+            control.position        = ccp(column * 22, 0);
+            [rowLayer addChild:control];
+            [controls addObject:control];
+        }
+    }
+    
+    // Generate the same touches for both runs
+    CGPoint *locations              = malloc(kHitTestBenchmarkTouches * sizeof(CGPoint));
+    srand48(42);
+    
+    for (NSUInteger i = 0; i < kHitTestBenchmarkTouches; i++)
+    {
+        locations[i]                = ccp(10 + drand48() * kHitTestBenchmarkColumns * 22, 60 + drand48() * kHitTestBenchmarkRows * 22);
+    }
+    
+    CCControlHitTestManager *manager = [[CCControlHitTestManager alloc] init];
+    
+    for (CCControl *control in controls)
+    {
+        [manager addControl:control];
+    }
+    
+    __block NSUInteger linearHits   = 0, gridHits = 0, mismatches = 0;
+    
+    double linearTime = [self millisecondsForIterations:kHitTestBenchmarkTouches block:^(NSUInteger i) {
+        if ([self linearControlAtLocation:locations[i] inControls:controls])
+        {
+            linearHits++;
+        }
+    }];
+    
+    double rebuildTime = [self millisecondsForIterations:1 block:^(NSUInteger i) {
+        [manager setNeedsUpdate];
+        [manager controlAtLocation:CGPointZero];
+    }];
+    
+    double gridTime = [self millisecondsForIterations:kHitTestBenchmarkTouches block:^(NSUInteger i) {
+        if ([manager controlAtLocation:locations[i]])
+        {
+            gridHits++;
+        }
+    }];
+    
+    // Check that both methods agree
+    for (NSUInteger i = 0; i < kHitTestBenchmarkTouches; i++)
+    {
+        if ([manager controlAtLocation:locations[i]] != [self linearControlAtLocation:locations[i] inControls:controls])
+        {
+            mismatches++;
+        }
+    }
+    
+    for (CCControl *control in controls)
+    {
+        [manager removeControl:control];
+    }
+    [manager release];
+    free(locations);
+    
+    [self logResult:@"%d controls, %d touches", kHitTestBenchmarkColumns * kHitTestBenchmarkRows, kHitTestBenchmarkTouches];
+    [self logResult:@"Linear: %.2f ms (%.2f us/touch, %lu hits)", linearTime, linearTime * 1000 / kHitTestBenchmarkTouches, (unsigned long)linearHits];
+    [self logResult:@"Grid: %.2f ms (%.2f us/touch, %lu hits)", gridTime, gridTime * 1000 / kHitTestBenchmarkTouches, (unsigned long)gridHits];
+    [self logResult:@"Grid rebuild: %.3f ms", rebuildTime];
+    [self logResult:@"Speedup: x%.1f, mismatches: %lu", linearTime / gridTime, (unsigned long)mismatches];
+}
+
+#pragma mark CCControlHitTestBenchmark Private Methods
+
+- (CCControl *)linearControlAtLocation:(CGPoint)location inControls:(NSArray *)controls
+{
+    for (CCControl *control in controls)
+    {
+        // Same tests as the controls do in ccTouchBegan:withEvent:
+        if ([control isPointInside:[[control parent] convertToNodeSpace:location]]
+            && [control isEnabled]
+            && [control visible]
+            && [control hasVisibleParents])
+        {
+            return control;
+        }
+    }
+    
+    return nil;
+}
+
+@end
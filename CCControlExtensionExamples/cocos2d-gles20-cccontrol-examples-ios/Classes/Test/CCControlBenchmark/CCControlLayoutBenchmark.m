@@ -0,0 +1,134 @@
+/*
+ * CCControlLayoutBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlLayoutBenchmark.h"
+#import "CCControlLayout.h"
+
+/** Number of buttons of Resources/layout-benchmark.txt. */
+#define kLayoutBenchmarkButtons     200
+/** Number of times the menu is loaded. */
+#define kLayoutBenchmarkRuns        5
+
+@interface CCControlLayoutBenchmark ()
+
+/** Returns the KVC keys of the button properties, in the order they are set. */
+- (NSArray *)buttonKeys;
+
+/**
+ * Returns the values of the button properties, as decoded by a layout
+ * tool: one array of values per button, ordered like buttonKeys.
+ */
+- (NSArray *)buttonValues;
+
+@end
+
+@implementation CCControlLayoutBenchmark
+
+#pragma mark -
+#pragma mark CCControlLayoutBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    NSArray *buttonKeys     = [self buttonKeys];
+    NSArray *buttonValues   = [self buttonValues];
+    NSUInteger keyCount     = [buttonKeys count];
+    
+    // Load the textures and the fonts first to only measure the controls
+    [[CCControlLayout layoutWithFile:@"layout-benchmark.ccl"] buildControlAtIndex:0];
+    
+    double layoutTime = [self millisecondsForIterations:kLayoutBenchmarkRuns block:^(NSUInteger i) {
+        CCControlLayout *layout = [CCControlLayout layoutWithFile:@"layout-benchmark.ccl"];
+        
+        [layout buildNode];
+    }];
+    
+    double kvcTime = [self millisecondsForIterations:kLayoutBenchmarkRuns block:^(NSUInteger i) {
+        CCNode *node = [CCNode node];
+        
+        for (NSArray *values in buttonValues)
+        {
+            CCControlButton *button = [[CCControlButton alloc] init];
+            
+            for (NSUInteger k = 0; k < keyCount; k++)
+            {
+                [button setValue:[values objectAtIndex:k] forKey:[buttonKeys objectAtIndex:k]];
+            }
+            
+            [node addChild:button];
+            [button release];
+        }
+    }];
+    
+    [self logResult:@"%d buttons, %d loads", kLayoutBenchmarkButtons, kLayoutBenchmarkRuns];
+    [self logResult:@"Binary layout: %.2f ms", layoutTime];
+    [self logResult:@"KVC: %.2f ms", kvcTime];
+}
+
+#pragma mark CCControlLayoutBenchmark Private Methods
+
+- (NSArray *)buttonKeys
+{
+    return [NSArray arrayWithObjects:
+            @"tag", @"position", @"preferredSize",
+            @"title|1", @"title|2", @"titleColor|1", @"titleColor|2",
+            @"titleTTF|1", @"titleTTF|2", @"titleTTFSize|1", @"titleTTFSize|2",
+            @"backgroundSpriteFrame|1", @"backgroundSpriteFrame|2", nil];
+}
+
+- (NSArray *)buttonValues
+{
+    NSMutableArray *buttons     = [NSMutableArray arrayWithCapacity:kLayoutBenchmarkButtons];
+    CCTexture2D *texture        = [[CCTextureCache sharedTextureCache] addImage:@"button.png"];
+    CCTexture2D *textureHL      = [[CCTextureCache sharedTextureCache] addImage:@"buttonHighlighted.png"];
+    CCSpriteFrame *frame        = [CCSpriteFrame frameWithTexture:texture rect:CGRectMake(0, 0, texture.contentSize.width, texture.contentSize.height)];
+    CCSpriteFrame *frameHL      = [CCSpriteFrame frameWithTexture:textureHL rect:CGRectMake(0, 0, textureHL.contentSize.width, textureHL.contentSize.height)];
+    ccColor3B titleColor        = ccWHITE;
+    ccColor3B titleColorHL      = ccc3(255, 200, 0);
+    
+    // Same buttons as Resources/layout-benchmark.txt
+    for (NSUInteger i = 0; i < kLayoutBenchmarkButtons; i++)
+    {
+        [buttons addObject:[NSArray arrayWithObjects:
+                            [NSNumber numberWithInteger:i],
+                            [NSValue valueWithCGPoint:ccp(60 + (i % 4) * 120, 20 + (i / 4) * 45)],
+                            [NSValue valueWithCGSize:CGSizeMake(100, 40)],
+                            [NSString stringWithFormat:@"Item %u", (unsigned int)i],
+                            [NSString stringWithFormat:@"Item %u!", (unsigned int)i],
+                            [NSValue value:&titleColor withObjCType:@encode(ccColor3B)],
+                            [NSValue value:&titleColorHL withObjCType:@encode(ccColor3B)],
+                            @"Marker Felt",
+                            @"Marker Felt",
+                            [NSNumber numberWithFloat:30],
+                            [NSNumber numberWithFloat:30],
+                            frame,
+                            frameHL,
+                            nil]];
+    }
+    
+    return buttons;
+}
+
+@end
@@ -0,0 +1,106 @@
+/*
+ * CCControlPickerBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlPickerBenchmark.h"
+
+/** Number of rows of the data source, as a long item list. */
+#define kPickerBenchmarkRows        5000
+/** Number of scroll steps, one row per step. */
+#define kPickerBenchmarkScrollSteps 500
+
+@interface CCControlPickerBenchmark ()
+@property (nonatomic, assign) NSUInteger    requestedRowCount;
+
+/** Runs the benchmark with the given virtualization mode. */
+- (void)runBenchmarkWithVirtualization:(BOOL)virtualized name:(NSString *)name;
+
+@end
+
+@implementation CCControlPickerBenchmark
+@synthesize requestedRowCount   = _requestedRowCount;
+
+#pragma mark -
+#pragma mark CCControlPickerBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    [self logResult:@"%d rows, %d scroll steps", kPickerBenchmarkRows, kPickerBenchmarkScrollSteps];
+    
+    [self runBenchmarkWithVirtualization:NO name:@"All rows"];
+    [self runBenchmarkWithVirtualization:YES name:@"Virtualized"];
+}
+
+#pragma mark CCControlPickerBenchmark Private Methods
+
+- (void)runBenchmarkWithVirtualization:(BOOL)virtualized name:(NSString *)name
+{
+    CCSprite *foreground            = [CCSprite spriteWithFile:@"pickerBackground.png"];
+    CCControlPicker *picker         = [CCControlPicker pickerWithForegroundSprite:foreground];
+    picker.virtualized              = virtualized;
+    picker.dataSource               = self;
+    
+    _requestedRowCount              = 0;
+    
+    double loadTime = [self millisecondsForIterations:1 block:^(NSUInteger i) {
+        [picker reloadComponent];
+    }];
+    
+    NSUInteger loadedRowCount       = _requestedRowCount;
+    
+    // Scroll through the rows, visiting the picker as a frame would do
+    double scrollTime = [self millisecondsForIterations:kPickerBenchmarkScrollSteps block:^(NSUInteger step) {
+        [picker selectRow:step animated:NO];
+        [picker visit];
+    }];
+    
+    [self logResult:@"%@: load %.2f ms (%lu rows requested), scroll %.3f ms/step (%lu rows requested)",
+     name, loadTime, (unsigned long)loadedRowCount, scrollTime / kPickerBenchmarkScrollSteps,
+     (unsigned long)(_requestedRowCount - loadedRowCount)];
+}
+
+#pragma mark - CCControlPicker DataSource Methods
+
+- (NSUInteger)numberOfRowsInControlPicker:(CCControlPicker *)controlPicker
+{
+    return kPickerBenchmarkRows;
+}
+
+- (CCControlPickerRow *)controlPicker:(CCControlPicker *)controlPicker nodeForRow:(NSUInteger)row
+{
+    _requestedRowCount++;
+    
+    CCControlPickerRow *rowNode     = [controlPicker dequeueReusableRow];
+    
+    if (!rowNode)
+    {
+        rowNode                     = [CCControlPickerRow node];
+    }
+    rowNode.textLabel.string        = [NSString stringWithFormat:@"%lu", (unsigned long)row];
+    
+    return rowNode;
+}
+
+@end
@@ -0,0 +1,157 @@
+/*
+ * CCControlPoolBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlPoolBenchmark.h"
+
+/** Number of rows of the list, each having a button, a switch and a stepper. */
+#define kPoolBenchmarkRows          100
+/** Number of screen transitions. */
+#define kPoolBenchmarkTransitions   20
+
+#define kPoolBenchmarkButtonIdentifier  @"PoolBenchmarkButton"
+#define kPoolBenchmarkSwitchIdentifier  @"PoolBenchmarkSwitch"
+#define kPoolBenchmarkStepperIdentifier @"PoolBenchmarkStepper"
+
+@interface CCControlPoolBenchmark ()
+
+/**
+ * Returns a list screen, its controls are taken from the pool when pools is
+ * YES.
+ */
+- (CCNode *)screenUsingPool:(BOOL)pools;
+
+/**
+ * Builds and tears down the screen for each transition, and returns the
+ * time spent in milliseconds per transition.
+ */
+- (double)millisecondsPerTransitionUsingPool:(BOOL)pools;
+
+/** Called by the controls of the screen. */
+- (void)valueChanged:(CCControl *)sender;
+
+@end
+
+@implementation CCControlPoolBenchmark
+
+#pragma mark -
+#pragma mark CCControlPoolBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    CCControlPool *pool         = [CCControlPool sharedPool];
+    
+    [self logResult:@"%d rows of a button, a switch and a stepper, %d transitions", kPoolBenchmarkRows, kPoolBenchmarkTransitions];
+    
+    double allocatedTime        = [self millisecondsPerTransitionUsingPool:NO];
+    [self logResult:@"Allocated: %.3f ms/transition", allocatedTime];
+    
+    pool.maximumNumberOfControlsPerIdentifier = kPoolBenchmarkRows;
+    [pool resetCounters];
+    
+    double pooledTime           = [self millisecondsPerTransitionUsingPool:YES];
+    [self logResult:@"Pooled: %.3f ms/transition", pooledTime];
+    [self logResult:@"%@", [pool dump]];
+    
+    [pool purge];
+}
+
+#pragma mark CCControlPoolBenchmark Private Methods
+
+- (CCNode *)screenUsingPool:(BOOL)pools
+{
+    CCNode *screen                      = [CCNode node];
+    
+    for (NSUInteger i = 0; i < kPoolBenchmarkRows; i++)
+    {
+        CGFloat y                       = 20 + i * 40;
+        
+        CCControlButton *button         = pools ? [CCControlButton dequeueReusableControlWithIdentifier:kPoolBenchmarkButtonIdentifier] : nil;
+        
+        if (!button)
+        {
+            button                      = [CCControlButton buttonWithTitle:@"" fontName:@"HelveticaNeue-Bold" fontSize:20];
+            [button setBackgroundSprite:[CCScale9Sprite spriteWithFile:@"button.png"] forState:CCControlStateNormal];
+            button.reuseIdentifier      = pools ? kPoolBenchmarkButtonIdentifier : nil;
+        }
+        [button setTitle:[NSString stringWithFormat:@"Item %lu", (unsigned long)i] forState:CCControlStateNormal];
+        [button setTitleColor:ccYELLOW forState:CCControlStateHighlighted];
+        [button addTarget:self action:@selector(valueChanged:) forControlEvents:CCControlEventTouchUpInside];
+        button.position                 = ccp(100, y);
+        
+        CCControlSwitch *switchControl  = pools ? [CCControlSwitch dequeueReusableControlWithIdentifier:kPoolBenchmarkSwitchIdentifier] : nil;
+        
+        if (!switchControl)
+        {
+            switchControl               = [CCControlSwitch switchWithMaskSprite:[CCSprite spriteWithFile:@"switch-mask.png"]
+                                                                       onSprite:[CCSprite spriteWithFile:@"switch-on.png"]
+                                                                      offSprite:[CCSprite spriteWithFile:@"switch-off.png"]
+                                                                    thumbSprite:[CCSprite spriteWithFile:@"switch-thumb.png"]];
+            switchControl.reuseIdentifier = pools ? kPoolBenchmarkSwitchIdentifier : nil;
+        }
+        switchControl.on                = (i % 2 == 0);
+        [switchControl addTarget:self action:@selector(valueChanged:) forControlEvents:CCControlEventValueChanged];
+        switchControl.position          = ccp(250, y);
+        
+        CCControlStepper *stepper       = pools ? [CCControlStepper dequeueReusableControlWithIdentifier:kPoolBenchmarkStepperIdentifier] : nil;
+        
+        if (!stepper)
+        {
+            stepper                     = [CCControlStepper stepperWithMinusSprite:[CCSprite spriteWithFile:@"stepper-minus.png"]
+                                                                        plusSprite:[CCSprite spriteWithFile:@"stepper-plus.png"]];
+            stepper.reuseIdentifier     = pools ? kPoolBenchmarkStepperIdentifier : nil;
+        }
+        stepper.value                   = i;
+        [stepper addTarget:self action:@selector(valueChanged:) forControlEvents:CCControlEventValueChanged];
+        stepper.position                = ccp(400, y);
+        
+        [screen addChild:button];
+        [screen addChild:switchControl];
+        [screen addChild:stepper];
+    }
+    
+    return screen;
+}
+
+- (double)millisecondsPerTransitionUsingPool:(BOOL)pools
+{
+    double time = [self millisecondsForIterations:kPoolBenchmarkTransitions block:^(NSUInteger transition) {
+        @autoreleasepool
+        {
+            // The screen is shown and then replaced by the next one
+            CCNode *screen              = [self screenUsingPool:pools];
+            [self addChild:screen];
+            [self removeChild:screen cleanup:YES];
+        }
+    }];
+    
+    return time / kPoolBenchmarkTransitions;
+}
+
+- (void)valueChanged:(CCControl *)sender
+{
+}
+
+@end
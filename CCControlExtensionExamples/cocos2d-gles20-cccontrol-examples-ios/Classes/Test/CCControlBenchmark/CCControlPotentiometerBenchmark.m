@@ -0,0 +1,113 @@
+/*
+ * CCControlPotentiometerBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlPotentiometerBenchmark.h"
+#import "CCControlProgressTimer.h"
+
+/** Number of value changes per potentiometer. */
+#define kPotentiometerBenchmarkChanges  10000
+/** Value step of a drag sample. */
+#define kPotentiometerBenchmarkStep     0.0037f
+
+@interface CCControlPotentiometerBenchmark ()
+
+/**
+ * Drags the potentiometer back and forth over its whole range and returns
+ * the time spent in milliseconds. The number of vertex data allocations
+ * is returned by reference.
+ */
+- (double)dragPotentiometerWithProgressTimer:(CCProgressTimer *)progressTimer allocations:(NSUInteger *)allocations;
+
+@end
+
+@implementation CCControlPotentiometerBenchmark
+
+#pragma mark -
+#pragma mark CCControlPotentiometerBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    CCProgressTimer *progressTimer                = [CCProgressTimer progressWithSprite:[CCSprite spriteWithFile:@"potentiometerProgress.png"]];
+    CCControlProgressTimer *controlProgressTimer  = [CCControlProgressTimer progressWithSprite:[CCSprite spriteWithFile:@"potentiometerProgress.png"]];
+    
+    NSUInteger progressTimerAllocations         = 0;
+    NSUInteger controlProgressTimerAllocations  = 0;
+    
+    double progressTimerTime        = [self dragPotentiometerWithProgressTimer:progressTimer
+                                                                   allocations:&progressTimerAllocations];
+    double controlProgressTimerTime = [self dragPotentiometerWithProgressTimer:controlProgressTimer
+                                                                   allocations:&controlProgressTimerAllocations];
+    
+    [self logResult:@"%d value changes", kPotentiometerBenchmarkChanges];
+    [self logResult:@"CCProgressTimer: %.2f ms, %u allocations", progressTimerTime, (unsigned int)progressTimerAllocations];
+    [self logResult:@"CCControlProgressTimer: %.2f ms, %u allocations", controlProgressTimerTime, (unsigned int)controlProgressTimerAllocations];
+}
+
+#pragma mark CCControlPotentiometerBenchmark Private Methods
+
+- (double)dragPotentiometerWithProgressTimer:(CCProgressTimer *)progressTimer allocations:(NSUInteger *)allocations
+{
+    CCControlPotentiometer *potentiometer = [[CCControlPotentiometer alloc] initWithTrackSprite:[CCSprite spriteWithFile:@"potentiometerTrack.png"]
+                                                                                  progressSprite:progressTimer
+                                                                                     thumbSprite:[CCSprite spriteWithFile:@"potentiometerButton.png"]];
+    
+    __block float value                 = 0;
+    __block float step                  = kPotentiometerBenchmarkStep;
+    __block NSUInteger count            = 0;
+    __block ccV2F_C4B_T2F *vertexData   = progressTimer.vertexData;
+    __block int vertexDataCount         = progressTimer.vertexDataCount;
+    
+    // CCProgressTimer frees and allocates its vertex data each time the
+    // number of vertices changes, and malloc may return the same block
+    BOOL reallocatesOnResize            = ![progressTimer isKindOfClass:[CCControlProgressTimer class]];
+    
+    double time = [self millisecondsForIterations:kPotentiometerBenchmarkChanges block:^(NSUInteger i) {
+        value += step;
+        if (value > 1.0f || value < 0.0f)
+        {
+            step  = -step;
+            value += 2 * step;
+        }
+        
+        potentiometer.value = value;
+        
+        if (progressTimer.vertexData != vertexData
+            || (reallocatesOnResize && progressTimer.vertexDataCount != vertexDataCount))
+        {
+            count++;
+        }
+        vertexData      = progressTimer.vertexData;
+        vertexDataCount = progressTimer.vertexDataCount;
+    }];
+    
+    [potentiometer release];
+    
+    *allocations = count;
+    
+    return time;
+}
+
+@end
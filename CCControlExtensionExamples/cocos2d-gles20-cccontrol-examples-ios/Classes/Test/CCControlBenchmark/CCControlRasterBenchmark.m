@@ -0,0 +1,154 @@
+/*
+ * CCControlRasterBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlRasterBenchmark.h"
+
+/** Number of rows of the settings screen, each having a button, a stepper and a switch. */
+#define kRasterBenchmarkRows        20
+/** Number of drawn frames. */
+#define kRasterBenchmarkFrames      60
+
+@interface CCControlRasterBenchmark ()
+
+/**
+ * Returns a settings screen whose controls rasterize themselves or not when
+ * they are idle.
+ */
+- (CCNode *)screenRasterizingWhenIdle:(BOOL)rasterizesWhenIdle;
+
+/**
+ * Returns the time spent to draw the node and to wait for the GPU, in
+ * milliseconds per frame. The number of draw calls per frame is returned in
+ * drawCalls. If toggles is YES, the highlight of a button is toggled before
+ * each frame.
+ */
+- (double)millisecondsPerFrameToDrawNode:(CCNode *)node togglingButtons:(BOOL)toggles drawCalls:(NSUInteger *)drawCalls;
+
+@end
+
+@implementation CCControlRasterBenchmark
+
+#pragma mark -
+#pragma mark CCControlRasterBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    CCControlRasterCache *cache = [CCControlRasterCache sharedRasterCache];
+    NSUInteger drawCalls        = 0;
+    
+    [self logResult:@"%d buttons, steppers and switches, %d frames", kRasterBenchmarkRows, kRasterBenchmarkFrames];
+    
+    double nodeTime             = [self millisecondsPerFrameToDrawNode:[self screenRasterizingWhenIdle:NO] togglingButtons:NO drawCalls:&drawCalls];
+    [self logResult:@"Node by node: %.3f ms/frame, %lu draw calls", nodeTime, (unsigned long)drawCalls];
+    
+    CCNode *screen              = [self screenRasterizingWhenIdle:YES];
+    [cache resetCounters];
+    
+    double idleTime             = [self millisecondsPerFrameToDrawNode:screen togglingButtons:NO drawCalls:&drawCalls];
+    [self logResult:@"Rasterized: %.3f ms/frame, %lu draw calls, %lu hits, %lu misses",
+     idleTime, (unsigned long)drawCalls, (unsigned long)cache.numberOfHits, (unsigned long)cache.numberOfMisses];
+    
+    [cache resetCounters];
+    
+    double toggleTime           = [self millisecondsPerFrameToDrawNode:screen togglingButtons:YES drawCalls:&drawCalls];
+    [self logResult:@"Rasterized, one change per frame: %.3f ms/frame, %lu draw calls, %lu hits, %lu misses",
+     toggleTime, (unsigned long)drawCalls, (unsigned long)cache.numberOfHits, (unsigned long)cache.numberOfMisses];
+    
+    // Give the render textures back to the pool
+    for (CCControl *control in [screen children])
+    {
+        control.rasterizesWhenIdle  = NO;
+    }
+    
+    [self logResult:@"%lu render textures in the pool", (unsigned long)cache.numberOfFreeRenderTextures];
+    [cache purge];
+}
+
+#pragma mark CCControlRasterBenchmark Private Methods
+
+- (CCNode *)screenRasterizingWhenIdle:(BOOL)rasterizesWhenIdle
+{
+    CCNode *screen                  = [CCNode node];
+    
+    for (NSUInteger i = 0; i < kRasterBenchmarkRows; i++)
+    {
+        CGFloat y                   = 20 + i * 40;
+        
+        CCLabelTTF *label           = [CCLabelTTF labelWithString:[NSString stringWithFormat:@"Setting %lu", (unsigned long)i]
+                                                         fontName:@"HelveticaNeue-Bold"
+                                                         fontSize:20];
+        CCControlButton *button     = [CCControlButton buttonWithLabel:label backgroundSprite:[CCScale9Sprite spriteWithFile:@"button.png"]];
+        [button setBackgroundSprite:[CCScale9Sprite spriteWithFile:@"buttonHighlighted.png"] forState:CCControlStateHighlighted];
+        button.position             = ccp(100, y);
+        
+        CCControlStepper *stepper   = [CCControlStepper stepperWithMinusSprite:[CCSprite spriteWithFile:@"stepper-minus.png"]
+                                                                    plusSprite:[CCSprite spriteWithFile:@"stepper-plus.png"]];
+        stepper.position            = ccp(260, y);
+        
+        CCControlSwitch *switchControl = [CCControlSwitch switchWithMaskSprite:[CCSprite spriteWithFile:@"switch-mask.png"]
+                                                                      onSprite:[CCSprite spriteWithFile:@"switch-on.png"]
+                                                                     offSprite:[CCSprite spriteWithFile:@"switch-off.png"]
+                                                                   thumbSprite:[CCSprite spriteWithFile:@"switch-thumb.png"]
+                                                                       onLabel:[CCLabelTTF labelWithString:@"On" fontName:@"Arial-BoldMT" fontSize:16]
+                                                                      offLabel:[CCLabelTTF labelWithString:@"Off" fontName:@"Arial-BoldMT" fontSize:16]];
+        switchControl.position      = ccp(400, y);
+        switchControl.on            = (i % 2 == 0);
+        
+        button.rasterizesWhenIdle         = rasterizesWhenIdle;
+        stepper.rasterizesWhenIdle        = rasterizesWhenIdle;
+        switchControl.rasterizesWhenIdle  = rasterizesWhenIdle;
+        
+        [screen addChild:button];
+        [screen addChild:stepper];
+        [screen addChild:switchControl];
+    }
+    
+    return screen;
+}
+
+- (double)millisecondsPerFrameToDrawNode:(CCNode *)node togglingButtons:(BOOL)toggles drawCalls:(NSUInteger *)drawCalls
+{
+    CCArray *controls               = [node children];
+    NSUInteger drawCallsBefore      = __ccNumberOfDraws;
+    
+    double time = [self millisecondsForIterations:kRasterBenchmarkFrames block:^(NSUInteger frame) {
+        if (toggles)
+        {
+            // The buttons are the first control of each row
+            CCControlButton *button = [controls objectAtIndex:(frame % kRasterBenchmarkRows) * 3];
+            button.highlighted      = !button.highlighted;
+        }
+        
+        [node visit];
+        glFinish();
+    }];
+    
+    *drawCalls                      = (__ccNumberOfDraws - drawCallsBefore) / kRasterBenchmarkFrames;
+    
+    return time / kRasterBenchmarkFrames;
+}
+
+@end
@@ -0,0 +1,133 @@
+/*
+ * CCControlSceneTransitionBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlSceneTransitionBenchmark.h"
+
+#import <QuartzCore/QuartzCore.h>
+#import "CCControlSceneManager.h"
+
+/** Number of builds of each scene. */
+#define kSceneTransitionBenchmarkRuns   5
+
+@interface CCControlSceneTransitionBenchmark ()
+
+/** Returns the class names of the test scenes. */
+- (NSArray *)testSceneNames;
+
+/**
+ * Builds each of the given scenes and returns the time spent in
+ * milliseconds per scene.
+ *
+ * @param removesTextures Tells whether the unused textures are removed from
+ * the cache before each build, so that the scene loads its files.
+ */
+- (double)millisecondsPerSceneBuildingScenes:(NSArray *)names removingTextures:(BOOL)removesTextures;
+
+@end
+
+@implementation CCControlSceneTransitionBenchmark
+
+#pragma mark -
+#pragma mark CCControlSceneTransitionBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    NSArray *names                  = [self testSceneNames];
+    CCControlSceneManager *manager  = [CCControlSceneManager sharedControlSceneManager];
+    
+    [self logResult:@"%lu test scenes, %d builds each", (unsigned long)[names count], kSceneTransitionBenchmarkRuns];
+    
+    double loadingTime              = [self millisecondsPerSceneBuildingScenes:names removingTextures:YES];
+    [self logResult:@"Loading the files: %.3f ms/scene", loadingTime];
+    
+    // The files are loaded in the background, then the scenes are built again
+    [[CCTextureCache sharedTextureCache] removeUnusedTextures];
+    
+    __block NSUInteger remainingScenes  = [names count];
+    CFTimeInterval preloadStart         = CACurrentMediaTime();
+    
+    for (NSString *name in names)
+    {
+        [manager preloadControlSceneNamed:name withBlock:^
+         {
+             if (--remainingScenes > 0)
+             {
+                 return;
+             }
+             
+             [self logResult:@"Preloading: %.3f ms in the background", (CACurrentMediaTime() - preloadStart) * 1000.0];
+             
+             double preloadedTime   = [self millisecondsPerSceneBuildingScenes:names removingTextures:NO];
+             [self logResult:@"Preloaded files: %.3f ms/scene", preloadedTime];
+         }];
+    }
+}
+
+#pragma mark CCControlSceneTransitionBenchmark Private Methods
+
+- (NSArray *)testSceneNames
+{
+    return [NSArray arrayWithObjects:
+            @"CCControlSliderTest",
+            @"CCControlColourPickerTest",
+            @"CCControlSwitchTest",
+            @"CCControlStepperTest",
+            @"CCControlButtonTest_Event",
+            @"CCControlButtonTest_HelloVariableSize",
+            @"CCControlButtonTest_Styling",
+            @"CCControlPotentiometerTest",
+            @"CCControlPickerTest",
+            nil];
+}
+
+- (double)millisecondsPerSceneBuildingScenes:(NSArray *)names removingTextures:(BOOL)removesTextures
+{
+    CCTextureCache *cache   = [CCTextureCache sharedTextureCache];
+    double time             = 0;
+    
+    for (NSUInteger run = 0; run < kSceneTransitionBenchmarkRuns; run++)
+    {
+        for (NSString *name in names)
+        {
+            if (removesTextures)
+            {
+                [cache removeUnusedTextures];
+            }
+            
+            // The scene is released before the next one is built
+            @autoreleasepool
+            {
+                time += [self millisecondsForIterations:1 block:^(NSUInteger iteration) {
+                    [NSClassFromString(name) sceneWithTitle:name];
+                }];
+            }
+        }
+    }
+    
+    return time / (kSceneTransitionBenchmarkRuns * [names count]);
+}
+
+@end
@@ -0,0 +1,46 @@
+/*
+ * CCControlStressBenchmark.h
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlBenchmarkScene.h"
+#import "CCControlPicker.h"
+
+/**
+ * Spawns 1, 100, 1000 and 5000 instances of each control type, drives them
+ * with synthetic drags and with animations, and records the frame time, the
+ * node count, the draw calls and the memory for each count.
+ *
+ * The results are appended to <documents>/CCControlStressBenchmark.csv, one
+ * row per control type and count, so that they can be compared across
+ * releases.
+ */
+@interface CCControlStressBenchmark : CCControlBenchmarkScene <CCControlPickerDataSource>
+
+#pragma mark Public Methods
+
+/** Returns the path of the file the results are written to. */
++ (NSString *)resultsPath;
+
+@end
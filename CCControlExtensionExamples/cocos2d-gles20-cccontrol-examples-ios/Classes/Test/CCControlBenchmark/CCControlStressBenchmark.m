@@ -0,0 +1,340 @@
+/*
+ * CCControlStressBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlStressBenchmark.h"
+#import "CCControlTouchReplay.h"
+
+#import <QuartzCore/QuartzCore.h>
+#import <mach/mach.h>
+
+/** Number of drawn frames for each count. */
+#define kStressBenchmarkFrames      30
+/** Maximum number of controls dragged for each count. */
+#define kStressBenchmarkDrags       60
+/** Number of samples of a drag. */
+#define kStressBenchmarkDragSamples 6
+/** Number of rows of the pickers. */
+#define kStressBenchmarkPickerRows  5
+
+/** Columns of the CSV file. */
+#define kStressBenchmarkCSVHeader   @"version,control,instances,nodes,build_ms,drag_ms,frame_ms,draw_calls,memory_kb"
+
+/** The stressed control types. */
+typedef enum
+{
+    CCControlStressTypeButton,
+    CCControlStressTypeSlider,
+    CCControlStressTypeSwitch,
+    CCControlStressTypeStepper,
+    CCControlStressTypePotentiometer,
+    CCControlStressTypeColourPicker,
+    CCControlStressTypePicker,
+    CCControlStressTypeCount
+} CCControlStressType;
+
+/** Names of the control types, as written in the CSV file. */
+static NSString * const kStressBenchmarkTypeNames[CCControlStressTypeCount] =
+{
+    @"button", @"slider", @"switch", @"stepper", @"potentiometer", @"colourpicker", @"picker"
+};
+
+/** The numbers of instances. */
+static const NSUInteger kStressBenchmarkCounts[] = { 1, 100, 1000, 5000 };
+
+@interface CCControlStressBenchmark ()
+
+/** Returns a new control of the given type. */
+- (CCControl *)controlOfType:(CCControlStressType)type;
+
+/**
+ * Returns a node holding the given number of controls of the given type,
+ * laid out in a grid filling the screen, each one running an animation.
+ */
+- (CCNode *)gridOfControlsOfType:(CCControlStressType)type count:(NSUInteger)count;
+
+/**
+ * Returns a trace dragging through up to kStressBenchmarkDrags controls of
+ * the grid, from a quarter to three quarters of their width.
+ */
+- (CCControlTouchTrace *)dragTraceThroughGrid:(CCNode *)grid;
+
+/** Returns the number of nodes of the tree of the given node. */
+- (NSUInteger)numberOfNodesInNode:(CCNode *)node;
+
+/** Returns the resident memory of the application, in kilobytes. */
+- (long)residentKilobytes;
+
+/**
+ * Measures the given number of controls of the given type and returns the
+ * row of the CSV file.
+ */
+- (NSString *)stressControlsOfType:(CCControlStressType)type count:(NSUInteger)count;
+
+@end
+
+@implementation CCControlStressBenchmark
+
+#pragma mark -
+#pragma mark CCControlStressBenchmark Public Methods
+
++ (NSString *)resultsPath
+{
+    NSString *documents = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+    
+    return [documents stringByAppendingPathComponent:@"CCControlStressBenchmark.csv"];
+}
+
+- (void)runBenchmark
+{
+    NSString *path          = [[self class] resultsPath];
+    NSMutableString *rows   = [NSMutableString string];
+    
+    if (![[NSFileManager defaultManager] fileExistsAtPath:path])
+    {
+        [rows appendFormat:@"%@\n", kStressBenchmarkCSVHeader];
+    }
+    
+    [self logResult:@"%@", kStressBenchmarkCSVHeader];
+    
+    for (NSUInteger type = 0; type < CCControlStressTypeCount; type++)
+    {
+        for (NSUInteger i = 0; i < sizeof(kStressBenchmarkCounts) / sizeof(kStressBenchmarkCounts[0]); i++)
+        {
+            NSString *row   = [self stressControlsOfType:type count:kStressBenchmarkCounts[i]];
+            
+            [rows appendFormat:@"%@\n", row];
+            [self logResult:@"%@", row];
+        }
+    }
+    
+    // The rows are appended so that the file keeps the history of the runs
+    NSFileHandle *file      = [NSFileHandle fileHandleForWritingAtPath:path];
+    
+    if (file)
+    {
+        [file seekToEndOfFile];
+        [file writeData:[rows dataUsingEncoding:NSUTF8StringEncoding]];
+        [file closeFile];
+    }
+    else
+    {
+        [rows writeToFile:path atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+    }
+    
+    [self logResult:@"Written to %@", path];
+}
+
+#pragma mark CCControlStressBenchmark Private Methods
+
+- (CCControl *)controlOfType:(CCControlStressType)type
+{
+    switch (type)
+    {
+        case CCControlStressTypeButton:
+        {
+            CCControlButton *button = [CCControlButton buttonWithTitle:@"Button" fontName:@"HelveticaNeue-Bold" fontSize:20];
+            [button setBackgroundSprite:[CCScale9Sprite spriteWithFile:@"button.png"] forState:CCControlStateNormal];
+            [button setBackgroundSprite:[CCScale9Sprite spriteWithFile:@"buttonHighlighted.png"] forState:CCControlStateHighlighted];
+            
+            return button;
+        }
+        case CCControlStressTypeSlider:
+            return [CCControlSlider sliderWithBackgroundFile:@"sliderTrack.png" progressFile:@"sliderProgress.png" thumbFile:@"sliderThumb.png"];
+        case CCControlStressTypeSwitch:
+            return [CCControlSwitch switchWithMaskFile:@"switch-mask.png" onFile:@"switch-on.png" offFile:@"switch-off.png" thumbFile:@"switch-thumb.png"];
+        case CCControlStressTypeStepper:
+            return [CCControlStepper stepperWithMinusFile:@"stepper-minus.png" plusFile:@"stepper-plus.png"];
+        case CCControlStressTypePotentiometer:
+            return [CCControlPotentiometer potentiometerWithTrackFile:@"potentiometerTrack.png"
+                                                         progressFile:@"potentiometerProgress.png"
+                                                            thumbFile:@"potentiometerButton.png"];
+        case CCControlStressTypeColourPicker:
+            return [CCControlColourPicker colourPickerWithHueFile:@"hueBackground.png"
+                                               tintBackgroundFile:@"tintBackground.png"
+                                                  tintOverlayFile:@"tintOverlay.png"
+                                                       pickerFile:@"picker.png"
+                                                        arrowFile:@"arrow.png"];
+        default:
+        {
+            CCControlPicker *picker = [CCControlPicker pickerWithForegroundFile:@"pickerBackground.png" selectionFile:@"pickerSelection.png"];
+            picker.dataSource       = self;
+            [picker reloadComponent];
+            
+            return picker;
+        }
+    }
+}
+
+- (CCNode *)gridOfControlsOfType:(CCControlStressType)type count:(NSUInteger)count
+{
+    CGSize screenSize           = [[CCDirector sharedDirector] winSize];
+    NSUInteger columns          = (NSUInteger)ceilf(sqrtf(count * screenSize.width / screenSize.height));
+    NSUInteger rows             = (count + columns - 1) / columns;
+    CGSize cellSize             = CGSizeMake(screenSize.width / columns, screenSize.height / rows);
+    
+    CCNode *grid                = [CCNode node];
+    
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        CCControl *control      = [self controlOfType:type];
+        CGSize size             = control.contentSize;
+        float scale             = MIN(1.0f, MIN(cellSize.width / size.width, cellSize.height / size.height));
+        
+        control.scale           = scale;
+        control.position        = ccp(((i % columns) + 0.5f) * cellSize.width, ((i / columns) + 0.5f) * cellSize.height);
+        [grid addChild:control];
+        
+        // A slight pulse keeps the action manager and the transforms busy
+        CCActionInterval *pulse = [CCSequence actions:
+                                   [CCScaleTo actionWithDuration:0.5f scale:scale * 0.9f],
+                                   [CCScaleTo actionWithDuration:0.5f scale:scale],
+                                   nil];
+        [control runAction:[CCRepeatForever actionWithAction:pulse]];
+    }
+    
+    return grid;
+}
+
+- (CCControlTouchTrace *)dragTraceThroughGrid:(CCNode *)grid
+{
+    CCArray *controls           = [grid children];
+    NSUInteger count            = [controls count];
+    NSUInteger drags            = MIN(count, kStressBenchmarkDrags);
+    CCControlTouchTrace *trace  = [CCControlTouchTrace trace];
+    
+    for (NSUInteger i = 0; i < drags; i++)
+    {
+        // The dragged controls are spread over the grid
+        CCControl *control      = [controls objectAtIndex:(i * count) / drags];
+        CGSize size             = control.contentSize;
+        CGPoint locations[kStressBenchmarkDragSamples];
+        
+        for (NSUInteger j = 0; j < kStressBenchmarkDragSamples; j++)
+        {
+            float x             = size.width * (0.25f + 0.5f * j / (kStressBenchmarkDragSamples - 1));
+            locations[j]        = [control convertToWorldSpace:ccp(x, size.height / 2)];
+        }
+        
+        [trace appendTrace:[CCControlTouchTrace dragTraceWithWorldLocations:locations count:kStressBenchmarkDragSamples]];
+    }
+    
+    return trace;
+}
+
+- (NSUInteger)numberOfNodesInNode:(CCNode *)node
+{
+    NSUInteger count = 1;
+    
+    for (CCNode *child in [node children])
+    {
+        count += [self numberOfNodesInNode:child];
+    }
+    
+    return count;
+}
+
+- (long)residentKilobytes
+{
+    struct task_basic_info info;
+    mach_msg_type_number_t size = TASK_BASIC_INFO_COUNT;
+    
+    if (task_info(mach_task_self(), TASK_BASIC_INFO, (task_info_t)&info, &size) != KERN_SUCCESS)
+    {
+        return 0;
+    }
+    
+    return (long)(info.resident_size / 1024);
+}
+
+- (NSString *)stressControlsOfType:(CCControlStressType)type count:(NSUInteger)count
+{
+    NSString *row;
+    
+    @autoreleasepool
+    {
+        CCScheduler *scheduler      = [CCDirector sharedDirector].scheduler;
+        long memoryBefore           = [self residentKilobytes];
+        __block CCNode *grid        = nil;
+        
+        // The controls are added to the running scene, so that they register their touches and run their actions
+        double buildTime = [self millisecondsForIterations:1 block:^(NSUInteger iteration) {
+            grid                    = [self gridOfControlsOfType:type count:count];
+            [self addChild:grid];
+        }];
+        
+        long memory                 = [self residentKilobytes] - memoryBefore;
+        NSUInteger nodes            = [self numberOfNodesInNode:grid];
+        
+        // Synthetic input
+        CCControlTouchTrace *trace  = [self dragTraceThroughGrid:grid];
+        ccControlTouchReplayResult result = [[CCControlTouchReplay replayWithNode:grid] replayTrace:trace];
+        NSUInteger drags            = MIN(count, kStressBenchmarkDrags);
+        
+        // Animated frames
+        NSUInteger drawCallsBefore  = __ccNumberOfDraws;
+        
+        double frameTime = [self millisecondsForIterations:kStressBenchmarkFrames block:^(NSUInteger frame) {
+            [scheduler update:1.0f / 60.0f];
+            [grid visit];
+            glFinish();
+        }];
+        
+        NSUInteger drawCalls        = (__ccNumberOfDraws - drawCallsBefore) / kStressBenchmarkFrames;
+        
+        [self removeChild:grid cleanup:YES];
+        
+        NSString *version           = [[[NSBundle mainBundle] infoDictionary] objectForKey:@"CFBundleVersion"];
+        
+        row = [[NSString alloc] initWithFormat:@"%@,%@,%lu,%lu,%.3f,%.3f,%.3f,%lu,%ld",
+               version, kStressBenchmarkTypeNames[type], (unsigned long)count, (unsigned long)nodes,
+               buildTime, result.seconds * 1000.0 / drags, frameTime / kStressBenchmarkFrames,
+               (unsigned long)drawCalls, memory];
+    }
+    
+    return [row autorelease];
+}
+
+#pragma mark - CCControlPicker DataSource Methods
+
+- (NSUInteger)numberOfRowsInControlPicker:(CCControlPicker *)controlPicker
+{
+    return kStressBenchmarkPickerRows;
+}
+
+- (CCControlPickerRow *)controlPicker:(CCControlPicker *)controlPicker nodeForRow:(NSUInteger)row
+{
+    CCControlPickerRow *rowNode     = [controlPicker dequeueReusableRow];
+    
+    if (!rowNode)
+    {
+        rowNode                     = [CCControlPickerRow node];
+    }
+    rowNode.textLabel.string        = [NSString stringWithFormat:@"%lu", (unsigned long)row];
+    
+    return rowNode;
+}
+
+@end
@@ -0,0 +1,105 @@
+/*
+ * CCControlSwitchBatchBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlSwitchBatchBenchmark.h"
+
+/** Number of switches of the settings screen. */
+#define kSwitchBatchBenchmarkSwitches   100
+/** Number of drawn frames. */
+#define kSwitchBatchBenchmarkFrames     60
+
+@interface CCControlSwitchBatchBenchmark ()
+
+/** Adds the switches to the given node in a grid. */
+- (void)addSwitchesWithSkin:(CCControlSwitchSkin *)skin toNode:(CCNode *)node;
+
+/**
+ * Returns the time spent to draw the node and to wait for the GPU, in
+ * milliseconds per frame. The number of draw calls per frame is returned in
+ * drawCalls.
+ */
+- (double)millisecondsPerFrameToDrawNode:(CCNode *)node drawCalls:(NSUInteger *)drawCalls;
+
+@end
+
+@implementation CCControlSwitchBatchBenchmark
+
+#pragma mark -
+#pragma mark CCControlSwitchBatchBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    CCControlSwitchSkin *skin           = [CCControlSwitchSkin skinWithMaskSprite:[CCSprite spriteWithFile:@"switch-mask.png"]
+                                                                         onSprite:[CCSprite spriteWithFile:@"switch-on.png"]
+                                                                        offSprite:[CCSprite spriteWithFile:@"switch-off.png"]
+                                                                      thumbSprite:[CCSprite spriteWithFile:@"switch-thumb.png"]
+                                                                          onLabel:[CCLabelTTF labelWithString:@"On" fontName:@"Arial-BoldMT" fontSize:16]
+                                                                         offLabel:[CCLabelTTF labelWithString:@"Off" fontName:@"Arial-BoldMT" fontSize:16]];
+    
+    CCNode *node                        = [CCNode node];
+    [self addSwitchesWithSkin:skin toNode:node];
+    
+    CCControlSwitchBatchNode *batchNode = [CCControlSwitchBatchNode batchNodeWithSkin:skin];
+    [self addSwitchesWithSkin:skin toNode:batchNode];
+    
+    NSUInteger nodeDrawCalls            = 0;
+    NSUInteger batchDrawCalls           = 0;
+    double nodeTime                     = [self millisecondsPerFrameToDrawNode:node drawCalls:&nodeDrawCalls];
+    double batchTime                    = [self millisecondsPerFrameToDrawNode:batchNode drawCalls:&batchDrawCalls];
+    
+    [self logResult:@"%d switches, %d frames", kSwitchBatchBenchmarkSwitches, kSwitchBatchBenchmarkFrames];
+    [self logResult:@"One by one: %.3f ms/frame, %lu draw calls", nodeTime, (unsigned long)nodeDrawCalls];
+    [self logResult:@"Batched: %.3f ms/frame, %lu draw calls", batchTime, (unsigned long)batchDrawCalls];
+}
+
+#pragma mark CCControlSwitchBatchBenchmark Private Methods
+
+- (void)addSwitchesWithSkin:(CCControlSwitchSkin *)skin toNode:(CCNode *)node
+{
+    for (NSUInteger i = 0; i < kSwitchBatchBenchmarkSwitches; i++)
+    {
+        CCControlSwitch *switchControl  = [CCControlSwitch switchWithSkin:skin];
+        switchControl.position          = ccp(50 + (i % 10) * 90, 50 + (i / 10) * 40);
+        switchControl.on                = (i % 2 == 0);
+        [node addChild:switchControl];
+    }
+}
+
+- (double)millisecondsPerFrameToDrawNode:(CCNode *)node drawCalls:(NSUInteger *)drawCalls
+{
+    NSUInteger drawCallsBefore          = __ccNumberOfDraws;
+    
+    double time = [self millisecondsForIterations:kSwitchBatchBenchmarkFrames block:^(NSUInteger frame) {
+        [node visit];
+        glFinish();
+    }];
+    
+    *drawCalls                          = (__ccNumberOfDraws - drawCallsBefore) / kSwitchBatchBenchmarkFrames;
+    
+    return time / kSwitchBatchBenchmarkFrames;
+}
+
+@end
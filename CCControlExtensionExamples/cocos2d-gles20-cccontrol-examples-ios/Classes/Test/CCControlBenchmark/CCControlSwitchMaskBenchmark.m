@@ -0,0 +1,86 @@
+/*
+ * CCControlSwitchMaskBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlSwitchMaskBenchmark.h"
+
+/** Number of switches of the settings screen. */
+#define kSwitchMaskBenchmarkSwitches    50
+
+@interface CCControlSwitchMaskBenchmark ()
+
+/**
+ * Creates and releases a switch. A flipped mask cannot be sampled as is, so
+ * it forces the mask to be baked.
+ */
+- (void)createSwitchWithFlippedMask:(BOOL)flipped;
+
+@end
+
+@implementation CCControlSwitchMaskBenchmark
+
+#pragma mark -
+#pragma mark CCControlSwitchMaskBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    // Load the images first to only measure the masks
+    [self createSwitchWithFlippedMask:NO];
+    
+    double bakedTime = [self millisecondsForIterations:kSwitchMaskBenchmarkSwitches block:^(NSUInteger i) {
+        [CCControlSwitch purgeMaskCache];
+        [self createSwitchWithFlippedMask:YES];
+    }];
+    
+    [CCControlSwitch purgeMaskCache];
+    double sharedTime = [self millisecondsForIterations:kSwitchMaskBenchmarkSwitches block:^(NSUInteger i) {
+        [self createSwitchWithFlippedMask:YES];
+    }];
+    
+    double imageTime = [self millisecondsForIterations:kSwitchMaskBenchmarkSwitches block:^(NSUInteger i) {
+        [self createSwitchWithFlippedMask:NO];
+    }];
+    
+    [self logResult:@"%d switches", kSwitchMaskBenchmarkSwitches];
+    [self logResult:@"One mask per switch: %.2f ms", bakedTime];
+    [self logResult:@"Shared baked mask: %.2f ms", sharedTime];
+    [self logResult:@"Mask image used as is: %.2f ms", imageTime];
+}
+
+#pragma mark CCControlSwitchMaskBenchmark Private Methods
+
+- (void)createSwitchWithFlippedMask:(BOOL)flipped
+{
+    CCSprite *maskSprite        = [CCSprite spriteWithFile:@"switch-mask.png"];
+    maskSprite.flipX            = flipped;
+    
+    CCControlSwitch *switchControl = [[CCControlSwitch alloc] initWithMaskSprite:maskSprite
+                                                                        onSprite:[CCSprite spriteWithFile:@"switch-on.png"]
+                                                                       offSprite:[CCSprite spriteWithFile:@"switch-off.png"]
+                                                                     thumbSprite:[CCSprite spriteWithFile:@"switch-thumb.png"]];
+    [switchControl release];
+}
+
+@end
@@ -0,0 +1,102 @@
+/*
+ * CCControlTouchReplay.h
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "cocos2d.h"
+#import "CCControlExtension.h"
+#import "CCControlTouchTrace.h"
+
+/** Measures of a replayed trace. */
+typedef struct _ccControlTouchReplayResult
+{
+    /** Number of samples fed into the controls. */
+    NSUInteger  numberOfEvents;
+    /** Time spent to feed the samples, in seconds. */
+    double      seconds;
+    /** Number of samples fed per second. */
+    double      eventsPerSecond;
+    /** Number of CCControlEventValueChanged events sent by the controls. */
+    NSUInteger  numberOfValueChangedEvents;
+    /** Number of layout passes run by the controls. */
+    NSUInteger  numberOfLayoutPasses;
+    /**
+     * Number of calls to malloc, calloc, realloc (and the like) made during
+     * the replay, and the number of bytes they requested. Every allocation
+     * is counted, including the blocks freed before the end of the replay.
+     */
+    NSUInteger  numberOfAllocations;
+    NSUInteger  allocatedBytes;
+    /**
+     * Growth of the number of live memory blocks, and of their size in bytes,
+     * between the start and the end of the replay, before the autorelease
+     * pool is drained. It is negative when the replay freed more blocks than
+     * it allocated.
+     */
+    NSInteger   liveBlocksGrowth;
+    NSInteger   liveBytesGrowth;
+} ccControlTouchReplayResult;
+
+/**
+ * Feeds a touch trace into the controls of a node at full speed, without
+ * waiting for the frames nor going through the touch (or event) dispatcher.
+ *
+ * Like the targeted touch dispatcher, each touch is offered to the controls
+ * of the node, in the order of their touch priority, and the moves and the
+ * end of the touch are fed to the control which has claimed it. On iOS the
+ * touches of the trace are replayed as distinct UITouch, so that several
+ * fingers can be down at once; on Mac OS X they all drive the mouse. The
+ * value changed events are flushed after each sample, as if each sample
+ * was dispatched in its own frame.
+ *
+ * The layout passes are counted during a second replay of the trace, by
+ * hooking the layout methods of the controls, so that the hooks do not
+ * weigh on the measured time.
+ */
+@interface CCControlTouchReplay : NSObject
+{
+@protected
+    CCNode          *node;
+    NSMutableArray  *targets;
+}
+/** The node, or the control, into whose controls the traces are replayed. */
+@property (nonatomic, readonly) CCNode *node;
+
+#pragma mark Constructors - Initializers
+
+/**
+ * Initializes a replay driver feeding the given node and its descendant
+ * controls. The node can be a whole test scene.
+ */
+- (id)initWithNode:(CCNode *)node;
+
+/** Creates a replay driver feeding the given node and its descendant controls. */
++ (id)replayWithNode:(CCNode *)node;
+
+#pragma mark Public Methods
+
+/** Replays the trace into the control and returns the measures. */
+- (ccControlTouchReplayResult)replayTrace:(CCControlTouchTrace *)trace;
+
+@end
@@ -0,0 +1,589 @@
+/*
+ * CCControlTouchReplay.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlTouchReplay.h"
+
+#import <QuartzCore/QuartzCore.h>
+#import <malloc/malloc.h>
+#import <objc/runtime.h>
+
+#pragma mark Replayed Events
+
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+
+/** Maximum number of touches in progress at the same time, as on the iPad. */
+#define kCCControlReplayMaxTouches  11
+
+/** A touch whose location, timestamp and phase are given by a sample. */
+@interface CCControlReplayTouch : UITouch
+{
+@protected
+    CGPoint         location;
+    CGPoint         previousLocation;
+    NSTimeInterval  sampleTimestamp;
+    UITouchPhase    samplePhase;
+}
+
+/** Moves the touch to the given sample. */
+- (void)setSample:(const ccControlTouchSample *)sample;
+
+@end
+
+@implementation CCControlReplayTouch
+
+- (void)setSample:(const ccControlTouchSample *)sample
+{
+    static const UITouchPhase phases[] = { UITouchPhaseBegan, UITouchPhaseMoved, UITouchPhaseEnded, UITouchPhaseCancelled };
+    
+    previousLocation    = (sample->phase == CCControlTouchPhaseBegan) ? ccp(sample->x, sample->y) : location;
+    location            = ccp(sample->x, sample->y);
+    sampleTimestamp     = sample->timestamp;
+    samplePhase         = phases[sample->phase];
+}
+
+- (CGPoint)locationInView:(UIView *)view
+{
+    return location;
+}
+
+- (CGPoint)previousLocationInView:(UIView *)view
+{
+    return previousLocation;
+}
+
+- (UIView *)view
+{
+    return [[CCDirector sharedDirector] view];
+}
+
+- (UIWindow *)window
+{
+    return [[[CCDirector sharedDirector] view] window];
+}
+
+- (NSTimeInterval)timestamp
+{
+    return sampleTimestamp;
+}
+
+- (UITouchPhase)phase
+{
+    return samplePhase;
+}
+
+- (NSUInteger)tapCount
+{
+    return 1;
+}
+
+@end
+
+#elif __MAC_OS_X_VERSION_MAX_ALLOWED
+
+/**
+ * Stands for the mouse events given by a sample. The controls and the
+ * director only read the location and the timestamp of the events.
+ */
+@interface CCControlReplayEvent : NSObject
+{
+@protected
+    NSPoint         location;
+    NSTimeInterval  sampleTimestamp;
+    NSEventType     sampleType;
+}
+
+/** Moves the event to the given sample. */
+- (void)setSample:(const ccControlTouchSample *)sample;
+
+@end
+
+@implementation CCControlReplayEvent
+
+- (void)setSample:(const ccControlTouchSample *)sample
+{
+    static const NSEventType types[] = { NSLeftMouseDown, NSLeftMouseDragged, NSLeftMouseUp, NSLeftMouseUp };
+    
+    location        = NSMakePoint(sample->x, sample->y);
+    sampleTimestamp = sample->timestamp;
+    sampleType      = types[sample->phase];
+}
+
+- (NSPoint)locationInWindow
+{
+    return location;
+}
+
+- (NSTimeInterval)timestamp
+{
+    return sampleTimestamp;
+}
+
+- (NSEventType)type
+{
+    return sampleType;
+}
+
+- (NSUInteger)modifierFlags
+{
+    return 0;
+}
+
+- (NSInteger)clickCount
+{
+    return 1;
+}
+
+- (NSWindow *)window
+{
+    return [[[CCDirector sharedDirector] view] window];
+}
+
+@end
+
+#endif
+
+#pragma mark - Layout Hooks
+
+/** Arguments of the hooked layout methods. */
+typedef enum
+{
+    kCCControlLayoutArgumentNone,
+    kCCControlLayoutArgumentFloat,
+    kCCControlLayoutArgumentPoint,
+} CCControlLayoutArgument;
+
+/** The methods running the layout passes of the controls. */
+static const struct
+{
+    const char              *className;
+    const char              *selectorName;
+    CCControlLayoutArgument argument;
+} ccControlLayoutMethods[] =
+{
+    { "CCControlButton",                        "updateLayout",                     kCCControlLayoutArgumentNone },
+    { "CCControlSlider",                        "layoutWithValue:",                 kCCControlLayoutArgumentFloat },
+    { "CCControlPotentiometer",                 "layoutWithValue:",                 kCCControlLayoutArgumentFloat },
+    { "CCControlPicker",                        "updateVisibleRows",                kCCControlLayoutArgumentNone },
+    { "CCControlStepper",                       "updateLayoutUsingTouchLocation:",  kCCControlLayoutArgumentPoint },
+    { "CCControlSwitchSprite",                  "needsLayout",                      kCCControlLayoutArgumentNone },
+    { "CCControlHuePicker",                     "updatePickerPosition:",            kCCControlLayoutArgumentPoint },
+    { "CCControlSaturationBrightnessPicker",    "updatePickerPosition:",            kCCControlLayoutArgumentPoint },
+};
+
+#define kCCControlLayoutMethodCount (sizeof(ccControlLayoutMethods) / sizeof(ccControlLayoutMethods[0]))
+
+/** Number of layout passes run since the hooks have been installed. */
+static NSUInteger ccControlLayoutPassCount = 0;
+
+/**
+ * Replaces the layout methods by counting trampolines and stores the
+ * original implementations in the given array.
+ */
+static void ccControlInstallLayoutHooks(IMP *originals)
+{
+    ccControlLayoutPassCount = 0;
+    
+    for (NSUInteger i = 0; i < kCCControlLayoutMethodCount; i++)
+    {
+        Class controlClass  = objc_getClass(ccControlLayoutMethods[i].className);
+        SEL selector        = sel_registerName(ccControlLayoutMethods[i].selectorName);
+        Method method       = controlClass ? class_getInstanceMethod(controlClass, selector) : NULL;
+        
+        // Only hook the methods implemented by the class itself
+        if (!method || method == class_getInstanceMethod(class_getSuperclass(controlClass), selector))
+        {
+            originals[i] = NULL;
+            continue;
+        }
+        
+        IMP original        = method_getImplementation(method);
+        IMP hook            = NULL;
+        
+        switch (ccControlLayoutMethods[i].argument)
+        {
+            case kCCControlLayoutArgumentNone:
+                hook = imp_implementationWithBlock(^(id receiver) {
+                    ccControlLayoutPassCount++;
+                    ((void (*)(id, SEL))original)(receiver, selector);
+                });
+                break;
+            case kCCControlLayoutArgumentFloat:
+                hook = imp_implementationWithBlock(^(id receiver, float value) {
+                    ccControlLayoutPassCount++;
+                    ((void (*)(id, SEL, float))original)(receiver, selector, value);
+                });
+                break;
+            case kCCControlLayoutArgumentPoint:
+                hook = imp_implementationWithBlock(^(id receiver, CGPoint point) {
+                    ccControlLayoutPassCount++;
+                    ((void (*)(id, SEL, CGPoint))original)(receiver, selector, point);
+                });
+                break;
+        }
+        
+        originals[i] = method_setImplementation(method, hook);
+    }
+}
+
+/** Restores the original implementations of the layout methods. */
+static void ccControlRemoveLayoutHooks(IMP *originals)
+{
+    for (NSUInteger i = 0; i < kCCControlLayoutMethodCount; i++)
+    {
+        if (!originals[i])
+        {
+            continue;
+        }
+        
+        Class controlClass  = objc_getClass(ccControlLayoutMethods[i].className);
+        Method method       = class_getInstanceMethod(controlClass, sel_registerName(ccControlLayoutMethods[i].selectorName));
+        
+        imp_removeBlock(method_setImplementation(method, originals[i]));
+    }
+}
+
+#pragma mark - Allocation Counting
+
+/**
+ * Logger called by the malloc zones after each allocation and deallocation,
+ * as the one installed by the malloc stack logging. It is not declared by
+ * the public headers of libmalloc.
+ */
+typedef void (ccControlMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numberOfHotFramesToSkip);
+extern ccControlMallocLogger *malloc_logger;
+
+/** Flags of the type given to the malloc logger. */
+#define kCCControlMallocLogAllocate     2
+#define kCCControlMallocLogDeallocate   4
+#define kCCControlMallocLogHasZone      8
+
+/** Number of allocations, and of bytes requested, since the logger has been installed. */
+static volatile int64_t ccControlAllocationCount   = 0;
+static volatile int64_t ccControlAllocatedBytes    = 0;
+/** The logger replaced by ccControlAllocationLogger, called in turn. */
+static ccControlMallocLogger *ccControlPreviousMallocLogger = NULL;
+
+/**
+ * Counts the allocation calls. The size is given by the second argument, or
+ * by the third one for realloc which passes the reallocated block before
+ * it. The allocations of the other threads are counted as well.
+ */
+static void ccControlAllocationLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numberOfHotFramesToSkip)
+{
+    if ((type & kCCControlMallocLogAllocate) && result)
+    {
+        uintptr_t size = (type & kCCControlMallocLogDeallocate) ? arg3 : arg2;
+        
+        __sync_fetch_and_add(&ccControlAllocationCount, 1);
+        __sync_fetch_and_add(&ccControlAllocatedBytes, (int64_t)size);
+    }
+    
+    if (ccControlPreviousMallocLogger)
+    {
+        ccControlPreviousMallocLogger(type, arg1, arg2, arg3, result, numberOfHotFramesToSkip + 1);
+    }
+}
+
+/** Resets the counters and starts counting the allocations. */
+static void ccControlStartCountingAllocations(void)
+{
+    ccControlAllocationCount        = 0;
+    ccControlAllocatedBytes         = 0;
+    ccControlPreviousMallocLogger   = malloc_logger;
+    malloc_logger                   = ccControlAllocationLogger;
+}
+
+/** Stops counting the allocations and restores the previous logger. */
+static void ccControlStopCountingAllocations(void)
+{
+    malloc_logger                   = ccControlPreviousMallocLogger;
+    ccControlPreviousMallocLogger   = NULL;
+}
+
+#pragma mark - CCControlTouchReplay
+
+@interface CCControlTouchReplay ()
+
+/** Appends the given node, if it is a control, and its descendant controls to the targets. */
+- (void)addTargetsFromNode:(CCNode *)aNode;
+
+/** Feeds all the samples of the trace into the targets. */
+- (void)feedTrace:(CCControlTouchTrace *)trace;
+
+@end
+
+@implementation CCControlTouchReplay
+@synthesize node;
+
+- (void)dealloc
+{
+    [node       release];
+    [targets    release];
+    
+    [super      dealloc];
+}
+
+#pragma mark Constructors - Initializers
+
+- (id)initWithNode:(CCNode *)aNode
+{
+    NSAssert(aNode, @"CCControlTouchReplay. The node cannot be nil");
+    
+    if ((self = [super init]))
+    {
+        node    = [aNode retain];
+        targets = [[NSMutableArray alloc] init];
+        
+        [self addTargetsFromNode:node];
+        
+        // Same order as the dispatcher: by priority, then by registration
+        [targets sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(CCControl *a, CCControl *b) {
+            if (a.defaultTouchPriority == b.defaultTouchPriority)
+            {
+                return NSOrderedSame;
+            }
+            return (a.defaultTouchPriority < b.defaultTouchPriority) ? NSOrderedAscending : NSOrderedDescending;
+        }];
+    }
+    return self;
+}
+
++ (id)replayWithNode:(CCNode *)aNode
+{
+    return [[[self alloc] initWithNode:aNode] autorelease];
+}
+
+#pragma mark Public Methods
+
+- (ccControlTouchReplayResult)replayTrace:(CCControlTouchTrace *)trace
+{
+    ccControlTouchReplayResult result;
+    memset(&result, 0, sizeof(result));
+    result.numberOfEvents               = trace.numberOfSamples;
+    
+    // Count the value changed events sent by every target
+    __block NSUInteger valueChangedCount = 0;
+    NSMutableArray *subscriptions       = [NSMutableArray arrayWithCapacity:[targets count]];
+    
+    for (CCControl *target in targets)
+    {
+        [subscriptions addObject:[target addBlock:^(id sender, CCControlEvent event) {
+            valueChangedCount++;
+        } forControlEvents:CCControlEventValueChanged]];
+    }
+    
+    // Timed replay
+    malloc_statistics_t before, after;
+    
+    @autoreleasepool
+    {
+        malloc_zone_statistics(NULL, &before);
+        ccControlStartCountingAllocations();
+        
+        CFTimeInterval start            = CACurrentMediaTime();
+        [self feedTrace:trace];
+        result.seconds                  = CACurrentMediaTime() - start;
+        
+        ccControlStopCountingAllocations();
+        malloc_zone_statistics(NULL, &after);
+    }
+    
+    result.eventsPerSecond              = (result.seconds > 0) ? result.numberOfEvents / result.seconds : 0;
+    result.numberOfValueChangedEvents   = valueChangedCount;
+    result.numberOfAllocations          = (NSUInteger)ccControlAllocationCount;
+    result.allocatedBytes               = (NSUInteger)ccControlAllocatedBytes;
+    result.liveBlocksGrowth             = (NSInteger)after.blocks_in_use - (NSInteger)before.blocks_in_use;
+    result.liveBytesGrowth              = (NSInteger)after.size_in_use - (NSInteger)before.size_in_use;
+    
+    for (NSUInteger i = 0; i < [targets count]; i++)
+    {
+        [[targets objectAtIndex:i] removeSubscription:[subscriptions objectAtIndex:i]];
+    }
+    
+    // Counting replay
+    IMP originals[kCCControlLayoutMethodCount];
+    ccControlInstallLayoutHooks(originals);
+    
+    @autoreleasepool
+    {
+        [self feedTrace:trace];
+    }
+    
+    result.numberOfLayoutPasses         = ccControlLayoutPassCount;
+    ccControlRemoveLayoutHooks(originals);
+    
+    return result;
+}
+
+#pragma mark Private Methods
+
+- (void)addTargetsFromNode:(CCNode *)aNode
+{
+    if ([aNode isKindOfClass:[CCControl class]])
+    {
+        [targets addObject:aNode];
+    }
+    
+    for (CCNode *child in aNode.children)
+    {
+        [self addTargetsFromNode:child];
+    }
+}
+
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+
+- (void)feedTrace:(CCControlTouchTrace *)trace
+{
+    // Each touch in progress has its own UITouch and its own owner
+    struct
+    {
+        BOOL                    active;
+        uint32_t                identifier;
+        CCControlReplayTouch    *touch;
+        CCControl               *owner;
+    } slots[kCCControlReplayMaxTouches];
+    
+    for (NSUInteger i = 0; i < kCCControlReplayMaxTouches; i++)
+    {
+        slots[i].active = NO;
+        slots[i].touch  = [[CCControlReplayTouch alloc] init];
+        slots[i].owner  = nil;
+    }
+    
+    for (NSUInteger i = 0; i < trace.numberOfSamples; i++)
+    {
+        const ccControlTouchSample *sample = &trace.samples[i];
+        
+        // The slot of the touch, or a free slot if the touch begins
+        NSUInteger slot = kCCControlReplayMaxTouches;
+        for (NSUInteger j = 0; j < kCCControlReplayMaxTouches; j++)
+        {
+            if (slots[j].active && slots[j].identifier == sample->touch)
+            {
+                slot = j;
+                break;
+            }
+            if (!slots[j].active && slot == kCCControlReplayMaxTouches && sample->phase == CCControlTouchPhaseBegan)
+            {
+                slot = j;
+            }
+        }
+        
+        if (slot == kCCControlReplayMaxTouches)
+        {
+            // Sample of a touch which has not begun, or too many touches
+            continue;
+        }
+        
+        CCControlReplayTouch *touch = slots[slot].touch;
+        [touch setSample:sample];
+        
+        switch (sample->phase)
+        {
+            case CCControlTouchPhaseBegan:
+                // The first target claiming the touch receives the rest of it
+                slots[slot].active      = YES;
+                slots[slot].identifier  = sample->touch;
+                slots[slot].owner       = nil;
+                for (CCControl *target in targets)
+                {
+                    if ([target ccTouchBegan:touch withEvent:nil])
+                    {
+                        slots[slot].owner = target;
+                        break;
+                    }
+                }
+                break;
+            case CCControlTouchPhaseMoved:
+                [slots[slot].owner ccTouchMoved:touch withEvent:nil];
+                break;
+            case CCControlTouchPhaseEnded:
+                [slots[slot].owner ccTouchEnded:touch withEvent:nil];
+                slots[slot].active      = NO;
+                slots[slot].owner       = nil;
+                break;
+            case CCControlTouchPhaseCancelled:
+                [slots[slot].owner ccTouchCancelled:touch withEvent:nil];
+                slots[slot].active      = NO;
+                slots[slot].owner       = nil;
+                break;
+        }
+        
+        [targets makeObjectsPerformSelector:@selector(flushValueChangedEvents)];
+    }
+    
+    for (NSUInteger i = 0; i < kCCControlReplayMaxTouches; i++)
+    {
+        [slots[i].touch release];
+    }
+}
+
+#elif __MAC_OS_X_VERSION_MAX_ALLOWED
+
+- (void)feedTrace:(CCControlTouchTrace *)trace
+{
+    CCControlReplayEvent *replayEvent   = [[CCControlReplayEvent alloc] init];
+    NSEvent *event                      = (NSEvent *)replayEvent;
+    
+    for (NSUInteger i = 0; i < trace.numberOfSamples; i++)
+    {
+        const ccControlTouchSample *sample = &trace.samples[i];
+        [replayEvent setSample:sample];
+        
+        // Each event goes through the targets until one swallows it
+        for (CCControl *target in targets)
+        {
+            BOOL swallowed = NO;
+            
+            switch (sample->phase)
+            {
+                case CCControlTouchPhaseBegan:
+                    swallowed = [target ccMouseDown:event];
+                    break;
+                case CCControlTouchPhaseMoved:
+                    swallowed = [target ccMouseDragged:event];
+                    break;
+                case CCControlTouchPhaseEnded:
+                case CCControlTouchPhaseCancelled:
+                    swallowed = [target ccMouseUp:event];
+                    break;
+            }
+            
+            if (swallowed)
+            {
+                break;
+            }
+        }
+        
+        [targets makeObjectsPerformSelector:@selector(flushValueChangedEvents)];
+    }
+    
+    [replayEvent release];
+}
+
+#endif
+
+@end
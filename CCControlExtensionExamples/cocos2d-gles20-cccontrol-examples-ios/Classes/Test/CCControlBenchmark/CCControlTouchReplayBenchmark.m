@@ -0,0 +1,237 @@
+/*
+ * CCControlTouchReplayBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlTouchReplayBenchmark.h"
+#import "CCControlTouchReplay.h"
+
+#import "CCControlColourPickerTest.h"
+#import "CCControlPickerTest.h"
+#import "CCControlPotentiometerTest.h"
+#import "CCControlSliderTest.h"
+#import "CCControlStepperTest.h"
+#import "CCControlSwitchTest.h"
+
+/** Number of drags of the generated drag traces. */
+#define kTouchReplayBenchmarkDrags          40
+/** Number of samples of a generated drag, one per frame. */
+#define kTouchReplayBenchmarkDragSamples    60
+/** Number of taps of the generated tap traces. */
+#define kTouchReplayBenchmarkTaps           600
+
+@interface CCControlTouchReplayBenchmark ()
+
+/**
+ * Creates the test scene of the given class and replays into it the trace
+ * recorded in this scene, or the generated one if there is none.
+ */
+- (void)replaySceneClass:(Class)sceneClass
+                    name:(NSString *)name
+          generatedTrace:(CCControlTouchTrace *(^)(CCNode *scene))generatedTrace;
+
+/** Returns the first control of the given class found in the node. */
+- (id)controlOfClass:(Class)controlClass inNode:(CCNode *)node;
+
+/**
+ * Returns a trace dragging back and forth between two locations, given in
+ * the node space of the node.
+ */
+- (CCControlTouchTrace *)dragTraceInNode:(CCNode *)node from:(CGPoint)from to:(CGPoint)to;
+
+/**
+ * Returns a trace dragging around a circle, given in the node space of the
+ * node.
+ */
+- (CCControlTouchTrace *)circleTraceInNode:(CCNode *)node center:(CGPoint)center radius:(float)radius;
+
+/**
+ * Returns a trace tapping alternately on the given locations, given in the
+ * node space of the node.
+ */
+- (CCControlTouchTrace *)tapTraceInNode:(CCNode *)node locations:(const CGPoint *)locations count:(NSUInteger)count;
+
+@end
+
+@implementation CCControlTouchReplayBenchmark
+
+#pragma mark -
+#pragma mark CCControlTouchReplayBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    [self replaySceneClass:[CCControlSliderTest class] name:@"Slider" generatedTrace:^(CCNode *scene) {
+        CCControlSlider *slider = [self controlOfClass:[CCControlSlider class] inNode:scene];
+        CGSize size             = slider.contentSize;
+        
+        return [self dragTraceInNode:slider from:ccp(size.width * 0.05f, size.height / 2) to:ccp(size.width * 0.95f, size.height / 2)];
+    }];
+    
+    [self replaySceneClass:[CCControlPotentiometerTest class] name:@"Potentiometer" generatedTrace:^(CCNode *scene) {
+        CCControlPotentiometer *potentiometer   = [self controlOfClass:[CCControlPotentiometer class] inNode:scene];
+        CGSize size                             = potentiometer.contentSize;
+        
+        return [self circleTraceInNode:potentiometer center:ccp(size.width / 2, size.height / 2) radius:size.width * 0.35f];
+    }];
+    
+    [self replaySceneClass:[CCControlPickerTest class] name:@"Picker" generatedTrace:^(CCNode *scene) {
+        CCControlPicker *picker = [self controlOfClass:[CCControlPicker class] inNode:scene];
+        CGSize size             = picker.contentSize;
+        
+        return [self dragTraceInNode:picker from:ccp(size.width / 2, size.height * 0.2f) to:ccp(size.width / 2, size.height * 0.8f)];
+    }];
+    
+    [self replaySceneClass:[CCControlStepperTest class] name:@"Stepper" generatedTrace:^(CCNode *scene) {
+        CCControlStepper *stepper   = [self controlOfClass:[CCControlStepper class] inNode:scene];
+        CGSize size                 = stepper.contentSize;
+        CGPoint locations[]         = { ccp(size.width * 0.75f, size.height / 2), ccp(size.width * 0.25f, size.height / 2) };
+        
+        return [self tapTraceInNode:stepper locations:locations count:2];
+    }];
+    
+    [self replaySceneClass:[CCControlSwitchTest class] name:@"Switch" generatedTrace:^(CCNode *scene) {
+        CCControlSwitch *aSwitch    = [self controlOfClass:[CCControlSwitch class] inNode:scene];
+        CGSize size                 = aSwitch.contentSize;
+        CGPoint location            = ccp(size.width / 2, size.height / 2);
+        
+        return [self tapTraceInNode:aSwitch locations:&location count:1];
+    }];
+    
+    [self replaySceneClass:[CCControlColourPickerTest class] name:@"Colour picker" generatedTrace:^(CCNode *scene) {
+        // The hue and tint pickers are centered on the origin of the colour picker
+        CCControlColourPicker *colourPicker = [self controlOfClass:[CCControlColourPicker class] inNode:scene];
+        float radius                        = colourPicker.contentSize.width / 2;
+        float tintRadius                    = radius * kCCColourPickerTintDiameterRatio;
+        
+        CCControlTouchTrace *trace          = [self circleTraceInNode:colourPicker center:CGPointZero radius:(radius + tintRadius) / 2];
+        [trace appendTrace:[self dragTraceInNode:colourPicker from:ccp(-tintRadius / 2, -tintRadius / 2) to:ccp(tintRadius / 2, tintRadius / 2)]];
+        
+        return trace;
+    }];
+}
+
+#pragma mark CCControlTouchReplayBenchmark Private Methods
+
+- (void)replaySceneClass:(Class)sceneClass
+                    name:(NSString *)name
+          generatedTrace:(CCControlTouchTrace *(^)(CCNode *scene))generatedTrace
+{
+    // The scene is not displayed, its controls are only fed by the replay
+    CCNode *scene               = [sceneClass node];
+    CCControlTouchTrace *trace  = [CCControlTouchTrace traceWithContentsOfFile:[sceneClass touchTracePath]];
+    BOOL recorded               = (trace != nil);
+    
+    if (!trace)
+    {
+        trace                   = generatedTrace(scene);
+    }
+    
+    ccControlTouchReplayResult result = [[CCControlTouchReplay replayWithNode:scene] replayTrace:trace];
+    
+    [self logResult:@"%@ (%@ trace): %lu events, %.0f events/s, %lu layout passes, %lu value changed, %lu allocations (%.1f KB), %+ld live blocks (%+.1f KB)",
+     name, recorded ? @"recorded" : @"generated", (unsigned long)result.numberOfEvents, result.eventsPerSecond,
+     (unsigned long)result.numberOfLayoutPasses, (unsigned long)result.numberOfValueChangedEvents,
+     (unsigned long)result.numberOfAllocations, result.allocatedBytes / 1024.0,
+     (long)result.liveBlocksGrowth, result.liveBytesGrowth / 1024.0];
+    
+    // Unschedules the animations started by the replay
+    [scene cleanup];
+}
+
+- (id)controlOfClass:(Class)controlClass inNode:(CCNode *)node
+{
+    if ([node isKindOfClass:controlClass])
+    {
+        return node;
+    }
+    
+    for (CCNode *child in node.children)
+    {
+        id control = [self controlOfClass:controlClass inNode:child];
+        
+        if (control)
+        {
+            return control;
+        }
+    }
+    
+    return nil;
+}
+
+- (CCControlTouchTrace *)dragTraceInNode:(CCNode *)node from:(CGPoint)from to:(CGPoint)to
+{
+    CCControlTouchTrace *trace = [CCControlTouchTrace trace];
+    CGPoint locations[kTouchReplayBenchmarkDragSamples];
+    
+    for (NSUInteger drag = 0; drag < kTouchReplayBenchmarkDrags; drag++)
+    {
+        // Every other drag goes backward
+        CGPoint start   = (drag % 2 == 0) ? from : to;
+        CGPoint end     = (drag % 2 == 0) ? to : from;
+        
+        for (NSUInteger i = 0; i < kTouchReplayBenchmarkDragSamples; i++)
+        {
+            locations[i] = [node convertToWorldSpace:ccpLerp(start, end, i / (float)(kTouchReplayBenchmarkDragSamples - 1))];
+        }
+        
+        [trace appendTrace:[CCControlTouchTrace dragTraceWithWorldLocations:locations count:kTouchReplayBenchmarkDragSamples]];
+    }
+    
+    return trace;
+}
+
+- (CCControlTouchTrace *)circleTraceInNode:(CCNode *)node center:(CGPoint)center radius:(float)radius
+{
+    // A single drag turning several times, as many samples as the drags
+    NSUInteger count    = kTouchReplayBenchmarkDrags * kTouchReplayBenchmarkDragSamples;
+    CGPoint *locations  = malloc(count * sizeof(CGPoint));
+    
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        float angle     = (2 * M_PI * i) / kTouchReplayBenchmarkDragSamples;
+        locations[i]    = [node convertToWorldSpace:ccpAdd(center, ccpMult(ccpForAngle(angle), radius))];
+    }
+    
+    CCControlTouchTrace *trace = [CCControlTouchTrace dragTraceWithWorldLocations:locations count:count];
+    free(locations);
+    
+    return trace;
+}
+
+- (CCControlTouchTrace *)tapTraceInNode:(CCNode *)node locations:(const CGPoint *)locations count:(NSUInteger)count
+{
+    CGPoint *worldLocations = malloc(count * sizeof(CGPoint));
+    
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        worldLocations[i]   = [node convertToWorldSpace:locations[i]];
+    }
+    
+    CCControlTouchTrace *trace = [CCControlTouchTrace tapTraceWithWorldLocations:worldLocations count:count taps:kTouchReplayBenchmarkTaps];
+    free(worldLocations);
+    
+    return trace;
+}
+
+@end
@@ -0,0 +1,148 @@
+/*
+ * CCControlTouchTrace.h
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "cocos2d.h"
+
+/** Phases of the samples of a touch trace. */
+typedef enum
+{
+    CCControlTouchPhaseBegan        = 0,
+    CCControlTouchPhaseMoved        = 1,
+    CCControlTouchPhaseEnded        = 2,
+    CCControlTouchPhaseCancelled    = 3,
+} CCControlTouchPhase;
+
+/**
+ * A touch (or mouse) event as fed to the ccTouch (or ccMouse) methods of
+ * the controls. The location is given in the coordinates of the view on
+ * iOS and of the window on Mac OS X, as returned by UITouch and NSEvent.
+ *
+ * The touch identifies the finger: the samples of a same touch, from its
+ * began phase to its ended (or cancelled) phase, share it. The touches of
+ * the generated traces and of the mouse are 0.
+ */
+typedef struct _ccControlTouchSample
+{
+    uint32_t    phase;
+    uint32_t    touch;
+    float       x;
+    float       y;
+    double      timestamp;
+} ccControlTouchSample;
+
+/**
+ * A touch trace is a stream of touch samples. It is recorded from the real
+ * input by a CCControlTouchRecorder, or generated, and replayed into a
+ * control by a CCControlTouchReplay.
+ *
+ * A trace is saved as a small header followed by the samples.
+ */
+@interface CCControlTouchTrace : NSObject
+{
+@protected
+    ccControlTouchSample    *samples;
+    NSUInteger              numberOfSamples;
+    NSUInteger              capacity;
+}
+/** The samples of the trace. */
+@property (nonatomic, readonly) const ccControlTouchSample *samples;
+/** The number of samples of the trace. */
+@property (nonatomic, readonly) NSUInteger numberOfSamples;
+
+#pragma mark Constructors - Initializers
+
+/** Creates an empty trace. */
++ (id)trace;
+
+/** Initializes a trace with the content of a file saved by writeToFile:. */
+- (id)initWithContentsOfFile:(NSString *)path;
+
+/** Creates a trace with the content of a file, or returns nil. */
++ (id)traceWithContentsOfFile:(NSString *)path;
+
+/**
+ * Creates a trace of a finger dragged through the given locations, in
+ * world coordinates, one sample every 1/60 s.
+ */
++ (id)dragTraceWithWorldLocations:(const CGPoint *)locations count:(NSUInteger)count;
+
+/**
+ * Creates a trace of taps alternating between the given locations, in
+ * world coordinates.
+ */
++ (id)tapTraceWithWorldLocations:(const CGPoint *)locations count:(NSUInteger)count taps:(NSUInteger)taps;
+
+#pragma mark Public Methods
+
+/** Appends a sample of the given touch to the trace. */
+- (void)addSampleWithTouch:(NSUInteger)touch phase:(CCControlTouchPhase)phase location:(CGPoint)location timestamp:(double)timestamp;
+
+/** Appends a sample of the touch 0 to the trace. */
+- (void)addSampleWithPhase:(CCControlTouchPhase)phase location:(CGPoint)location timestamp:(double)timestamp;
+
+/** Appends the samples of the given trace to the receiver. */
+- (void)appendTrace:(CCControlTouchTrace *)trace;
+
+/** Saves the trace to the given file. Returns NO if it cannot be written. */
+- (BOOL)writeToFile:(NSString *)path;
+
+@end
+
+/**
+ * Records the touches (or the mouse events) dispatched to the scene into
+ * a trace. The recorder is registered with the highest priority and does
+ * not swallow the events, so the controls receive them unchanged.
+ */
+@interface CCControlTouchRecorder : NSObject
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+<CCTargetedTouchDelegate>
+#elif __MAC_OS_X_VERSION_MAX_ALLOWED
+<CCMouseEventDelegate>
+#endif
+{
+@protected
+    CCControlTouchTrace *trace;
+    BOOL                recording;
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+    CFMutableDictionaryRef  touchIdentifiers;
+    NSUInteger              nextTouchIdentifier;
+#endif
+}
+/** The recorded trace. */
+@property (nonatomic, readonly) CCControlTouchTrace *trace;
+/** YES between startRecording and stopRecording. */
+@property (nonatomic, readonly, getter = isRecording) BOOL recording;
+
+/** Creates a recorder with an empty trace. */
++ (id)recorder;
+
+/** Starts recording the events into the trace. */
+- (void)startRecording;
+
+/** Stops recording the events. */
+- (void)stopRecording;
+
+@end
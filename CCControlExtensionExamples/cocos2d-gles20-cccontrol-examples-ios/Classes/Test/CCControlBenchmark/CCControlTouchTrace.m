@@ -0,0 +1,386 @@
+/*
+ * CCControlTouchTrace.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlTouchTrace.h"
+
+/** "CCTT" read as a little-endian 32-bit integer. */
+#define kCCControlTouchTraceMagic       0x54544343
+/** Version of the trace files. */
+#define kCCControlTouchTraceVersion     2
+/** Version of the trace files whose samples have no touch. */
+#define kCCControlTouchTraceVersion1    1
+/** Interval between the samples of the generated traces, in seconds. */
+#define kCCControlTouchTraceInterval    (1.0 / 60.0)
+
+/** Header of the trace files. */
+typedef struct _ccControlTouchTraceHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    sampleSize;
+    uint32_t    numberOfSamples;
+} ccControlTouchTraceHeader;
+
+/** Samples of the version 1 trace files, all of the touch 0. */
+typedef struct _ccControlTouchSampleVersion1
+{
+    uint32_t    phase;
+    float       x;
+    float       y;
+    double      timestamp;
+} ccControlTouchSampleVersion1;
+
+/** Returns the location of the given world location in the trace coordinates. */
+static CGPoint ccControlTouchTraceLocationFromWorld(CGPoint worldLocation)
+{
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+    return [[CCDirector sharedDirector] convertToUI:worldLocation];
+#elif __MAC_OS_X_VERSION_MAX_ALLOWED
+    // The window is supposed to display the scene without scaling
+    NSView *view = [[CCDirector sharedDirector] view];
+    
+    return NSPointToCGPoint([view convertPoint:NSPointFromCGPoint(worldLocation) toView:nil]);
+#endif
+}
+
+@implementation CCControlTouchTrace
+@synthesize samples;
+@synthesize numberOfSamples;
+
+- (void)dealloc
+{
+    free(samples);
+    
+    [super dealloc];
+}
+
+#pragma mark Constructors - Initializers
+
++ (id)trace
+{
+    return [[[self alloc] init] autorelease];
+}
+
+- (id)initWithContentsOfFile:(NSString *)path
+{
+    if ((self = [super init]))
+    {
+        NSData *data                            = [NSData dataWithContentsOfFile:path];
+        const ccControlTouchTraceHeader *header = [data bytes];
+        BOOL version1                           = ([data length] >= sizeof(ccControlTouchTraceHeader)
+                                                   && header->version == kCCControlTouchTraceVersion1);
+        size_t sampleSize                       = version1 ? sizeof(ccControlTouchSampleVersion1) : sizeof(ccControlTouchSample);
+        
+        if ([data length] < sizeof(ccControlTouchTraceHeader)
+            || header->magic != kCCControlTouchTraceMagic
+            || (header->version != kCCControlTouchTraceVersion && !version1)
+            || header->sampleSize != sampleSize
+            || header->numberOfSamples > ([data length] - sizeof(ccControlTouchTraceHeader)) / sampleSize)
+        {
+            [self release];
+            return nil;
+        }
+        
+        numberOfSamples = header->numberOfSamples;
+        capacity        = numberOfSamples;
+        samples         = malloc(MAX(capacity, 1) * sizeof(ccControlTouchSample));
+        
+        if (version1)
+        {
+            // The recordings made before the touches were stored have a single touch
+            const ccControlTouchSampleVersion1 *oldSamples = (const ccControlTouchSampleVersion1 *)(header + 1);
+            
+            for (NSUInteger i = 0; i < numberOfSamples; i++)
+            {
+                samples[i].phase        = oldSamples[i].phase;
+                samples[i].touch        = 0;
+                samples[i].x            = oldSamples[i].x;
+                samples[i].y            = oldSamples[i].y;
+                samples[i].timestamp    = oldSamples[i].timestamp;
+            }
+        } else
+        {
+            memcpy(samples, header + 1, numberOfSamples * sizeof(ccControlTouchSample));
+        }
+    }
+    return self;
+}
+
++ (id)traceWithContentsOfFile:(NSString *)path
+{
+    return [[[self alloc] initWithContentsOfFile:path] autorelease];
+}
+
++ (id)dragTraceWithWorldLocations:(const CGPoint *)locations count:(NSUInteger)count
+{
+    CCControlTouchTrace *trace = [self trace];
+    
+    for (NSUInteger i = 0; i < count; i++)
+    {
+        CCControlTouchPhase phase = (i == 0) ? CCControlTouchPhaseBegan
+                                  : (i == count - 1) ? CCControlTouchPhaseEnded
+                                  : CCControlTouchPhaseMoved;
+        
+        [trace addSampleWithPhase:phase
+                         location:ccControlTouchTraceLocationFromWorld(locations[i])
+                        timestamp:i * kCCControlTouchTraceInterval];
+    }
+    
+    return trace;
+}
+
++ (id)tapTraceWithWorldLocations:(const CGPoint *)locations count:(NSUInteger)count taps:(NSUInteger)taps
+{
+    CCControlTouchTrace *trace = [self trace];
+    
+    for (NSUInteger i = 0; i < taps; i++)
+    {
+        CGPoint location = ccControlTouchTraceLocationFromWorld(locations[i % count]);
+        
+        [trace addSampleWithPhase:CCControlTouchPhaseBegan location:location timestamp:(2 * i) * kCCControlTouchTraceInterval];
+        [trace addSampleWithPhase:CCControlTouchPhaseEnded location:location timestamp:(2 * i + 1) * kCCControlTouchTraceInterval];
+    }
+    
+    return trace;
+}
+
+#pragma mark Public Methods
+
+- (void)addSampleWithTouch:(NSUInteger)touch phase:(CCControlTouchPhase)phase location:(CGPoint)location timestamp:(double)timestamp
+{
+    if (numberOfSamples == capacity)
+    {
+        capacity    = MAX(capacity * 2, 64);
+        samples     = realloc(samples, capacity * sizeof(ccControlTouchSample));
+        NSAssert(samples, @"CCControlTouchTrace. Not enough memory");
+    }
+    
+    ccControlTouchSample *sample    = &samples[numberOfSamples++];
+    sample->phase                   = phase;
+    sample->touch                   = (uint32_t)touch;
+    sample->x                       = location.x;
+    sample->y                       = location.y;
+    sample->timestamp               = timestamp;
+}
+
+- (void)addSampleWithPhase:(CCControlTouchPhase)phase location:(CGPoint)location timestamp:(double)timestamp
+{
+    [self addSampleWithTouch:0 phase:phase location:location timestamp:timestamp];
+}
+
+- (void)appendTrace:(CCControlTouchTrace *)trace
+{
+    // The appended samples follow the last sample of the receiver
+    double offset = (numberOfSamples > 0) ? samples[numberOfSamples - 1].timestamp + kCCControlTouchTraceInterval : 0;
+    
+    for (NSUInteger i = 0; i < trace.numberOfSamples; i++)
+    {
+        const ccControlTouchSample *sample = &trace.samples[i];
+        
+        [self addSampleWithTouch:sample->touch
+                           phase:sample->phase
+                        location:ccp(sample->x, sample->y)
+                       timestamp:offset + sample->timestamp - trace.samples[0].timestamp];
+    }
+}
+
+- (BOOL)writeToFile:(NSString *)path
+{
+    ccControlTouchTraceHeader header;
+    header.magic            = kCCControlTouchTraceMagic;
+    header.version          = kCCControlTouchTraceVersion;
+    header.sampleSize       = sizeof(ccControlTouchSample);
+    header.numberOfSamples  = (uint32_t)numberOfSamples;
+    
+    NSMutableData *data = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [data appendBytes:samples length:numberOfSamples * sizeof(ccControlTouchSample)];
+    
+    return [data writeToFile:path atomically:YES];
+}
+
+@end
+
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+
+@interface CCControlTouchRecorder ()
+
+/**
+ * Appends a sample of the given touch, identified by the order in which
+ * the touches began. The identifier is forgotten when the touch ends.
+ */
+- (void)addSampleWithTouch:(UITouch *)touch phase:(CCControlTouchPhase)phase;
+
+@end
+
+#endif
+
+@implementation CCControlTouchRecorder
+@synthesize trace;
+@synthesize recording;
+
+- (void)dealloc
+{
+    [self stopRecording];
+    [trace release];
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+    CFRelease(touchIdentifiers);
+#endif
+    
+    [super dealloc];
+}
+
+- (id)init
+{
+    if ((self = [super init]))
+    {
+        trace = [[CCControlTouchTrace alloc] init];
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+        // Maps the UITouch being recorded, not retained, to their identifier
+        touchIdentifiers = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+#endif
+    }
+    return self;
+}
+
++ (id)recorder
+{
+    return [[[self alloc] init] autorelease];
+}
+
+#pragma mark Public Methods
+
+- (void)startRecording
+{
+    if (recording)
+    {
+        return;
+    }
+    recording = YES;
+    
+    // Sees the events before the controls without swallowing them
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+    [[[CCDirector sharedDirector] touchDispatcher] addTargetedDelegate:self priority:INT_MIN swallowsTouches:NO];
+#elif __MAC_OS_X_VERSION_MAX_ALLOWED
+    [[[CCDirector sharedDirector] eventDispatcher] addMouseDelegate:self priority:INT_MIN];
+#endif
+}
+
+- (void)stopRecording
+{
+    if (!recording)
+    {
+        return;
+    }
+    recording = NO;
+    
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+    [[[CCDirector sharedDirector] touchDispatcher] removeDelegate:self];
+    CFDictionaryRemoveAllValues(touchIdentifiers);
+#elif __MAC_OS_X_VERSION_MAX_ALLOWED
+    [[[CCDirector sharedDirector] eventDispatcher] removeMouseDelegate:self];
+#endif
+}
+
+#ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
+
+#pragma mark CCTargetedTouchDelegate
+
+- (void)addSampleWithTouch:(UITouch *)touch phase:(CCControlTouchPhase)phase
+{
+    const void *identifier = NULL;
+    
+    if (phase == CCControlTouchPhaseBegan)
+    {
+        identifier = (const void *)(uintptr_t)nextTouchIdentifier++;
+        CFDictionarySetValue(touchIdentifiers, touch, identifier);
+    } else if (!CFDictionaryGetValueIfPresent(touchIdentifiers, touch, &identifier))
+    {
+        // The touch began before the recording
+        return;
+    }
+    
+    [trace addSampleWithTouch:(NSUInteger)(uintptr_t)identifier
+                        phase:phase
+                     location:[touch locationInView:[touch view]]
+                    timestamp:touch.timestamp];
+    
+    if (phase == CCControlTouchPhaseEnded || phase == CCControlTouchPhaseCancelled)
+    {
+        CFDictionaryRemoveValue(touchIdentifiers, touch);
+    }
+}
+
+- (BOOL)ccTouchBegan:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    [self addSampleWithTouch:touch phase:CCControlTouchPhaseBegan];
+    
+    // Claims the touch to receive its moves, but lets the controls have it
+    return YES;
+}
+
+- (void)ccTouchMoved:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    [self addSampleWithTouch:touch phase:CCControlTouchPhaseMoved];
+}
+
+- (void)ccTouchEnded:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    [self addSampleWithTouch:touch phase:CCControlTouchPhaseEnded];
+}
+
+- (void)ccTouchCancelled:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    [self addSampleWithTouch:touch phase:CCControlTouchPhaseCancelled];
+}
+
+#elif __MAC_OS_X_VERSION_MAX_ALLOWED
+
+#pragma mark CCMouseEventDelegate
+
+- (BOOL)ccMouseDown:(NSEvent *)event
+{
+    [trace addSampleWithPhase:CCControlTouchPhaseBegan location:NSPointToCGPoint([event locationInWindow]) timestamp:[event timestamp]];
+    
+    return NO;
+}
+
+- (BOOL)ccMouseDragged:(NSEvent *)event
+{
+    [trace addSampleWithPhase:CCControlTouchPhaseMoved location:NSPointToCGPoint([event locationInWindow]) timestamp:[event timestamp]];
+    
+    return NO;
+}
+
+- (BOOL)ccMouseUp:(NSEvent *)event
+{
+    [trace addSampleWithPhase:CCControlTouchPhaseEnded location:NSPointToCGPoint([event locationInWindow]) timestamp:[event timestamp]];
+    
+    return NO;
+}
+
+#endif
+
+@end
@@ -0,0 +1,155 @@
+/*
+ * CCControlTransformCacheBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCControlTransformCacheBenchmark.h"
+
+/** Number of simulated touches per depth. */
+#define kTransformCacheBenchmarkTouches 10000
+
+@interface CCControlTransformCacheBenchmark ()
+
+/** Runs the benchmark for a control nested at the given depth. */
+- (void)runBenchmarkWithDepth:(NSUInteger)depth;
+
+/** Returns whether the location hits the control, walking the ancestors as
+ cocos2d does. */
+- (BOOL)uncachedControl:(CCControl *)control containsLocation:(CGPoint)location;
+
+@end
+
+@implementation CCControlTransformCacheBenchmark
+
+#pragma mark -
+#pragma mark CCControlTransformCacheBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    [self logResult:@"%d touches per depth", kTransformCacheBenchmarkTouches];
+    
+    [self runBenchmarkWithDepth:10];
+    [self runBenchmarkWithDepth:20];
+    [self runBenchmarkWithDepth:40];
+}
+
+#pragma mark CCControlTransformCacheBenchmark Private Methods
+
+- (void)runBenchmarkWithDepth:(NSUInteger)depth
+{
+    // Build a chain of slightly transformed nodes with the control as leaf
+    CCNode *root                    = [CCNode node];
+    CCNode *node                    = root;
+    
+    for (NSUInteger i = 1; i < depth; i++)
+    {
+        CCNode *child               = [CCNode node];
+        child.position              = ccp(2, 1);
+        child.rotation              = 0.5f;
+        child.scale                 = 1.002f;
+        [node addChild:child];
+        
+        node                        = child;
+    }
+    
+    CCControl *control              = [CCControl node];
+    control.contentSize             = CGSizeMake(100, 100);
+    control.position                = ccp(150, 100);
+    [node addChild:control];
+    
+    // Generate the same touches for all the runs
+    CGPoint *locations              = malloc(kTransformCacheBenchmarkTouches * sizeof(CGPoint));
+    srand48(42);
+    
+    for (NSUInteger i = 0; i < kTransformCacheBenchmarkTouches; i++)
+    {
+        locations[i]                = ccp(drand48() * 480, drand48() * 320);
+    }
+    
+    __block NSUInteger uncachedHits = 0, coldHits = 0, cachedHits = 0, movingHits = 0;
+    
+    double uncachedTime = [self millisecondsForIterations:kTransformCacheBenchmarkTouches block:^(NSUInteger i) {
+        if ([self uncachedControl:control containsLocation:locations[i]])
+        {
+            uncachedHits++;
+        }
+    }];
+    
+    double coldTime = [self millisecondsForIterations:kTransformCacheBenchmarkTouches block:^(NSUInteger i) {
+        [control setNeedsTransformUpdate];
+        
+        if ([control hasVisibleParents]
+            && [control isPointInside:[control convertWorldLocationToParentSpace:locations[i]]])
+        {
+            coldHits++;
+        }
+    }];
+    
+    double cachedTime = [self millisecondsForIterations:kTransformCacheBenchmarkTouches block:^(NSUInteger i) {
+        if ([control hasVisibleParents]
+            && [control isPointInside:[control convertWorldLocationToParentSpace:locations[i]]])
+        {
+            cachedHits++;
+        }
+    }];
+    
+    // The root is set to the same position before each touch, which
+    // invalidates the cache of every control as an animation would
+    double movingTime = [self millisecondsForIterations:kTransformCacheBenchmarkTouches block:^(NSUInteger i) {
+        root.position = CGPointZero;
+        
+        if ([control hasVisibleParents]
+            && [control isPointInside:[control convertWorldLocationToParentSpace:locations[i]]])
+        {
+            movingHits++;
+        }
+    }];
+    
+    free(locations);
+    
+    [self logResult:@"Depth %lu: uncached %.2f ms, cold %.2f ms, moving %.2f ms, cached %.2f ms (x%.1f)",
+     (unsigned long)depth, uncachedTime, coldTime, movingTime, cachedTime, uncachedTime / cachedTime];
+    
+    if (uncachedHits != cachedHits || uncachedHits != coldHits || uncachedHits != movingHits)
+    {
+        [self logResult:@"Depth %lu: hit count mismatch (%lu, %lu, %lu, %lu)",
+         (unsigned long)depth, (unsigned long)uncachedHits, (unsigned long)coldHits,
+         (unsigned long)movingHits, (unsigned long)cachedHits];
+    }
+}
+
+- (BOOL)uncachedControl:(CCControl *)control containsLocation:(CGPoint)location
+{
+    for (CCNode *node = [control parent]; node != nil; node = [node parent])
+    {
+        if (![node visible])
+        {
+            return NO;
+        }
+    }
+    
+    return [control isPointInside:[[control parent] convertToNodeSpace:location]];
+}
+
+@end
@@ -0,0 +1,121 @@
+/*
+ * CCScale9SpriteBenchmark.m
+ *
+ * Copyright (c) 2013 Yannick Loriot
+ * http://yannickloriot.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#import "CCScale9SpriteBenchmark.h"
+
+/** Number of 9-slice sprites, as a list of 100 buttons. */
+#define kScale9SpriteBenchmarkSprites   100
+/** Number of resize steps, as a one second layout animation. */
+#define kScale9SpriteBenchmarkSteps     60
+
+/** Exposes the layout method to measure it without drawing. */
+@interface CCScale9Sprite (Benchmark)
+
+- (void)updatePosition;
+
+@end
+
+@interface CCScale9SpriteBenchmark ()
+
+/** Runs the benchmark for the given render mode. */
+- (void)runBenchmarkWithRenderMode:(CCScale9SpriteRenderMode)renderMode name:(NSString *)name;
+
+/** Returns the number of nodes of the given tree. */
+- (NSUInteger)numberOfNodesInTree:(CCNode *)node;
+
+@end
+
+@implementation CCScale9SpriteBenchmark
+
+#pragma mark -
+#pragma mark CCScale9SpriteBenchmark Public Methods
+
+- (void)runBenchmark
+{
+    CCScale9SpriteRenderMode defaultRenderMode = [CCScale9Sprite defaultRenderMode];
+    
+    [self logResult:@"%d sprites, %d resize steps", kScale9SpriteBenchmarkSprites, kScale9SpriteBenchmarkSteps];
+    
+    [self runBenchmarkWithRenderMode:CCScale9SpriteRenderModeSprites name:@"Sprites"];
+    [self runBenchmarkWithRenderMode:CCScale9SpriteRenderModeQuads name:@"Quads"];
+    
+    [CCScale9Sprite setDefaultRenderMode:defaultRenderMode];
+}
+
+#pragma mark CCScale9SpriteBenchmark Private Methods
+
+- (void)runBenchmarkWithRenderMode:(CCScale9SpriteRenderMode)renderMode name:(NSString *)name
+{
+    [CCScale9Sprite setDefaultRenderMode:renderMode];
+    
+    // Warm the texture cache up so that only the sprites are measured
+    [[CCTextureCache sharedTextureCache] addImage:@"buttonBackground.png"];
+    
+    CCNode *list                = [CCNode node];
+    
+    double creationTime = [self millisecondsForIterations:kScale9SpriteBenchmarkSprites block:^(NSUInteger i) {
+        CCScale9Sprite *sprite  = [CCScale9Sprite spriteWithFile:@"buttonBackground.png"];
+        sprite.position         = ccp(0, i * 40);
+        [list addChild:sprite];
+    }];
+    
+    NSUInteger numberOfNodes    = [self numberOfNodesInTree:list] - 1;
+    
+    double resizeTime = [self millisecondsForIterations:kScale9SpriteBenchmarkSteps block:^(NSUInteger step) {
+        CGSize size             = CGSizeMake(100 + step * 2, 40 + step);
+        
+        for (CCScale9Sprite *sprite in [list children])
+        {
+            sprite.contentSize  = size;
+            [sprite updatePosition];
+        }
+    }];
+    
+    // Switch the insets back and forth as a theme change would do
+    double capInsetsTime = [self millisecondsForIterations:kScale9SpriteBenchmarkSprites block:^(NSUInteger i) {
+        CCScale9Sprite *sprite  = [[list children] objectAtIndex:i];
+        sprite.capInsets        = (i % 2) ? CGRectMake(10, 10, 20, 10) : CGRectMake(12, 12, 16, 6);
+    }];
+    
+    [self logResult:@"%@: creation %.2f ms, resize %.2f ms (%.1f us/sprite), %lu nodes",
+     name, creationTime, resizeTime, resizeTime * 1000 / (kScale9SpriteBenchmarkSteps * kScale9SpriteBenchmarkSprites),
+     (unsigned long)numberOfNodes];
+    [self logResult:@"%@: cap insets change %.2f ms", name, capInsetsTime];
+}
+
+- (NSUInteger)numberOfNodesInTree:(CCNode *)node
+{
+    NSUInteger count            = 1;
+    
+    for (CCNode *child in [node children])
+    {
+        count                   += [self numberOfNodesInTree:child];
+    }
+    
+    return count;
+}
+
+@end
@@ -40,6 +40,12 @@
     [super dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"buttonBackground.png", @"button.png", @"buttonHighlighted.png", nil]];
+}
+
 - (id)init
 {
     if ((self = [super init]))
@@ -122,6 +128,12 @@
     [super dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"buttonBackground.png", @"button.png", @"buttonHighlighted.png", nil]];
+}
+
 - (id)init
 {
 	if ((self = [super init]))
@@ -234,6 +246,12 @@
     [super dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"buttonBackground.png", @"button.png", @"buttonHighlighted.png", nil]];
+}
+
 - (id)init
 {
     if ((self = [super init]))
@@ -44,6 +44,12 @@
     [super dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"buttonBackground.png", @"hueBackground.png", @"tintBackground.png", @"tintOverlay.png", @"picker.png", @"arrow.png", nil]];
+}
+
 - (id)init
 {
 	if ((self = [super init]))
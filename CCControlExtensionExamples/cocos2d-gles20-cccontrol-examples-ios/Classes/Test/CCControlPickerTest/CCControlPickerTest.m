@@ -48,6 +48,12 @@
     [super              dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"buttonBackground.png", @"pickerBackground.png", @"pickerSelection.png", nil]];
+}
+
 - (id)init
 {
 	if ((self = [super init]))
@@ -126,7 +132,12 @@
 
 - (CCControlPickerRow *)controlPicker:(CCControlPicker *)controlPicker nodeForRow:(NSUInteger)row
 {
-    CCControlPickerRow *rowNode = [CCControlPickerRow node];
+    CCControlPickerRow *rowNode = [controlPicker dequeueReusableRow];
+    
+    if (!rowNode)
+    {
+        rowNode                 = [CCControlPickerRow node];
+    }
     rowNode.textLabel.string    = [_source objectAtIndex:row];
     
     return rowNode;
@@ -45,6 +45,12 @@
     [super              dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"buttonBackground.png", @"potentiometerTrack.png", @"potentiometerProgress.png", @"potentiometerButton.png", nil]];
+}
+
 - (id)init
 {
 	if ((self = [super init]))
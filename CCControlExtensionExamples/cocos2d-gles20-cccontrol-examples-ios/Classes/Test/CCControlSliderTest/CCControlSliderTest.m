@@ -47,6 +47,12 @@
     [super              dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"sliderTrack.png", @"sliderProgress.png", @"sliderThumb.png", nil]];
+}
+
 - (id)init
 {
 	if ((self = [super init]))
@@ -47,6 +47,12 @@
     [super              dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"buttonBackground.png", @"stepper-minus.png", @"stepper-plus.png", nil]];
+}
+
 - (id)init
 {
 	if ((self = [super init]))
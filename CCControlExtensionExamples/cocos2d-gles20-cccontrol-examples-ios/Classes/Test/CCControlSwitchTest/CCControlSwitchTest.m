@@ -49,6 +49,12 @@
     [super              dealloc];
 }
 
++ (NSArray *)assetFiles
+{
+    return [[super assetFiles] arrayByAddingObjectsFromArray:
+            [NSArray arrayWithObjects:@"buttonBackground.png", @"switch-mask.png", @"switch-on.png", @"switch-off.png", @"switch-thumb.png", nil]];
+}
+
 - (id)init
 {
 	if ((self = [super init]))
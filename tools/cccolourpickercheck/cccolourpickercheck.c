@@ -0,0 +1,274 @@
+/*
+ * cccolourpickercheck.c
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/*
+ * cccolourpickercheck compares the colour picker textures drawn by the
+ * ccColourPickerFill functions (see
+ * CCControlExtension/CCControl/Utils/CCColourPickerFill.h) with reference
+ * pixels computed in double precision from the definition of each texture,
+ * and fails on any mismatch.
+ *
+ * Build and run on Linux or Mac OS X:
+ *
+ *     cc -std=c99 -O2 -o cccolourpickercheck cccolourpickercheck.c \
+ *         ../../CCControlExtension/CCControl/Utils/CCColourPickerFill.c -lm
+ *     ./cccolourpickercheck
+ *
+ * A reference component whose exact value lies within kRoundingMargin of a
+ * rounding boundary of the byte may round either way in single precision, so
+ * it is counted apart instead of compared.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../CCControlExtension/CCControl/Utils/CCColourPickerFill.h"
+
+/** Distance to a rounding boundary below which a component is not compared,
+ in 1/255 units. */
+#define kRoundingMargin     0.01
+/** Maximum number of mismatches printed per texture. */
+#define kMaxReports         8
+
+/** Same constants as CCColourPickerFill.c, written from the original images. */
+#define kHueDiscRatio       0.4855
+#define kHueOuterRatio      0.4548
+#define kHueInnerRatio      0.3645
+#define kMarkerMiddleRatio  0.77
+#define kMarkerInnerRatio   0.54
+#define kMarkerShadow       0.3
+#define kArrowHalfBaseRatio 0.19
+#define kTintBoxInsetRatio  (20 / 110.0f)
+
+/** A reference pixel, each component in [0, 1]. */
+typedef struct
+{
+    double      c[4];
+} Reference;
+
+typedef void (*ReferenceFunction)(size_t x, size_t y, size_t width, size_t height, float parameter, Reference *out);
+
+typedef struct
+{
+    unsigned long compared;
+    unsigned long skipped;
+    unsigned long mismatches;
+} Result;
+
+static double clamp01(double value)
+{
+    return (value < 0) ? 0 : (value > 1) ? 1 : value;
+}
+
+/** Part of the pixel at the given distance from a center covered by a disc. */
+static double coverage(double distance, double radius)
+{
+    return clamp01(radius - distance + 0.5);
+}
+
+/** Offset of the pixel center from the center of the buffer, y pointing up. */
+static void pixelOffset(size_t x, size_t y, size_t size, double *dx, double *dy)
+{
+    *dx = x + 0.5 - size / 2.0;
+    *dy = size / 2.0 - (y + 0.5);
+}
+
+static void referenceHueWheel(size_t x, size_t y, size_t width, size_t height, float parameter, Reference *out)
+{
+    (void)height;
+    (void)parameter;
+    
+    double dx, dy;
+    pixelOffset(x, y, width, &dx, &dy);
+    
+    // Hue from 0 on the left through the bottom, with the chroma/second
+    // component form of the HSV to RGB conversion
+    double hue = atan2(dy, dx) * 180.0 / 3.14159265358979323846 + 180.0;
+    hue        = fmod(hue, 360.0) / 60.0;
+    double x2  = 1.0 - fabs(fmod(hue, 2.0) - 1.0);
+    double rgb[3];
+    
+    switch ((int)hue) {
+        case 0:  rgb[0] = 1;  rgb[1] = x2; rgb[2] = 0;  break;
+        case 1:  rgb[0] = x2; rgb[1] = 1;  rgb[2] = 0;  break;
+        case 2:  rgb[0] = 0;  rgb[1] = 1;  rgb[2] = x2; break;
+        case 3:  rgb[0] = 0;  rgb[1] = x2; rgb[2] = 1;  break;
+        case 4:  rgb[0] = x2; rgb[1] = 0;  rgb[2] = 1;  break;
+        default: rgb[0] = 1;  rgb[1] = 0;  rgb[2] = x2; break;
+    }
+    
+    double distance = sqrt(dx * dx + dy * dy);
+    double ring     = coverage(distance, width * kHueOuterRatio) * (1 - coverage(distance, width * kHueInnerRatio));
+    
+    for (int i = 0; i < 3; i++) {
+        out->c[i] = (1 - ring) + rgb[i] * ring;
+    }
+    out->c[3] = coverage(distance, width * kHueDiscRatio);
+}
+
+static void referenceTintBackground(size_t x, size_t y, size_t width, size_t height, float parameter, Reference *out)
+{
+    (void)height;
+    (void)parameter;
+    
+    double dx, dy;
+    pixelOffset(x, y, width, &dx, &dy);
+    
+    out->c[0] = out->c[1] = out->c[2] = 1;
+    out->c[3] = coverage(sqrt(dx * dx + dy * dy), width / 2.0);
+}
+
+static void referenceTintOverlay(size_t x, size_t y, size_t width, size_t height, float parameter, Reference *out)
+{
+    (void)height;
+    
+    double dx, dy;
+    pixelOffset(x, y, width, &dx, &dy);
+    
+    double boxSize    = width - 2.0 * parameter;
+    double saturation = 1 - clamp01((dx + width / 2.0 - parameter) / boxSize);
+    double brightness = clamp01((dy + width / 2.0 - parameter) / boxSize);
+    
+    // Over the hue H, the grey G with the alpha A must give v * (1 - s) + v * s * H
+    double alpha = 1 - brightness * saturation;
+    double grey  = (alpha > 0) ? brightness * (1 - saturation) / alpha : 0;
+    
+    out->c[0] = out->c[1] = out->c[2] = grey;
+    out->c[3] = alpha * coverage(sqrt(dx * dx + dy * dy), width / 2.0);
+}
+
+static void referenceMarker(size_t x, size_t y, size_t width, size_t height, float parameter, Reference *out)
+{
+    (void)height;
+    (void)parameter;
+    
+    double dx, dy;
+    pixelOffset(x, y, width, &dx, &dy);
+    
+    double distance = sqrt(dx * dx + dy * dy);
+    double radius   = width / 2.0;
+    double white    = 1 - coverage(distance, radius * kMarkerMiddleRatio);
+    double ring     = coverage(distance, radius) * (1 - coverage(distance, radius * kMarkerInnerRatio));
+    
+    out->c[0] = out->c[1] = out->c[2] = white;
+    out->c[3] = ring * (white + (1 - white) * kMarkerShadow);
+}
+
+static void referenceArrow(size_t x, size_t y, size_t width, size_t height, float parameter, Reference *out)
+{
+    (void)parameter;
+    
+    // Signed distance to the closest of the two slanted edges of the triangle
+    double tipX     = width / 2.0;
+    double halfBase = height * kArrowHalfBaseRatio;
+    double px       = x + 0.5;
+    double py       = fabs(y + 0.5 - height / 2.0);
+    double distance = (halfBase * (tipX - px) - tipX * py) / sqrt(tipX * tipX + halfBase * halfBase);
+    
+    out->c[0] = out->c[1] = out->c[2] = 1;
+    out->c[3] = clamp01(distance + 0.5);
+}
+
+/** Compares a filled buffer with the reference pixels. */
+static void compare(const char *name, const uint8_t *pixels, size_t width, size_t height, float parameter, ReferenceFunction reference, Result *result)
+{
+    unsigned long reports = 0;
+    
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            Reference expected;
+            reference(x, y, width, height, parameter, &expected);
+            
+            for (int i = 0; i < 4; i++) {
+                double scaled   = expected.c[i] * 255.0 + 0.5;
+                double fraction = scaled - floor(scaled);
+                
+                if (fraction < kRoundingMargin || fraction > 1 - kRoundingMargin) {
+                    result->skipped++;
+                    continue;
+                }
+                
+                uint8_t actual = pixels[(y * width + x) * 4 + i];
+                result->compared++;
+                
+                if (actual != (uint8_t)floor(scaled)) {
+                    result->mismatches++;
+                    
+                    if (reports++ < kMaxReports) {
+                        fprintf(stderr, "%s %lux%lu: pixel (%lu, %lu) component %d is %u, expected %u (%.4f)\n",
+                                name, (unsigned long)width, (unsigned long)height, (unsigned long)x, (unsigned long)y,
+                                i, actual, (unsigned)floor(scaled), expected.c[i] * 255.0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    static const size_t sizes[] = { 1, 2, 7, 13, 26, 64, 110, 166, 220, 332, 498 };
+    const size_t sizeCount      = sizeof(sizes) / sizeof(sizes[0]);
+    Result total;
+    
+    memset(&total, 0, sizeof(total));
+    
+    for (size_t s = 0; s < sizeCount; s++) {
+        size_t size     = sizes[s];
+        uint8_t *pixels = calloc(size * 2 * size * 4, sizeof(uint8_t));
+        float boxInset  = size * kTintBoxInsetRatio;
+        
+        if (pixels == NULL) {
+            fprintf(stderr, "cccolourpickercheck: out of memory\n");
+            return EXIT_FAILURE;
+        }
+        
+        ccColourPickerFillHueWheel(pixels, size);
+        compare("hue wheel", pixels, size, size, 0, referenceHueWheel, &total);
+        
+        ccColourPickerFillTintBackground(pixels, size);
+        compare("tint background", pixels, size, size, 0, referenceTintBackground, &total);
+        
+        ccColourPickerFillTintOverlay(pixels, size, boxInset);
+        compare("tint overlay", pixels, size, size, boxInset, referenceTintOverlay, &total);
+        
+        ccColourPickerFillMarker(pixels, size);
+        compare("marker", pixels, size, size, 0, referenceMarker, &total);
+        
+        // The arrow is twice as high as wide
+        ccColourPickerFillArrow(pixels, size, size * 2);
+        compare("arrow", pixels, size, size * 2, 0, referenceArrow, &total);
+        
+        free(pixels);
+    }
+    
+    printf("%lu components compared, %lu too close to a rounding boundary, %lu mismatches\n",
+           total.compared, total.skipped, total.mismatches);
+    
+    return (total.mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,792 @@
+/*
+ * cccontrollayout.c
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/*
+ * cccontrollayout converts a text description of CCControl hierarchies
+ * into the binary layout read by CCControlLayout (see
+ * CCControlExtension/CCControl/CCControlLayoutFormat.h).
+ *
+ * Build and run on Linux or Mac OS X:
+ *
+ *     cc -std=c99 -O2 -o cccontrollayout cccontrollayout.c
+ *     ./cccontrollayout menu.txt menu.ccl
+ *
+ * The description is a list of controls. Each control starts with its type
+ * (button, slider, switch, stepper or picker), ends with "end" and contains
+ * one property per line. Strings are double-quoted, "#" starts a comment
+ * and the states are named normal, highlighted, disabled and selected.
+ *
+ *     button
+ *         position        160 240
+ *         preferredSize   200 50
+ *         title           normal "Play"
+ *         titleColor      highlighted 255 0 0
+ *         titleTTF        normal "Marker Felt" 30
+ *         background      normal "button.png"
+ *         background      highlighted frame "buttonHighlighted.png" insets 10 10 20 20
+ *     end
+ *
+ * See README.md for the list of properties.
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../CCControlExtension/CCControl/CCControlLayoutFormat.h"
+
+/** Maximum number of tokens of a line. */
+#define kMaxTokens          16
+/** Maximum length of a line. */
+#define kMaxLine            1024
+
+typedef struct
+{
+    char        *bytes;
+    size_t      size;
+    size_t      capacity;
+} Buffer;
+
+typedef struct
+{
+    const char  *path;
+    int         line;
+    
+    /** The controls. */
+    ccControlLayoutRecord   *records;
+    uint32_t                recordCount;
+    uint32_t                recordCapacity;
+    
+    /** The string table, starting with the empty string. */
+    Buffer                  strings;
+} Converter;
+
+static void fail(const Converter *converter, const char *format, ...)
+{
+    va_list args;
+    
+    fprintf(stderr, "%s:%d: ", converter->path, converter->line);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+    
+    exit(EXIT_FAILURE);
+}
+
+static void *checkedRealloc(void *pointer, size_t size)
+{
+    void *result = realloc(pointer, size);
+    
+    if (result == NULL) {
+        fprintf(stderr, "cccontrollayout: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    return result;
+}
+
+static void bufferAppend(Buffer *buffer, const void *bytes, size_t size)
+{
+    if (buffer->size + size > buffer->capacity) {
+        buffer->capacity = (buffer->size + size) * 2;
+        buffer->bytes    = checkedRealloc(buffer->bytes, buffer->capacity);
+    }
+    memcpy(buffer->bytes + buffer->size, bytes, size);
+    buffer->size += size;
+}
+
+/** Returns the offset of the given string, appending it to the table once. */
+static uint32_t internString(Converter *converter, const char *string)
+{
+    size_t offset = 0;
+    
+    if (string[0] == '\0') {
+        return 0;
+    }
+    
+    while (offset < converter->strings.size) {
+        const char *existing = converter->strings.bytes + offset;
+        
+        if (strcmp(existing, string) == 0) {
+            return (uint32_t)offset;
+        }
+        offset += strlen(existing) + 1;
+    }
+    
+    bufferAppend(&converter->strings, string, strlen(string) + 1);
+    
+    return (uint32_t)offset;
+}
+
+/**
+ * Splits a line into tokens in place. The quoted strings are unescaped and
+ * returned without their quotes. Returns the number of tokens.
+ */
+static int tokenize(const Converter *converter, char *line, char **tokens)
+{
+    int count = 0;
+    char *p   = line;
+    
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            p++;
+        }
+        if (*p == '\0' || *p == '#') {
+            return count;
+        }
+        if (count == kMaxTokens) {
+            fail(converter, "too many values");
+        }
+        
+        if (*p == '"') {
+            char *out = ++p;
+            
+            tokens[count++] = out;
+            while (*p != '"') {
+                if (*p == '\0' || *p == '\n') {
+                    fail(converter, "unterminated string");
+                }
+                if (*p == '\\' && p[1] != '\0') {
+                    p++;
+                }
+                *out++ = *p++;
+            }
+            p++;
+            *out = '\0';
+        }
+        else {
+            tokens[count++] = p;
+            while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' && *p != '#') {
+                p++;
+            }
+            if (*p == '#') {
+                *p = '\0';
+                return count;
+            }
+            if (*p != '\0') {
+                *p++ = '\0';
+            }
+        }
+    }
+}
+
+static float parseFloat(const Converter *converter, const char *token)
+{
+    char *end;
+    float value = strtof(token, &end);
+    
+    if (end == token || *end != '\0') {
+        fail(converter, "'%s' is not a number", token);
+    }
+    
+    return value;
+}
+
+static long parseInteger(const Converter *converter, const char *token, long min, long max)
+{
+    char *end;
+    long value;
+    
+    errno = 0;
+    value = strtol(token, &end, 10);
+    
+    if (end == token || *end != '\0' || errno != 0 || value < min || value > max) {
+        fail(converter, "'%s' is not an integer between %ld and %ld", token, min, max);
+    }
+    
+    return value;
+}
+
+static int parseBool(const Converter *converter, const char *token)
+{
+    if (strcmp(token, "yes") == 0 || strcmp(token, "true") == 0) {
+        return 1;
+    }
+    if (strcmp(token, "no") == 0 || strcmp(token, "false") == 0) {
+        return 0;
+    }
+    
+    fail(converter, "'%s' is not yes or no", token);
+    return 0;
+}
+
+/** Returns the bit position of the given state, as used by CCControlState. */
+static int parseState(const Converter *converter, const char *token)
+{
+    static const char *names[kCCControlLayoutStates] = { "normal", "highlighted", "disabled", "selected" };
+    int i;
+    
+    for (i = 0; i < kCCControlLayoutStates; i++) {
+        if (strcmp(token, names[i]) == 0) {
+            return i;
+        }
+    }
+    
+    fail(converter, "unknown state '%s'", token);
+    return 0;
+}
+
+static void parseColor(const Converter *converter, char **tokens, uint8_t *color)
+{
+    int i;
+    
+    for (i = 0; i < 3; i++) {
+        color[i] = (uint8_t)parseInteger(converter, tokens[i], 0, 255);
+    }
+}
+
+static void setFlag(ccControlLayoutRecord *record, uint32_t flag, int enabled)
+{
+    if (enabled) {
+        record->flags |= flag;
+    }
+    else {
+        record->flags &= ~flag;
+    }
+}
+
+/** Parses [frame] "name" [insets x y w h]. */
+static void parseSprite(Converter *converter, char **tokens, int count, ccControlLayoutSprite *sprite)
+{
+    int i = 0;
+    
+    memset(sprite, 0, sizeof(*sprite));
+    
+    if (i < count && strcmp(tokens[i], "frame") == 0) {
+        sprite->flags |= kCCControlLayoutSpriteFrame;
+        i++;
+    }
+    if (i >= count || tokens[i][0] == '\0') {
+        fail(converter, "missing sprite name");
+    }
+    sprite->name = internString(converter, tokens[i++]);
+    
+    if (i < count) {
+        if (strcmp(tokens[i], "insets") != 0 || count - i != 5) {
+            fail(converter, "expected 'insets x y width height'");
+        }
+        for (i = 0; i < 4; i++) {
+            sprite->capInsets[i] = parseFloat(converter, tokens[count - 4 + i]);
+        }
+    }
+}
+
+static void expectValues(const Converter *converter, const char *key, int count, int expected)
+{
+    if (count != expected) {
+        fail(converter, "'%s' expects %d value%s", key, expected, expected > 1 ? "s" : "");
+    }
+}
+
+static ccControlLayoutRecord *beginRecord(Converter *converter, uint32_t type)
+{
+    ccControlLayoutRecord *record;
+    
+    if (converter->recordCount == converter->recordCapacity) {
+        converter->recordCapacity = converter->recordCapacity ? converter->recordCapacity * 2 : 64;
+        converter->records        = checkedRealloc(converter->records, converter->recordCapacity * sizeof(ccControlLayoutRecord));
+    }
+    
+    record = &converter->records[converter->recordCount++];
+    memset(record, 0, sizeof(*record));
+    
+    // Default values of the controls
+    record->type        = type;
+    record->parent      = kCCControlLayoutNoParent;
+    record->color[0]    = 255;
+    record->color[1]    = 255;
+    record->color[2]    = 255;
+    record->opacity     = 255;
+    
+    switch (type) {
+        case kCCControlLayoutTypeButton:
+            record->flags               = kCCControlLayoutFlagZoomOnTouchDown | kCCControlLayoutFlagAdjustBackground;
+            record->margins[0]          = 8;
+            record->margins[1]          = 2;
+            record->labelAnchorPoint[0] = 0.5f;
+            record->labelAnchorPoint[1] = 0.5f;
+            break;
+        case kCCControlLayoutTypeSlider:
+            record->maximumValue        = 1;
+            break;
+        case kCCControlLayoutTypeSwitch:
+            record->flags               = kCCControlLayoutFlagOn;
+            break;
+        case kCCControlLayoutTypeStepper:
+            record->flags               = kCCControlLayoutFlagContinuous | kCCControlLayoutFlagAutorepeat;
+            record->maximumValue        = 100;
+            record->stepValue           = 1;
+            break;
+    }
+    
+    return record;
+}
+
+/** Names of the sprites of each type, indexed like ccControlLayoutRecord.sprites. */
+static const char *spriteKeys[][kCCControlLayoutSprites] =
+{
+    [kCCControlLayoutTypeButton]    = { NULL, NULL, NULL, NULL },
+    [kCCControlLayoutTypeSlider]    = { "background", "progress", "thumb", NULL },
+    [kCCControlLayoutTypeSwitch]    = { "mask", "on", "off", "thumb" },
+    [kCCControlLayoutTypeStepper]   = { "minus", "plus", NULL, NULL },
+    [kCCControlLayoutTypePicker]    = { "foreground", "selection", NULL, NULL },
+};
+
+/** Number of required sprites of each type. */
+static const int requiredSprites[] =
+{
+    [kCCControlLayoutTypeButton]    = 0,
+    [kCCControlLayoutTypeSlider]    = 3,
+    [kCCControlLayoutTypeSwitch]    = 4,
+    [kCCControlLayoutTypeStepper]   = 2,
+    [kCCControlLayoutTypePicker]    = 1,
+};
+
+/** Returns the index of the sprite named by the given key, or -1. */
+static int spriteIndex(uint32_t type, const char *key)
+{
+    int i;
+    
+    for (i = 0; i < kCCControlLayoutSprites; i++) {
+        if (spriteKeys[type][i] && strcmp(spriteKeys[type][i], key) == 0) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+static void endRecord(const Converter *converter, const ccControlLayoutRecord *record)
+{
+    int i;
+    
+    for (i = 0; i < requiredSprites[record->type]; i++) {
+        if (record->sprites[i].name == 0) {
+            fail(converter, "missing '%s' sprite", spriteKeys[record->type][i]);
+        }
+    }
+    
+    if (record->type == kCCControlLayoutTypeStepper) {
+        if (record->minimumValue >= record->maximumValue) {
+            fail(converter, "minimumValue must be less than maximumValue");
+        }
+        if (record->stepValue <= 0) {
+            fail(converter, "stepValue must be greater than 0");
+        }
+    }
+}
+
+/** Parses titleTTF "font" [size] or titleBMFont "file" into the given state. */
+static void parseFont(Converter *converter, const char *key, char **values, int valueCount, ccControlLayoutState *state)
+{
+    int isBMFont = (strcmp(key, "titleBMFont") == 0);
+    
+    if (valueCount < 1 || valueCount > (isBMFont ? 1 : 2)) {
+        fail(converter, isBMFont ? "expected 'titleBMFont \"file\"'" : "expected 'titleTTF \"font\" [size]'");
+    }
+    
+    state->font     = internString(converter, values[0]);
+    state->fontSize = (valueCount == 2) ? parseFloat(converter, values[1]) : 0;
+    
+    if (isBMFont) {
+        state->flags |= kCCControlLayoutStateBMFont;
+    }
+    else {
+        state->flags &= ~kCCControlLayoutStateBMFont;
+    }
+}
+
+/** Parses a property common to all the controls. Returns 0 if the key is unknown. */
+static int parseControlProperty(Converter *converter, ccControlLayoutRecord *record, const char *key, char **values, int valueCount)
+{
+    int index;
+    
+    if (strcmp(key, "position") == 0) {
+        expectValues(converter, key, valueCount, 2);
+        record->position[0] = parseFloat(converter, values[0]);
+        record->position[1] = parseFloat(converter, values[1]);
+    }
+    else if (strcmp(key, "anchorPoint") == 0) {
+        expectValues(converter, key, valueCount, 2);
+        record->anchorPoint[0]  = parseFloat(converter, values[0]);
+        record->anchorPoint[1]  = parseFloat(converter, values[1]);
+        record->flags          |= kCCControlLayoutFlagAnchorPoint;
+    }
+    else if (strcmp(key, "tag") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        record->tag = (int32_t)parseInteger(converter, values[0], INT32_MIN, INT32_MAX);
+    }
+    else if (strcmp(key, "z") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        record->z = (int32_t)parseInteger(converter, values[0], INT32_MIN, INT32_MAX);
+    }
+    else if (strcmp(key, "parent") == 0) {
+        // The parents must precede their children
+        expectValues(converter, key, valueCount, 1);
+        
+        if (converter->recordCount < 2) {
+            fail(converter, "the parent must be a previous control");
+        }
+        record->parent = (int32_t)parseInteger(converter, values[0], 0, (long)converter->recordCount - 2);
+    }
+    else if (strcmp(key, "color") == 0) {
+        expectValues(converter, key, valueCount, 3);
+        parseColor(converter, values, record->color);
+    }
+    else if (strcmp(key, "opacity") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        record->opacity = (uint8_t)parseInteger(converter, values[0], 0, 255);
+    }
+    else if (strcmp(key, "enabled") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        setFlag(record, kCCControlLayoutFlagDisabled, !parseBool(converter, values[0]));
+    }
+    else if (strcmp(key, "selected") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        setFlag(record, kCCControlLayoutFlagSelected, parseBool(converter, values[0]));
+    }
+    else if ((index = spriteIndex(record->type, key)) >= 0) {
+        parseSprite(converter, values, valueCount, &record->sprites[index]);
+    }
+    else {
+        return 0;
+    }
+    
+    return 1;
+}
+
+/** Parses a property of a button. Returns 0 if the key is unknown. */
+static int parseButtonProperty(Converter *converter, ccControlLayoutRecord *record, const char *key, char **values, int valueCount)
+{
+    ccControlLayoutState *state;
+    
+    if (strcmp(key, "preferredSize") == 0) {
+        expectValues(converter, key, valueCount, 2);
+        record->preferredSize[0] = parseFloat(converter, values[0]);
+        record->preferredSize[1] = parseFloat(converter, values[1]);
+        return 1;
+    }
+    if (strcmp(key, "margins") == 0) {
+        expectValues(converter, key, valueCount, 2);
+        record->margins[0] = parseFloat(converter, values[0]);
+        record->margins[1] = parseFloat(converter, values[1]);
+        return 1;
+    }
+    if (strcmp(key, "labelAnchorPoint") == 0) {
+        expectValues(converter, key, valueCount, 2);
+        record->labelAnchorPoint[0] = parseFloat(converter, values[0]);
+        record->labelAnchorPoint[1] = parseFloat(converter, values[1]);
+        return 1;
+    }
+    if (strcmp(key, "zoomOnTouchDown") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        setFlag(record, kCCControlLayoutFlagZoomOnTouchDown, parseBool(converter, values[0]));
+        return 1;
+    }
+    if (strcmp(key, "adjustBackgroundImage") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        setFlag(record, kCCControlLayoutFlagAdjustBackground, parseBool(converter, values[0]));
+        return 1;
+    }
+    if (strcmp(key, "loadsStatesLazily") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        setFlag(record, kCCControlLayoutFlagLoadsStatesLazily, parseBool(converter, values[0]));
+        return 1;
+    }
+    
+    // Per-state properties: key state values...
+    if (strcmp(key, "title") != 0
+        && strcmp(key, "titleColor") != 0
+        && strcmp(key, "titleTTF") != 0
+        && strcmp(key, "titleBMFont") != 0
+        && strcmp(key, "background") != 0) {
+        return 0;
+    }
+    if (valueCount < 1) {
+        fail(converter, "'%s' expects a state", key);
+    }
+    
+    state = &record->states[parseState(converter, values[0])];
+    values++;
+    valueCount--;
+    
+    if (strcmp(key, "title") == 0) {
+        expectValues(converter, key, valueCount, 1);
+        state->title = internString(converter, values[0]);
+    }
+    else if (strcmp(key, "titleColor") == 0) {
+        expectValues(converter, key, valueCount, 3);
+        parseColor(converter, values, state->titleColor);
+        state->flags |= kCCControlLayoutStateTitleColor;
+    }
+    else if (strcmp(key, "background") == 0) {
+        parseSprite(converter, values, valueCount, &state->background);
+    }
+    else {
+        parseFont(converter, key, values, valueCount, state);
+    }
+    
+    return 1;
+}
+
+/** Parses a property of a slider, a switch, a stepper or a picker. Returns 0 if the key is unknown. */
+static int parseValueProperty(Converter *converter, ccControlLayoutRecord *record, const char *key, char **values, int valueCount)
+{
+    uint32_t type = record->type;
+    
+    if ((type == kCCControlLayoutTypeSlider || type == kCCControlLayoutTypeStepper)
+        && (strcmp(key, "value") == 0 || strcmp(key, "minimumValue") == 0 || strcmp(key, "maximumValue") == 0)) {
+        expectValues(converter, key, valueCount, 1);
+        
+        float value = parseFloat(converter, values[0]);
+        
+        if (key[0] == 'v') {
+            record->value = value;
+        }
+        else if (key[1] == 'i') {
+            record->minimumValue = value;
+        }
+        else {
+            record->maximumValue = value;
+        }
+        return 1;
+    }
+    
+    if (type == kCCControlLayoutTypeStepper) {
+        if (strcmp(key, "stepValue") == 0) {
+            expectValues(converter, key, valueCount, 1);
+            record->stepValue = parseFloat(converter, values[0]);
+            return 1;
+        }
+        if (strcmp(key, "continuous") == 0 || strcmp(key, "autorepeat") == 0 || strcmp(key, "wraps") == 0) {
+            uint32_t flag = (key[0] == 'c') ? kCCControlLayoutFlagContinuous
+                          : (key[0] == 'a') ? kCCControlLayoutFlagAutorepeat
+                          : kCCControlLayoutFlagWraps;
+            
+            expectValues(converter, key, valueCount, 1);
+            setFlag(record, flag, parseBool(converter, values[0]));
+            return 1;
+        }
+    }
+    
+    if (type == kCCControlLayoutTypeSwitch) {
+        // The on and off titles are stored as the normal and selected states
+        if (strcmp(key, "isOn") == 0) {
+            expectValues(converter, key, valueCount, 1);
+            setFlag(record, kCCControlLayoutFlagOn, parseBool(converter, values[0]));
+            return 1;
+        }
+        if (strcmp(key, "onTitle") == 0 || strcmp(key, "offTitle") == 0) {
+            expectValues(converter, key, valueCount, 1);
+            record->states[(key[1] == 'n') ? 0 : 3].title = internString(converter, values[0]);
+            return 1;
+        }
+        if (strcmp(key, "titleTTF") == 0 || strcmp(key, "titleBMFont") == 0) {
+            parseFont(converter, key, values, valueCount, &record->states[0]);
+            record->states[3].font      = record->states[0].font;
+            record->states[3].fontSize  = record->states[0].fontSize;
+            record->states[3].flags     = record->states[0].flags;
+            return 1;
+        }
+    }
+    
+    if (type == kCCControlLayoutTypePicker) {
+        if (strcmp(key, "looping") == 0) {
+            expectValues(converter, key, valueCount, 1);
+            setFlag(record, kCCControlLayoutFlagLooping, parseBool(converter, values[0]));
+            return 1;
+        }
+        if (strcmp(key, "swipeOrientation") == 0) {
+            expectValues(converter, key, valueCount, 1);
+            
+            if (strcmp(values[0], "horizontal") == 0) {
+                record->flags |= kCCControlLayoutFlagSwipeHorizontally;
+            }
+            else if (strcmp(values[0], "vertical") == 0) {
+                record->flags &= ~kCCControlLayoutFlagSwipeHorizontally;
+            }
+            else {
+                fail(converter, "expected horizontal or vertical");
+            }
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/** Returns the type of the control starting with the given keyword, or 0. */
+static uint32_t controlType(const char *keyword)
+{
+    static const char *names[] = { NULL, "button", "slider", "switch", "stepper", "picker" };
+    uint32_t type;
+    
+    for (type = kCCControlLayoutTypeButton; type <= kCCControlLayoutTypePicker; type++) {
+        if (strcmp(keyword, names[type]) == 0) {
+            return type;
+        }
+    }
+    
+    return 0;
+}
+
+static void parseFile(Converter *converter, FILE *file)
+{
+    char line[kMaxLine];
+    char *tokens[kMaxTokens];
+    ccControlLayoutRecord *record = NULL;
+    
+    while (fgets(line, sizeof(line), file)) {
+        int count;
+        uint32_t type;
+        
+        converter->line++;
+        
+        if (strchr(line, '\n') == NULL && !feof(file)) {
+            fail(converter, "line too long");
+        }
+        
+        count = tokenize(converter, line, tokens);
+        
+        if (count == 0) {
+            continue;
+        }
+        
+        if ((type = controlType(tokens[0])) != 0) {
+            if (record) {
+                fail(converter, "missing 'end' before '%s'", tokens[0]);
+            }
+            if (count != 1) {
+                fail(converter, "unexpected value after '%s'", tokens[0]);
+            }
+            record = beginRecord(converter, type);
+        }
+        else if (record == NULL) {
+            fail(converter, "expected a control type, found '%s'", tokens[0]);
+        }
+        else if (strcmp(tokens[0], "end") == 0) {
+            endRecord(converter, record);
+            record = NULL;
+        }
+        else if (!parseControlProperty(converter, record, tokens[0], tokens + 1, count - 1)
+                 && !(record->type == kCCControlLayoutTypeButton
+                      ? parseButtonProperty(converter, record, tokens[0], tokens + 1, count - 1)
+                      : parseValueProperty(converter, record, tokens[0], tokens + 1, count - 1))) {
+            fail(converter, "unknown property '%s'", tokens[0]);
+        }
+    }
+    
+    if (ferror(file)) {
+        fail(converter, "%s", strerror(errno));
+    }
+    if (record) {
+        fail(converter, "missing 'end'");
+    }
+}
+
+static void writeLayout(const Converter *converter, const char *path)
+{
+    ccControlLayoutHeader header;
+    Buffer output = { NULL, 0, 0 };
+    const char *error;
+    FILE *file;
+    
+    memset(&header, 0, sizeof(header));
+    header.magic            = kCCControlLayoutMagic;
+    header.version          = kCCControlLayoutVersion;
+    header.recordSize       = sizeof(ccControlLayoutRecord);
+    header.recordCount      = converter->recordCount;
+    header.recordsOffset    = sizeof(ccControlLayoutHeader);
+    header.stringsOffset    = header.recordsOffset + converter->recordCount * sizeof(ccControlLayoutRecord);
+    header.stringsSize      = (uint32_t)converter->strings.size;
+    
+    bufferAppend(&output, &header, sizeof(header));
+    bufferAppend(&output, converter->records, converter->recordCount * sizeof(ccControlLayoutRecord));
+    bufferAppend(&output, converter->strings.bytes, converter->strings.size);
+    
+    // Check the output with the validation of the loader
+    if ((error = ccControlLayoutValidate(output.bytes, output.size)) != NULL) {
+        fprintf(stderr, "cccontrollayout: invalid output: %s\n", error);
+        exit(EXIT_FAILURE);
+    }
+    
+    file = fopen(path, "wb");
+    
+    if (file == NULL
+        || fwrite(output.bytes, 1, output.size, file) != output.size
+        || fclose(file) != 0) {
+        fprintf(stderr, "cccontrollayout: %s: %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    
+    free(output.bytes);
+}
+
+int main(int argc, char **argv)
+{
+    const uint16_t byteOrderProbe = 1;
+    Converter converter;
+    FILE *input;
+    
+    if (argc != 3) {
+        fprintf(stderr, "usage: cccontrollayout <input.txt> <output.ccl>\n");
+        return EXIT_FAILURE;
+    }
+    
+    // The records are written as they are laid out in memory
+    if (*(const uint8_t *)&byteOrderProbe != 1) {
+        fprintf(stderr, "cccontrollayout: big-endian hosts are not supported\n");
+        return EXIT_FAILURE;
+    }
+    
+    memset(&converter, 0, sizeof(converter));
+    converter.path = argv[1];
+    
+    // The offset 0 of the string table is the empty string
+    bufferAppend(&converter.strings, "", 1);
+    
+    input = fopen(argv[1], "r");
+    
+    if (input == NULL) {
+        fprintf(stderr, "cccontrollayout: %s: %s\n", argv[1], strerror(errno));
+        return EXIT_FAILURE;
+    }
+    
+    parseFile(&converter, input);
+    fclose(input);
+    
+    writeLayout(&converter, argv[2]);
+    
+    printf("%s: %u controls, %lu bytes of strings\n", argv[2], converter.recordCount, (unsigned long)converter.strings.size);
+    
+    free(converter.records);
+    free(converter.strings.bytes);
+    
+    return EXIT_SUCCESS;
+}
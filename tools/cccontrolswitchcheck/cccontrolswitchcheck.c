@@ -0,0 +1,393 @@
+/*
+ * cccontrolswitchcheck.c
+ *
+ * Copyright 2011-present Yannick Loriot.
+ * http://yannickloriot.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/*
+ * cccontrolswitchcheck compares the quads of the batched switches filled by
+ * ccControlSwitchFillQuads (see
+ * CCControlExtension/CCControl/Utils/CCControlSwitchQuads.h) with the layout
+ * of a non batched switch, as placed by CCControlSwitchSprite -needsLayout,
+ * and fails on any mismatch.
+ *
+ * Build and run on Linux or Mac OS X:
+ *
+ *     cc -std=c99 -O2 -o cccontrolswitchcheck cccontrolswitchcheck.c \
+ *         ../../CCControlExtension/CCControl/Utils/CCControlSwitchQuads.c -lm
+ *     ./cccontrolswitchcheck
+ *
+ * Each switch is sampled on a grid of points. At each point the reference
+ * tells which part of the switch is visible (the thumb, the off side, the on
+ * side or nothing) and which point of its image and of the mask is sampled.
+ * The quads must give the same part and the same texture coordinates. The
+ * points lying within kEdgeMargin of an edge may fall on either side in
+ * single precision, so they are counted apart instead of compared.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../CCControlExtension/CCControl/Utils/CCControlSwitchQuads.h"
+
+/** Distance to an edge below which a point is not compared, in points. */
+#define kEdgeMargin         1e-3
+/** Tolerance on the normalized texture coordinates. */
+#define kTexCoordTolerance  1e-4
+/** Same values as CCControlSwitchBatchNode.m. */
+#define kPadding            2
+#define kOpaqueSize         4
+#define kQuadsPerSwitch     3
+/** Maximum number of mismatches printed. */
+#define kMaxReports         8
+
+/** The parts of a switch visible at a point. */
+typedef enum
+{
+    kPartNone,
+    kPartOn,
+    kPartOff,
+    kPartThumb,
+} Part;
+
+static const char *partNames[] = { "nothing", "on side", "off side", "thumb" };
+
+/** What a point of the switch shows: the part and its normalized image and
+ mask coordinates, v growing downward like the images. */
+typedef struct
+{
+    Part    part;
+    double  u, v;
+    double  maskU, maskV;
+} Sample;
+
+typedef struct
+{
+    double  mask[2];
+    double  on[2];
+    double  off[2];
+    double  thumb[2];
+} Sizes;
+
+typedef struct
+{
+    unsigned long compared;
+    unsigned long skipped;
+    unsigned long mismatches;
+} Result;
+
+static double minimum(double a, double b)
+{
+    return (a < b) ? a : b;
+}
+
+/** Distance from the value to the closer of two edges. */
+static double edgeDistance(double value, double low, double high)
+{
+    return minimum(fabs(value - low), fabs(value - high));
+}
+
+/**
+ * The reference: the sprites placed by -needsLayout, the sides rendered into
+ * a texture of the size of the mask and masked by it, the thumb drawn over
+ * them. Returns the distance of the point to the closest edge it depends on.
+ */
+static double referenceSample(const Sizes *sizes, double slider, double x, double y, Sample *out)
+{
+    // -needsLayout centers the sprites on these positions
+    double onX     = sizes->on[0] / 2 + slider;
+    double offX    = sizes->on[0] + sizes->off[0] / 2 + slider;
+    double thumbX  = sizes->on[0] + slider;
+    double thumbY  = sizes->mask[1] / 2;
+    
+    double thumbX0 = thumbX - sizes->thumb[0] / 2, thumbX1 = thumbX + sizes->thumb[0] / 2;
+    double thumbY0 = thumbY - sizes->thumb[1] / 2, thumbY1 = thumbY + sizes->thumb[1] / 2;
+    double margin  = minimum(edgeDistance(x, thumbX0, thumbX1), edgeDistance(y, thumbY0, thumbY1));
+    
+    out->part      = kPartNone;
+    
+    if (x > thumbX0 && x < thumbX1 && y > thumbY0 && y < thumbY1) {
+        out->part  = kPartThumb;
+        out->u     = (x - thumbX0) / sizes->thumb[0];
+        out->v     = (thumbY1 - y) / sizes->thumb[1];
+        return margin;
+    }
+    
+    // The render texture of the sides has the size of the mask
+    margin = minimum(margin, minimum(edgeDistance(x, 0, sizes->mask[0]), edgeDistance(y, 0, sizes->mask[1])));
+    
+    if (x < 0 || x > sizes->mask[0] || y < 0 || y > sizes->mask[1]) {
+        return margin;
+    }
+    
+    out->maskU     = x / sizes->mask[0];
+    out->maskV     = 1 - y / sizes->mask[1];
+    
+    // The off side is visited after the on side
+    double offX0   = offX - sizes->off[0] / 2, offX1 = offX + sizes->off[0] / 2;
+    double onX0    = onX - sizes->on[0] / 2, onX1 = onX + sizes->on[0] / 2;
+    margin         = minimum(margin, minimum(edgeDistance(x, offX0, offX1), edgeDistance(y, 0, sizes->off[1])));
+    margin         = minimum(margin, minimum(edgeDistance(x, onX0, onX1), edgeDistance(y, 0, sizes->on[1])));
+    
+    if (x > offX0 && x < offX1 && y < sizes->off[1]) {
+        out->part  = kPartOff;
+        out->u     = (x - offX0) / sizes->off[0];
+        out->v     = 1 - y / sizes->off[1];
+    }
+    else if (x > onX0 && x < onX1 && y < sizes->on[1]) {
+        out->part  = kPartOn;
+        out->u     = (x - onX0) / sizes->on[0];
+        out->v     = 1 - y / sizes->on[1];
+    }
+    
+    return margin;
+}
+
+/** Returns the coordinate of the point of the region, normalized. */
+static void normalizeInRegion(ccControlSwitchRegion region, double u, double v, double *outU, double *outV)
+{
+    *outU = (u - region.x) / region.width;
+    *outV = (v - region.y) / region.height;
+}
+
+static int insideRegion(ccControlSwitchRegion region, double u, double v)
+{
+    return u >= region.x - kTexCoordTolerance && u <= region.x + region.width + kTexCoordTolerance
+        && v >= region.y - kTexCoordTolerance && v <= region.y + region.height + kTexCoordTolerance;
+}
+
+/** Reads what the quads show at a point: the last quad containing it wins. */
+static int quadSample(const ccControlSwitchSkinLayout *layout, const ccControlSwitchQuad *quads, size_t count,
+                      double x, double y, Sample *out, ccControlSwitchColor4B *color)
+{
+    out->part = kPartNone;
+    
+    for (size_t i = count; i-- > 0; ) {
+        const ccControlSwitchQuad *quad = &quads[i];
+        
+        // The quads are axis aligned in the space of the switch
+        double x0 = quad->bl.vertices.x, x1 = quad->br.vertices.x;
+        double y0 = quad->bl.vertices.y, y1 = quad->tl.vertices.y;
+        
+        if (x <= x0 || x >= x1 || y <= y0 || y >= y1) {
+            continue;
+        }
+        
+        // The vertices must form a rectangle, with linear texture coordinates
+        if (quad->tr.vertices.x != quad->br.vertices.x || quad->tr.vertices.y != quad->tl.vertices.y
+            || quad->bl.vertices.x != quad->tl.vertices.x || quad->bl.vertices.y != quad->br.vertices.y
+            || fabs(quad->tr.texCoords.u - (quad->br.texCoords.u + quad->tl.texCoords.u - quad->bl.texCoords.u)) > kTexCoordTolerance
+            || fabs(quad->tr.texCoords.v - (quad->br.texCoords.v + quad->tl.texCoords.v - quad->bl.texCoords.v)) > kTexCoordTolerance) {
+            return 0;
+        }
+        
+        double fx    = (x - x0) / (x1 - x0);
+        double fy    = (y - y0) / (y1 - y0);
+        double u     = quad->bl.texCoords.u + fx * (quad->br.texCoords.u - quad->bl.texCoords.u) + fy * (quad->tl.texCoords.u - quad->bl.texCoords.u);
+        double v     = quad->bl.texCoords.v + fx * (quad->br.texCoords.v - quad->bl.texCoords.v) + fy * (quad->tl.texCoords.v - quad->bl.texCoords.v);
+        double maskU = quad->bl.maskCoords.u + fx * (quad->br.maskCoords.u - quad->bl.maskCoords.u) + fy * (quad->tl.maskCoords.u - quad->bl.maskCoords.u);
+        double maskV = quad->bl.maskCoords.v + fx * (quad->br.maskCoords.v - quad->bl.maskCoords.v) + fy * (quad->tl.maskCoords.v - quad->bl.maskCoords.v);
+        
+        *color = quad->bl.colors;
+        
+        if (insideRegion(layout->thumbRegion, u, v)) {
+            out->part = kPartThumb;
+            normalizeInRegion(layout->thumbRegion, u, v, &out->u, &out->v);
+            
+            // The thumb is not masked: its mask coordinates must be opaque
+            return insideRegion(layout->opaqueRegion, maskU, maskV);
+        }
+        
+        out->part = insideRegion(layout->onRegion, u, v) ? kPartOn
+                  : insideRegion(layout->offRegion, u, v) ? kPartOff
+                  : kPartNone;
+        normalizeInRegion((out->part == kPartOn) ? layout->onRegion : layout->offRegion, u, v, &out->u, &out->v);
+        normalizeInRegion(layout->maskRegion, maskU, maskV, &out->maskU, &out->maskV);
+        
+        return out->part != kPartNone;
+    }
+    
+    return 1;
+}
+
+/** Lays the parts out in an atlas like CCControlSwitchSkin. */
+static ccControlSwitchSkinLayout makeLayout(const Sizes *sizes)
+{
+    ccControlSwitchSkinLayout layout;
+    const double *parts[] = { sizes->mask, sizes->on, sizes->off, sizes->thumb };
+    ccControlSwitchRegion *regions[] = { &layout.maskRegion, &layout.onRegion, &layout.offRegion, &layout.thumbRegion };
+    double rects[5][4];
+    double x      = kPadding;
+    double height = kOpaqueSize;
+    
+    for (int i = 0; i < 4; i++) {
+        rects[i][0] = x;
+        rects[i][1] = kPadding;
+        rects[i][2] = parts[i][0];
+        rects[i][3] = parts[i][1];
+        x           += ceil(parts[i][0]) + kPadding;
+        height      = (ceil(parts[i][1]) > height) ? ceil(parts[i][1]) : height;
+    }
+    
+    rects[4][0] = x;
+    rects[4][1] = kPadding;
+    rects[4][2] = kOpaqueSize;
+    rects[4][3] = kOpaqueSize;
+    x           += kOpaqueSize + kPadding;
+    height      += 2 * kPadding;
+    
+    layout.maskSize  = (ccControlSwitchSize) { (float)sizes->mask[0], (float)sizes->mask[1] };
+    layout.onSize    = (ccControlSwitchSize) { (float)sizes->on[0], (float)sizes->on[1] };
+    layout.offSize   = (ccControlSwitchSize) { (float)sizes->off[0], (float)sizes->off[1] };
+    layout.thumbSize = (ccControlSwitchSize) { (float)sizes->thumb[0], (float)sizes->thumb[1] };
+    
+    for (int i = 0; i < 5; i++) {
+        ccControlSwitchRegion *region = (i < 4) ? regions[i] : &layout.opaqueRegion;
+        region->x      = (float)(rects[i][0] / x);
+        region->y      = (float)(rects[i][1] / height);
+        region->width  = (float)(rects[i][2] / x);
+        region->height = (float)(rects[i][3] / height);
+    }
+    
+    return layout;
+}
+
+static int sameColor(ccControlSwitchColor4B a, ccControlSwitchColor4B b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static void checkSwitch(const Sizes *sizes, double slider, Result *result)
+{
+    ccControlSwitchSkinLayout layout = makeLayout(sizes);
+    ccControlSwitchColor4B color     = { 200, 100, 50, 200 };
+    ccControlSwitchColor4B thumbColor = { 10, 20, 30, 255 };
+    ccControlSwitchQuad quads[kQuadsPerSwitch];
+    size_t count = ccControlSwitchFillQuads(&layout, (float)slider, color, thumbColor, quads);
+    
+    double step  = 0.37;
+    
+    for (double y = -sizes->thumb[1] + 0.0123; y < sizes->mask[1] + sizes->thumb[1]; y += step) {
+        for (double x = -sizes->thumb[0] + 0.0071; x < sizes->mask[0] + sizes->thumb[0]; x += step) {
+            Sample expected = { kPartNone, 0, 0, 0, 0 };
+            Sample actual   = expected;
+            ccControlSwitchColor4B actualColor = { 0, 0, 0, 0 };
+            
+            if (referenceSample(sizes, slider, x, y, &expected) < kEdgeMargin) {
+                result->skipped++;
+                continue;
+            }
+            
+            int valid = quadSample(&layout, quads, count, x, y, &actual, &actualColor);
+            int match = valid && actual.part == expected.part;
+            
+            if (match && expected.part != kPartNone) {
+                match = fabs(actual.u - expected.u) < kTexCoordTolerance
+                     && fabs(actual.v - expected.v) < kTexCoordTolerance
+                     && sameColor(actualColor, (expected.part == kPartThumb) ? thumbColor : color);
+            }
+            
+            if (match && (expected.part == kPartOn || expected.part == kPartOff)) {
+                match = fabs(actual.maskU - expected.maskU) < kTexCoordTolerance
+                     && fabs(actual.maskV - expected.maskV) < kTexCoordTolerance;
+            }
+            
+            result->compared++;
+            
+            if (!match) {
+                if (result->mismatches++ < kMaxReports) {
+                    fprintf(stderr, "mask %gx%g, on %gx%g, off %gx%g, thumb %gx%g, slider %g: at (%g, %g) expected %s, got %s%s\n",
+                            sizes->mask[0], sizes->mask[1], sizes->on[0], sizes->on[1], sizes->off[0], sizes->off[1],
+                            sizes->thumb[0], sizes->thumb[1], slider, x, y,
+                            partNames[expected.part], partNames[actual.part], valid ? "" : " (invalid quad)");
+                }
+            }
+        }
+    }
+}
+
+/** The transformed quads must be the quads with transformed vertices. */
+static void checkTransform(Result *result)
+{
+    Sizes sizes                      = { { 94, 27 }, { 94, 27 }, { 94, 27 }, { 28, 28 } };
+    ccControlSwitchSkinLayout layout = makeLayout(&sizes);
+    ccControlSwitchColor4B color     = { 255, 255, 255, 255 };
+    ccControlSwitchQuad quads[kQuadsPerSwitch], transformed[kQuadsPerSwitch];
+    size_t count                     = ccControlSwitchFillQuads(&layout, -30, color, color, quads);
+    double angle                     = 0.3;
+    ccControlSwitchTransform transform = { (float)(2 * cos(angle)), (float)(2 * sin(angle)), (float)(-sin(angle)), (float)cos(angle), 12.5f, -7 };
+    
+    for (size_t i = 0; i < count; i++) {
+        transformed[i] = quads[i];
+    }
+    ccControlSwitchTransformQuads(transformed, count, transform);
+    
+    const ccControlSwitchVertex *before = (const ccControlSwitchVertex *)quads;
+    const ccControlSwitchVertex *after  = (const ccControlSwitchVertex *)transformed;
+    
+    for (size_t i = 0; i < count * 4; i++) {
+        double x = transform.a * before[i].vertices.x + transform.c * before[i].vertices.y + transform.tx;
+        double y = transform.b * before[i].vertices.x + transform.d * before[i].vertices.y + transform.ty;
+        
+        result->compared++;
+        
+        if (fabs(after[i].vertices.x - x) > 1e-3 || fabs(after[i].vertices.y - y) > 1e-3
+            || after[i].texCoords.u != before[i].texCoords.u || after[i].texCoords.v != before[i].texCoords.v) {
+            if (result->mismatches++ < kMaxReports) {
+                fprintf(stderr, "transform: vertex %lu is (%g, %g), expected (%g, %g)\n",
+                        (unsigned long)i, after[i].vertices.x, after[i].vertices.y, x, y);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    // Sizes of the example switch, and of skins whose sides are wider, taller
+    // or narrower than the mask
+    static const Sizes sizes[] =
+    {
+        { { 94, 27 }, { 94, 27 }, { 94, 27 }, { 28, 28 } },
+        { { 80, 30 }, { 120, 30 }, { 120, 30 }, { 32, 32 } },
+        { { 60, 20 }, { 70, 26 }, { 64, 18 }, { 24, 22 } },
+        { { 50.5, 21.25 }, { 40, 21.25 }, { 55.75, 21.25 }, { 19.5, 25 } },
+    };
+    Result result = { 0, 0, 0 };
+    
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        // From the off to the on position, and past them while dragged
+        double off = sizes[i].thumb[0] / 2 - sizes[i].on[0];
+        
+        for (int step = -2; step <= 22; step++) {
+            checkSwitch(&sizes[i], off * (1 - step / 20.0), &result);
+        }
+    }
+    
+    checkTransform(&result);
+    
+    printf("%lu samples compared, %lu too close to an edge, %lu mismatches\n",
+           result.compared, result.skipped, result.mismatches);
+    
+    return (result.mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}